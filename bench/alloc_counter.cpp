@@ -0,0 +1,45 @@
+#include "alloc_counter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<std::size_t> g_allocations{0};     // NOLINT
+static std::atomic<std::size_t> g_allocated_bytes{0}; // NOLINT
+
+// the replaced operators pair malloc() and free() themselves
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(const std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if(void* memory = std::malloc(size == 0 ? 1 : size)){ // NOLINT
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory); // NOLINT
+}
+
+void operator delete(void* memory, std::size_t /*size*/) noexcept
+{
+    std::free(memory); // NOLINT
+}
+
+
+std::size_t AllocationCount() noexcept
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+
+std::size_t AllocatedBytes() noexcept
+{
+    return g_allocated_bytes.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,26 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstddef>
+
+/*
+ * Heap allocations of a benchmark binary: alloc_counter.cpp replaces the
+ * global operator new and delete of the program it is linked into, and
+ * counts every allocation of the process, from any thread.
+ */
+
+/**
+ * @brief AllocationCount
+ *
+ * @return The number of calls to operator new so far
+ */
+std::size_t AllocationCount() noexcept;
+
+/**
+ * @brief AllocatedBytes
+ *
+ * @return The number of bytes requested from operator new so far
+ */
+std::size_t AllocatedBytes() noexcept;
+
+#endif // ALLOC_COUNTER_H
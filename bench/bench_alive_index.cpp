@@ -0,0 +1,92 @@
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "alive_index.h"
+#include "fighter.h"
+
+/*
+ * "Any enemy left ?" and the choice of a target, in a horde of monsters
+ * where only the last one is still alive: the worst case of asking each
+ * fighter, as done for the orc and the dragon of the game.
+ *
+ * - BM_PollIsAlive asks IsAlive() to each monster.
+ * - BM_AliveIndexAnyAlive reads the counter of the faction.
+ * - BM_AliveIndexFind scans the bitset of the faction, 64 monsters a word.
+ * - BM_AliveIndexTarget picks a target from the dense list.
+ */
+
+// A horde with a single living monster, the last one
+struct Horde {
+    std::vector<Monster> monsters;
+    AliveIndex alive;
+
+    explicit Horde(const std::size_t count)
+    : monsters(count, Monster(ROLE_ORC)) {
+        for(auto& monster : monsters){
+            alive.Add(monster);
+        }
+        for(std::size_t i = 0; i + 1 < count; ++i){
+            monsters[i].Reset();
+        }
+    }
+};
+
+
+static void BM_PollIsAlive(benchmark::State& state)
+{
+    const Horde horde(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state)
+    {
+        bool any{false};
+        for(const auto& monster : horde.monsters){
+            if(monster.IsAlive()){
+                any = true;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(any);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+
+static void BM_AliveIndexAnyAlive(benchmark::State& state)
+{
+    const Horde horde(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(horde.alive.AnyAlive(FACTION_MONSTERS));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+
+static void BM_AliveIndexFind(benchmark::State& state)
+{
+    const Horde horde(static_cast<std::size_t>(state.range(0)));
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(horde.alive.Find(FACTION_MONSTERS));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+
+static void BM_AliveIndexTarget(benchmark::State& state)
+{
+    const Horde horde(static_cast<std::size_t>(state.range(0)));
+    const auto hero = Hero(ROLE_HERO);
+    std::size_t choice{0};
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(horde.alive.Target(hero, choice++));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_PollIsAlive)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_AliveIndexAnyAlive)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_AliveIndexFind)->Arg(1000)->Arg(1000000);
+BENCHMARK(BM_AliveIndexTarget)->Arg(1000)->Arg(1000000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,132 @@
+#include <cctype>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+#include "alloc_counter.h"
+#include "command_parser.h"
+#include "input_reactor.h"
+
+/*
+ * Parsing rate of a bot script piped into the game, one command per line.
+ * The string rebuilding parser of the former hero loop is compared to
+ * ParseHeroCommand() on views into the script, alone and behind an
+ * InputReactor reading the script from a file.
+ *
+ * Every heap allocation of the process is counted by alloc_counter.cpp:
+ * allocs_per_command must be 0 for the views.
+ */
+
+// A script of attacks, in mixed case, with some unknown commands
+static std::string MakeScript(const std::size_t lines)
+{
+    static const char* const COMMANDS[] = {
+        "attack orc\n", "Attack Dragon\n", "ATTACK ORC\n", "jump\n",
+    };
+    std::string script;
+    for(std::size_t i = 0; i < lines; ++i){
+        script += COMMANDS[i % 4];
+    }
+    return script;
+}
+
+static void Counters(benchmark::State& state, const std::size_t allocations)
+{
+    const auto commands = state.iterations() * state.range(0);
+    state.SetItemsProcessed(commands);
+    state.counters["allocs_per_command"] =
+        static_cast<double>(allocations) / static_cast<double>(commands);
+}
+
+
+static void BM_ParseStringCopy(benchmark::State& state)
+{
+    const std::string script = MakeScript(static_cast<std::size_t>(state.range(0)));
+    std::size_t attacks{0};
+    const std::size_t allocations_before = AllocationCount();
+
+    for(auto _ : state)
+    {
+        std::string command_in;
+        std::string command;
+        std::size_t start{0};
+        for(auto end = script.find('\n'); end != std::string::npos;
+            start = end + 1, end = script.find('\n', start))
+        {
+            command_in.assign(script, start, end - start);
+            command.clear();
+            for(auto item : command_in){
+                command += static_cast<char>( tolower(item) );
+            }
+            attacks += command == "attack orc" || command == "attack dragon";
+        }
+    }
+    benchmark::DoNotOptimize(attacks);
+    Counters(state, AllocationCount() - allocations_before);
+}
+
+
+static void BM_ParseHeroCommand(benchmark::State& state)
+{
+    const std::string script = MakeScript(static_cast<std::size_t>(state.range(0)));
+    std::size_t attacks{0};
+    const std::size_t allocations_before = AllocationCount();
+
+    for(auto _ : state)
+    {
+        const std::string_view view{script};
+        std::size_t start{0};
+        for(auto end = view.find('\n'); end != std::string_view::npos;
+            start = end + 1, end = view.find('\n', start))
+        {
+            attacks += ParseHeroCommand(view.substr(start, end - start)) != ROLE_UNDEFINED;
+        }
+    }
+    benchmark::DoNotOptimize(attacks);
+    Counters(state, AllocationCount() - allocations_before);
+}
+
+
+static void BM_ReactorScript(benchmark::State& state)
+{
+    const std::string script = MakeScript(static_cast<std::size_t>(state.range(0)));
+    std::FILE* file = std::tmpfile();
+    if(file == nullptr ||
+       std::fwrite(script.data(), 1, script.size(), file) != script.size() ||
+       std::fflush(file) != 0)
+    {
+        state.SkipWithError("unable to write the script");
+        return;
+    }
+    const int fd = fileno(file);
+    std::size_t attacks{0};
+    std::size_t allocations{0};
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        lseek(fd, 0, SEEK_SET);
+        InputReactor reactor;
+        reactor.Add(fd, [&attacks](const std::string_view command) {
+            attacks += ParseHeroCommand(command) != ROLE_UNDEFINED;
+        });
+        const std::size_t allocations_before = AllocationCount();
+        state.ResumeTiming();
+
+        reactor.Run();
+
+        allocations += AllocationCount() - allocations_before;
+    }
+    benchmark::DoNotOptimize(attacks);
+    std::fclose(file);
+    Counters(state, allocations);
+}
+
+BENCHMARK(BM_ParseStringCopy)->Arg(1 << 20);
+BENCHMARK(BM_ParseHeroCommand)->Arg(1 << 20);
+BENCHMARK(BM_ReactorScript)->Arg(1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "command_queue.h"
+
+/*
+ * Commands sent to the simulation of the game by a growing number of
+ * producer threads, e.g the player input, the monster behaviors or the
+ * sessions of a server, and drained in batches by a single consumer.
+ *
+ * - BM_CommandQueue uses the lock free CommandQueue of the GameLoop.
+ * - BM_MutexQueue uses a bounded std::deque behind a mutex, as a baseline.
+ *
+ * The argument is the number of producers. items_per_second is the rate of
+ * the commands through the queue. Counters, in nanoseconds: enqueue_ns is
+ * the mean time for a producer to queue a command, retries on a full queue
+ * included, and enqueue_p99_ns its 99th percentile.
+ */
+
+constexpr std::size_t COMMANDS_PER_PRODUCER = 1 << 15;
+// one push out of SAMPLE_EVERY is timed: the clock costs as much as a push
+constexpr std::size_t SAMPLE_EVERY = 16;
+
+
+// The same interface as CommandQueue, with a lock
+class MutexQueue {
+public:
+    explicit MutexQueue(const std::size_t capacity) : m_capacity(capacity) {}
+
+    bool TryPush(const GameCommand& command, std::uint64_t& ticket) {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        if(m_commands.size() == m_capacity){
+            return false;
+        }
+        m_commands.push_back(command);
+        ticket = m_pushed++;
+        return true;
+    }
+
+    std::size_t Drain(std::vector<GameCommand>& batch, const std::size_t max) {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        const std::size_t count = std::min(max, m_commands.size());
+        const auto end = m_commands.begin() + static_cast<std::ptrdiff_t>(count);
+        batch.insert(batch.end(), m_commands.begin(), end);
+        m_commands.erase(m_commands.begin(), end);
+        return count;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<GameCommand> m_commands;
+    std::size_t m_capacity;
+    std::uint64_t m_pushed{0};
+};
+
+
+/**
+ * @brief Send COMMANDS_PER_PRODUCER commands from each producer thread, and
+ *        drain them all on the calling thread
+ *
+ * @param producers the number of producer threads
+ * @param latencies receives the sampled enqueue times, in nanoseconds
+ */
+template<typename Queue>
+static void run_round(const std::size_t producers, std::vector<double>& latencies)
+{
+    Queue queue{COMMAND_QUEUE_CAPACITY};
+    std::vector<std::vector<double>> samples(producers);
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for(std::size_t p = 0; p < producers; ++p){
+        threads.emplace_back([&queue, &samples, &go, p]() {
+            samples[p].reserve(COMMANDS_PER_PRODUCER / SAMPLE_EVERY);
+            while( !go.load(std::memory_order_acquire) ){
+                std::this_thread::yield();
+            }
+            const GameCommand command{COMMAND_ATTACK, static_cast<std::uint32_t>(p), 0};
+            std::uint64_t ticket{0};
+            for(std::size_t i = 0; i < COMMANDS_PER_PRODUCER; ++i){
+                const bool timed = i % SAMPLE_EVERY == 0;
+                const auto start = timed ? std::chrono::steady_clock::now()
+                                         : std::chrono::steady_clock::time_point{};
+                while( !queue.TryPush(command, ticket) ){
+                    std::this_thread::yield();
+                }
+                if(timed){
+                    samples[p].push_back(std::chrono::duration<double, std::nano>(
+                        std::chrono::steady_clock::now() - start).count());
+                }
+            }
+        });
+    }
+    go.store(true, std::memory_order_release);
+
+    std::vector<GameCommand> batch;
+    batch.reserve(COMMAND_QUEUE_CAPACITY);
+    const std::size_t total = producers * COMMANDS_PER_PRODUCER;
+    for(std::size_t drained = 0; drained < total; ){
+        batch.clear();
+        const std::size_t count = queue.Drain(batch, COMMAND_QUEUE_CAPACITY);
+        benchmark::DoNotOptimize(batch.data());
+        drained += count;
+        if(count == 0){
+            std::this_thread::yield();
+        }
+    }
+
+    for(auto& thread : threads){
+        thread.join();
+    }
+    for(const auto& sample : samples){
+        latencies.insert(latencies.end(), sample.begin(), sample.end());
+    }
+}
+
+
+template<typename Queue>
+static void run_benchmark(benchmark::State& state)
+{
+    const auto producers = static_cast<std::size_t>(state.range(0));
+    std::vector<double> latencies;
+    for(auto _ : state)
+    {
+        run_round<Queue>(producers, latencies);
+    }
+    state.SetItemsProcessed(state.iterations() *
+                            static_cast<std::int64_t>(producers * COMMANDS_PER_PRODUCER));
+
+    if( !latencies.empty() ){
+        std::sort(latencies.begin(), latencies.end());
+        state.counters["enqueue_ns"] = std::accumulate(latencies.begin(), latencies.end(), 0.0) /
+                                       static_cast<double>(latencies.size());
+        state.counters["enqueue_p99_ns"] = latencies[latencies.size() * 99 / 100];
+    }
+}
+
+
+static void BM_CommandQueue(benchmark::State& state)
+{
+    run_benchmark<CommandQueue>(state);
+}
+
+
+static void BM_MutexQueue(benchmark::State& state)
+{
+    run_benchmark<MutexQueue>(state);
+}
+
+BENCHMARK(BM_CommandQueue)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()
+                          ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MutexQueue)->RangeMultiplier(2)->Range(1, 8)->UseRealTime()
+                        ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
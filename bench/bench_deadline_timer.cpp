@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <benchmark/benchmark.h>
+#include "deadline_timer.h"
+
+/*
+ * Accuracy of periodic wake ups, as done by the monsters attacking every
+ * ORC_ATTACK_INTERVAL: each iteration does some work, then waits for the
+ * next period. The lateness of a wake up is measured against the ideal
+ * deadline start + i * period.
+ *
+ * - BM_RelativeSleep sleeps for a period after the work, as did the monster
+ *   threads before the EventScheduler: the lateness builds up.
+ * - BM_DeadlineTimer sleeps until the absolute deadline, with the busy wait
+ *   given in microseconds as argument.
+ *
+ * Counters, in microseconds: drift is the lateness of the last wake up,
+ * i.e the error accumulated over the run, late the mean lateness, jitter
+ * its standard deviation and max_late the worst wake up.
+ */
+
+constexpr std::chrono::milliseconds PERIOD{2};
+constexpr std::chrono::microseconds WORK{200};
+
+
+// Lateness of the wake ups, in microseconds
+struct Lateness {
+    double last{0.0};
+    double sum{0.0};
+    double sum_squares{0.0};
+    double max{0.0};
+    long long count{0};
+
+    void Add(const std::chrono::steady_clock::duration lateness) {
+        last = std::chrono::duration<double, std::micro>(lateness).count();
+        sum += last;
+        sum_squares += last * last;
+        max = std::max(max, last);
+        ++count;
+    }
+
+    void Report(benchmark::State& state) const {
+        const auto n = static_cast<double>(std::max(count, 1LL));
+        const double mean = sum / n;
+        state.counters["drift_us"] = last;
+        state.counters["late_us"] = mean;
+        state.counters["jitter_us"] = std::sqrt(std::max(sum_squares / n - mean * mean, 0.0));
+        state.counters["max_late_us"] = max;
+    }
+};
+
+
+static void Work()
+{
+    const auto end = std::chrono::steady_clock::now() + WORK;
+    while(std::chrono::steady_clock::now() < end){}
+}
+
+
+static void BM_RelativeSleep(benchmark::State& state)
+{
+    Lateness lateness;
+    const auto start = std::chrono::steady_clock::now();
+    long long period{0};
+    for(auto _ : state)
+    {
+        Work();
+        std::this_thread::sleep_for(PERIOD);
+        ++period;
+        lateness.Add(std::chrono::steady_clock::now() - (start + period * PERIOD));
+    }
+    lateness.Report(state);
+}
+
+
+static void BM_DeadlineTimer(benchmark::State& state)
+{
+    DeadlineTimer timer{std::chrono::microseconds(state.range(0))};
+    Lateness lateness;
+    const auto start = std::chrono::steady_clock::now();
+    long long period{0};
+    for(auto _ : state)
+    {
+        Work();
+        ++period;
+        const auto deadline = start + period * PERIOD;
+        timer.SleepUntil(deadline);
+        lateness.Add(std::chrono::steady_clock::now() - deadline);
+    }
+    lateness.Report(state);
+}
+
+BENCHMARK(BM_RelativeSleep)->Iterations(1000)->UseRealTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DeadlineTimer)->Arg(0)->Arg(20)->Arg(100)
+    ->Iterations(1000)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
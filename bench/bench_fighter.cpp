@@ -0,0 +1,282 @@
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "combat_log.h"
+#include "fighter.h"
+
+/*
+ * Micro benchmarks of the fighter core. Each case runs on a population of
+ * fighters of a given size, with 1, 2 and 4 threads each owning its own
+ * population. Run the target bench_fighter_json to get JSON results, e.g
+ * to compare two releases with Google Benchmark's compare.py.
+ */
+
+// Fighters of the attack cases survive all the iterations
+constexpr int BATTLE_HEALTH = 1000000000;
+
+static void Populations(benchmark::internal::Benchmark* benchmark)
+{
+    for(const int population : {64, 4096, 262144}){
+        benchmark->Arg(population);
+    }
+    benchmark->ThreadRange(1, 4)->UseRealTime();
+}
+
+static std::size_t Population(const benchmark::State& state)
+{
+    return static_cast<std::size_t>(state.range(0));
+}
+
+static void Processed(benchmark::State& state)
+{
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static std::vector<Fighter> MixedFighters(const std::size_t count)
+{
+    std::vector<Fighter> fighters;
+    fighters.reserve(count);
+    for(std::size_t i = 0; i < count; ++i){
+        fighters.emplace_back( static_cast<int>(i % 4) - 1 );
+    }
+    return fighters;
+}
+
+
+/**
+ * @brief A stream buffer discarding everything written to it
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int_type overflow(const int_type character) override { return character; }
+    std::streamsize xsputn(const char*, const std::streamsize count) override {
+        return count;
+    }
+};
+
+static NullBuffer g_null_buffer;       // NOLINT
+static std::ostream g_null_stream{&g_null_buffer}; // NOLINT
+
+// output enabled: each message is formatted and written by the attacker
+static void OutputEnabled(const benchmark::State&)
+{
+    CombatLog::Instance().Start(LOG_MODE_DIRECT, LOG_OVERFLOW_DROP,
+                                &g_null_stream);
+}
+
+// output suppressed: only the binary record is queued, and dropped once the
+// ring buffer is full
+static void OutputSuppressed(const benchmark::State&)
+{
+    CombatLog::Instance().Start(LOG_MODE_ASYNC_BINARY, LOG_OVERFLOW_DROP,
+                                &g_null_stream);
+}
+
+static void RestoreOutput(const benchmark::State&)
+{
+    CombatLog::Instance().Stop();
+}
+
+
+//=============================================================================
+//
+//                    Construction, copy and move
+//
+//=============================================================================
+
+static void BM_ConstructFromInt(benchmark::State& state)
+{
+    const std::size_t count = Population(state);
+    for(auto _ : state){
+        for(std::size_t i = 0; i < count; ++i){
+            Fighter fighter{ static_cast<int>(i % 4) - 1 };
+            benchmark::DoNotOptimize(fighter);
+        }
+    }
+    Processed(state);
+}
+BENCHMARK(BM_ConstructFromInt)->Apply(Populations);
+
+static void BM_ConstructFromRole(benchmark::State& state)
+{
+    const std::size_t count = Population(state);
+    for(auto _ : state){
+        for(std::size_t i = 0; i < count; ++i){
+            Fighter fighter{ static_cast<ROLE_t>(static_cast<int>(i % 4) - 1) };
+            benchmark::DoNotOptimize(fighter);
+        }
+    }
+    Processed(state);
+}
+BENCHMARK(BM_ConstructFromRole)->Apply(Populations);
+
+static void BM_CopyConstruct(benchmark::State& state)
+{
+    const auto fighters = MixedFighters(Population(state));
+    for(auto _ : state){
+        for(const auto& fighter : fighters){
+            Fighter copy{fighter};
+            benchmark::DoNotOptimize(copy);
+        }
+    }
+    Processed(state);
+}
+BENCHMARK(BM_CopyConstruct)->Apply(Populations);
+
+static void BM_MoveConstruct(benchmark::State& state)
+{
+    auto fighters = MixedFighters(Population(state));
+    for(auto _ : state){
+        for(auto& fighter : fighters){
+            Fighter moved{std::move(fighter)};
+            benchmark::DoNotOptimize(moved);
+            fighter = std::move(moved); // restore the population
+        }
+    }
+    Processed(state);
+}
+BENCHMARK(BM_MoveConstruct)->Apply(Populations);
+
+static void BM_CopyAssign(benchmark::State& state)
+{
+    const auto fighters = MixedFighters(Population(state));
+    auto copies = MixedFighters(Population(state));
+    for(auto _ : state){
+        for(std::size_t i = 0; i < fighters.size(); ++i){
+            copies[i] = fighters[fighters.size() - 1 - i];
+        }
+        benchmark::ClobberMemory();
+    }
+    Processed(state);
+}
+BENCHMARK(BM_CopyAssign)->Apply(Populations);
+
+static void BM_MoveAssign(benchmark::State& state)
+{
+    auto fighters = MixedFighters(Population(state));
+    auto others = MixedFighters(Population(state));
+    for(auto _ : state){
+        for(std::size_t i = 0; i < fighters.size(); ++i){
+            others[i] = std::move(fighters[i]);
+        }
+        std::swap(fighters, others);
+        benchmark::ClobberMemory();
+    }
+    Processed(state);
+}
+BENCHMARK(BM_MoveAssign)->Apply(Populations);
+
+
+//=============================================================================
+//
+//                    Rules
+//
+//=============================================================================
+
+static void BM_IntToRole(benchmark::State& state)
+{
+    const std::size_t count = Population(state);
+    for(auto _ : state){
+        for(std::size_t i = 0; i < count; ++i){
+            benchmark::DoNotOptimize( Fighter::IntToRole(static_cast<int>(i % 4) - 1) );
+        }
+    }
+    Processed(state);
+}
+BENCHMARK(BM_IntToRole)->Apply(Populations);
+
+static void BM_IsEnemy(benchmark::State& state)
+{
+    const auto fighters = MixedFighters(Population(state));
+    for(auto _ : state){
+        for(std::size_t i = 0; i < fighters.size(); ++i){
+            benchmark::DoNotOptimize(
+                fighters[i].IsEnemy(fighters[fighters.size() - 1 - i]) );
+        }
+    }
+    Processed(state);
+}
+BENCHMARK(BM_IsEnemy)->Apply(Populations);
+
+static void BM_CanAttack(benchmark::State& state)
+{
+    const auto fighters = MixedFighters(Population(state));
+    for(auto _ : state){
+        for(std::size_t i = 0; i < fighters.size(); ++i){
+            benchmark::DoNotOptimize(
+                fighters[i].CanAttack(fighters[fighters.size() - 1 - i]) );
+        }
+    }
+    Processed(state);
+}
+BENCHMARK(BM_CanAttack)->Apply(Populations);
+
+
+//=============================================================================
+//
+//                    Attacks and output
+//
+//=============================================================================
+
+static void BM_HeroAttack(benchmark::State& state)
+{
+    const std::size_t count = Population(state);
+    const std::vector<Hero> heroes(count, Hero(ROLE_HERO));
+    std::vector<Monster> monsters;
+    for(std::size_t i = 0; i < count; ++i){
+        monsters.emplace_back(i % 2 == 0 ? ROLE_ORC : ROLE_DRAGON);
+        monsters.back().SetHealth(BATTLE_HEALTH);
+    }
+
+    for(auto _ : state){
+        for(std::size_t i = 0; i < count; ++i){
+            heroes[i].Attack(monsters[i]);
+        }
+    }
+    Processed(state);
+}
+BENCHMARK(BM_HeroAttack)->Name("BM_HeroAttack/output:suppressed")
+    ->Apply(Populations)->Setup(OutputSuppressed)->Teardown(RestoreOutput);
+BENCHMARK(BM_HeroAttack)->Name("BM_HeroAttack/output:enabled")
+    ->Apply(Populations)->Setup(OutputEnabled)->Teardown(RestoreOutput);
+
+static void BM_MonsterAttack(benchmark::State& state)
+{
+    const std::size_t count = Population(state);
+    std::vector<Monster> monsters;
+    std::vector<Hero> heroes(count, Hero(ROLE_HERO));
+    for(std::size_t i = 0; i < count; ++i){
+        monsters.emplace_back(i % 2 == 0 ? ROLE_ORC : ROLE_DRAGON);
+        heroes[i].SetHealth(BATTLE_HEALTH);
+    }
+
+    for(auto _ : state){
+        for(std::size_t i = 0; i < count; ++i){
+            monsters[i].Attack(heroes[i]);
+        }
+    }
+    Processed(state);
+}
+BENCHMARK(BM_MonsterAttack)->Name("BM_MonsterAttack/output:suppressed")
+    ->Apply(Populations)->Setup(OutputSuppressed)->Teardown(RestoreOutput);
+BENCHMARK(BM_MonsterAttack)->Name("BM_MonsterAttack/output:enabled")
+    ->Apply(Populations)->Setup(OutputEnabled)->Teardown(RestoreOutput);
+
+static void BM_Print(benchmark::State& state)
+{
+    const auto fighters = MixedFighters(Population(state));
+    for(auto _ : state){
+        for(const auto& fighter : fighters){
+            fighter.Print();
+        }
+    }
+    Processed(state);
+}
+BENCHMARK(BM_Print)->Apply(Populations)
+    ->Setup(OutputEnabled)->Teardown(RestoreOutput);
+
+BENCHMARK_MAIN();
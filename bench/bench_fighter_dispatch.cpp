@@ -0,0 +1,140 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "combat_log.h"
+#include "fighter.h"
+#include "static_fighter.h"
+
+// Large mixed battles: one fighter out of four is an hero, the others are
+// orcs and dragons. Each fighter attacks a random one. Fighters have enough
+// health points to survive all the iterations.
+//
+// Every arm does the same work per attack: the enemy check, the damage,
+// the rejected attacks counted in the metrics and the hits logged. No replay
+// is recorded, so that the virtual attacks only check the recorder. What is
+// left is what the static dispatch saves: the rules of the virtual fighters
+// are read from the RoleCatalog, the static ones are compile-time constants.
+constexpr int BATTLE_HEALTH = 1000000000;
+
+static std::vector<ROLE_t> MixedRoles(const std::size_t count)
+{
+    std::minstd_rand random{42};
+    std::uniform_int_distribution<int> role{0, 3};
+    std::vector<ROLE_t> roles(count);
+    for(auto& value : roles){
+        const int draw = role(random);
+        value = (draw == 0) ? ROLE_HERO : (draw == 1) ? ROLE_ORC : ROLE_DRAGON;
+    }
+    return roles;
+}
+
+static std::vector<std::size_t> RandomTargets(const std::size_t count)
+{
+    std::minstd_rand random{7};
+    std::uniform_int_distribution<std::size_t> index{0, count - 1};
+    std::vector<std::size_t> targets(count);
+    for(auto& value : targets){
+        value = index(random);
+    }
+    return targets;
+}
+
+// The attacks are logged in binary mode to a stream without buffer, so that
+// the terminal does not hide the cost of the dispatch
+static void SilentLog(const benchmark::State&)
+{
+    static std::ostream null_stream{nullptr};
+    CombatLog::Instance().Start(LOG_MODE_ASYNC_BINARY, LOG_OVERFLOW_DROP,
+                                &null_stream);
+}
+
+static void RestoreLog(const benchmark::State&)
+{
+    CombatLog::Instance().Stop();
+}
+
+
+static void BM_VirtualAttack(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto roles = MixedRoles(count);
+    const auto targets = RandomTargets(count);
+
+    std::vector<std::unique_ptr<Fighter>> fighters;
+    for(const ROLE_t role : roles){
+        if(role == ROLE_HERO){
+            fighters.push_back(std::make_unique<Hero>(role));
+        }
+        else if(role == ROLE_ORC){
+            fighters.push_back(std::make_unique<Orc>(role));
+        }
+        else{
+            fighters.push_back(std::make_unique<Dragon>(role));
+        }
+        fighters.back()->SetHealth(BATTLE_HEALTH);
+    }
+
+    for(auto _ : state){
+        for(std::size_t i = 0; i < count; ++i){
+            fighters[i]->Attack(*fighters[targets[i]]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+
+static void BM_VariantAttack(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto roles = MixedRoles(count);
+    const auto targets = RandomTargets(count);
+
+    std::vector<AnyFighter> fighters;
+    fighters.reserve(count);
+    for(const ROLE_t role : roles){
+        fighters.push_back(MakeFighter(role));
+        std::visit([](auto& self) { self.SetHealth(BATTLE_HEALTH); },
+                   fighters.back());
+    }
+
+    for(auto _ : state){
+        for(std::size_t i = 0; i < count; ++i){
+            Attack(fighters[i], fighters[targets[i]]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+
+// Homogeneous containers: heroes attacking orcs, the roles are known at
+// compile time and nothing is dispatched
+static void BM_HomogeneousAttack(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto targets = RandomTargets(count);
+    const std::vector<StaticHero> heroes(count, StaticHero{BATTLE_HEALTH});
+    std::vector<StaticOrc> orcs(count, StaticOrc{BATTLE_HEALTH});
+
+    for(auto _ : state){
+        for(std::size_t i = 0; i < count; ++i){
+            heroes[i].Attack(orcs[targets[i]]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+BENCHMARK(BM_VirtualAttack)->Arg(1 << 16)->Arg(1 << 20)
+    ->Setup(SilentLog)->Teardown(RestoreLog);
+BENCHMARK(BM_VariantAttack)->Arg(1 << 16)->Arg(1 << 20)
+    ->Setup(SilentLog)->Teardown(RestoreLog);
+BENCHMARK(BM_HomogeneousAttack)->Arg(1 << 16)->Arg(1 << 20)
+    ->Setup(SilentLog)->Teardown(RestoreLog);
+
+BENCHMARK_MAIN();
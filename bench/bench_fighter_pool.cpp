@@ -0,0 +1,143 @@
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "fighter.h"
+#include "fighter_pool.h"
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+/*
+ * Spawn and despawn cost of fighters built with plain new/delete against
+ * fighters built inside a FighterPool. Each iteration is a wave: a mixed
+ * population is spawned, half of it dies and is replaced, then the whole
+ * wave ends. Each thread uses its own pool, as concurrent sessions would.
+ *
+ * The heap_bytes_per_fighter counter is the heap footprint of a live wave,
+ * malloc bookkeeping included, measured by the single thread runs only.
+ * The rss_mb counter is the resident memory of the process at the end of
+ * the run.
+ */
+
+static void Waves(benchmark::internal::Benchmark* benchmark)
+{
+    for(const int population : {256, 65536}){
+        benchmark->Arg(population);
+    }
+    benchmark->ThreadRange(1, 4)->UseRealTime();
+}
+
+static ROLE_t WaveRole(const std::size_t index)
+{
+    switch(index % 3)
+    {
+        case 0:  return ROLE_ORC;
+        case 1:  return ROLE_DRAGON;
+        default: return ROLE_HERO;
+    }
+}
+
+static std::unique_ptr<Fighter> NewFighter(const ROLE_t role)
+{
+    switch(role)
+    {
+        case ROLE_HERO:   return std::make_unique<Hero>(role);
+        case ROLE_ORC:    return std::make_unique<Orc>(role);
+        case ROLE_DRAGON: return std::make_unique<Dragon>(role);
+        default:          return std::make_unique<Fighter>(role);
+    }
+}
+
+// Bytes currently allocated on the heap, 0 when unknown
+static double HeapBytes()
+{
+#if defined(__GLIBC__)
+    return static_cast<double>(mallinfo2().uordblks);
+#else
+    return 0.0;
+#endif
+}
+
+// Resident memory of the process in megabytes, 0 when unknown
+static double ResidentMegabytes()
+{
+    std::ifstream statm{"/proc/self/statm"};
+    double pages{0.0};
+    double resident{0.0};
+    if( !(statm >> pages >> resident) ){
+        return 0.0;
+    }
+    return resident * 4096.0 / (1024.0 * 1024.0);
+}
+
+static void Counters(benchmark::State& state, const double heap_bytes)
+{
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    if(state.thread_index() != 0){
+        return;
+    }
+    if(state.threads() == 1){
+        state.counters["heap_bytes_per_fighter"] =
+            heap_bytes / static_cast<double>(state.range(0));
+    }
+    state.counters["rss_mb"] = ResidentMegabytes();
+}
+
+
+static void BM_WaveNewDelete(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<std::unique_ptr<Fighter>> wave;
+    wave.reserve(count);
+    double heap_bytes{0.0};
+
+    for(auto _ : state)
+    {
+        const double heap_before = HeapBytes();
+        for(std::size_t i = 0; i < count; ++i){
+            wave.push_back(NewFighter(WaveRole(i)));
+        }
+        for(std::size_t i = 0; i < count; i += 2){
+            wave[i] = NewFighter(WaveRole(i + 1));
+        }
+        heap_bytes = HeapBytes() - heap_before;
+        benchmark::DoNotOptimize(wave.data());
+        wave.clear();
+    }
+    Counters(state, heap_bytes);
+}
+
+
+static void BM_WavePool(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<Fighter*> wave;
+    wave.reserve(count);
+    const double heap_before = HeapBytes();
+    FighterPool pool; // owned by the thread, grows during the first wave
+    double heap_bytes{0.0};
+
+    for(auto _ : state)
+    {
+        for(std::size_t i = 0; i < count; ++i){
+            wave.push_back(pool.Spawn(WaveRole(i)));
+        }
+        for(std::size_t i = 0; i < count; i += 2){
+            pool.Despawn(wave[i]);
+            wave[i] = pool.Spawn(WaveRole(i + 1));
+        }
+        heap_bytes = HeapBytes() - heap_before; // chunks kept from the first wave
+        benchmark::DoNotOptimize(wave.data());
+        wave.clear();
+        pool.Release();
+    }
+    Counters(state, heap_bytes);
+}
+
+BENCHMARK(BM_WaveNewDelete)->Apply(Waves);
+BENCHMARK(BM_WavePool)->Apply(Waves);
+
+BENCHMARK_MAIN();
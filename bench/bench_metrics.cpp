@@ -0,0 +1,126 @@
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "combat_log.h"
+#include "fighter.h"
+#include "metrics.h"
+
+/*
+ * Overhead of the metrics on the attack path. This file is built twice:
+ * bench_metrics counts every attack, and bench_metrics_disabled is compiled
+ * with -DGAME_METRICS_DISABLED. The difference of items_per_second of the
+ * attack cases between both programs is the cost of the metrics, to be kept
+ * under 1 %. The record cases give the raw cost of a record.
+ *
+ * The attack cases count their hits in an AttackTally, as the loops of the
+ * game do: the metrics are written once per batch of hits, not once per hit.
+ */
+
+// Fighters of the attack cases survive all the iterations
+constexpr int BATTLE_HEALTH = 1000000000;
+
+static std::vector<Monster> Monsters(const std::size_t count)
+{
+    std::vector<Monster> monsters;
+    for(std::size_t i = 0; i < count; ++i){
+        monsters.emplace_back(i % 2 == 0 ? ROLE_ORC : ROLE_DRAGON);
+        monsters.back().SetHealth(BATTLE_HEALTH);
+    }
+    return monsters;
+}
+
+/**
+ * @brief A stream buffer discarding everything written to it
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int_type overflow(const int_type character) override { return character; }
+    std::streamsize xsputn(const char*, const std::streamsize count) override {
+        return count;
+    }
+};
+
+static NullBuffer g_null_buffer;       // NOLINT
+static std::ostream g_null_stream{&g_null_buffer}; // NOLINT
+
+// the binary records of the attacks are queued, as in the game
+static void OutputSuppressed(const benchmark::State&)
+{
+    CombatLog::Instance().Start(LOG_MODE_ASYNC_BINARY, LOG_OVERFLOW_DROP,
+                                &g_null_stream);
+}
+
+static void RestoreOutput(const benchmark::State&)
+{
+    CombatLog::Instance().Stop();
+}
+
+
+static void BM_Hit(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto hero = Hero(ROLE_HERO);
+    const ROLE_t role = hero.GetRole();
+    auto monsters = Monsters(count);
+
+    for(auto _ : state){
+        AttackTally tally;
+        for(auto& monster : monsters){
+            const bool hit = hero.Hit(monster);
+            benchmark::DoNotOptimize(hit);
+            tally.Add(role, hit);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(METRICS_ENABLED ? "metrics:on" : "metrics:off");
+}
+
+static void BM_HeroAttack(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto hero = Hero(ROLE_HERO);
+    const ROLE_t role = hero.GetRole();
+    auto monsters = Monsters(count);
+
+    for(auto _ : state){
+        AttackTally tally;
+        for(auto& monster : monsters){
+            const bool hit = hero.CanAttack(monster);
+            hero.Attack(monster);
+            tally.Add(role, hit);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(METRICS_ENABLED ? "metrics:on" : "metrics:off");
+}
+
+static void BM_Count(benchmark::State& state)
+{
+    for(auto _ : state){
+        Metrics::Count(COUNTER_ATTACKS, ROLE_ORC);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_Record(benchmark::State& state)
+{
+    std::uint64_t nanoseconds{0};
+    for(auto _ : state){
+        Metrics::Record(HISTOGRAM_TICK_LATENESS, nanoseconds);
+        nanoseconds = (nanoseconds + 7919) & 0xFFFFF;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Hit)->Arg(4096)->ThreadRange(1, 4)->UseRealTime()
+    ->Repetitions(5)->ReportAggregatesOnly(true);
+BENCHMARK(BM_HeroAttack)->Arg(4096)->ThreadRange(1, 4)->UseRealTime()
+    ->Repetitions(5)->ReportAggregatesOnly(true)
+    ->Setup(OutputSuppressed)->Teardown(RestoreOutput);
+BENCHMARK(BM_Count)->ThreadRange(1, 4);
+BENCHMARK(BM_Record)->ThreadRange(1, 4);
+
+BENCHMARK_MAIN();
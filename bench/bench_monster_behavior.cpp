@@ -0,0 +1,119 @@
+#include <cstddef>
+#include <memory>
+#include <semaphore>
+#include <thread>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <pthread.h>
+#include "alloc_counter.h"
+#include "fighter.h"
+#include "monster_behavior.h"
+
+/*
+ * Cost of a monster waiting for its next attack: a coroutine suspended in a
+ * BehaviorExecutor, compared to a thread per monster as done before the
+ * EventScheduler.
+ *
+ * - BM_MonsterBehaviors runs the battle of a horde of coroutines against a
+ *   hero: items are attacks, i.e resumptions of a behavior. The bytes
+ *   allocated per monster are counted by alloc_counter.cpp.
+ * - BM_ThreadHandoff passes the turn to attack around a ring of threads, one
+ *   per monster, with semaphores: items are context switches. Each thread
+ *   reserves the default stack size of the process.
+ */
+
+// Health of the hero: a few cycles of attacks of the whole horde
+static int HeroHealth(const std::size_t monsters)
+{
+    return static_cast<int>(monsters) * 20;
+}
+
+
+static void BM_MonsterBehaviors(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<Monster> horde;
+    for(std::size_t i = 0; i < count; ++i){
+        horde.emplace_back(i % 2 == 0 ? ROLE_ORC : ROLE_DRAGON);
+    }
+    std::vector<const Monster*> monsters;
+    for(const auto& monster : horde){
+        monsters.push_back(&monster);
+    }
+
+    std::size_t attacks{0};
+    std::size_t frame_bytes{0};
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto hero = Hero(ROLE_HERO);
+        hero.SetHealth(HeroHealth(count));
+        BehaviorExecutor executor;
+        std::size_t round{0};
+        const std::size_t before = AllocatedBytes();
+        for(const Monster* monster : monsters){
+            executor.Spawn( MonsterBehavior(executor, *monster, hero, round, false) );
+        }
+        frame_bytes = AllocatedBytes() - before;
+        state.ResumeTiming();
+
+        executor.Run();
+        attacks += round;
+    }
+
+    state.SetItemsProcessed(static_cast<long long>(attacks));
+    // the coroutine frames and the slots of the executor
+    state.counters["bytes_per_monster"] =
+        static_cast<double>(frame_bytes) / static_cast<double>(count);
+}
+
+
+static void BM_ThreadHandoff(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    constexpr long long ROUNDS = 100;
+
+    std::size_t stack_size{0};
+    pthread_attr_t attributes;
+    pthread_attr_init(&attributes);
+    pthread_attr_getstacksize(&attributes, &stack_size);
+    pthread_attr_destroy(&attributes);
+
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto hero = Hero(ROLE_HERO);
+        hero.SetHealth(HeroHealth(count));
+        auto orc = Orc(ROLE_ORC);
+        std::vector<std::unique_ptr<std::binary_semaphore>> turns;
+        for(std::size_t i = 0; i < count; ++i){
+            turns.push_back(std::make_unique<std::binary_semaphore>(0));
+        }
+        std::vector<std::thread> threads;
+        for(std::size_t i = 0; i < count; ++i){
+            threads.emplace_back([&, i]() {
+                for(long long round = 0; round < ROUNDS; ++round){
+                    turns[i]->acquire();
+                    benchmark::DoNotOptimize(orc.Hit(hero));
+                    turns[(i + 1) % count]->release();
+                }
+            });
+        }
+        state.ResumeTiming();
+
+        turns[0]->release();
+        for(auto& thread : threads){
+            thread.join();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<long long>(count) * ROUNDS);
+    state.counters["bytes_per_monster"] = static_cast<double>(stack_size);
+}
+
+BENCHMARK(BM_MonsterBehaviors)->Arg(100)->Arg(10000)->Unit(benchmark::kMillisecond);
+// the switches happen on the monster threads: the CPU time of the main thread
+// does not count them
+BENCHMARK(BM_ThreadHandoff)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
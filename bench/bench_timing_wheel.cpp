@@ -0,0 +1,88 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "timing_wheel.h"
+
+// Attack timers of monsters: random cooldowns up to two seconds, each
+// expired timer is scheduled again, as a monster attacks again and again
+constexpr long long MAX_COOLDOWN = 2000;
+
+static std::vector<long long> Cooldowns(const std::size_t count)
+{
+    std::minstd_rand random{42};
+    std::uniform_int_distribution<long long> cooldown{1, MAX_COOLDOWN};
+    std::vector<long long> cooldowns(count);
+    for(auto& value : cooldowns){
+        value = cooldown(random);
+    }
+    return cooldowns;
+}
+
+
+static void BM_BinaryHeap(benchmark::State& state)
+{
+    using Timer = std::pair<long long, std::uint32_t>;
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto cooldowns = Cooldowns(count);
+
+    for(auto _ : state)
+    {
+        std::vector<Timer> storage;
+        storage.reserve(count);
+        std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> heap{
+            std::greater<Timer>{}, std::move(storage)
+        };
+        for(std::uint32_t i = 0; i < count; ++i){
+            heap.emplace(cooldowns[i], i);
+        }
+        // every timer expires twice
+        for(std::size_t expired = 0; expired < 2 * count; ++expired)
+        {
+            const Timer timer = heap.top();
+            heap.pop();
+            heap.emplace(timer.first + cooldowns[timer.second], timer.second);
+        }
+        benchmark::DoNotOptimize(heap.top());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(3 * count));
+}
+
+
+static void BM_TimingWheel(benchmark::State& state)
+{
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto cooldowns = Cooldowns(count);
+
+    for(auto _ : state)
+    {
+        TimingWheel wheel;
+        wheel.Reserve(count);
+        for(std::uint32_t i = 0; i < count; ++i){
+            wheel.Insert(cooldowns[i], i);
+        }
+        std::size_t expired{0};
+        while(expired < 2 * count)
+        {
+            expired += wheel.Advance(wheel.Now() + 1, [&](const long long tick,
+                                     const std::vector<std::uint32_t>& ready) {
+                for(const std::uint32_t index : ready){
+                    wheel.Insert(tick + cooldowns[index], index);
+                }
+            });
+        }
+        benchmark::DoNotOptimize(wheel.Size());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(3 * count));
+}
+
+BENCHMARK(BM_BinaryHeap)->Arg(1000000)->Arg(10000000)->Arg(50000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TimingWheel)->Arg(1000000)->Arg(10000000)->Arg(50000000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
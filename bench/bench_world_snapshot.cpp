@@ -0,0 +1,131 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "fighter.h"
+#include "fighter_batch.h"
+#include "world_snapshot.h"
+
+/*
+ * Saving and resuming the world of a horde battle, as done by
+ * battle_simulator --checkpoint and --restore: a hero, monsters and the
+ * pending attack of each monster, or no pending attack at all.
+ *
+ * - BM_WriteSnapshot writes the world with WriteSnapshot().
+ * - BM_OpenSnapshot maps it with MappedSnapshot::Open(), with the checksum
+ *   check (verify:1) or without it (verify:0).
+ * - BM_ReadSnapshot restores a WorldState with ReadSnapshot().
+ *
+ * The arguments are the number of fighters and whether the monsters have a
+ * pending attack, which makes the file 4 times larger. bytes_per_second is
+ * the rate of the snapshot file. The file lives in the temporary directory,
+ * in the page cache after the first iteration: the disk is not measured.
+ */
+
+constexpr std::int64_t FIGHTERS_SMALL = 1 << 20;
+constexpr std::int64_t FIGHTERS_LARGE = 10000000;
+
+
+// A horde battle in progress, and the file it is saved to
+struct SavedWorld {
+    WorldState world;
+    std::string path;
+
+    SavedWorld(const std::size_t fighters, const bool timers)
+    : path((std::filesystem::temp_directory_path() /
+            ("bench_world_snapshot_" + std::to_string(fighters) + ".snap")).string())
+    {
+        world.clock = 4500;
+        world.steps = fighters;
+        world.fighters.Reserve(fighters);
+        world.fighters.Add(ROLE_HERO);
+        world.timers.reserve(timers ? fighters : 0);
+        for(std::size_t i = 1; i < fighters; ++i){
+            world.fighters.Add(i % 2 == 0 ? ROLE_DRAGON : ROLE_ORC);
+            if(timers){
+                world.timers.push_back(SnapshotTimer{
+                    static_cast<std::int64_t>(6000 + i % 2 * 500), i, i});
+            }
+        }
+    }
+
+    ~SavedWorld() {
+        std::remove(path.c_str());
+    }
+
+    SavedWorld(const SavedWorld&) = delete;
+    SavedWorld& operator=(const SavedWorld&) = delete;
+
+    std::int64_t FileSize() const {
+        return static_cast<std::int64_t>(std::filesystem::file_size(path));
+    }
+};
+
+
+static void BM_WriteSnapshot(benchmark::State& state)
+{
+    const SavedWorld saved(static_cast<std::size_t>(state.range(0)), state.range(1) != 0);
+    for(auto _ : state)
+    {
+        if(WriteSnapshot(saved.world, saved.path.c_str()) != SNAPSHOT_OK){
+            state.SkipWithError("unable to write the snapshot");
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * saved.FileSize());
+}
+
+
+static void BM_OpenSnapshot(benchmark::State& state)
+{
+    const SavedWorld saved(static_cast<std::size_t>(state.range(0)), state.range(1) != 0);
+    const bool verify = state.range(2) != 0;
+    if(WriteSnapshot(saved.world, saved.path.c_str()) != SNAPSHOT_OK){
+        state.SkipWithError("unable to write the snapshot");
+        return;
+    }
+    for(auto _ : state)
+    {
+        MappedSnapshot snapshot;
+        if(snapshot.Open(saved.path.c_str(), verify) != SNAPSHOT_OK){
+            state.SkipWithError("unable to open the snapshot");
+            break;
+        }
+        benchmark::DoNotOptimize(snapshot.Health());
+    }
+    state.SetBytesProcessed(state.iterations() * saved.FileSize());
+}
+
+
+static void BM_ReadSnapshot(benchmark::State& state)
+{
+    const SavedWorld saved(static_cast<std::size_t>(state.range(0)), state.range(1) != 0);
+    if(WriteSnapshot(saved.world, saved.path.c_str()) != SNAPSHOT_OK){
+        state.SkipWithError("unable to write the snapshot");
+        return;
+    }
+    for(auto _ : state)
+    {
+        WorldState world;
+        if(ReadSnapshot(saved.path.c_str(), world) != SNAPSHOT_OK){
+            state.SkipWithError("unable to read the snapshot");
+            break;
+        }
+        benchmark::DoNotOptimize(world.fighters.Health());
+    }
+    state.SetBytesProcessed(state.iterations() * saved.FileSize());
+}
+
+BENCHMARK(BM_WriteSnapshot)->ArgNames({"fighters", "timers"})
+                           ->ArgsProduct({{FIGHTERS_SMALL, FIGHTERS_LARGE}, {0, 1}})
+                           ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_OpenSnapshot)->ArgNames({"fighters", "timers", "verify"})
+                          ->ArgsProduct({{FIGHTERS_SMALL, FIGHTERS_LARGE}, {0, 1}, {0, 1}})
+                          ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReadSnapshot)->ArgNames({"fighters", "timers"})
+                          ->ArgsProduct({{FIGHTERS_SMALL, FIGHTERS_LARGE}, {0, 1}})
+                          ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,292 @@
+#ifndef ALIVE_INDEX_H
+#define ALIVE_INDEX_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "fighter.h"
+
+/**
+ * @brief The sides of a battle: the fighters of a faction are the enemies
+ *        of the fighters of the other one
+ */
+using FACTION_t = enum FACTION {
+    FACTION_NONE = -1,
+    FACTION_HEROES,
+    FACTION_MONSTERS,
+};
+constexpr std::size_t FACTIONS = 2;
+
+// Slot returned by AliveIndex::Find() when no fighter is alive
+constexpr std::size_t NO_FIGHTER = ~std::size_t{0};
+
+
+/**
+ * @brief RoleFaction
+ *
+ * @param role the role of a fighter
+ * @return The faction of the role, FACTION_NONE for an undefined role. The
+ *         roles added by a RoleCatalog are monsters: RoleCatalog::Load()
+ *         rejects the catalogs with other enemies.
+ */
+ATTRIBUTE_NO_DISCARD constexpr FACTION_t RoleFaction(const ROLE_t role) noexcept
+{
+    switch(role)
+    {
+        case ROLE_UNDEFINED: return FACTION_NONE;
+        case ROLE_HERO:      return FACTION_HEROES;
+        default:             return FACTION_MONSTERS;
+    }
+}
+
+/**
+ * @brief EnemyFaction
+ *
+ * @param faction a faction
+ * @return The faction fighting against it, FACTION_NONE for FACTION_NONE
+ */
+ATTRIBUTE_NO_DISCARD constexpr FACTION_t EnemyFaction(const FACTION_t faction) noexcept
+{
+    switch(faction)
+    {
+        case FACTION_HEROES:   return FACTION_MONSTERS;
+        case FACTION_MONSTERS: return FACTION_HEROES;
+        default:               return FACTION_NONE;
+    }
+}
+
+static_assert(Fighter::RolesAreEnemies(ROLE_HERO, ROLE_DRAGON) &&
+              EnemyFaction(RoleFaction(ROLE_HERO)) == RoleFaction(ROLE_DRAGON) &&
+              !Fighter::RolesAreEnemies(ROLE_ORC, ROLE_DRAGON) &&
+              RoleFaction(ROLE_ORC) == RoleFaction(ROLE_DRAGON),
+              "the factions follow Fighter::RolesAreEnemies()");
+
+
+/**
+ * @brief Class AliveIndex
+ *
+ * The living fighters of a battle, by faction. Each faction keeps a bitset
+ * of its living fighters, a counter and a dense list of their slots with
+ * swap-remove: "any enemy left ?" and the size of a faction are O(1), a
+ * target is picked in O(1) from the dense list, and the lowest living slot
+ * is found by scanning 64 fighters per word of the bitset.
+ *
+ * A registered fighter leaves the index by itself when it is killed by an
+ * attack, or reset: Fighter::Reset() calls Remove(). Changes through
+ * SetHealth() or SetRole() are not tracked, they need a call to Update().
+ * A destroyed fighter, e.g despawned from a FighterPool, is unregistered by
+ * its destructor: its slot stays empty.
+ *
+ * The fighters are registered with Add() before the battle: Add() must not
+ * run concurrently with anything else. During the battle, removals and
+ * queries may come from any thread, behind a lock, unless the index has a
+ * single writer: see SetSingleWriter().
+ */
+class AliveIndex {
+public:
+    /**
+     * @brief Default Constructor
+     *
+     * A constructor for creating an empty index.
+     */
+    explicit AliveIndex() noexcept = default;
+
+    /**
+     * @brief The destructor
+     *
+     * Unregister the fighters
+     */
+    ~AliveIndex();
+
+    AliveIndex(const AliveIndex&) = delete;
+    AliveIndex& operator=(const AliveIndex&) = delete;
+
+    /**
+     * @brief Add
+     *
+     * Register a fighter, counted in its faction if it is alive. A fighter
+     * is registered to one index at a time.
+     *
+     * @param fighter the fighter to be registered
+     * @return The slot of the fighter inside the index
+     */
+    std::size_t Add(Fighter& fighter);
+
+    /**
+     * @brief Remove
+     *
+     * Take a fighter out of its faction, e.g when it dies. Removing a
+     * fighter already out of its faction has no effect.
+     *
+     * @param slot the slot of the fighter
+     */
+    void Remove(std::size_t slot) noexcept;
+
+    /**
+     * @brief Unregister
+     *
+     * Take a fighter out of its faction and forget it: At() returns nullptr
+     * for its slot. Called by the destructor of the fighter.
+     *
+     * @param slot the slot of the fighter
+     */
+    void Unregister(std::size_t slot) noexcept;
+
+    /**
+     * @brief Update
+     *
+     * Move a fighter to the faction matching its role and health points,
+     * after SetHealth() or SetRole()
+     *
+     * @param slot the slot of the fighter
+     */
+    void Update(std::size_t slot) noexcept;
+
+    /**
+     * @brief Clear
+     *
+     * Unregister all fighters
+     */
+    void Clear() noexcept;
+
+    /**
+     * @brief SetSingleWriter
+     *
+     * Drop the lock of Remove(), Unregister(), Update() and Target() when
+     * a single thread attacks and resets the fighters, e.g the simulation
+     * thread of a GameLoop. These calls must then come from that thread;
+     * Count(), AnyAlive(), IsOver(), IsAlive(), PopCount() and Find() may
+     * still come from any thread. Like Add(), not during the battle.
+     *
+     * @param single_writer whether the index has a single writer
+     */
+    inline void SetSingleWriter(const bool single_writer) noexcept {
+        m_single_writer = single_writer;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return true if the index has a single writer, see SetSingleWriter()
+     */
+    ATTRIBUTE_NO_DISCARD inline bool SingleWriter() const noexcept {
+        return m_single_writer;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of registered fighters, dead or alive
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Size() const noexcept {
+        return m_fighters.size();
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @param slot the slot of a fighter
+     * @return The registered fighter, or nullptr if it was destroyed
+     */
+    ATTRIBUTE_NO_DISCARD inline Fighter* At(std::size_t slot) const noexcept {
+        return m_fighters[slot];
+    }
+
+    /**
+     * @brief IsAlive
+     *
+     * @param slot the slot of a fighter
+     * @return true if the fighter is counted in a faction, or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD bool IsAlive(std::size_t slot) const noexcept;
+
+    /**
+     * @brief Count
+     *
+     * @param faction a faction
+     * @return The number of living fighters of the faction
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Count(FACTION_t faction) const noexcept {
+        return faction == FACTION_NONE
+            ? 0U : m_factions[static_cast<std::size_t>(faction)].count.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief AnyAlive
+     *
+     * @param faction a faction
+     * @return true if a fighter of the faction is alive, or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD inline bool AnyAlive(FACTION_t faction) const noexcept {
+        return Count(faction) > 0;
+    }
+
+    /**
+     * @brief IsOver
+     *
+     * @return true if a faction has no living fighter left, or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD inline bool IsOver() const noexcept {
+        return !AnyAlive(FACTION_HEROES) || !AnyAlive(FACTION_MONSTERS);
+    }
+
+    /**
+     * @brief PopCount
+     *
+     * Count the living fighters of a faction from its bitset, 64 fighters
+     * per word. Count() returns the same number in O(1).
+     *
+     * @param faction a faction
+     * @return The number of bits set in the bitset of the faction
+     */
+    ATTRIBUTE_NO_DISCARD std::size_t PopCount(FACTION_t faction) const noexcept;
+
+    /**
+     * @brief Find
+     *
+     * @param faction a faction
+     * @param from the first slot to look at
+     * @return The lowest slot of a living fighter of the faction at or
+     *         after from, or NO_FIGHTER if there is none
+     */
+    ATTRIBUTE_NO_DISCARD std::size_t Find(FACTION_t faction,
+                                          std::size_t from = 0) const noexcept;
+
+    /**
+     * @brief Target
+     *
+     * Pick a living enemy of a fighter in O(1): the choice-th living
+     * fighter of the enemy faction, modulo their number. The order of the
+     * living fighters changes as they die.
+     *
+     * @param attacker the attacking fighter
+     * @param choice the index of the target, e.g a random number
+     * @return A living enemy, or nullptr if there is none
+     */
+    ATTRIBUTE_NO_DISCARD Fighter* Target(const Fighter& attacker,
+                                         std::size_t choice = 0) const noexcept;
+
+private:
+    struct Faction {
+        std::vector<std::uint64_t> alive;  // bitset by slot
+        std::vector<std::uint32_t> dense;  // living slots, in no order
+        std::atomic<std::size_t> count{0};
+    };
+
+    std::unique_lock<std::mutex> Lock() const noexcept;
+    void Insert(std::size_t slot, FACTION_t faction) noexcept;
+    void Erase(std::size_t slot) noexcept;
+
+    // The state of the fighters, by slot
+    std::vector<Fighter*> m_fighters;      // nullptr once unregistered
+    std::vector<FACTION_t> m_member;       // faction counting the fighter
+    std::vector<std::uint32_t> m_position; // inside the dense list
+    std::array<Faction, FACTIONS> m_factions;
+    mutable std::mutex m_mutex;            // serializes the updates
+    bool m_single_writer{false};           // the updates are not locked
+};
+
+#endif // ALIVE_INDEX_H
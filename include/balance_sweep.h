@@ -0,0 +1,104 @@
+#ifndef BALANCE_SWEEP_H
+#define BALANCE_SWEEP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include "simulation.h"
+
+
+/**
+ * @brief Values taken by a balance parameter: first, first + step, ...
+ *        up to last
+ */
+struct SweepRange {
+    int first{0};
+    int last{0};
+    int step{1};
+
+    /**
+     * @brief Count
+     *
+     * @return The number of values of the range, 0 if it is empty
+     */
+    ATTRIBUTE_NO_DISCARD std::size_t Count() const noexcept;
+};
+
+
+/**
+ * @brief Ranges of all balance parameters of a sweep
+ *
+ * A single value range, e.g {40, 40}, keeps a parameter fixed. The
+ * defaults are the values of the game.
+ */
+struct SweepRanges {
+    SweepRange hero_health{HEALTH_HERO, HEALTH_HERO};
+    SweepRange orc_health{HEALTH_ORC, HEALTH_ORC};
+    SweepRange dragon_health{HEALTH_DRAGON, HEALTH_DRAGON};
+    SweepRange hero_damage{Fighter::RoleDamage(ROLE_HERO), Fighter::RoleDamage(ROLE_HERO)};
+    SweepRange orc_damage{Fighter::RoleDamage(ROLE_ORC), Fighter::RoleDamage(ROLE_ORC)};
+    SweepRange dragon_damage{Fighter::RoleDamage(ROLE_DRAGON),
+                             Fighter::RoleDamage(ROLE_DRAGON)};
+    SweepRange hero_interval{1000, 1000};
+    SweepRange orc_interval{ORC_ATTACK_INTERVAL, ORC_ATTACK_INTERVAL};
+    SweepRange dragon_interval{DRAGON_ATTACK_INTERVAL, DRAGON_ATTACK_INTERVAL};
+};
+
+
+/**
+ * @brief SweepSize
+ *
+ * @param ranges the ranges of the sweep
+ * @return The number of configurations, i.e of combinations of values
+ */
+std::size_t SweepSize(const SweepRanges& ranges) noexcept;
+
+/**
+ * @brief SweepEnds
+ *
+ * Check that every battle of a sweep ends: the attack intervals and the
+ * damages must be positive. With a damage of 0 nobody dies, and a negative
+ * damage heals, so that the simulation would never stop.
+ *
+ * @param ranges the ranges of the sweep
+ * @return true if all values of the damage and interval ranges are positive
+ */
+ATTRIBUTE_NO_DISCARD bool SweepEnds(const SweepRanges& ranges) noexcept;
+
+/**
+ * @brief SweepConfig
+ *
+ * Build a configuration of a sweep. The hero health varies the slowest and
+ * the dragon interval the fastest.
+ *
+ * @param base the configuration providing the policy, the jitter and the
+ *        script
+ * @param ranges the ranges of the sweep
+ * @param index the index of the configuration, below SweepSize()
+ * @return The configuration
+ */
+BattleConfig SweepConfig(const BattleConfig& base, const SweepRanges& ranges,
+                         std::size_t index);
+
+/**
+ * @brief RunSweep
+ *
+ * Simulate a number of battles for every configuration of a sweep. The
+ * configurations are shared by the OpenMP threads; each thread aggregates
+ * the battles it runs, and the aggregates are combined by a reduction.
+ * One CSV line per configuration is written, in the order of the
+ * configurations, while the sweep goes on.
+ *
+ * @param base the configuration providing the policy, the jitter and the
+ *        script
+ * @param ranges the ranges of the sweep
+ * @param battles the number of battles per configuration
+ * @param seed the seed of the first battle of each configuration
+ * @param csv the stream receiving the results
+ * @return The aggregated outcome of all battles of the sweep
+ */
+BattleStatistics RunSweep(const BattleConfig& base, const SweepRanges& ranges,
+                          std::size_t battles, std::uint32_t seed,
+                          std::ostream& csv);
+
+#endif // BALANCE_SWEEP_H
@@ -0,0 +1,112 @@
+#ifndef BATTLE_SOLVER_H
+#define BATTLE_SOLVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include "fighter.h"
+#include "simulation.h"
+
+
+/**
+ * @brief Class BattleSolver
+ *
+ * Exact outcome of Hero vs Orc and Dragon battles, without any simulated
+ * clock. Without jitter a battle is a pure function of its state: the
+ * health of each fighter, the time left before the next attack of each
+ * fighter (the cooldown phase) and, for a scripted hero, the next command.
+ * The outcome of a state is the outcome of the state following its next
+ * event, plus the effect of that event.
+ *
+ * Every state visited by a query is kept in a cache, together with the
+ * outcome of the battle from that state on. The cache outlives the
+ * queries: a later query reaching a known state, e.g the same battle with
+ * another start health, stops there. Monster health is stored as the
+ * number of hero hits it can take, so that battles differing only by
+ * health points that do not change the number of hits share their states.
+ *
+ * The rules and the order of the events are those of SimulateBattle().
+ * Damages and attack intervals must be positive; the jitter of the hero is
+ * ignored.
+ */
+class BattleSolver {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param config the rules of the battles: policy, script, attack
+     *        intervals and damages, as well as the default start health
+     */
+    explicit BattleSolver(const BattleConfig& config);
+
+    /**
+     * @brief Solve
+     *
+     * @return The outcome of the battle with the start health of the
+     *         configuration
+     */
+    BattleResult Solve();
+
+    /**
+     * @brief Solve
+     *
+     * @param hero_health the start health of the hero
+     * @param orc_health the start health of the orc
+     * @param dragon_health the start health of the dragon
+     * @return The outcome of the battle, as SimulateBattle() would give it
+     */
+    BattleResult Solve(int hero_health, int orc_health, int dragon_health);
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of states in the cache
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t CacheSize() const noexcept {
+        return m_cache.size();
+    }
+
+    /**
+     * @brief ClearCache
+     *
+     * Forget all known states
+     */
+    void ClearCache() noexcept;
+
+private:
+    // Cooldown of a fighter which does not attack any more
+    static constexpr int NO_ATTACK = -1;
+
+    struct State {
+        int hero;          // health of the hero
+        int orc;           // hero hits the orc can still take
+        int dragon;        // hero hits the dragon can still take
+        int hero_cooldown; // time until the next attack of each fighter
+        int orc_cooldown;
+        int dragon_cooldown;
+        std::uint32_t command; // next command of a scripted hero
+
+        bool operator==(const State& other) const noexcept;
+    };
+
+    struct StateHash {
+        std::size_t operator()(const State& state) const noexcept;
+    };
+
+    // What happens between a state and the next one
+    struct Transition {
+        int elapsed{0};
+        bool hero_hit{false};
+        bool monster_hit{false};
+        bool over{false};
+        bool hero_wins{false};
+    };
+
+    int HitsToKill(int health) const noexcept;
+    Transition Advance(State& state) const noexcept;
+
+    BattleConfig m_config;
+    std::unordered_map<State, BattleResult, StateHash> m_cache;
+};
+
+#endif // BATTLE_SOLVER_H
@@ -0,0 +1,59 @@
+#ifndef BYTE_ORDER_H
+#define BYTE_ORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/*
+ * Little endian encoding of the integers of the binary file formats,
+ * whatever the byte order of the host.
+ */
+
+/**
+ * @brief LittleEndianHost
+ *
+ * @return true if the host stores integers in little endian order
+ */
+inline bool LittleEndianHost() noexcept
+{
+    const std::uint16_t probe{1};
+    unsigned char first{0};
+    std::memcpy(&first, &probe, 1);
+    return first == 1;
+}
+
+/**
+ * @brief StoreLittle
+ *
+ * @param out the bytes receiving the value
+ * @param value the value to be stored
+ * @param bytes the number of bytes of the stored value, at most 8
+ */
+inline void StoreLittle(unsigned char* out, std::uint64_t value,
+                        const std::size_t bytes) noexcept
+{
+    for(std::size_t i = 0; i < bytes; ++i){
+        out[i] = static_cast<unsigned char>(value & 0xFFU);
+        value >>= 8U;
+    }
+}
+
+/**
+ * @brief LoadLittle
+ *
+ * @param in the bytes of the stored value
+ * @param bytes the number of bytes of the stored value, at most 8
+ * @return The value
+ */
+inline std::uint64_t LoadLittle(const unsigned char* in,
+                                const std::size_t bytes) noexcept
+{
+    std::uint64_t value{0};
+    for(std::size_t i = bytes; i-- > 0; ){
+        value = (value << 8U) | in[i];
+    }
+    return value;
+}
+
+#endif // BYTE_ORDER_H
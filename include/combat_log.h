@@ -0,0 +1,219 @@
+#ifndef COMBAT_LOG_H
+#define COMBAT_LOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fighter.h"
+
+/**
+ * @brief Where and how the combat messages are written
+ */
+using LOG_MODE_t = enum LOG_MODE {
+    LOG_MODE_DIRECT,       // formatted and written by the calling thread
+    LOG_MODE_ASYNC_TEXT,   // formatted and written in batches by a flusher
+    LOG_MODE_ASYNC_BINARY, // written as raw CombatRecord in batches
+};
+
+/**
+ * @brief What a thread does when its ring buffer is full
+ */
+using LOG_OVERFLOW_t = enum LOG_OVERFLOW {
+    LOG_OVERFLOW_DROP,  // discard the message and count it
+    LOG_OVERFLOW_BLOCK, // wait until the flusher makes some room
+};
+
+/**
+ * @brief Kind of a combat message
+ */
+using LOG_EVENT_t = enum LOG_EVENT : std::int8_t {
+    LOG_EVENT_ATTACK,  // "Orc hits Hero."
+    LOG_EVENT_HIT,     // "Orc hits Hero. Hero health is 39"
+    LOG_EVENT_FIGHTER, // the information printed by Fighter::Print()
+};
+
+
+/**
+ * @brief A combat message, as stored in the ring buffers
+ *
+ * Only the raw values are stored: the text is built by the flusher. This is
+ * also the record format of LOG_MODE_ASYNC_BINARY.
+ */
+struct CombatRecord {
+    std::uint64_t time;      // steady clock in nanoseconds: the order of the messages
+    std::int32_t health;     // health of the target, or of the fighter
+    LOG_EVENT_t event;
+    std::int8_t attacker;    // ROLE_t of the attacker, or of the fighter
+    std::int8_t target;      // ROLE_t of the target
+    std::int8_t unused;
+};
+
+
+/**
+ * @brief Class CombatLog
+ *
+ * The output of the attacks and of Fighter::Print(). By default each
+ * message is written directly to the output stream. Once Start() is called,
+ * each thread appends its messages to its own lock free ring buffer, and a
+ * background thread formats them and writes them in large batches, so that
+ * an attack never waits for the terminal.
+ *
+ * Each message is stamped with the steady clock by its thread, without
+ * any shared counter, and the flusher merges the messages of a batch by
+ * time. A message may still appear after a later one written in the
+ * previous batch.
+ */
+class CombatLog {
+public:
+    /**
+     * @brief Instance
+     *
+     * The log is never destroyed, so that it stays usable by all threads
+     * until the program ends.
+     *
+     * @return The log shared by the whole program
+     */
+    static CombatLog& Instance();
+
+    CombatLog(const CombatLog&) = delete;
+    CombatLog& operator=(const CombatLog&) = delete;
+
+    /**
+     * @brief Start
+     *
+     * Select the output mode. An asynchronous mode starts the flusher thread.
+     *
+     * @param mode the output mode
+     * @param overflow the policy applied when a ring buffer is full
+     * @param output the stream to write to, std::cout if null
+     */
+    void Start(LOG_MODE_t mode,
+               LOG_OVERFLOW_t overflow = LOG_OVERFLOW_DROP,
+               std::ostream* output = nullptr);
+
+    /**
+     * @brief Stop
+     *
+     * Write all pending messages, stop the flusher and go back to the
+     * direct mode on std::cout. The fighters should not be attacking anymore.
+     */
+    void Stop();
+
+    /**
+     * @brief Flush
+     *
+     * Wait until all messages logged so far are written
+     */
+    void Flush();
+
+    /**
+     * @brief LogAttack
+     *
+     * Log the message of Fighter::Attack()
+     *
+     * @param attacker the role of the attacking fighter
+     * @param target the role of the attacked fighter
+     */
+    void LogAttack(ROLE_t attacker, ROLE_t target) noexcept;
+
+    /**
+     * @brief LogHit
+     *
+     * Log the message of Hero::Attack() and Monster::Attack()
+     *
+     * @param attacker the role of the attacking fighter
+     * @param target the role of the attacked fighter
+     * @param health the health of the target after the hit
+     */
+    void LogHit(ROLE_t attacker, ROLE_t target, int health) noexcept;
+
+    /**
+     * @brief LogFighter
+     *
+     * Log the message of Fighter::Print()
+     *
+     * @param role the role of the fighter
+     * @param health the health of the fighter
+     */
+    void LogFighter(ROLE_t role, int health) noexcept;
+
+    /**
+     * @brief A getter
+     *
+     * @return The output mode
+     */
+    ATTRIBUTE_NO_DISCARD inline LOG_MODE_t Mode() const noexcept {
+        return m_mode.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of messages discarded because of full ring buffers
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Dropped() const noexcept {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief FormatRecord
+     *
+     * Append the text of a combat message to a string
+     *
+     * @param record the message
+     * @param text the string to append to
+     */
+    static void FormatRecord(const CombatRecord& record, std::string& text);
+
+    /**
+     * @brief DecodeRecords
+     *
+     * Convert the output of LOG_MODE_ASYNC_BINARY into text
+     *
+     * @param input the binary records
+     * @param output the stream receiving the text
+     * @return The number of decoded records
+     */
+    static std::size_t DecodeRecords(std::istream& input, std::ostream& output);
+
+private:
+    class Ring;
+
+    CombatLog() = default;
+    ~CombatLog() = default;
+
+    void Log(LOG_EVENT_t event, ROLE_t attacker, ROLE_t target,
+             int health) noexcept;
+    Ring& LocalRing();
+    void RunFlusher();
+    std::size_t Drain();
+
+    std::atomic<LOG_MODE_t> m_mode{LOG_MODE_DIRECT};
+    std::atomic<LOG_OVERFLOW_t> m_overflow{LOG_OVERFLOW_DROP};
+    std::atomic<std::ostream*> m_output{nullptr};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_dropped{0};
+
+    std::mutex m_rings_mutex; // protects m_rings
+    std::vector<std::shared_ptr<Ring>> m_rings;
+
+    std::mutex m_mutex;       // protects the members below
+    std::condition_variable m_wakeup;
+    std::condition_variable m_flushed;
+    bool m_running{false};
+    std::uint64_t m_flush_requests{0};
+    std::uint64_t m_flush_done{0};
+    std::thread m_flusher;
+
+    LOG_MODE_t m_async_mode{LOG_MODE_ASYNC_TEXT}; // used by the flusher only
+    std::vector<CombatRecord> m_batch;
+    std::string m_text;
+};
+
+#endif // COMBAT_LOG_H
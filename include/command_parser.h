@@ -0,0 +1,21 @@
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+#include <string_view>
+#include "fighter.h"
+
+/**
+ * @brief ParseHeroCommand
+ *
+ * Parse a command of the player, e.g "attack orc". The words are case
+ * insensitive and separated by blanks. Each word is looked up in a perfect
+ * hash table of the known verbs and targets: a command is parsed in place,
+ * without any allocation, whatever its length.
+ *
+ * @param command a command line, without its end of line
+ * @return The role of the monster attacked by the command, or
+ *         ROLE_UNDEFINED for an unknown command
+ */
+ROLE_t ParseHeroCommand(std::string_view command) noexcept;
+
+#endif // COMMAND_PARSER_H
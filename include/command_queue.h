@@ -0,0 +1,105 @@
+#ifndef COMMAND_QUEUE_H
+#define COMMAND_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "fighter.h"
+
+// Default capacity of a command queue, in commands
+constexpr std::size_t COMMAND_QUEUE_CAPACITY = 1024;
+// Ticket of a command that was not queued
+constexpr std::uint64_t NO_TICKET = UINT64_MAX;
+
+/**
+ * @brief Kind of a command sent to the simulation of the game
+ */
+using COMMAND_t = enum COMMAND : std::uint32_t {
+    COMMAND_NONE,   // does nothing
+    COMMAND_ATTACK, // the attacker attacks the target
+};
+
+/**
+ * @brief A command sent to the simulation of the game
+ *
+ * The fighters are given by their slot in the AliveIndex of the game: a
+ * command holds no pointer into the world, it is just data.
+ */
+struct GameCommand {
+    COMMAND_t type{COMMAND_NONE};
+    std::uint32_t attacker{0};
+    std::uint32_t target{0};
+};
+
+
+/**
+ * @brief Class CommandQueue
+ *
+ * A bounded lock free queue with many producers and a single consumer. Each
+ * cell of the ring carries a sequence number telling whether it is free for
+ * the producer of a given position or filled for the consumer: a producer
+ * claims a position with a compare-and-swap of the tail, writes its command
+ * and publishes the cell, and the consumer reads the published cells in
+ * order without any atomic read-modify-write. A full queue is reported to
+ * the producer instead of blocking it.
+ */
+class CommandQueue {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param capacity the largest number of queued commands, rounded up to
+     *        a power of two
+     */
+    explicit CommandQueue(std::size_t capacity = COMMAND_QUEUE_CAPACITY);
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    /**
+     * @brief TryPush
+     *
+     * Queue a command, from any thread
+     *
+     * @param command the command to be queued
+     * @param ticket receives the position of the command in the queue, the
+     *        number of commands queued before it
+     * @return true if the command was queued, or false if the queue is full
+     */
+    bool TryPush(const GameCommand& command, std::uint64_t& ticket) noexcept;
+
+    /**
+     * @brief Drain
+     *
+     * Move the queued commands to a batch, in the order of their tickets.
+     * To be called by the consumer thread only.
+     *
+     * @param batch the batch the commands are appended to
+     * @param max the largest number of commands to be moved
+     * @return The number of commands moved
+     */
+    std::size_t Drain(std::vector<GameCommand>& batch, std::size_t max);
+
+    /**
+     * @brief A getter
+     *
+     * @return The largest number of queued commands
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Capacity() const noexcept {
+        return m_cells.size();
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::uint64_t> sequence{0};
+        GameCommand command;
+    };
+
+    std::vector<Cell> m_cells;
+    std::uint64_t m_mask{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> m_tail{0}; // producers
+    alignas(CACHE_LINE_SIZE) std::uint64_t m_head{0};             // consumer
+};
+
+#endif // COMMAND_QUEUE_H
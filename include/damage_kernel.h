@@ -0,0 +1,89 @@
+#ifndef DAMAGE_KERNEL_H
+#define DAMAGE_KERNEL_H
+
+#include <cstddef>
+#include "fighter.h"
+
+/**
+ * @brief Instruction sets the damage kernel can be compiled for
+ */
+using KERNEL_ISA_t = enum KERNEL_ISA {
+    ISA_SCALAR,
+    ISA_SSE42,
+    ISA_AVX2,
+    ISA_AVX512,
+};
+
+
+/**
+ * @brief ApplyDamageTick
+ *
+ * Apply one tick of damage to arrays of fighters stored as roles and health
+ * points: the attacker i attacks the target i, for each index lower than
+ * count. The rules are the ones of Hero::Attack() and Monster::Attack(),
+ * a killed target is reset. The attackers and the targets may be the same
+ * arrays. The best instruction set supported by the processor is selected
+ * on the first call. The vector code knows only the built-in roles: with
+ * any other RoleCatalog the scalar code runs.
+ *
+ * @param attacker_roles the roles of the attacking fighters
+ * @param attacker_health the health points of the attacking fighters
+ * @param target_roles the roles of the attacked fighters
+ * @param target_health the health points of the attacked fighters
+ * @param count the number of attacks to perform
+ * @return The number of attacks that occurred
+ */
+std::size_t ApplyDamageTick(const int* attacker_roles,
+                            const int* attacker_health,
+                            int* target_roles,
+                            int* target_health,
+                            std::size_t count) noexcept;
+
+/**
+ * @brief ApplyDamageTick
+ *
+ * Same as above, but with an explicitly chosen instruction set. An
+ * instruction set not supported by the processor, or a RoleCatalog other
+ * than the built-in one, falls back to scalar code.
+ *
+ * @param isa the instruction set to be used
+ * @param attacker_roles the roles of the attacking fighters
+ * @param attacker_health the health points of the attacking fighters
+ * @param target_roles the roles of the attacked fighters
+ * @param target_health the health points of the attacked fighters
+ * @param count the number of attacks to perform
+ * @return The number of attacks that occurred
+ */
+std::size_t ApplyDamageTick(KERNEL_ISA_t isa,
+                            const int* attacker_roles,
+                            const int* attacker_health,
+                            int* target_roles,
+                            int* target_health,
+                            std::size_t count) noexcept;
+
+/**
+ * @brief KernelIsaSupported
+ *
+ * Check at runtime if the processor supports an instruction set
+ *
+ * @param isa the instruction set to be checked
+ * @return true if the instruction set can be used, or false otherwise
+ */
+ATTRIBUTE_NO_DISCARD bool KernelIsaSupported(KERNEL_ISA_t isa) noexcept;
+
+/**
+ * @brief DetectKernelIsa
+ *
+ * @return The best instruction set supported by the processor
+ */
+ATTRIBUTE_NO_DISCARD KERNEL_ISA_t DetectKernelIsa() noexcept;
+
+/**
+ * @brief KernelIsaToString
+ *
+ * @param isa an instruction set
+ * @return The name of the instruction set as a C string
+ */
+ATTRIBUTE_NO_DISCARD const char* KernelIsaToString(KERNEL_ISA_t isa) noexcept;
+
+#endif // DAMAGE_KERNEL_H
@@ -0,0 +1,116 @@
+#ifndef DEADLINE_TIMER_H
+#define DEADLINE_TIMER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "fighter.h"
+
+// Default busy wait before a deadline: it absorbs the wake up latency of the
+// kernel, a few tens of microseconds
+constexpr std::chrono::microseconds DEADLINE_SPIN_DEFAULT{100};
+
+
+/**
+ * @brief Accuracy of the wake ups of a DeadlineTimer, in nanoseconds
+ *
+ * The lateness is the time between a deadline and the wake up. Its mean is
+ * the drift of each wake up, its standard deviation the jitter. Deadlines
+ * being absolute, the drift never accumulates over a battle.
+ */
+struct TimingStats {
+    std::uint64_t count{0}; // wake ups on time or late, interruptions excluded
+    double mean_lateness{0.0};
+    double jitter{0.0};
+    std::int64_t max_lateness{0};
+};
+
+
+/**
+ * @brief Class DeadlineTimer
+ *
+ * Sleeps until absolute deadlines of the steady clock: the time spent
+ * between two sleeps, e.g to attack and to print, does not delay the next
+ * deadline. The sleep is a timerfd armed with TFD_TIMER_ABSTIME and polled
+ * together with an eventfd, so that Interrupt() wakes up the sleeper from
+ * any thread. The last microseconds before the deadline are spent in a
+ * busy wait, if configured.
+ */
+class DeadlineTimer {
+public:
+    /**
+     * @brief Constructor
+     *
+     * Create the timerfd and the eventfd. Without them, e.g when the
+     * process is out of file descriptors, the timer falls back to short
+     * sleeps of the thread.
+     *
+     * @param spin the busy wait before each deadline, 0 for none
+     */
+    explicit DeadlineTimer(std::chrono::nanoseconds spin = DEADLINE_SPIN_DEFAULT) noexcept;
+
+    /**
+     * @brief The destructor
+     *
+     * Close the file descriptors
+     */
+    ~DeadlineTimer();
+
+    DeadlineTimer(const DeadlineTimer&) = delete;
+    DeadlineTimer& operator=(const DeadlineTimer&) = delete;
+
+    /**
+     * @brief SleepUntil
+     *
+     * Block the calling thread until a deadline, or until Interrupt() is
+     * called. A past deadline returns at once. The lateness of the wake up
+     * is added to the statistics.
+     *
+     * @param deadline the time to wake up at
+     * @return true at the deadline, or false if the timer was interrupted
+     */
+    bool SleepUntil(std::chrono::steady_clock::time_point deadline) noexcept;
+
+    /**
+     * @brief Interrupt
+     *
+     * Wake up the sleeping thread, possibly from another thread. The timer
+     * stays interrupted: later sleeps return at once.
+     */
+    void Interrupt() noexcept;
+
+    /**
+     * @brief A getter
+     *
+     * @return true if Interrupt() was called, or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD inline bool Interrupted() const noexcept {
+        return m_interrupted.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief A getter
+     *
+     * To be called by the sleeping thread, or once it is done
+     *
+     * @return The drift and the jitter of the wake ups so far
+     */
+    ATTRIBUTE_NO_DISCARD TimingStats Stats() const noexcept;
+
+private:
+    bool Wait(std::chrono::steady_clock::time_point wake_up) noexcept;
+    void Account(std::chrono::steady_clock::time_point deadline) noexcept;
+
+    std::chrono::nanoseconds m_spin;
+    int m_timer{-1}; // timerfd on CLOCK_MONOTONIC, the clock of steady_clock
+    int m_wake{-1};  // eventfd written by Interrupt()
+    std::atomic<bool> m_interrupted{false};
+
+    // lateness of the wake ups, in nanoseconds
+    std::uint64_t m_count{0};
+    double m_sum{0.0};
+    double m_sum_squares{0.0};
+    std::int64_t m_max{0};
+};
+
+#endif // DEADLINE_TIMER_H
@@ -0,0 +1,276 @@
+#ifndef EVENT_SCHEDULER_H
+#define EVENT_SCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "deadline_timer.h"
+#include "fighter.h"
+
+// Time scale of a scheduler that never waits
+constexpr double TIME_SCALE_UNTHROTTLED = 0.0;
+// Time scale of a scheduler following the wall clock
+constexpr double TIME_SCALE_REAL_TIME = 1.0;
+
+
+/**
+ * @brief A timed event of the scheduler
+ */
+struct ScheduledEvent {
+    long long time{0};         // simulated time in milliseconds
+    std::size_t actor{0};      // index of the fighter the event belongs to
+    std::uint64_t sequence{0}; // scheduling order
+};
+
+
+/**
+ * @brief Class EventScheduler
+ *
+ * A single threaded discrete-event engine. Events are kept in a priority
+ * queue and processed in time order. Events due at the same time are
+ * processed by increasing actor index, then in scheduling order, so that
+ * a run is fully deterministic.
+ *
+ * The time scale defines how fast the simulated clock runs compared to the
+ * wall clock: 1 is real time, 10 is ten times faster and
+ * TIME_SCALE_UNTHROTTLED processes events as fast as possible.
+ */
+class EventScheduler {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param time_scale the speed of the simulated clock
+     * @param spin the busy wait ending each wait for an event, see DeadlineTimer
+     */
+    explicit EventScheduler(double time_scale = TIME_SCALE_UNTHROTTLED,
+                            std::chrono::nanoseconds spin = DEADLINE_SPIN_DEFAULT) noexcept
+    : m_time_scale{time_scale}, m_timer{spin} {}
+
+    /**
+     * @brief Schedule
+     *
+     * Add an event to the queue
+     *
+     * @param time the simulated time of the event, in milliseconds
+     * @param actor the index of the fighter the event belongs to
+     */
+    void Schedule(long long time, std::size_t actor);
+
+    /**
+     * @brief Run
+     *
+     * Process the events in order until the queue is empty or Stop() is
+     * called. The handler is called with each event and returns the delay
+     * until the next event of the same actor: a delay lower or equal to zero
+     * ends the activity of the actor.
+     *
+     * @tparam Handler a callable taking a const ScheduledEvent&
+     *         and returning a long long
+     * @param handler the function processing the events
+     * @param max_events the largest number of events to process, e.g to
+     *        save the pending ones in the middle of a run
+     * @return The number of processed events
+     */
+    template<typename Handler>
+    std::size_t Run(Handler&& handler, std::size_t max_events = SIZE_MAX);
+
+    /**
+     * @brief Pending
+     *
+     * @return The pending events, in no particular order, e.g to save them
+     */
+    ATTRIBUTE_NO_DISCARD inline const std::vector<ScheduledEvent>& Pending() const noexcept {
+        return m_queue;
+    }
+
+    /**
+     * @brief Restore
+     *
+     * Replace the pending events, e.g by the ones saved by a previous run.
+     * The events keep their sequence numbers, the next ones are scheduled
+     * after them. The next Run() starts the wall clock at the restored time:
+     * a throttled scheduler waits for the first event as if it had been
+     * running since then, instead of catching up with the time before it.
+     *
+     * @param now the simulated time of the last processed event
+     * @param events the pending events
+     */
+    void Restore(long long now, const std::vector<ScheduledEvent>& events);
+
+    /**
+     * @brief Stop
+     *
+     * Stop a running scheduler, possibly from another thread. A scheduler
+     * waiting for its next event wakes up immediately.
+     */
+    void Stop() noexcept;
+
+    /**
+     * @brief A getter
+     *
+     * @return true if Stop() was called, or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD inline bool Stopped() const noexcept {
+        return m_stopped.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The simulated time of the last processed event
+     */
+    ATTRIBUTE_NO_DISCARD inline long long Now() const noexcept {
+        return m_now;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of pending events
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Size() const noexcept {
+        return m_queue.size();
+    }
+
+    /**
+     * @brief A getter
+     *
+     * To be called by the thread of Run(), or once it is done
+     *
+     * @return The drift and the jitter of the events in real time
+     */
+    ATTRIBUTE_NO_DISCARD inline TimingStats Timing() const noexcept {
+        return m_timer.Stats();
+    }
+
+private:
+    struct Later {
+        bool operator()(const ScheduledEvent& lhs,
+                        const ScheduledEvent& rhs) const noexcept {
+            if(lhs.time != rhs.time){ return lhs.time > rhs.time; }
+            if(lhs.actor != rhs.actor){ return lhs.actor > rhs.actor; }
+            return lhs.sequence > rhs.sequence;
+        }
+    };
+
+    /**
+     * @brief WaitUntil
+     *
+     * Block until the wall clock reaches a simulated time, according to
+     * the time scale. Returns immediately for an unthrottled scheduler.
+     *
+     * @param time the simulated time to wait for
+     */
+    void WaitUntil(long long time);
+
+    /**
+     * @brief WallTime
+     *
+     * @param time a simulated time
+     * @return The wall clock time it takes, according to the time scale,
+     *         or zero for an unthrottled scheduler
+     */
+    ATTRIBUTE_NO_DISCARD std::chrono::steady_clock::duration WallTime(long long time) const noexcept;
+
+    std::vector<ScheduledEvent> m_queue; // a heap ordered by Later
+    double m_time_scale{TIME_SCALE_UNTHROTTLED};
+    long long m_now{0};
+    std::uint64_t m_sequence{0};
+    bool m_started{false};
+    std::chrono::steady_clock::time_point m_start;
+    std::atomic<bool> m_stopped{false};
+    DeadlineTimer m_timer;
+};
+
+
+template<typename Handler>
+std::size_t EventScheduler::Run(Handler&& handler, const std::size_t max_events)
+{
+    if(!m_started){
+        // the simulated clock starts at the restored time, if any
+        m_start = std::chrono::steady_clock::now() - WallTime(m_now);
+        m_started = true;
+    }
+
+    std::size_t processed{0};
+    while(!m_queue.empty() && !Stopped() && processed < max_events)
+    {
+        std::pop_heap(m_queue.begin(), m_queue.end(), Later{});
+        const ScheduledEvent event = m_queue.back();
+        m_queue.pop_back();
+
+        WaitUntil(event.time);
+        if(Stopped()){
+            break;
+        }
+
+        m_now = event.time;
+        const long long delay = handler(event);
+        ++processed;
+        if(delay > 0){
+            Schedule(event.time + delay, event.actor);
+        }
+    }
+    return processed;
+}
+
+
+/**
+ * @brief RunMonsterActions
+ *
+ * Let many monsters attack the hero from a single thread: each monster
+ * attacks at the interval of its role (ORC_ATTACK_INTERVAL or
+ * DRAGON_ATTACK_INTERVAL), starting one interval after the current time of
+ * the scheduler. The run ends when the hero dies or the scheduler is
+ * stopped. Output is printed by Monster::Attack() if verbose is true,
+ * otherwise the silent Fighter::Hit() is used.
+ *
+ * @param scheduler the scheduler driving the attacks
+ * @param hero the Hero of the game
+ * @param monsters the monsters fighting against the hero
+ * @param verbose whether attacks are printed on the terminal
+ * @return The number of attacks that occurred
+ */
+std::size_t RunMonsterActions(EventScheduler& scheduler,
+                              Hero& hero,
+                              const std::vector<const Monster*>& monsters,
+                              bool verbose = false);
+
+/**
+ * @brief ScheduleMonsterActions
+ *
+ * Schedule the first attack of each monster, one interval of its role
+ * after the current time of the scheduler. The actor of an event is the
+ * index of its monster.
+ *
+ * @param scheduler the scheduler driving the attacks
+ * @param monsters the monsters fighting against the hero
+ */
+void ScheduleMonsterActions(EventScheduler& scheduler,
+                            const std::vector<const Monster*>& monsters);
+
+/**
+ * @brief ResumeMonsterActions
+ *
+ * Same as RunMonsterActions() on the attacks already scheduled, e.g by
+ * ScheduleMonsterActions() or restored from a snapshot, up to a number of
+ * events
+ *
+ * @param scheduler the scheduler driving the attacks
+ * @param hero the Hero of the game
+ * @param monsters the monsters fighting against the hero
+ * @param verbose whether attacks are printed on the terminal
+ * @param max_events the largest number of attacks to process
+ * @return The number of attacks that occurred
+ */
+std::size_t ResumeMonsterActions(EventScheduler& scheduler,
+                                 Hero& hero,
+                                 const std::vector<const Monster*>& monsters,
+                                 bool verbose = false,
+                                 std::size_t max_events = SIZE_MAX);
+
+#endif // EVENT_SCHEDULER_H
@@ -1,14 +1,21 @@
 #ifndef FIGHTER_H
 #define FIGHTER_H
 
+#include <atomic>
+#include <cstddef>
+
 //#ifdef _OPENMP
 //    #include <omp.h>
 //#endif
 
 #if defined(__GNUC__) || defined(__clang__)
     #define ATTRIBUTE_NO_DISCARD [[nodiscard]]
+    // a rarely called function, kept out of the code of its callers
+    #define ATTRIBUTE_COLD __attribute__((cold, noinline))
 
-    using ROLE_t = enum ROLE {
+    // the underlying type is fixed: the roles of a RoleCatalog go beyond
+    // ROLE_DRAGON
+    using ROLE_t = enum ROLE : int {
         ROLE_UNDEFINED = -1,
         ROLE_HERO,
         ROLE_ORC,
@@ -24,8 +31,9 @@
     };
 #else
     #define ATTRIBUTE_NO_DISCARD
+    #define ATTRIBUTE_COLD
 
-    typedef enum ROLE {
+    typedef enum ROLE : int {
         ROLE_UNDEFINED = -1,
         ROLE_HERO,
         ROLE_ORC,
@@ -41,12 +49,23 @@
     } START_HEALTH_t;
 #endif
 
+// Time in milliseconds between two attacks of a monster
+const int ORC_ATTACK_INTERVAL = 1500;
+const int DRAGON_ATTACK_INTERVAL = 2000;
+
+// Fighters hit by different threads should not share a cache line
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+class AliveIndex;
+
 
 /**
  * @brief Class fighter
  *
  * This class implements a simple fighter. 
  * It is meant to be a base class that other classes can inherit from.
+ * Role and health points are atomic, so that several threads can attack
+ * the same fighter without any lock.
  */
 class Fighter {
 public:
@@ -99,8 +118,10 @@ public:
     // so this class can really be an abstract class
     /**
      * @brief The destructor
+     *
+     * Unregister the fighter from its AliveIndex, if any
      */
-    virtual ~Fighter()=default;
+    virtual ~Fighter();
 
     /**
      * @brief Operator=
@@ -129,8 +150,8 @@ public:
      *
      * @return The role of the fighter
      */
-    ATTRIBUTE_NO_DISCARD inline constexpr ROLE_t GetRole() const noexcept { 
-        return this->m_role; 
+    ATTRIBUTE_NO_DISCARD inline ROLE_t GetRole() const noexcept { 
+        return this->m_role.load(std::memory_order_relaxed); 
     }
 
     /**
@@ -141,7 +162,7 @@ public:
      * @return The health points of the fighter
      */
     ATTRIBUTE_NO_DISCARD inline int GetHealth() const noexcept { 
-        return this->m_health; 
+        return this->m_health.load(std::memory_order_relaxed); 
     }
 
     /**
@@ -171,7 +192,7 @@ public:
      * @param health_points the health points to be set
      */
     inline void SetHealth(const int health_points) noexcept { 
-        this->m_health = health_points; 
+        this->m_health.store(health_points, std::memory_order_relaxed); 
     }
 
     /**
@@ -182,7 +203,7 @@ public:
      * @return true if the fighter is alive or false otherwise
      */
     ATTRIBUTE_NO_DISCARD inline bool IsAlive() const noexcept{ 
-        return this->m_health > HEALTH_DEAD; 
+        return this->GetHealth() > HEALTH_DEAD; 
     }
 
     /**
@@ -218,7 +239,8 @@ public:
      * @brief Reset
      *
      * Reset the fighter by setting its role and 
-     * health points to undefined values
+     * health points to undefined values. The fighter leaves its
+     * AliveIndex, if any.
      */
     void Reset() noexcept;
 
@@ -234,25 +256,188 @@ public:
     /**
      * @brief IntToRole
      *
-     * Return the role of fighter as a C string
+     * Convert an id into a role of the RoleCatalog
      *
      * @param role the role which corresponding ROLE_t value is required
-     * @return The role of the fighter
+     * @return The role, or ROLE_UNDEFINED for an id unknown to the catalog
      */
     static ROLE_t IntToRole(int role) noexcept;
 
     /**
      * @brief Attack()
      *
-     * The main method to attack an enemy
+     * The main method to attack an enemy. The base implementation only
+     * logs the attack: it neither damages the enemy nor counts anything in
+     * the metrics. The overrides of Hero and Monster damage it and, as
+     * Hit(), count the kills and the rejected attacks, leaving the hits to
+     * the caller.
      *
      * @param other the fighter to be attacked
      */
     virtual void Attack(Fighter& other) const noexcept;
 
+    /**
+     * @brief Damage
+     *
+     * Query the number of health points an enemy looses when hit by
+     * the fighter, as given by the RoleCatalog: by default 2 for an hero,
+     * 1 for an orc and 3 for a dragon.
+     *
+     * @return The damage of the fighter, 0 for an undefined fighter
+     */
+    ATTRIBUTE_NO_DISCARD int Damage() const noexcept;
+
+    /**
+     * @brief RoleDamage
+     *
+     * Query the damage dealt by a fighter of a given built-in role, known
+     * at compile time. The RoleCatalog starts with this rule, and Damage()
+     * follows the catalog.
+     *
+     * @param role the role of the attacking fighter
+     * @return The damage of the role, 0 for an undefined role
+     */
+    ATTRIBUTE_NO_DISCARD static constexpr int RoleDamage(ROLE_t role) noexcept{
+        switch(role)
+        {
+            case ROLE_HERO:   return 2;
+            case ROLE_ORC:    return 1;
+            case ROLE_DRAGON: return 3;
+            default:          return 0;
+        }
+    }
+
+    /**
+     * @brief RolesAreEnemies
+     *
+     * Check if a fighter of a given built-in role is an enemy of another
+     * one, at compile time. The RoleCatalog starts with this rule, and
+     * IsEnemy() follows the catalog.
+     *
+     * @param role the role of the first fighter
+     * @param other_role the role of the second fighter
+     * @return true if both roles are enemies, or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD static constexpr bool RolesAreEnemies(
+        ROLE_t role, ROLE_t other_role) noexcept{
+        if(role == ROLE_HERO){
+            return other_role == ROLE_ORC || other_role == ROLE_DRAGON;
+        }
+        if(role == ROLE_ORC || role == ROLE_DRAGON){
+            return other_role == ROLE_HERO;
+        }
+        return false; //undefined fighter
+    }
+
+    /**
+     * @brief RoleHealth
+     *
+     * Query the health points of a new fighter of a given built-in role, at
+     * compile time. The RoleCatalog starts with this rule.
+     *
+     * @param role the role of the fighter
+     * @return The start health of the role, HEALTH_UNDEFINED for an
+     *         undefined role
+     */
+    ATTRIBUTE_NO_DISCARD static constexpr int RoleHealth(ROLE_t role) noexcept{
+        switch(role)
+        {
+            case ROLE_HERO:   return HEALTH_HERO;
+            case ROLE_ORC:    return HEALTH_ORC;
+            case ROLE_DRAGON: return HEALTH_DRAGON;
+            default:          return HEALTH_UNDEFINED;
+        }
+    }
+
+    /**
+     * @brief RoleAttackInterval
+     *
+     * Query the time between two attacks of a monster of a given built-in
+     * role, at compile time. The RoleCatalog starts with this rule.
+     *
+     * @param role the role of the monster
+     * @return The attack interval in milliseconds, 0 for other roles
+     */
+    ATTRIBUTE_NO_DISCARD static constexpr int RoleAttackInterval(
+        ROLE_t role) noexcept{
+        switch(role)
+        {
+            case ROLE_ORC:    return ORC_ATTACK_INTERVAL;
+            case ROLE_DRAGON: return DRAGON_ATTACK_INTERVAL;
+            default:          return 0;
+        }
+    }
+
+    /**
+     * @brief RoleName
+     *
+     * Query the name of a built-in role. The RoleCatalog starts with these
+     * names, and RoleToString() follows the catalog.
+     *
+     * @param role the role of the fighter
+     * @return The name of the role as a C string
+     */
+    ATTRIBUTE_NO_DISCARD static constexpr const char* RoleName(
+        ROLE_t role) noexcept{
+        switch(role)
+        {
+            case ROLE_HERO:   return "Hero";
+            case ROLE_ORC:    return "Orc";
+            case ROLE_DRAGON: return "Dragon";
+            default:          return "Undefined";
+        }
+    }
+
+    /**
+     * @brief Hit()
+     *
+     * Apply the same rules as Hero::Attack() and Monster::Attack() without
+     * any terminal output. This is meant for simulations running a huge
+     * number of attacks. A killed enemy is reset. The kills and the rejected
+     * attacks are counted in the metrics, the hits are left to the caller:
+     * see AttackTally. The hits are recorded by the ReplayRecorder.
+     *
+     * @param other the fighter to be hit
+     * @return true if the attack occurred, or false otherwise
+     */
+    bool Hit(Fighter& other) const noexcept;
+
+    /**
+     * @brief Hit()
+     *
+     * Same as Hit(Fighter&), with a damage other than the one of the role,
+     * e.g to try other balance values in simulations
+     *
+     * @param other the fighter to be hit
+     * @param damage the number of health points removed from the other
+     * @return true if the attack occurred, or false otherwise
+     */
+    bool Hit(Fighter& other, int damage) const noexcept;
+
+    /**
+     * @brief TakeDamage()
+     *
+     * Remove health points from a living fighter with an atomic
+     * compare-and-swap. The fighter is reset by the thread whose damage
+     * kills it, so that a death is handled exactly once.
+     *
+     * @param damage the number of health points to be removed
+     * @param health_after receives the health points right after the
+     *        damage, before a possible reset
+     * @return true if the fighter was alive and got damaged, false otherwise
+     */
+    bool TakeDamage(int damage, int& health_after) noexcept;
+
 private:
-    ROLE_t m_role{ROLE::ROLE_UNDEFINED};
-    int m_health{START_HEALTH::HEALTH_UNDEFINED};
+    friend class AliveIndex;
+
+    std::atomic<ROLE_t> m_role{ROLE::ROLE_UNDEFINED};
+    std::atomic<int> m_health{START_HEALTH::HEALTH_UNDEFINED};
+
+    // The index of the living fighters this one is registered to, if any:
+    // not copied nor moved with the fighter
+    AliveIndex* m_index{nullptr};
+    std::size_t m_slot{0};
 };
 
 
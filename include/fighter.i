@@ -10,13 +10,148 @@
 #include <thread>
 #include <utility>
 #include <type_traits>
+#include <cstdint>
+#include <vector>
 #include "fighter.h"
+#include "fighter_batch.h"
 %}
 
+%include <stdint.i>
+
 // includes containing the C/C++ to be interfaced to python
 %include "fighter.h"
 
+// FighterBatch holds millions of fighters: its arrays are seen from python
+// as NumPy arrays viewing the C++ memory, see fighter_arrays() below, instead
+// of one python object per fighter
+%ignore FighterBatch::IsAlive(std::vector<std::uint8_t>&) const;
+%ignore FighterBatch::CanAttack;
+%ignore FighterBatch::Assign;
+%ignore FighterBatch::Roles;
+%ignore FighterBatch::Health;
+
+// the vectors behind the NumPy arrays must not move or shrink: changing the
+// fighters of a batch is refused while arrays view it, see _ViewLease below
+%pythonprepend FighterBatch::Add %{
+    _check_no_views(self)
+%}
+%pythonprepend FighterBatch::Reserve %{
+    _check_no_views(self)
+%}
+%pythonprepend FighterBatch::Clear %{
+    _check_no_views(self)
+%}
+%pythonprepend FighterBatch::AssignAddresses %{
+    _check_no_views(self)
+%}
+%include "fighter_batch.h"
+
+%extend FighterBatch {
+    // address of the array of roles, read only
+    uintptr_t RolesAddress() const {
+        return reinterpret_cast<uintptr_t>($self->Roles());
+    }
+    // address of the array of health points, writable
+    uintptr_t HealthAddress() {
+        return reinterpret_cast<uintptr_t>($self->Health());
+    }
+    // replace the fighters by a copy of two arrays of C int
+    void AssignAddresses(uintptr_t roles, uintptr_t health, size_t count) {
+        $self->Assign(reinterpret_cast<const int*>(roles),
+                      reinterpret_cast<const int*>(health), count);
+    }
+}
+
 %pythoncode%{
+    import ctypes as _ctypes
+
+    # number of live views of each FighterBatch, by id: a batch is kept alive
+    # by its views, so that its id is not reused while it has some
+    _view_counts = {}
+
+    class _ViewLease:
+        """Counts a view of a FighterBatch as long as it is alive"""
+        def __init__(self, batch):
+            self._key = id(batch)
+            _view_counts[self._key] = _view_counts.get(self._key, 0) + 1
+
+        def __del__(self):
+            count = _view_counts.pop(self._key) - 1
+            if count > 0:
+                _view_counts[self._key] = count
+
+    def _check_no_views(batch):
+        if _view_counts.get(id(batch), 0) > 0:
+            raise RuntimeError("the fighters of a FighterBatch cannot change "
+                               "while NumPy arrays view it: delete the arrays "
+                               "of fighter_arrays() first")
+
+    def _int_view(owner, address, count):
+        # a ctypes array exports the C++ memory through the buffer protocol,
+        # and keeps its owner alive as long as a NumPy array uses it
+        view = (_ctypes.c_int * count).from_address(address)
+        view._owner = owner
+        view._lease = _ViewLease(owner)
+        return view
+
+    def fighter_arrays(batch):
+        """Roles and health points of a FighterBatch as NumPy arrays of C
+        int viewing the C++ memory, without copy. The roles are read only,
+        the health points are writable. While the arrays are alive, adding
+        fighters to the batch, reserving memory or clearing it raises a
+        RuntimeError, since it could move the memory they view."""
+        import numpy
+        count = batch.Size()
+        if count == 0:
+            return numpy.empty(0, numpy.intc), numpy.empty(0, numpy.intc)
+        roles = numpy.frombuffer(_int_view(batch, batch.RolesAddress(), count), numpy.intc)
+        roles.flags.writeable = False
+        health = numpy.frombuffer(_int_view(batch, batch.HealthAddress(), count), numpy.intc)
+        return roles, health
+
+    def batch_from_arrays(roles, health):
+        """A FighterBatch holding a copy of arrays of roles and health points"""
+        import numpy
+        roles = numpy.ascontiguousarray(roles, dtype=numpy.intc)
+        health = numpy.ascontiguousarray(health, dtype=numpy.intc)
+        if roles.ndim != 1 or roles.shape != health.shape:
+            raise ValueError("roles and health must be 1D arrays of the same size")
+        batch = FighterBatch()
+        batch.AssignAddresses(roles.ctypes.data, health.ctypes.data, roles.size)
+        return batch
+
+    def count_alive(health):
+        """The number of living fighters of an array of health points"""
+        import numpy
+        return int(numpy.count_nonzero(numpy.asarray(health) > HEALTH_DEAD))
+
+    def run_ticks_in_place(attackers, targets, ticks=1):
+        """The attacker i of a FighterBatch attacks the target i of another
+        one on each tick, until a tick has no attack left. The batches are
+        updated in place, nothing is copied: returns the roles and the
+        health points of the targets as views of fighter_arrays(), and the
+        number of attacks. The loop runs in C++."""
+        attacks = attackers.RunTicks(targets, ticks)
+        roles, health = fighter_arrays(targets)
+        return roles, health, attacks
+
+    def apply_attacks_in_place(attackers, targets):
+        """A single tick of run_ticks_in_place()"""
+        return run_ticks_in_place(attackers, targets, 1)
+
+    def run_ticks(attacker_roles, attacker_health, target_roles, target_health, ticks=1):
+        """Same as run_ticks_in_place() on arrays of roles and health points:
+        the inputs are copied into batches and left unchanged. Simulations
+        running many ticks should keep their fighters in FighterBatch
+        objects and call run_ticks_in_place() instead."""
+        attackers = batch_from_arrays(attacker_roles, attacker_health)
+        targets = batch_from_arrays(target_roles, target_health)
+        return run_ticks_in_place(attackers, targets, ticks)
+
+    def apply_attacks(attacker_roles, attacker_health, target_roles, target_health):
+        """A single tick of run_ticks()"""
+        return run_ticks(attacker_roles, attacker_health, target_roles, target_health, 1)
+
     print("\nBASIC GAME PYTHON INTERFACE:  Main function for playing not implemented yet\n")
 
     if __name__ == "__main__":
@@ -32,5 +167,6 @@
  * TODO @Kamdoum: Complete the python interface
  *                - Main function to play the game using python 
  *                  module threading: separate file
- *                - Python tests using Pytest: separate file
+ *
+ * The Python tests, run by pytest, are in test/test_basic_game.py
  */
\ No newline at end of file
@@ -0,0 +1,244 @@
+#ifndef FIGHTER_BATCH_H
+#define FIGHTER_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "fighter.h"
+
+/**
+ * @brief Class FighterBatch
+ *
+ * This class stores a large number of fighters as a structure of arrays:
+ * the roles and the health points are kept in two separate contiguous
+ * arrays, without any virtual table. The batched operations apply the same
+ * rules as Fighter, Hero and Monster, but iterate linearly over memory.
+ */
+class FighterBatch {
+public:
+    /**
+     * @brief Default Constructor
+     *
+     * A constructor for creating an empty batch.
+     */
+    explicit FighterBatch() noexcept = default;
+
+    /**
+     * @brief Constructor from role
+     *
+     * A constructor for creating a batch of fighters sharing the same role.
+     *
+     * @param count the number of fighters to be created
+     * @param role the role of the fighters to be created
+     */
+    FighterBatch(std::size_t count, ROLE_t role);
+
+    /**
+     * @brief Add
+     *
+     * Append a new fighter with the start health of its role
+     *
+     * @param role the role of the fighter to be added
+     * @return The index of the new fighter inside the batch
+     */
+    std::size_t Add(ROLE_t role);
+
+    /**
+     * @brief Add
+     *
+     * Append a copy of an existing fighter
+     *
+     * @param fighter the fighter to be copied
+     * @return The index of the new fighter inside the batch
+     */
+    std::size_t Add(const Fighter& fighter);
+
+    /**
+     * @brief Reserve
+     *
+     * Allocate memory for a given number of fighters
+     *
+     * @param count the number of fighters
+     */
+    void Reserve(std::size_t count);
+
+    /**
+     * @brief Clear
+     *
+     * Remove all fighters from the batch
+     */
+    void Clear() noexcept;
+
+    /**
+     * @brief Assign
+     *
+     * Replace the content of the batch by copies of two raw arrays, e.g
+     * the ones of a snapshot
+     *
+     * @param roles the roles of the fighters
+     * @param health the health points of the fighters
+     * @param count the number of fighters
+     */
+    void Assign(const int* roles, const int* health, std::size_t count);
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of fighters inside the batch
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Size() const noexcept {
+        return m_roles.size();
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @param index the index of the fighter
+     * @return The role of the fighter
+     */
+    ATTRIBUTE_NO_DISCARD inline ROLE_t GetRole(std::size_t index) const noexcept {
+        return static_cast<ROLE_t>(m_roles[index]);
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @param index the index of the fighter
+     * @return The health points of the fighter
+     */
+    ATTRIBUTE_NO_DISCARD inline int GetHealth(std::size_t index) const noexcept {
+        return m_health[index];
+    }
+
+    /**
+     * @brief A setter
+     *
+     * @param index the index of the fighter
+     * @param health_points the health points to be set
+     */
+    inline void SetHealth(std::size_t index, int health_points) noexcept {
+        m_health[index] = health_points;
+    }
+
+    /**
+     * @brief Get
+     *
+     * Create a standalone copy of a fighter of the batch
+     *
+     * @param index the index of the fighter
+     * @return A fighter with the same role and health points
+     */
+    ATTRIBUTE_NO_DISCARD Fighter Get(std::size_t index) const noexcept;
+
+    /**
+     * @brief IsAlive
+     *
+     * @param index the index of the fighter
+     * @return true if the fighter is alive or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD inline bool IsAlive(std::size_t index) const noexcept {
+        return m_health[index] > HEALTH_DEAD;
+    }
+
+    /**
+     * @brief IsAlive
+     *
+     * Check which fighters of the batch are alive
+     *
+     * @param alive receives 1 for each living fighter and 0 otherwise
+     * @return The number of living fighters
+     */
+    std::size_t IsAlive(std::vector<std::uint8_t>& alive) const;
+
+    /**
+     * @brief CountAlive
+     *
+     * @return The number of living fighters inside the batch
+     */
+    ATTRIBUTE_NO_DISCARD std::size_t CountAlive() const noexcept;
+
+    /**
+     * @brief CanAttack
+     *
+     * Check for each index i if the fighter i of this batch can attack the
+     * fighter i of the other batch. Only the common part of both batches is
+     * considered.
+     *
+     * @param targets the fighters to be checked
+     * @param allowed receives 1 if the attack can occur and 0 otherwise
+     * @return The number of attacks that can occur
+     */
+    std::size_t CanAttack(const FighterBatch& targets,
+                          std::vector<std::uint8_t>& allowed) const;
+
+    /**
+     * @brief AttackAll
+     *
+     * The fighter i of this batch attacks the fighter i of the other batch,
+     * for each index of the common part of both batches. The rules are the
+     * ones of Fighter::Hit(): killed fighters are reset. The work is done by
+     * the vectorized kernel ApplyDamageTick().
+     *
+     * @param targets the fighters to be attacked
+     * @return The number of attacks that occurred
+     */
+    std::size_t AttackAll(FighterBatch& targets) const noexcept;
+
+    /**
+     * @brief RunTicks
+     *
+     * Repeat AttackAll() for a number of ticks, or until a tick has no
+     * attack left
+     *
+     * @param targets the fighters to be attacked
+     * @param ticks the largest number of ticks
+     * @return The number of attacks that occurred
+     */
+    std::size_t RunTicks(FighterBatch& targets, std::size_t ticks) const noexcept;
+
+    /**
+     * @brief AttackedBy
+     *
+     * A single fighter attacks every fighter of the batch.
+     *
+     * @param attacker the attacking fighter
+     * @return The number of attacks that occurred
+     */
+    std::size_t AttackedBy(const Fighter& attacker) noexcept;
+
+    /**
+     * @brief Raw access
+     *
+     * @return A pointer to the contiguous array of roles
+     */
+    ATTRIBUTE_NO_DISCARD inline const int* Roles() const noexcept {
+        return m_roles.data();
+    }
+
+    /**
+     * @brief Raw access
+     *
+     * @return A pointer to the contiguous array of health points
+     */
+    ATTRIBUTE_NO_DISCARD inline const int* Health() const noexcept {
+        return m_health.data();
+    }
+
+    /**
+     * @brief Raw access
+     *
+     * The array is valid until fighters are added or the batch is cleared,
+     * e.g while the Python module views it as a NumPy array
+     *
+     * @return A pointer to the contiguous array of health points, writable
+     */
+    ATTRIBUTE_NO_DISCARD inline int* Health() noexcept {
+        return m_health.data();
+    }
+
+private:
+    std::vector<int> m_roles;
+    std::vector<int> m_health;
+};
+
+#endif // FIGHTER_BATCH_H
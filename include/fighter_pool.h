@@ -0,0 +1,121 @@
+#ifndef FIGHTER_POOL_H
+#define FIGHTER_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "fighter.h"
+
+// Size and alignment of the slot of a pooled fighter: all fighter classes
+// have the same layout, so that a single pool serves them all
+constexpr std::size_t FIGHTER_SLOT_SIZE = sizeof(Fighter);
+constexpr std::size_t FIGHTER_SLOT_ALIGN = alignof(Fighter);
+static_assert(sizeof(Hero) == FIGHTER_SLOT_SIZE &&
+              sizeof(Orc) == FIGHTER_SLOT_SIZE &&
+              sizeof(Dragon) == FIGHTER_SLOT_SIZE,
+              "fighter classes must fit in the same slot");
+
+
+/**
+ * @brief Class FighterPool
+ *
+ * Storage for many short lived fighters, e.g the monsters of a wave. The
+ * fighters are built inside chunks of fixed size slots allocated once: a
+ * despawned fighter gives its slot back to a free list, and Release() ends
+ * all fighters at once, keeping the chunks for the next battle. Spawning
+ * thus never calls the heap once the pool has grown to the largest wave.
+ *
+ * A pool is not thread safe: concurrent sessions each use their own, e.g
+ * the one returned by ThreadLocal().
+ */
+class FighterPool {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param chunk_size the number of fighters of a chunk
+     */
+    explicit FighterPool(std::size_t chunk_size = 1024);
+
+    FighterPool(const FighterPool&) = delete;
+    FighterPool& operator=(const FighterPool&) = delete;
+
+    /**
+     * @brief The destructor
+     *
+     * Release the fighters still alive, and free all chunks
+     */
+    ~FighterPool();
+
+    /**
+     * @brief Spawn
+     *
+     * Build a fighter of the class matching its role: Hero, Orc, Dragon
+     * or Fighter
+     *
+     * @param role the role of the fighter
+     * @return The new fighter, owned by the pool
+     */
+    Fighter* Spawn(ROLE_t role);
+
+    /**
+     * @brief Despawn
+     *
+     * Destroy a fighter and recycle its slot
+     *
+     * @param fighter a fighter spawned by this pool and not despawned yet
+     */
+    void Despawn(Fighter* fighter) noexcept;
+
+    /**
+     * @brief Release
+     *
+     * End all fighters of the pool at once, e.g at the end of a battle: the
+     * living ones are destroyed, leaving their AliveIndex if any. The
+     * chunks are kept for the next spawns.
+     */
+    void Release() noexcept;
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of fighters spawned and not despawned or released
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Live() const noexcept {
+        return m_live;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of fighters the pool can hold without growing
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Capacity() const noexcept {
+        return m_chunks.size() * m_chunk_size;
+    }
+
+    /**
+     * @brief ThreadLocal
+     *
+     * @return The pool of the calling thread
+     */
+    static FighterPool& ThreadLocal();
+
+private:
+    union Slot {
+        Slot* next; // while in the free list
+        alignas(FIGHTER_SLOT_ALIGN) unsigned char storage[FIGHTER_SLOT_SIZE];
+    };
+
+    void* Allocate();
+
+    std::size_t m_chunk_size;
+    std::vector<std::unique_ptr<Slot[]>> m_chunks;
+    std::size_t m_chunk{0};   // chunk receiving the next new slot
+    std::size_t m_used{0};    // slots of that chunk already handed out
+    Slot* m_free{nullptr};    // despawned slots
+    std::vector<const Slot*> m_free_slots; // sorted by Release()
+    std::size_t m_live{0};
+};
+
+#endif // FIGHTER_POOL_H
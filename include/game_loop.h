@@ -0,0 +1,150 @@
+#ifndef GAME_LOOP_H
+#define GAME_LOOP_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "alive_index.h"
+#include "command_queue.h"
+#include "deadline_timer.h"
+#include "fighter.h"
+
+class AttackTally;
+
+// Default period of the simulation: the commands of a tick are applied
+// together
+constexpr std::chrono::milliseconds GAME_TICK_DEFAULT{1};
+
+
+/**
+ * @brief Class GameLoop
+ *
+ * The simulation of a game, the only writer of its fighters. The player
+ * input, the monster behaviors or any other thread submit commands to a
+ * CommandQueue; each tick the simulation thread drains them in a batch and
+ * applies them in order. The fighters are never hit by two threads at
+ * once: the combat path takes no lock.
+ *
+ * The fighters are the ones of an AliveIndex, registered before Run(). The
+ * GameLoop is the single writer of the index while it exists: a fighter
+ * killed by a command leaves it without a lock. The only lock left on the
+ * combat path is the one of the ReplayRecorder, while a replay is recorded
+ * by the verbose attacks.
+ */
+class GameLoop {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param alive the index of the fighters of the game
+     * @param verbose whether attacks are printed by Hero::Attack() and
+     *        Monster::Attack()
+     * @param capacity the largest number of commands waiting for a tick
+     */
+    explicit GameLoop(AliveIndex& alive, bool verbose = false,
+                      std::size_t capacity = COMMAND_QUEUE_CAPACITY);
+
+    /**
+     * @brief The destructor
+     *
+     * Give the AliveIndex back to any thread
+     */
+    ~GameLoop();
+
+    GameLoop(const GameLoop&) = delete;
+    GameLoop& operator=(const GameLoop&) = delete;
+
+    /**
+     * @brief Submit
+     *
+     * Queue a command for the next tick, from any thread. While the queue
+     * is full the caller waits for the simulation to drain it.
+     *
+     * @param command the command to be applied
+     * @return The ticket of the command, or NO_TICKET if the game is over
+     */
+    std::uint64_t Submit(const GameCommand& command) noexcept;
+
+    /**
+     * @brief WaitFor
+     *
+     * Block until a command has been applied, or until the simulation ends.
+     * Run() must be running, or about to.
+     *
+     * @param ticket the ticket returned by Submit()
+     */
+    void WaitFor(std::uint64_t ticket) const noexcept;
+
+    /**
+     * @brief Tick
+     *
+     * Apply the queued commands. Called by Run(), or by a single thread
+     * driving the simulation itself, e.g a test.
+     *
+     * @return The number of commands applied
+     */
+    std::size_t Tick();
+
+    /**
+     * @brief Run
+     *
+     * Run the simulation on the calling thread, one tick per period, until
+     * one side of the game has no living fighter left or until Stop().
+     *
+     * @param tick the period of the simulation
+     */
+    void Run(std::chrono::nanoseconds tick = GAME_TICK_DEFAULT);
+
+    /**
+     * @brief Stop
+     *
+     * Stop the simulation, possibly from another thread. The commands
+     * submitted afterwards are rejected.
+     */
+    void Stop() noexcept;
+
+    /**
+     * @brief A getter
+     *
+     * @return true once the simulation is stopped, or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD inline bool Stopped() const noexcept {
+        return m_stopped.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of commands applied so far
+     */
+    ATTRIBUTE_NO_DISCARD inline std::uint64_t Applied() const noexcept {
+        return m_applied.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of attacks that occurred
+     */
+    ATTRIBUTE_NO_DISCARD inline std::uint64_t Attacks() const noexcept {
+        return m_attacks.load(std::memory_order_relaxed);
+    }
+
+private:
+    void Apply(const GameCommand& command, AttackTally& tally);
+
+    AliveIndex& m_alive;
+    bool m_verbose{false};
+    CommandQueue m_queue;
+    std::vector<GameCommand> m_batch;
+    std::atomic<bool> m_stopped{false};
+    std::atomic<std::uint64_t> m_applied{0};
+    // waited on by WaitFor(): the commands applied, NO_TICKET once Run() is over
+    std::atomic<std::uint64_t> m_released{0};
+    std::atomic<std::uint64_t> m_attacks{0};
+    DeadlineTimer m_timer{std::chrono::nanoseconds{0}};
+};
+
+#endif // GAME_LOOP_H
@@ -0,0 +1,139 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "event_scheduler.h"
+#include "fighter.h"
+
+/*
+ * Protocol of the game server, in text lines ended by '\n'. The client sends
+ * the commands of the terminal game, e.g "attack orc". The server answers
+ * each command with exactly one line starting with "Hero ":
+ *
+ *   Hero hits Orc. Orc health is 5
+ *   Hero cannot attack Dragon
+ *   Hero does not understand the command
+ *
+ * and pushes the attacks of the monsters as they happen, then the end of
+ * the game, after which it closes the connection:
+ *
+ *   Orc hits Hero. Hero health is 38
+ *   Game over: you win
+ *   Game over: you loose
+ */
+
+// Default number of event loop threads of a server
+constexpr std::size_t SERVER_WORKERS_DEFAULT = 2;
+
+/**
+ * @brief Outcome of GameServer::Start()
+ */
+using SERVER_STATUS_t = enum SERVER_STATUS {
+    SERVER_OK,
+    SERVER_SOCKET_ERROR, // the socket could not be created, bound or listened
+    SERVER_RUNNING,      // the server was already started
+};
+
+
+/**
+ * @brief Configuration of a game server
+ */
+struct ServerConfig {
+    const char* socket_path{nullptr};  // Unix domain socket, replaced if it exists
+    std::size_t workers{SERVER_WORKERS_DEFAULT};
+    double time_scale{TIME_SCALE_REAL_TIME}; // speed of the monster attacks
+};
+
+
+class ServerWorker;
+
+/**
+ * @brief Class GameServer
+ *
+ * Serves many players at once over a Unix domain socket. Each connection is
+ * a session with its own Hero, Orc and Dragon. The sessions are spread over
+ * a few worker threads, each one running an epoll event loop: a worker
+ * accepts connections, reads and frames their commands, and fires the
+ * attacks of the monsters of all its sessions from a single TimingWheel.
+ * A session stays on the worker which accepted it, so that its fighters are
+ * never shared between threads.
+ */
+class GameServer {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param config the socket, the number of workers and the time scale
+     */
+    explicit GameServer(const ServerConfig& config);
+
+    /**
+     * @brief The destructor
+     *
+     * Stop the server
+     */
+    ~GameServer();
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    /**
+     * @brief Start
+     *
+     * Listen on the socket and start the workers
+     *
+     * @return SERVER_OK, or the reason why the server is not running
+     */
+    SERVER_STATUS_t Start();
+
+    /**
+     * @brief Stop
+     *
+     * Close every session, stop the workers and remove the socket
+     */
+    void Stop();
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of connected sessions
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Sessions() const noexcept {
+        return m_sessions.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of sessions accepted since the start
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t SessionsServed() const noexcept {
+        return m_served.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of commands answered since the start
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Commands() const noexcept {
+        return m_commands.load(std::memory_order_relaxed);
+    }
+
+private:
+    friend class ServerWorker;
+
+    ServerConfig m_config;
+    int m_listen{-1};
+    std::vector<std::unique_ptr<ServerWorker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::atomic<std::size_t> m_sessions{0};
+    std::atomic<std::size_t> m_served{0};
+    std::atomic<std::size_t> m_commands{0};
+};
+
+#endif // GAME_SERVER_H
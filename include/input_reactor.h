@@ -0,0 +1,143 @@
+#ifndef INPUT_REACTOR_H
+#define INPUT_REACTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <vector>
+#include <poll.h>
+#include "fighter.h"
+
+// Longest command line, in bytes: longer lines are dropped
+constexpr std::size_t INPUT_LINE_MAX = 1024;
+
+// Bytes read at once from an input, many lines of a script being piped
+constexpr std::size_t INPUT_READ_SIZE = 65536;
+
+// Timeout of InputReactor::RunOnce() waiting without limit
+constexpr int INPUT_WAIT_FOREVER = -1;
+
+
+/**
+ * @brief Class InputReactor
+ *
+ * Reads commands from several file descriptors, e.g the standard input or
+ * sockets, on the thread calling Run(). A single poll() waits for all of
+ * them and for the wake up of Stop(): nothing blocks in a read, and a
+ * reactor being stopped returns immediately instead of waiting for the
+ * next line of the player.
+ *
+ * The bytes read are framed into lines in a buffer per input, and each line
+ * is handed over as a view into that buffer: no copy and no allocation per
+ * line. A line ends with '\n', a trailing '\r' is removed, and the last
+ * line of an input may lack its '\n'. Lines longer than INPUT_LINE_MAX are
+ * dropped.
+ */
+class InputReactor {
+public:
+    // Called with each line, without its end of line. The view is valid
+    // until the handler returns.
+    using LineHandler = std::function<void(std::string_view line)>;
+    // Called once, when the end of an input is reached
+    using CloseHandler = std::function<void()>;
+
+    /**
+     * @brief Constructor
+     *
+     * Create the pipe waking up the reactor
+     */
+    InputReactor();
+
+    /**
+     * @brief The destructor
+     *
+     * Close the wake up pipe, the inputs are left open
+     */
+    ~InputReactor();
+
+    InputReactor(const InputReactor&) = delete;
+    InputReactor& operator=(const InputReactor&) = delete;
+
+    /**
+     * @brief Add
+     *
+     * Watch an input. Must not be called from a handler.
+     *
+     * @param fd the file descriptor to read, owned by the caller
+     * @param on_line the function receiving the lines
+     * @param on_close the function called at the end of the input
+     * @return true if the input is watched, or false if the reactor could
+     *         not be created
+     */
+    bool Add(int fd, LineHandler on_line, CloseHandler on_close = {});
+
+    /**
+     * @brief RunOnce
+     *
+     * Wait until an input is readable or Stop() is called, then read once
+     * from each readable input and deliver its complete lines
+     *
+     * @param timeout_ms the longest wait in milliseconds, or
+     *        INPUT_WAIT_FOREVER
+     * @return The number of lines delivered
+     */
+    std::size_t RunOnce(int timeout_ms = INPUT_WAIT_FOREVER);
+
+    /**
+     * @brief Run
+     *
+     * Deliver the lines of the inputs until Stop() is called or every input
+     * is closed
+     *
+     * @return The number of lines delivered
+     */
+    std::size_t Run();
+
+    /**
+     * @brief Stop
+     *
+     * Stop a running reactor, possibly from another thread or from a
+     * handler. A reactor waiting for input wakes up immediately. A reactor
+     * stopped stays stopped.
+     */
+    void Stop() noexcept;
+
+    /**
+     * @brief A getter
+     *
+     * @return true if Stop() was called, or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD inline bool Stopped() const noexcept {
+        return m_stopped.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of inputs not closed yet
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Inputs() const noexcept {
+        return m_inputs.size();
+    }
+
+private:
+    struct Input {
+        int fd{-1};
+        LineHandler on_line;
+        CloseHandler on_close;
+        std::vector<char> buffer;  // INPUT_READ_SIZE bytes
+        std::size_t fill{0};       // bytes not delivered yet
+        bool overflow{false};      // the pending line is too long
+    };
+
+    std::size_t Read(Input& input, bool& closed);
+    std::size_t Deliver(Input& input, std::size_t start);
+
+    std::vector<Input> m_inputs;
+    std::vector<pollfd> m_polled; // the wake up pipe, then the inputs
+    int m_wake[2]{-1, -1}; // read and write ends of the wake up pipe
+    std::atomic<bool> m_stopped{false};
+};
+
+#endif // INPUT_REACTOR_H
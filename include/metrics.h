@@ -0,0 +1,389 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include "fighter.h"
+#include "role_catalog.h"
+
+/**
+ * @brief Counters of the attacks, one per role of the attacker
+ */
+using METRIC_COUNTER_t = enum METRIC_COUNTER {
+    COUNTER_ATTACKS,   // hits that damaged their target
+    COUNTER_KILLS,     // hits that killed their target
+    COUNTER_REJECTED,  // attacks refused by Fighter::CanAttack()
+};
+constexpr std::size_t METRIC_COUNTERS = 3;
+
+/**
+ * @brief Latency histograms, in nanoseconds
+ */
+using METRIC_HISTOGRAM_t = enum METRIC_HISTOGRAM {
+    HISTOGRAM_TICK_LATENESS,   // delay of a monster attack after its deadline
+    HISTOGRAM_COMMAND_LATENCY, // from the read of a command to its answer
+    HISTOGRAM_LOCK_WAIT,       // wait for the lock of the replay recorder
+};
+constexpr std::size_t METRIC_HISTOGRAMS = 3;
+
+/**
+ * @brief Output formats of Metrics::Dump()
+ */
+using METRICS_FORMAT_t = enum METRICS_FORMAT {
+    METRICS_TEXT,
+    METRICS_JSON,
+};
+
+// Metrics compiled out with -DGAME_METRICS_DISABLED, e.g to measure their
+// overhead: records do nothing and all values stay 0
+#ifdef GAME_METRICS_DISABLED
+constexpr bool METRICS_ENABLED = false;
+#else
+constexpr bool METRICS_ENABLED = true;
+#endif
+
+// Roles counted: ROLE_UNDEFINED and every role a RoleCatalog can hold
+constexpr std::size_t METRIC_ROLES = ROLE_CAPACITY + 1;
+static_assert((METRIC_ROLES & (METRIC_ROLES - 1)) == 0, "the roles are masked");
+
+// A histogram bucket covers 1/16 of a power of two: values are recorded
+// with a relative error below 6.25 %, from 0 to 2^64 - 1
+constexpr int HISTOGRAM_SUB_BITS = 4;
+constexpr std::size_t HISTOGRAM_SUB_BUCKETS = std::size_t{1} << HISTOGRAM_SUB_BITS;
+constexpr std::size_t HISTOGRAM_BUCKETS =
+    (64 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS;
+
+
+/**
+ * @brief MetricCounterIndex
+ *
+ * The role is masked as by RoleCatalog: a role unknown to the catalog, e.g
+ * given to Fighter::SetRole(ROLE_t), is counted in an unspecified row but
+ * never outside the counters.
+ *
+ * @param counter a counter
+ * @param role the role of the attacker
+ * @return The index of the counter of the role inside a shard
+ */
+ATTRIBUTE_NO_DISCARD constexpr std::size_t MetricCounterIndex(METRIC_COUNTER_t counter,
+                                                              ROLE_t role) noexcept
+{
+    return static_cast<std::size_t>(counter) * METRIC_ROLES +
+           (static_cast<std::size_t>(role + 1) & (METRIC_ROLES - 1));
+}
+
+
+/**
+ * @brief Percentiles of a histogram, in nanoseconds
+ */
+struct HistogramSummary {
+    std::uint64_t count{0};
+    std::uint64_t p50{0};
+    std::uint64_t p90{0};
+    std::uint64_t p99{0};
+    std::uint64_t p999{0};
+    std::uint64_t max{0};
+};
+
+
+/**
+ * @brief HistogramBucket
+ *
+ * @param value a recorded value
+ * @return The index of the bucket counting the value
+ */
+ATTRIBUTE_NO_DISCARD constexpr std::size_t HistogramBucket(std::uint64_t value) noexcept
+{
+    if(value < HISTOGRAM_SUB_BUCKETS){
+        return value;
+    }
+    const int exponent = 63 - std::countl_zero(value);
+    const int shift = exponent - HISTOGRAM_SUB_BITS;
+    const std::size_t sub = (value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1);
+    return static_cast<std::size_t>(shift + 1) * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+/**
+ * @brief HistogramBucketMax
+ *
+ * @param bucket the index of a bucket
+ * @return The highest value counted by the bucket
+ */
+ATTRIBUTE_NO_DISCARD constexpr std::uint64_t HistogramBucketMax(std::size_t bucket) noexcept
+{
+    if(bucket < HISTOGRAM_SUB_BUCKETS){
+        return bucket;
+    }
+    const auto shift = static_cast<int>(bucket / HISTOGRAM_SUB_BUCKETS) - 1;
+    const std::uint64_t sub = HISTOGRAM_SUB_BUCKETS + bucket % HISTOGRAM_SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+static_assert(HistogramBucket(~std::uint64_t{0}) == HISTOGRAM_BUCKETS - 1,
+              "the last bucket holds the largest value");
+static_assert(HistogramBucket(HistogramBucketMax(100)) == 100 &&
+              HistogramBucket(HistogramBucketMax(100) + 1) == 101,
+              "the buckets are contiguous");
+
+
+/**
+ * @brief Class Metrics
+ *
+ * Counters and latency histograms of the game, cheap enough for the attack
+ * path. Each thread writes to its own shard, taken on its first record and
+ * handed over to the next thread once it ends: a record is a plain load and
+ * store in memory owned by the thread, without any atomic read-modify-write
+ * nor shared cache line. Readers sum the shards at any time, e.g to dump
+ * them on demand from another thread.
+ */
+class Metrics {
+public:
+    /**
+     * @brief Instance
+     *
+     * The metrics are never destroyed, so that the threads still running at
+     * the end of the program can record.
+     *
+     * @return The metrics of the whole program
+     */
+    static Metrics& Instance();
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    /**
+     * @brief Count
+     *
+     * Add to a counter of the calling thread
+     *
+     * @param counter the counter to increment
+     * @param role the role of the attacker
+     * @param count the number of events, e.g the attacks of a whole tick
+     */
+    static inline void Count(METRIC_COUNTER_t counter, ROLE_t role,
+                             std::uint64_t count = 1) noexcept {
+        if constexpr( !METRICS_ENABLED ){
+            return;
+        }
+        auto& value = Shard().counters[MetricCounterIndex(counter, role)];
+        value.store(value.load(std::memory_order_relaxed) + count,
+                    std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief CountOutcome
+     *
+     * Count the rare outcomes of an attack: the kills and the rejected
+     * attacks. The hits are counted by the callers of the attacks, in
+     * batches: see AttackTally.
+     *
+     * @param role the role of the attacker
+     * @param hit whether the target took the damage
+     * @param health_after the health points of the target after the hit
+     */
+    static inline void CountOutcome(ROLE_t role, bool hit, int health_after) noexcept {
+        if constexpr( !METRICS_ENABLED ){
+            return;
+        }
+        if( !hit || health_after <= HEALTH_DEAD ){
+            CountRareOutcome(role, hit);
+        }
+    }
+
+    /**
+     * @brief Record
+     *
+     * Add a value to a histogram of the calling thread
+     *
+     * @param histogram the histogram
+     * @param nanoseconds the value to add
+     */
+    static inline void Record(METRIC_HISTOGRAM_t histogram,
+                              std::uint64_t nanoseconds) noexcept {
+        if constexpr( !METRICS_ENABLED ){
+            return;
+        }
+        auto& bucket = Shard().histograms[histogram][HistogramBucket(nanoseconds)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Record
+     *
+     * Add a duration to a histogram of the calling thread, negative
+     * durations counting as 0
+     *
+     * @param histogram the histogram
+     * @param duration the value to add
+     */
+    template<typename Rep, typename Period>
+    static inline void Record(METRIC_HISTOGRAM_t histogram,
+                              std::chrono::duration<Rep, Period> duration) noexcept {
+        const auto nanoseconds =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        Record(histogram, nanoseconds > 0 ? static_cast<std::uint64_t>(nanoseconds) : 0U);
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @param counter a counter
+     * @param role the role of the attacker
+     * @return The sum of the counter over all threads
+     */
+    ATTRIBUTE_NO_DISCARD std::uint64_t Counter(METRIC_COUNTER_t counter,
+                                               ROLE_t role) const;
+
+    /**
+     * @brief Summary
+     *
+     * @param histogram a histogram
+     * @return The percentiles of the histogram over all threads
+     */
+    ATTRIBUTE_NO_DISCARD HistogramSummary Summary(METRIC_HISTOGRAM_t histogram) const;
+
+    /**
+     * @brief Summarize
+     *
+     * @param buckets the counts of the buckets of a histogram
+     * @return The percentiles of the histogram
+     */
+    ATTRIBUTE_NO_DISCARD static HistogramSummary Summarize(
+        const std::array<std::uint64_t, HISTOGRAM_BUCKETS>& buckets) noexcept;
+
+    /**
+     * @brief Dump
+     *
+     * Write all counters and the summaries of the histograms
+     *
+     * @param output the stream to write to
+     * @param format text lines or a JSON object
+     */
+    void Dump(std::ostream& output, METRICS_FORMAT_t format) const;
+
+    /**
+     * @brief CounterName
+     *
+     * @param counter a counter
+     * @return The name of the counter as a C string
+     */
+    ATTRIBUTE_NO_DISCARD static const char* CounterName(METRIC_COUNTER_t counter) noexcept;
+
+    /**
+     * @brief HistogramName
+     *
+     * @param histogram a histogram
+     * @return The name of the histogram as a C string
+     */
+    ATTRIBUTE_NO_DISCARD static const char* HistogramName(METRIC_HISTOGRAM_t histogram) noexcept;
+
+private:
+    struct alignas(CACHE_LINE_SIZE) MetricsShard {
+        std::array<std::atomic<std::uint64_t>, METRIC_COUNTERS * METRIC_ROLES> counters{};
+        std::array<std::array<std::atomic<std::uint64_t>, HISTOGRAM_BUCKETS>,
+                   METRIC_HISTOGRAMS> histograms{};
+    };
+
+    Metrics() = default;
+
+    static inline MetricsShard& Shard() noexcept {
+        return t_shard != nullptr ? *t_shard : AcquireShard();
+    }
+    static MetricsShard& AcquireShard() noexcept;
+    // out of line: the registers it needs are not saved by the attacks
+    // that only hit
+    ATTRIBUTE_COLD static void CountRareOutcome(ROLE_t role, bool hit) noexcept;
+    void ReleaseShard(MetricsShard* shard) noexcept;
+
+    friend struct ShardLease;
+
+    static inline thread_local MetricsShard* t_shard{nullptr};
+
+    mutable std::mutex m_mutex;
+    std::vector<MetricsShard*> m_shards; // never freed
+    std::vector<MetricsShard*> m_free;   // shards of the threads ended
+};
+
+
+/**
+ * @brief Class AttackTally
+ *
+ * The attacks of a batch, e.g the commands of a tick, counted by the caller
+ * of Fighter::Hit() or Fighter::Attack(): both only count the kills and the
+ * rejected attacks, off their fast path. A hit adds 1 to a local count,
+ * added to COUNTER_ATTACKS once the role of the attacker changes, by Flush()
+ * or by the destructor: a loop of hits by one role writes no memory for the
+ * metrics.
+ */
+class AttackTally {
+public:
+    AttackTally() = default;
+    AttackTally(const AttackTally&) = delete;
+    AttackTally& operator=(const AttackTally&) = delete;
+
+    ~AttackTally() { Flush(); }
+
+    /**
+     * @brief Add
+     *
+     * @param role the role of the attacker
+     * @param hit the result of Fighter::Hit()
+     */
+    inline void Add(const ROLE_t role, const bool hit) noexcept {
+        if(role != m_role){
+            Flush();
+            m_role = role;
+        }
+        m_count += hit ? 1U : 0U;
+    }
+
+    /**
+     * @brief Flush
+     *
+     * Add the attacks counted so far to the metrics of the calling thread
+     */
+    inline void Flush() noexcept {
+        if(m_count > 0){
+            Metrics::Count(COUNTER_ATTACKS, m_role, m_count);
+            m_count = 0;
+        }
+    }
+
+private:
+    ROLE_t m_role{ROLE_UNDEFINED};
+    std::uint64_t m_count{0};
+};
+
+
+/**
+ * @brief LockTimed
+ *
+ * Lock a mutex, recording the time waited in HISTOGRAM_LOCK_WAIT. A mutex
+ * free at once records 0 without reading the clock.
+ *
+ * @param mutex the mutex to lock
+ * @return The lock owning the mutex
+ */
+template<typename Mutex>
+std::unique_lock<Mutex> LockTimed(Mutex& mutex)
+{
+    std::unique_lock<Mutex> lock(mutex, std::try_to_lock);
+    if(lock.owns_lock()){
+        Metrics::Record(HISTOGRAM_LOCK_WAIT, std::uint64_t{0});
+        return lock;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    lock.lock();
+    Metrics::Record(HISTOGRAM_LOCK_WAIT, std::chrono::steady_clock::now() - start);
+    return lock;
+}
+
+#endif // METRICS_H
@@ -0,0 +1,268 @@
+#ifndef MONSTER_BEHAVIOR_H
+#define MONSTER_BEHAVIOR_H
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <vector>
+#include "deadline_timer.h"
+#include "event_scheduler.h"
+#include "fighter.h"
+#include "game_loop.h"
+#include "timing_wheel.h"
+
+class BehaviorExecutor;
+
+/**
+ * @brief Class Behavior
+ *
+ * A coroutine driving a fighter, e.g a monster attacking at the interval of
+ * its role. A behavior starts suspended and runs once handed over to a
+ * BehaviorExecutor with Spawn(). While it waits, a behavior only keeps its
+ * coroutine frame, a few hundred bytes, instead of the stack of a thread.
+ */
+class Behavior {
+public:
+    struct promise_type {
+        std::uint32_t slot{0}; // index of the behavior in its executor
+
+        Behavior get_return_object() noexcept {
+            return Behavior{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        // the frame is destroyed by the executor once the behavior is done
+        std::suspend_always final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+
+    Behavior(Behavior&& other) noexcept : m_handle(other.m_handle) {
+        other.m_handle = nullptr;
+    }
+    Behavior(const Behavior&) = delete;
+    Behavior& operator=(const Behavior&) = delete;
+    Behavior& operator=(Behavior&&) = delete;
+
+    /**
+     * @brief The destructor
+     *
+     * Destroy the coroutine of a behavior never spawned
+     */
+    ~Behavior() {
+        if(m_handle){
+            m_handle.destroy();
+        }
+    }
+
+private:
+    friend class BehaviorExecutor;
+
+    explicit Behavior(std::coroutine_handle<promise_type> handle) noexcept
+    : m_handle(handle) {}
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+
+/**
+ * @brief Class BehaviorExecutor
+ *
+ * Runs many behaviors on the calling thread. A behavior suspended by
+ * co_await SleepFor() is a timer of a TimingWheel: the executor sleeps until
+ * the next timer, then resumes the behaviors due on that tick. The time
+ * scale defines how fast the simulated clock runs, as for the EventScheduler.
+ */
+class BehaviorExecutor {
+public:
+    /**
+     * @brief Awaitable of SleepFor()
+     */
+    class Sleep {
+    public:
+        Sleep(BehaviorExecutor& executor, long long delay) noexcept
+        : m_executor(executor), m_delay(delay) {}
+
+        bool await_ready() const noexcept { return m_executor.Stopped(); }
+        void await_suspend(std::coroutine_handle<Behavior::promise_type> handle) {
+            m_executor.Wake(handle.promise().slot, m_executor.Now() + m_delay);
+        }
+        // false when the executor is stopped: the behavior should end
+        bool await_resume() const noexcept { return !m_executor.Stopped(); }
+
+    private:
+        BehaviorExecutor& m_executor;
+        long long m_delay{0};
+    };
+
+    /**
+     * @brief Constructor
+     *
+     * @param time_scale the speed of the simulated clock
+     * @param spin the busy wait ending each wait for a tick, see DeadlineTimer
+     */
+    explicit BehaviorExecutor(double time_scale = TIME_SCALE_UNTHROTTLED,
+                              std::chrono::nanoseconds spin = DEADLINE_SPIN_DEFAULT) noexcept
+    : m_time_scale{time_scale}, m_timer{spin} {}
+
+    /**
+     * @brief The destructor
+     *
+     * Destroy the behaviors still suspended
+     */
+    ~BehaviorExecutor();
+
+    BehaviorExecutor(const BehaviorExecutor&) = delete;
+    BehaviorExecutor& operator=(const BehaviorExecutor&) = delete;
+
+    /**
+     * @brief Spawn
+     *
+     * Take over a behavior, which starts at the current time of Run()
+     *
+     * @param behavior the behavior to run
+     */
+    void Spawn(Behavior behavior);
+
+    /**
+     * @brief Run
+     *
+     * Resume the behaviors as their sleeps end, until every behavior is done
+     * or Stop() is called
+     *
+     * @return The number of resumptions
+     */
+    std::size_t Run();
+
+    /**
+     * @brief Stop
+     *
+     * Stop a running executor, possibly from another thread or from a
+     * behavior. An executor waiting for its next tick wakes up immediately.
+     */
+    void Stop() noexcept;
+
+    /**
+     * @brief SleepFor
+     *
+     * Suspend the calling behavior: co_await executor.SleepFor(delay)
+     *
+     * @param delay the simulated time to sleep, in milliseconds
+     * @return The awaitable, resuming to false if the executor was stopped
+     */
+    ATTRIBUTE_NO_DISCARD inline Sleep SleepFor(long long delay) noexcept {
+        return Sleep{*this, delay};
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return true if Stop() was called, or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD inline bool Stopped() const noexcept {
+        return m_stopped.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The simulated time of the behaviors being resumed
+     */
+    ATTRIBUTE_NO_DISCARD inline long long Now() const noexcept {
+        return m_wheel.Now();
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of behaviors not done yet
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Size() const noexcept {
+        return m_live;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * To be called by the thread of Run(), or once it is done
+     *
+     * @return The drift and the jitter of the ticks in real time
+     */
+    ATTRIBUTE_NO_DISCARD inline TimingStats Timing() const noexcept {
+        return m_timer.Stats();
+    }
+
+private:
+    using Handle = std::coroutine_handle<Behavior::promise_type>;
+
+    void Wake(std::uint32_t slot, long long time);
+    void Resume(std::uint32_t slot);
+    void WaitUntil(long long time);
+    std::chrono::steady_clock::time_point Deadline(long long time) const noexcept;
+
+    TimingWheel m_wheel;
+    std::vector<Handle> m_behaviors; // by slot, null when free
+    std::vector<std::uint32_t> m_free;
+    std::vector<std::uint32_t> m_ready; // spawned, to be started
+    std::size_t m_live{0};
+    double m_time_scale{TIME_SCALE_UNTHROTTLED};
+    bool m_started{false};
+    std::chrono::steady_clock::time_point m_start;
+    std::atomic<bool> m_stopped{false};
+    DeadlineTimer m_timer;
+};
+
+
+/**
+ * @brief MonsterBehavior
+ *
+ * The behavior of a monster: sleep for the attack interval of its role,
+ * attack the hero, and so on until the monster or the hero dies. The death
+ * of the hero stops the executor.
+ *
+ * @param executor the executor running the behavior
+ * @param monster the attacking monster
+ * @param hero the Hero of the game
+ * @param attacks the counter of the attacks that occurred
+ * @param verbose whether attacks are printed by Monster::Attack()
+ * @return The behavior, to be spawned
+ */
+Behavior MonsterBehavior(BehaviorExecutor& executor, const Monster& monster,
+                         Hero& hero, std::size_t& attacks, bool verbose);
+
+/**
+ * @brief RunMonsterBehaviors
+ *
+ * Same battle as RunMonsterActions(), each monster being a coroutine
+ *
+ * @param executor the executor running the behaviors
+ * @param hero the Hero of the game
+ * @param monsters the monsters fighting against the hero
+ * @param verbose whether attacks are printed on the terminal
+ * @return The number of attacks that occurred
+ */
+std::size_t RunMonsterBehaviors(BehaviorExecutor& executor,
+                                Hero& hero,
+                                const std::vector<const Monster*>& monsters,
+                                bool verbose = false);
+
+/**
+ * @brief MonsterCommandBehavior
+ *
+ * Same as MonsterBehavior(), but the attacks are submitted to the
+ * simulation of the game instead of hitting the hero from the thread of the
+ * executor. The behavior ends with the monster, or with the game: the end
+ * of the game is known by the simulation, which should stop the executor.
+ *
+ * @param executor the executor running the behavior
+ * @param monster the attacking monster
+ * @param game the simulation applying the attacks
+ * @param attack the attack of the monster against the hero
+ * @return The behavior, to be spawned
+ */
+Behavior MonsterCommandBehavior(BehaviorExecutor& executor, const Monster& monster,
+                                GameLoop& game, GameCommand attack);
+
+#endif // MONSTER_BEHAVIOR_H
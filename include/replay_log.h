@@ -0,0 +1,205 @@
+#ifndef REPLAY_LOG_H
+#define REPLAY_LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "fighter.h"
+
+/*
+ * Replay log, version 1: a 16 bytes header, the magic "SCGREPLY", the
+ * version and the record size (2 bytes each) and 4 zero bytes, followed by
+ * records of 16 bytes. All values are little endian.
+ *
+ *   offset  size  content
+ *        0     1  kind of event, REPLAY_EVENT_t
+ *        1     1  role of the actor
+ *        2     2  index of the actor, in spawn order
+ *        4     2  index of the target
+ *        6     2  zero
+ *        8     4  spawn and state: health, hit: damage, game over: hero wins
+ *       12     4  hit: health of the target after the hit
+ */
+
+constexpr std::uint16_t REPLAY_VERSION = 1;
+constexpr std::size_t REPLAY_HEADER_SIZE = 16;
+constexpr std::size_t REPLAY_RECORD_SIZE = 16;
+
+/**
+ * @brief Kind of a replay event
+ */
+using REPLAY_EVENT_t = enum REPLAY_EVENT : std::uint8_t {
+    REPLAY_SPAWN,     // a fighter enters the battle with some health
+    REPLAY_HIT,       // an attack removed health points from a target
+    REPLAY_DEATH,     // the target of the previous hit was killed and reset
+    REPLAY_GAME_OVER, // end of the battle
+    REPLAY_STATE,     // health of a fighter when the recording stopped
+};
+
+
+/**
+ * @brief A replay event, decoded
+ */
+struct ReplayRecord {
+    REPLAY_EVENT_t event{REPLAY_SPAWN};
+    std::int8_t role{ROLE_UNDEFINED};
+    std::uint16_t actor{0};
+    std::uint16_t target{0};
+    std::int32_t value{0};
+    std::int32_t health{0};
+};
+
+
+/**
+ * @brief Class ReplayRecorder
+ *
+ * Records the battle as it happens: the fighters registered with Spawn(),
+ * every hit between them, from Hero::Attack(), Monster::Attack() or
+ * Fighter::Hit(), the kills and the end of the game. Records are appended to
+ * a buffer and written to the output stream in blocks. When no recording is
+ * running, the hooks of the attacks cost a single atomic load.
+ *
+ * Only the fighters registered with Spawn() are recorded: the sessions of
+ * the game server and the simulations register none, and record nothing
+ * even while a recording is running. StaticFighter is never recorded.
+ *
+ * The records are in the order the hits are recorded, just after they
+ * happen. A hit racing with the death of its attacker may thus be recorded
+ * after that death; the replay then reports it as a mismatch.
+ */
+class ReplayRecorder {
+public:
+    /**
+     * @brief Instance
+     *
+     * @return The recorder shared by the whole program
+     */
+    static ReplayRecorder& Instance();
+
+    ReplayRecorder(const ReplayRecorder&) = delete;
+    ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+    /**
+     * @brief Start
+     *
+     * Write the header and start recording, forgetting the fighters of a
+     * previous recording
+     *
+     * @param output the stream receiving the log, which must outlive the
+     *        recording
+     */
+    void Start(std::ostream& output);
+
+    /**
+     * @brief Stop
+     *
+     * Record the health of every fighter, write the pending records and
+     * stop recording. The spawned fighters must still exist.
+     */
+    void Stop();
+
+    /**
+     * @brief A getter
+     *
+     * @return true if a recording is running
+     */
+    ATTRIBUTE_NO_DISCARD inline bool Recording() const noexcept {
+        return m_recording.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Spawn
+     *
+     * Register a fighter taking part in the battle
+     *
+     * @param fighter the fighter, which must outlive the recording
+     */
+    void Spawn(const Fighter& fighter) noexcept;
+
+    /**
+     * @brief RecordHit
+     *
+     * Record a hit, and the death of the target if it was killed. Hits
+     * involving a fighter which was not spawned are ignored.
+     *
+     * @param attacker the attacking fighter
+     * @param target the attacked fighter
+     * @param damage the health points removed from the target
+     * @param health the health of the target after the hit
+     */
+    void RecordHit(const Fighter& attacker, const Fighter& target,
+                   int damage, int health) noexcept;
+
+    /**
+     * @brief RecordGameOver
+     *
+     * @param hero_wins whether the hero won the battle
+     */
+    void RecordGameOver(bool hero_wins) noexcept;
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of records of the current or last recording
+     */
+    ATTRIBUTE_NO_DISCARD std::size_t Recorded() const;
+
+private:
+    ReplayRecorder() = default;
+    ~ReplayRecorder() = default;
+
+    void Append(const ReplayRecord& record);
+    void WritePending();
+
+    std::atomic<bool> m_recording{false};
+    mutable std::mutex m_mutex; // protects the members below
+    std::ostream* m_output{nullptr};
+    std::unordered_map<const Fighter*, std::uint16_t> m_ids;
+    std::vector<const Fighter*> m_fighters;
+    std::vector<unsigned char> m_pending;
+    std::size_t m_recorded{0};
+};
+
+
+/**
+ * @brief Outcome of a replay
+ */
+struct ReplayResult {
+    bool valid{false};           // false if the log could not be decoded
+    std::size_t events{0};       // records replayed
+    std::size_t hits{0};
+    std::size_t deaths{0};
+    bool game_over{false};
+    bool hero_wins{false};
+    std::size_t mismatches{0};   // records contradicting the Fighter rules
+    std::size_t first_mismatch{0}; // index of the first one
+};
+
+
+/**
+ * @brief Replay
+ *
+ * Re-execute a recorded battle with the Fighter rules, as fast as possible:
+ * fighters are built from the spawn records, each hit is replayed with
+ * Fighter::Hit() and the health of its target compared to the recorded
+ * one, deaths, the winner and the final health of each fighter are
+ * checked too.
+ *
+ * @param input the replay log
+ * @return The number of events and of mismatches
+ */
+ReplayResult Replay(std::istream& input);
+
+/**
+ * @brief DecodeReplayRecord
+ *
+ * @param bytes the REPLAY_RECORD_SIZE bytes of a record
+ * @return The decoded record
+ */
+ReplayRecord DecodeReplayRecord(const unsigned char* bytes) noexcept;
+
+#endif // REPLAY_LOG_H
@@ -0,0 +1,276 @@
+#ifndef ROLE_CATALOG_H
+#define ROLE_CATALOG_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string_view>
+#include "fighter.h"
+
+// Largest number of roles of a catalog: the enemies of a role are a 64 bit
+// mask, whose bit 0 stands for ROLE_UNDEFINED
+constexpr std::size_t ROLE_CAPACITY = 63;
+// The built-in roles, ROLE_HERO to ROLE_DRAGON, come first in any catalog
+constexpr std::size_t ROLE_BUILTIN = 3;
+// Longest name of a role, with its terminating null character
+constexpr std::size_t ROLE_NAME_SIZE = 24;
+
+/**
+ * @brief Outcome of the load of a role catalog
+ */
+using CATALOG_STATUS_t = enum CATALOG_STATUS {
+    CATALOG_OK,
+    CATALOG_IO_ERROR,       // the file could not be opened or read
+    CATALOG_BAD_FORMAT,     // not: name health damage interval enemies
+    CATALOG_BAD_BUILTIN,    // the first roles are not Hero, Orc and Dragon
+    CATALOG_DUPLICATE_ROLE, // two roles with the same name
+    CATALOG_UNKNOWN_ENEMY,  // an enemy which is not a role of the catalog
+    CATALOG_TOO_MANY_ROLES, // more than ROLE_CAPACITY roles
+    CATALOG_BAD_FACTIONS,   // not the hero against all the other roles
+};
+
+
+/**
+ * @brief Class RoleCatalog
+ *
+ * The rules of each role as flat tables indexed by role id: health, damage,
+ * attack interval and the enemies of the role as a bit mask. A lookup is a
+ * load from a table of a few hundred bytes, without any branch: ROLE_UNDEFINED
+ * has its own row, with no health, no damage and no enemy.
+ *
+ * The catalog holds the built-in roles of Fighter::RoleHealth() and
+ * the like until Load() replaces them, e.g by a file read at startup: new
+ * monster types need no recompilation. A catalog is a text file with one
+ * role per line, the id of a role being its rank among the roles:
+ *
+ *     # name   health  damage  interval  enemies
+ *     Hero     40      2       0         Orc,Dragon,Troll
+ *     Orc      7       1       1500      Hero
+ *     Dragon   20      3       2000      Hero
+ *     Troll    30      2       2500      Hero
+ *
+ * Empty lines and lines starting with '#' are skipped, "-" stands for no
+ * enemy. The first three roles must be Hero, Orc and Dragon, the roles of
+ * the game itself. The battles have two factions, see RoleFaction(): the
+ * hero is the enemy of every other role, and the only enemy of each one.
+ *
+ * The catalog is read by all threads without any lock: it is loaded at
+ * startup, before the fighters are created.
+ */
+class RoleCatalog {
+public:
+    /**
+     * @brief Instance
+     *
+     * The catalog is initialized at compile time: it is valid even during
+     * the initialization of static objects.
+     *
+     * @return The catalog of the whole program
+     */
+    static inline RoleCatalog& Instance() noexcept {
+        return s_instance;
+    }
+
+    /**
+     * @brief Default Constructor
+     *
+     * A constructor for creating a catalog of the built-in roles.
+     */
+    constexpr RoleCatalog() noexcept {
+        LoadBuiltin();
+    }
+
+    RoleCatalog(const RoleCatalog&) = delete;
+    RoleCatalog& operator=(const RoleCatalog&) = delete;
+
+    /**
+     * @brief Load
+     *
+     * Replace the roles by the ones of a catalog. On error the roles are
+     * left unchanged, and ErrorLine() tells the faulty line.
+     *
+     * @param input the text of the catalog
+     * @return CATALOG_OK, or the reason of the failure
+     */
+    CATALOG_STATUS_t Load(std::istream& input);
+
+    /**
+     * @brief LoadFile
+     *
+     * Same as Load(), from a file
+     *
+     * @param path the file of the catalog
+     * @return CATALOG_OK, or the reason of the failure
+     */
+    CATALOG_STATUS_t LoadFile(const char* path);
+
+    /**
+     * @brief LoadBuiltin
+     *
+     * Replace the roles by the built-in ones
+     */
+    constexpr void LoadBuiltin() noexcept {
+        constexpr std::array<ROLE_t, ROLE_BUILTIN> ROLES{ROLE_HERO, ROLE_ORC, ROLE_DRAGON};
+        Erase();
+        for(const ROLE_t role : ROLES){
+            for(const ROLE_t other : ROLES){
+                if(Fighter::RolesAreEnemies(role, other)){
+                    m_enemies[Row(role)] |= std::uint64_t{1} << Row(other);
+                }
+            }
+            Set(role, Fighter::RoleName(role), Fighter::RoleHealth(role),
+                Fighter::RoleDamage(role), Fighter::RoleAttackInterval(role));
+        }
+        m_size = ROLE_BUILTIN;
+        m_builtin = true;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of roles, ROLE_UNDEFINED excluded
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Size() const noexcept {
+        return m_size;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return true if the roles are the built-in ones, or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD inline bool IsBuiltin() const noexcept {
+        return m_builtin;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The line of the last failed Load(), 0 for an error outside
+     *         any line
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t ErrorLine() const noexcept {
+        return m_error_line;
+    }
+
+    /**
+     * @brief Role
+     *
+     * @param id the id of a role
+     * @return The role, or ROLE_UNDEFINED if the id is not in the catalog
+     */
+    ATTRIBUTE_NO_DISCARD inline ROLE_t Role(int id) const noexcept {
+        return static_cast<std::size_t>(id) < m_size ? static_cast<ROLE_t>(id)
+                                                     : ROLE_UNDEFINED;
+    }
+
+    /**
+     * @brief Find
+     *
+     * @param name the name of a role
+     * @return The role, or ROLE_UNDEFINED if no role has this name
+     */
+    ATTRIBUTE_NO_DISCARD ROLE_t Find(std::string_view name) const noexcept;
+
+    /**
+     * @brief Health
+     *
+     * @param role ROLE_UNDEFINED or a role of the catalog
+     * @return The start health of the role, HEALTH_UNDEFINED for ROLE_UNDEFINED
+     */
+    ATTRIBUTE_NO_DISCARD inline int Health(ROLE_t role) const noexcept {
+        return m_health[Row(role)];
+    }
+
+    /**
+     * @brief Damage
+     *
+     * @param role ROLE_UNDEFINED or a role of the catalog
+     * @return The damage of the role, 0 for ROLE_UNDEFINED
+     */
+    ATTRIBUTE_NO_DISCARD inline int Damage(ROLE_t role) const noexcept {
+        return m_damage[Row(role)];
+    }
+
+    /**
+     * @brief AttackInterval
+     *
+     * @param role ROLE_UNDEFINED or a role of the catalog
+     * @return The time between two attacks in milliseconds, 0 for the
+     *         roles not attacking by themselves
+     */
+    ATTRIBUTE_NO_DISCARD inline int AttackInterval(ROLE_t role) const noexcept {
+        return m_interval[Row(role)];
+    }
+
+    /**
+     * @brief AreEnemies
+     *
+     * @param role ROLE_UNDEFINED or a role of the catalog
+     * @param other ROLE_UNDEFINED or a role of the catalog
+     * @return true if a fighter of the role may attack one of the other
+     *         role, or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD inline bool AreEnemies(ROLE_t role, ROLE_t other) const noexcept {
+        return ((m_enemies[Row(role)] >> Row(other)) & 1U) != 0;
+    }
+
+    /**
+     * @brief Name
+     *
+     * @param role ROLE_UNDEFINED or a role of the catalog
+     * @return The name of the role as a C string, "Undefined" for
+     *         ROLE_UNDEFINED
+     */
+    ATTRIBUTE_NO_DISCARD inline const char* Name(ROLE_t role) const noexcept {
+        return m_names[Row(role)].data();
+    }
+
+private:
+    static constexpr std::size_t ROWS = ROLE_CAPACITY + 1;
+    static_assert((ROWS & (ROWS - 1)) == 0, "the rows are masked");
+
+    // the mask keeps any id inside the tables, e.g the roles of a batch
+    // written from python: ids unknown to the catalog get an unspecified row
+    ATTRIBUTE_NO_DISCARD static constexpr std::size_t Row(ROLE_t role) noexcept {
+        return static_cast<std::size_t>(role + 1) & (ROWS - 1);
+    }
+
+    constexpr void Erase() noexcept {
+        for(std::size_t row = 0; row < ROWS; ++row){
+            m_health[row] = HEALTH_UNDEFINED;
+            m_damage[row] = 0;
+            m_interval[row] = 0;
+            m_enemies[row] = 0;
+            m_names[row] = {};
+        }
+        Set(ROLE_UNDEFINED, Fighter::RoleName(ROLE_UNDEFINED), HEALTH_UNDEFINED, 0, 0);
+    }
+
+    constexpr void Set(ROLE_t role, std::string_view name, int health,
+                       int damage, int interval) noexcept {
+        const std::size_t row = Row(role);
+        m_health[row] = health;
+        m_damage[row] = damage;
+        m_interval[row] = interval;
+        m_names[row] = {};
+        for(std::size_t i = 0; i < name.size() && i + 1 < ROLE_NAME_SIZE; ++i){
+            m_names[row][i] = name[i];
+        }
+    }
+
+    static RoleCatalog s_instance;
+
+    // the tables of the attack path first, on their own cache lines
+    alignas(CACHE_LINE_SIZE) std::array<std::uint64_t, ROWS> m_enemies{};
+    alignas(CACHE_LINE_SIZE) std::array<int, ROWS> m_health{};
+    std::array<int, ROWS> m_damage{};
+    std::array<int, ROWS> m_interval{};
+    std::array<std::array<char, ROLE_NAME_SIZE>, ROWS> m_names{};
+    std::size_t m_size{0};
+    bool m_builtin{true};
+    std::size_t m_error_line{0};
+};
+
+#endif // ROLE_CATALOG_H
@@ -0,0 +1,183 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "fighter.h"
+
+/**
+ * @brief Strategy of the simulated player controlling the Hero
+ */
+using HERO_POLICY_t = enum HERO_POLICY {
+    POLICY_ORC_FIRST,     // attack the orc until it dies, then the dragon
+    POLICY_DRAGON_FIRST,  // attack the dragon until it dies, then the orc
+    POLICY_SCRIPTED,      // replay a list of commands, then stay idle
+};
+
+
+/**
+ * @brief Parameters of a simulated battle
+ *
+ * All times are given in milliseconds of the simulated clock.
+ */
+struct BattleConfig {
+    HERO_POLICY_t policy{POLICY_ORC_FIRST};
+    int hero_interval{1000};  // time the player needs to enter a command
+    int hero_jitter{0};       // random extra delay added to each command
+    int orc_interval{ORC_ATTACK_INTERVAL};
+    int dragon_interval{DRAGON_ATTACK_INTERVAL};
+    std::vector<ROLE_t> script; // targets of the commands (POLICY_SCRIPTED)
+
+    // balance values, the ones of the game by default
+    int hero_health{HEALTH_HERO};
+    int orc_health{HEALTH_ORC};
+    int dragon_health{HEALTH_DRAGON};
+    int hero_damage{Fighter::RoleDamage(ROLE_HERO)};
+    int orc_damage{Fighter::RoleDamage(ROLE_ORC)};
+    int dragon_damage{Fighter::RoleDamage(ROLE_DRAGON)};
+};
+
+
+/**
+ * @brief Outcome of a single simulated battle
+ */
+struct BattleResult {
+    bool hero_wins{false};
+    long long duration{0};    // simulated time at game over, in milliseconds
+    int hero_health{HEALTH_UNDEFINED};
+    int hero_hits{0};
+    int monster_hits{0};
+};
+
+
+/**
+ * @brief Aggregated outcome of a batch of simulated battles
+ */
+struct BattleStatistics {
+    std::size_t battles{0};
+    std::size_t wins{0};
+    long long total_duration{0};
+    long long hero_hits{0};
+    long long monster_hits{0};
+};
+
+
+/**
+ * @brief Class BattleSession
+ *
+ * A Hero vs Orc and Dragon battle processed one event at a time: each call
+ * to Step() runs the next command of the hero or the next monster attack.
+ * Many sessions can thus be interleaved, e.g as short tasks of a thread
+ * pool. The rules and the order of the events are those of
+ * SimulateBattle().
+ */
+class BattleSession {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param config the parameters of the battle, which must outlive
+     *        the session
+     * @param seed the seed of the random generator used for the hero jitter
+     */
+    BattleSession(const BattleConfig& config, std::uint32_t seed) noexcept;
+
+    /**
+     * @brief Step
+     *
+     * Process the next event of the battle
+     *
+     * @return true if the battle goes on, or false once it is over
+     */
+    bool Step() noexcept;
+
+    /**
+     * @brief A getter
+     *
+     * @return true once the battle is over
+     */
+    ATTRIBUTE_NO_DISCARD inline bool Over() const noexcept {
+        return m_over;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The outcome of the battle, final once it is over
+     */
+    ATTRIBUTE_NO_DISCARD inline const BattleResult& Result() const noexcept {
+        return m_result;
+    }
+
+private:
+    long long HeroDelay() noexcept;
+
+    const BattleConfig* m_config;
+    Hero m_hero{ROLE_HERO};
+    Orc m_orc{ROLE_ORC};
+    Dragon m_dragon{ROLE_DRAGON};
+    std::minstd_rand m_generator;
+    std::uniform_int_distribution<int> m_jitter;
+    BattleResult m_result;
+    std::size_t m_command_index{0};
+    bool m_hero_idle;
+    bool m_over{false};
+    long long m_hero_time;
+    long long m_orc_time;
+    long long m_dragon_time;
+};
+
+
+/**
+ * @brief SimulateBattle
+ *
+ * Run a complete Hero vs Orc and Dragon battle against a simulated clock.
+ * The rules are the ones of Fighter::Hit(), but no time is spent waiting:
+ * the clock jumps from one attack to the next. Events occurring at the same
+ * time are processed in the order Hero, Orc, Dragon.
+ *
+ * @param config the parameters of the battle
+ * @param seed the seed of the random generator used for the hero jitter
+ * @return The outcome of the battle
+ */
+BattleResult SimulateBattle(const BattleConfig& config,
+                            std::uint32_t seed = 0) noexcept;
+
+/**
+ * @brief AddResult
+ *
+ * Aggregate the outcome of a battle into statistics
+ *
+ * @param stats the statistics to be updated
+ * @param result the outcome of a battle
+ */
+void AddResult(BattleStatistics& stats, const BattleResult& result) noexcept;
+
+/**
+ * @brief RunBattles
+ *
+ * Simulate several battles in a row, each with its own seed derived
+ * from the given one, and aggregate their outcomes.
+ *
+ * @param config the parameters shared by all battles
+ * @param count the number of battles to simulate
+ * @param seed the seed of the first battle
+ * @return The aggregated outcome of all battles
+ */
+BattleStatistics RunBattles(const BattleConfig& config, std::size_t count,
+                            std::uint32_t seed = 0) noexcept;
+
+/**
+ * @brief ParseCommand
+ *
+ * Translate a command of the player, e.g "Attack Orc", into the role of the
+ * targeted monster, with ParseHeroCommand().
+ *
+ * @param command the command entered by the player
+ * @return The targeted role, or ROLE_UNDEFINED for an unknown command
+ */
+ROLE_t ParseCommand(const char* command) noexcept;
+
+#endif // SIMULATION_H
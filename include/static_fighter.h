@@ -0,0 +1,269 @@
+#ifndef STATIC_FIGHTER_H
+#define STATIC_FIGHTER_H
+
+#include <type_traits>
+#include <variant>
+#include "combat_log.h"
+#include "fighter.h"
+#include "metrics.h"
+
+
+/**
+ * @brief Class StaticFighter
+ *
+ * A fighter whose role is a template parameter: the same rules as Fighter,
+ * Hero and Monster, but without any virtual function. The damage, the start
+ * health and the enemies of a role are constants, so that an attack can be
+ * fully inlined. A StaticFighter only holds its health points, and a
+ * container of fighters of one role does not store any vptr.
+ *
+ * Unlike Fighter, the health points are not atomic: a StaticFighter must
+ * not be attacked by several threads at once. A killed fighter gets
+ * undefined health points, and its role reads as ROLE_UNDEFINED afterwards,
+ * as Fighter::Reset() does.
+ *
+ * The kills and the rejected attacks are counted in the Metrics, as by
+ * Fighter. Two things differ on purpose: the rules are the built-in ones,
+ * whatever RoleCatalog is loaded, and the attacks are never recorded by
+ * the ReplayRecorder, which only knows the registered Fighter objects.
+ *
+ * @tparam ROLE the role of the fighter
+ */
+template<ROLE_t ROLE>
+class StaticFighter {
+public:
+    /**
+     * @brief Default Constructor
+     *
+     * A fighter with the start health of its role.
+     */
+    constexpr StaticFighter() noexcept = default;
+
+    /**
+     * @brief Constructor from health
+     *
+     * @param health the health points of the fighter
+     */
+    explicit constexpr StaticFighter(const int health) noexcept
+    : m_health{health} {}
+
+    /**
+     * @brief A getter
+     *
+     * @return The role of the fighter, ROLE_UNDEFINED once killed
+     */
+    ATTRIBUTE_NO_DISCARD constexpr ROLE_t GetRole() const noexcept {
+        return (m_health == HEALTH_UNDEFINED) ? ROLE_UNDEFINED : ROLE;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The health points of the fighter
+     */
+    ATTRIBUTE_NO_DISCARD constexpr int GetHealth() const noexcept {
+        return m_health;
+    }
+
+    /**
+     * @brief A setter
+     *
+     * @param health_points the health points to be set
+     */
+    constexpr void SetHealth(const int health_points) noexcept {
+        m_health = health_points;
+    }
+
+    /**
+     * @brief IsAlive
+     *
+     * @return true if the fighter is alive or false otherwise
+     */
+    ATTRIBUTE_NO_DISCARD constexpr bool IsAlive() const noexcept {
+        return m_health > HEALTH_DEAD;
+    }
+
+    /**
+     * @brief Damage
+     *
+     * @return The damage dealt by the fighter, see Fighter::RoleDamage()
+     */
+    ATTRIBUTE_NO_DISCARD static constexpr int Damage() noexcept {
+        return Fighter::RoleDamage(ROLE);
+    }
+
+    /**
+     * @brief CanAttack
+     *
+     * Check if the fighter can attack another one. Fighters of roles which
+     * are not enemies are rejected at compile time.
+     *
+     * @param other the fighter to be checked
+     * @return true if the other is an enemy and both are alive
+     */
+    template<ROLE_t OTHER>
+    ATTRIBUTE_NO_DISCARD constexpr bool CanAttack(
+        const StaticFighter<OTHER>& other) const noexcept {
+        if constexpr( !Fighter::RolesAreEnemies(ROLE, OTHER) ){
+            return false;
+        }
+        else{
+            return IsAlive() && other.IsAlive();
+        }
+    }
+
+    /**
+     * @brief TakeDamage()
+     *
+     * Remove health points from a living fighter
+     *
+     * @param damage the number of health points to be removed
+     * @param health_after receives the health points right after the
+     *        damage, before a possible reset
+     * @return true if the fighter was alive and got damaged, false otherwise
+     */
+    constexpr bool TakeDamage(const int damage, int& health_after) noexcept {
+        if(m_health <= HEALTH_DEAD){
+            return false;
+        }
+        health_after = m_health - damage;
+        m_health = (health_after <= HEALTH_DEAD) ? int{HEALTH_UNDEFINED}
+                                                 : health_after;
+        return true;
+    }
+
+    /**
+     * @brief Hit()
+     *
+     * Same as Fighter::Hit(): attack without any output, with the
+     * built-in rules and without any replay
+     *
+     * @param other the fighter to be hit
+     * @return true if the attack occurred, or false otherwise
+     */
+    template<ROLE_t OTHER>
+    constexpr bool Hit(StaticFighter<OTHER>& other) const noexcept {
+        int health_after{0};
+        const bool hit = CanAttack(other) && other.TakeDamage(Damage(), health_after);
+        if( !std::is_constant_evaluated() ){
+            Metrics::CountOutcome(GetRole(), hit, health_after);
+        }
+        return hit;
+    }
+
+    /**
+     * @brief Attack()
+     *
+     * Same as Hero::Attack() and Monster::Attack(), with the built-in
+     * rules and without any replay: the hit is written to the CombatLog
+     *
+     * @param other the fighter to be attacked
+     */
+    template<ROLE_t OTHER>
+    void Attack(StaticFighter<OTHER>& other) const noexcept {
+        int health{0};
+        const bool hit = CanAttack(other) && other.TakeDamage(Damage(), health);
+        Metrics::CountOutcome(GetRole(), hit, health);
+        if(hit){
+            CombatLog::Instance().LogHit(ROLE, OTHER, health);
+        }
+    }
+
+    /**
+     * @brief Print
+     *
+     * Same as Fighter::Print()
+     */
+    void Print() const noexcept {
+        CombatLog::Instance().LogFighter(GetRole(), m_health);
+    }
+
+private:
+    int m_health{Fighter::RoleHealth(ROLE)};
+};
+
+using StaticUndefined = StaticFighter<ROLE_UNDEFINED>;
+using StaticHero = StaticFighter<ROLE_HERO>;
+using StaticOrc = StaticFighter<ROLE_ORC>;
+using StaticDragon = StaticFighter<ROLE_DRAGON>;
+
+
+/**
+ * @brief A fighter of any role, dispatched with std::visit
+ *
+ * The counterpart of a Fighter pointer for mixed containers: the role is
+ * given by the index of the alternative instead of a vptr.
+ */
+using AnyFighter = std::variant<StaticUndefined, StaticHero, StaticOrc,
+                                StaticDragon>;
+
+/**
+ * @brief MakeFighter
+ *
+ * @param role the role of the fighter to be created
+ * @return A new fighter of the given role, with the start health of the role
+ */
+AnyFighter MakeFighter(ROLE_t role) noexcept;
+
+/**
+ * @brief GetRole
+ *
+ * @param fighter the fighter to be queried
+ * @return The role of the fighter, ROLE_UNDEFINED once killed
+ */
+inline ROLE_t GetRole(const AnyFighter& fighter) noexcept
+{
+    return std::visit([](const auto& self) { return self.GetRole(); }, fighter);
+}
+
+/**
+ * @brief GetHealth
+ *
+ * @param fighter the fighter to be queried
+ * @return The health points of the fighter
+ */
+inline int GetHealth(const AnyFighter& fighter) noexcept
+{
+    return std::visit([](const auto& self) { return self.GetHealth(); }, fighter);
+}
+
+/**
+ * @brief Hit
+ *
+ * Same as StaticFighter::Hit(), dispatched on the roles of both fighters
+ *
+ * @param attacker the attacking fighter
+ * @param target the fighter to be hit
+ * @return true if the attack occurred, or false otherwise
+ */
+inline bool Hit(const AnyFighter& attacker, AnyFighter& target) noexcept
+{
+    return std::visit([](const auto& self, auto& other) { return self.Hit(other); },
+                      attacker, target);
+}
+
+/**
+ * @brief Attack
+ *
+ * Same as StaticFighter::Attack(), dispatched on the roles of both
+ * fighters
+ *
+ * @param attacker the attacking fighter
+ * @param target the fighter to be attacked
+ */
+inline void Attack(const AnyFighter& attacker, AnyFighter& target) noexcept
+{
+    std::visit([](const auto& self, auto& other) { self.Attack(other); },
+               attacker, target);
+}
+
+/**
+ * @brief Print
+ *
+ * Same as Fighter::Print()
+ *
+ * @param fighter the fighter to be printed
+ */
+void Print(const AnyFighter& fighter) noexcept;
+
+#endif // STATIC_FIGHTER_H
@@ -0,0 +1,213 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "fighter.h"
+
+using TimerId = std::uint32_t;
+constexpr TimerId INVALID_TIMER = std::numeric_limits<TimerId>::max();
+
+
+/**
+ * @brief Class TimingWheel
+ *
+ * A hierarchical timing wheel for a huge number of timers, e.g the attack
+ * cooldowns of millions of monsters. Time is counted in ticks (one tick is
+ * one millisecond for the game). Four levels of 256 slots cover 2^32 ticks,
+ * later timers wait in an overflow list. Timers are nodes of a pool linked
+ * into the slots by index, so that insert, cancel and expire are O(1).
+ *
+ * Each timer carries a 32 bit payload, e.g the index of a monster. All the
+ * timers due on the same tick are handed over together to the handler of
+ * Advance().
+ */
+class TimingWheel {
+public:
+    /**
+     * @brief Constructor
+     *
+     * @param now the current tick of the wheel
+     */
+    explicit TimingWheel(long long now = 0) noexcept;
+
+    /**
+     * @brief Insert
+     *
+     * Add a timer. A timer due at or before the current tick expires on
+     * the next tick.
+     *
+     * @param expiry the tick on which the timer expires
+     * @param payload the value handed over to Advance() on expiry
+     * @return The identifier of the timer, valid until it expires or is
+     *         cancelled
+     */
+    TimerId Insert(long long expiry, std::uint32_t payload);
+
+    /**
+     * @brief Cancel
+     *
+     * Remove a pending timer
+     *
+     * @param id the identifier returned by Insert()
+     * @return true if the timer was pending, or false otherwise
+     */
+    bool Cancel(TimerId id) noexcept;
+
+    /**
+     * @brief Advance
+     *
+     * Move the wheel forward to a given tick. For each tick with expired
+     * timers, the handler is called once with the tick and the payloads of
+     * all timers expiring on it. The handler may insert new timers.
+     *
+     * @tparam Handler a callable taking a long long and a
+     *         const std::vector<std::uint32_t>&
+     * @param now the tick to advance to
+     * @param handler the function processing the expired timers
+     * @return The number of expired timers
+     */
+    template<typename Handler>
+    std::size_t Advance(long long now, Handler&& handler);
+
+    /**
+     * @brief Reserve
+     *
+     * Allocate memory for a given number of timers
+     *
+     * @param count the number of timers
+     */
+    void Reserve(std::size_t count);
+
+    /**
+     * @brief NextTick
+     *
+     * Find the next tick on which timers expire or are cascaded: a caller
+     * sleeping until then never misses a timer
+     *
+     * @return The next tick with something to do
+     */
+    ATTRIBUTE_NO_DISCARD long long NextTick() const noexcept;
+
+    /**
+     * @brief A getter
+     *
+     * @return The current tick of the wheel
+     */
+    ATTRIBUTE_NO_DISCARD inline long long Now() const noexcept {
+        return m_now;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of pending timers
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Size() const noexcept {
+        return m_size;
+    }
+
+private:
+    static constexpr int SLOT_BITS = 8;
+    static constexpr int LEVELS = 4;
+    static constexpr std::size_t SLOTS = std::size_t{1} << SLOT_BITS;
+    static constexpr std::uint32_t SLOT_MASK = SLOTS - 1;
+    static constexpr std::uint32_t NIL = INVALID_TIMER;
+    static constexpr std::uint16_t OVERFLOW_LIST = LEVELS * SLOTS;
+    static constexpr std::uint16_t FREE_NODE = OVERFLOW_LIST + 1;
+
+    struct Node {
+        long long expiry;
+        std::uint32_t payload;
+        std::uint32_t next;
+        std::uint32_t prev;
+        std::uint16_t list; // slot index, OVERFLOW_LIST or FREE_NODE
+    };
+
+    void Link(std::uint32_t index) noexcept;
+    void Unlink(std::uint32_t index) noexcept;
+    void Cascade(int level) noexcept;
+    std::uint32_t Detach(std::uint16_t list) noexcept;
+    void Release(std::uint32_t index) noexcept;
+
+    std::vector<Node> m_nodes;
+    std::array<std::uint32_t, LEVELS * SLOTS + 1> m_heads{};
+    std::array<std::uint64_t, LEVELS * SLOTS / 64> m_occupied{}; // non empty slots
+    std::uint32_t m_free{NIL};
+    std::size_t m_size{0};
+    long long m_now{0};
+    std::vector<std::uint32_t> m_batch;
+};
+
+
+template<typename Handler>
+std::size_t TimingWheel::Advance(const long long now, Handler&& handler)
+{
+    std::size_t expired{0};
+    while(m_now < now)
+    {
+        if(m_size == 0){
+            m_now = now; // nothing to expire: jump directly
+            break;
+        }
+
+        // skip the ticks on which nothing happens
+        const long long next_tick = NextTick();
+        if(next_tick > now){
+            m_now = now;
+            break;
+        }
+        m_now = next_tick;
+
+        const auto tick = static_cast<std::uint64_t>(m_now);
+        // when the lower levels wrap around, the timers of the next slot of
+        // the upper levels move down, the highest level first
+        int level{0};
+        while(level < LEVELS &&
+              (tick & ((std::uint64_t{1} << (SLOT_BITS * (level + 1))) - 1)) == 0){
+            ++level;
+        }
+        for(int upper = level; upper >= 1; --upper){
+            Cascade(upper);
+        }
+
+        std::uint32_t index = Detach(static_cast<std::uint16_t>(tick & SLOT_MASK));
+        if(index == NIL){
+            continue;
+        }
+
+        m_batch.clear();
+        while(index != NIL){
+            const std::uint32_t next = m_nodes[index].next;
+            m_batch.push_back(m_nodes[index].payload);
+            Release(index);
+            index = next;
+        }
+        expired += m_batch.size();
+        handler(m_now, std::as_const(m_batch));
+    }
+    return expired;
+}
+
+
+/**
+ * @brief RunMonsterCooldowns
+ *
+ * Same battle as RunMonsterActions(), but the attack cooldowns of the
+ * monsters are kept in a TimingWheel: all the monsters ready on the same
+ * tick attack together. Attacks are silent (Fighter::Hit()).
+ *
+ * @param hero the Hero of the game
+ * @param monsters the monsters fighting against the hero
+ * @param end_time receives the time of the last attack, in milliseconds
+ * @return The number of attacks that occurred
+ */
+std::size_t RunMonsterCooldowns(Hero& hero,
+                                const std::vector<const Monster*>& monsters,
+                                long long& end_time);
+
+#endif // TIMING_WHEEL_H
@@ -0,0 +1,154 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "fighter.h"
+#include "simulation.h"
+
+
+/**
+ * @brief Activity of a worker of a WorkStealingPool
+ */
+struct WorkerStatistics {
+    std::size_t tasks{0};     // tasks executed by the worker
+    std::size_t steals{0};    // tasks taken from the deque of another worker
+    double busy_seconds{0.0}; // time spent running tasks
+    double utilization{0.0};  // busy time over the elapsed time
+};
+
+
+/**
+ * @brief Class WorkStealingPool
+ *
+ * A fixed set of worker threads, each with its own deque of tasks. A worker
+ * runs the tasks of its own deque last in first out, and when it is empty
+ * steals the oldest task of another worker chosen at random. Tasks
+ * submitted by a task go to the deque of the worker running it, other
+ * tasks are spread over the workers in turn.
+ *
+ * Tasks must not throw.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Constructor
+     *
+     * Start the workers
+     *
+     * @param workers the number of worker threads, 0 for one per core
+     */
+    explicit WorkStealingPool(std::size_t workers = 0);
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief The destructor
+     *
+     * Run the remaining tasks and stop the workers
+     */
+    ~WorkStealingPool();
+
+    /**
+     * @brief Submit
+     *
+     * Queue a task
+     *
+     * @param task the task to be run by a worker
+     */
+    void Submit(Task task);
+
+    /**
+     * @brief Wait
+     *
+     * Block until all submitted tasks, and the tasks they submitted,
+     * are done. Must not be called from a task.
+     */
+    void Wait();
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of worker threads
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t Workers() const noexcept {
+        return m_workers.size();
+    }
+
+    /**
+     * @brief Statistics
+     *
+     * @return The activity of each worker since the construction of the pool
+     *         or the last call to ResetStatistics()
+     */
+    ATTRIBUTE_NO_DISCARD std::vector<WorkerStatistics> Statistics() const;
+
+    /**
+     * @brief ResetStatistics
+     *
+     * Restart the counters of all workers
+     */
+    void ResetStatistics();
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Worker {
+        std::mutex mutex; // protects tasks
+        std::deque<Task> tasks;
+        std::atomic<std::size_t> executed{0};
+        std::atomic<std::size_t> steals{0};
+        std::atomic<long long> busy_ns{0};
+        std::thread thread;
+    };
+
+    void Run(std::size_t index);
+    bool Pop(std::size_t index, Task& task);
+    bool Steal(std::size_t index, std::uint32_t& random, Task& task);
+    void Finish() noexcept;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_queued{0};  // in deques
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_pending{0}; // not done
+    std::atomic<std::size_t> m_sleeping{0};
+    std::atomic<std::size_t> m_next{0}; // worker receiving the next outer task
+    std::atomic<bool> m_stop{false};
+    std::atomic<std::chrono::steady_clock::rep> m_statistics_start{0};
+
+    std::mutex m_mutex; // used to sleep and to wait for completion
+    std::condition_variable m_wakeup;
+    std::condition_variable m_done;
+};
+
+
+/**
+ * @brief RunSessions
+ *
+ * Same as RunBattles(), but the battles are BattleSession run concurrently
+ * by a pool. Each task processes a few events of a session, then submits
+ * the session again, so that thousands of battles progress side by side.
+ *
+ * @param pool the pool running the sessions
+ * @param config the parameters shared by all battles
+ * @param count the number of battles to simulate
+ * @param seed the seed of the first battle
+ * @param events_per_task the number of events processed by a task
+ * @return The aggregated outcome of all battles
+ */
+BattleStatistics RunSessions(WorkStealingPool& pool,
+                             const BattleConfig& config,
+                             std::size_t count,
+                             std::uint32_t seed = 0,
+                             std::size_t events_per_task = 1);
+
+#endif // WORK_STEALING_POOL_H
@@ -0,0 +1,248 @@
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "fighter.h"
+#include "fighter_batch.h"
+
+/*
+ * Binary snapshot of a world, version 1. All values are little endian.
+ *
+ *   offset  size  content
+ *        0     8  magic "SCGWORLD"
+ *        8     2  format version
+ *       10     2  header size, the offset of the first section
+ *       12     4  flags: bit 0 game over, bit 1 hero wins
+ *       16     8  number of fighters N
+ *       24     8  number of timers T
+ *       32     8  simulated clock, in milliseconds
+ *       40     8  number of events processed so far
+ *       48     8  checksum of the sections
+ *       56     8  size of the sections, in bytes
+ *
+ * The sections follow the header, each one padded with zeros to a multiple
+ * of 8 bytes: the roles (N int32), the health points (N int32) and the
+ * timers (T SnapshotTimer). The checksum is FNV-1a over the sections read
+ * as 64 bit words.
+ */
+
+// Version written by WriteSnapshot(), and the only one read
+constexpr std::uint16_t SNAPSHOT_VERSION = 1;
+constexpr std::size_t SNAPSHOT_HEADER_SIZE = 64;
+
+/**
+ * @brief Outcome of a snapshot operation
+ */
+using SNAPSHOT_STATUS_t = enum SNAPSHOT_STATUS {
+    SNAPSHOT_OK,
+    SNAPSHOT_IO_ERROR,       // the file could not be opened, read or written
+    SNAPSHOT_BAD_FORMAT,     // not a snapshot, or a truncated one
+    SNAPSHOT_BAD_VERSION,    // a snapshot of another format version
+    SNAPSHOT_BAD_CHECKSUM,   // a corrupted snapshot
+    SNAPSHOT_BAD_BYTE_ORDER, // zero copy view requested on a big endian host
+};
+
+
+/**
+ * @brief A pending attack of a fighter, as stored in a snapshot
+ */
+struct SnapshotTimer {
+    std::int64_t time{0};       // simulated time in milliseconds
+    std::uint64_t actor{0};     // index of the fighter
+    std::uint64_t sequence{0};  // scheduling order
+};
+static_assert(sizeof(SnapshotTimer) == 24, "timers are stored as 3 words");
+
+
+/**
+ * @brief Everything needed to resume a battle
+ */
+struct WorldState {
+    std::int64_t clock{0};
+    std::uint64_t steps{0};
+    bool over{false};
+    bool hero_wins{false};
+    FighterBatch fighters;
+    std::vector<SnapshotTimer> timers;
+};
+
+
+/**
+ * @brief WriteSnapshot
+ *
+ * Write a world to a file in a single pass
+ *
+ * @param world the world to be saved
+ * @param path the path to the snapshot file, replaced if it exists
+ * @return SNAPSHOT_OK, or SNAPSHOT_IO_ERROR
+ */
+SNAPSHOT_STATUS_t WriteSnapshot(const WorldState& world, const char* path);
+
+/**
+ * @brief ReadSnapshot
+ *
+ * Load a snapshot into a world, copying its content
+ *
+ * @param path the path to the snapshot file
+ * @param world the world receiving the content of the snapshot
+ * @return SNAPSHOT_OK, or the reason why the world was left unchanged
+ */
+SNAPSHOT_STATUS_t ReadSnapshot(const char* path, WorldState& world);
+
+
+/**
+ * @brief Class MappedSnapshot
+ *
+ * A read only view of a snapshot file mapped into memory. The arrays of
+ * roles, health points and timers point directly into the mapping: opening
+ * a snapshot costs neither allocations nor copies, pages are loaded on
+ * first access. The view requires a little endian host.
+ */
+class MappedSnapshot {
+public:
+    MappedSnapshot() noexcept = default;
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+    /**
+     * @brief The destructor
+     *
+     * Unmap the snapshot
+     */
+    ~MappedSnapshot();
+
+    /**
+     * @brief Open
+     *
+     * Map a snapshot file, replacing the snapshot viewed so far
+     *
+     * @param path the path to the snapshot file
+     * @param verify whether to check the checksum, which reads every page
+     * @return SNAPSHOT_OK, or the reason why nothing is viewed
+     */
+    SNAPSHOT_STATUS_t Open(const char* path, bool verify = true);
+
+    /**
+     * @brief Close
+     *
+     * Unmap the snapshot, the arrays returned so far become invalid
+     */
+    void Close() noexcept;
+
+    /**
+     * @brief Restore
+     *
+     * Copy the viewed snapshot into a world
+     *
+     * @param world the world receiving the content of the snapshot
+     */
+    void Restore(WorldState& world) const;
+
+    /**
+     * @brief A getter
+     *
+     * @return true if a snapshot is viewed
+     */
+    ATTRIBUTE_NO_DISCARD inline bool IsOpen() const noexcept {
+        return m_data != nullptr;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of fighters of the snapshot
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t FighterCount() const noexcept {
+        return m_fighter_count;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The roles of the fighters, inside the mapping
+     */
+    ATTRIBUTE_NO_DISCARD inline const int* Roles() const noexcept {
+        return m_roles;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The health points of the fighters, inside the mapping
+     */
+    ATTRIBUTE_NO_DISCARD inline const int* Health() const noexcept {
+        return m_health;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of pending attacks of the snapshot
+     */
+    ATTRIBUTE_NO_DISCARD inline std::size_t TimerCount() const noexcept {
+        return m_timer_count;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The pending attacks, inside the mapping
+     */
+    ATTRIBUTE_NO_DISCARD inline const SnapshotTimer* Timers() const noexcept {
+        return m_timers;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The simulated time of the snapshot, in milliseconds
+     */
+    ATTRIBUTE_NO_DISCARD inline std::int64_t Clock() const noexcept {
+        return m_clock;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return The number of events processed before the snapshot
+     */
+    ATTRIBUTE_NO_DISCARD inline std::uint64_t Steps() const noexcept {
+        return m_steps;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return true if the battle of the snapshot is over
+     */
+    ATTRIBUTE_NO_DISCARD inline bool Over() const noexcept {
+        return m_over;
+    }
+
+    /**
+     * @brief A getter
+     *
+     * @return true if the hero of the snapshot won the battle
+     */
+    ATTRIBUTE_NO_DISCARD inline bool HeroWins() const noexcept {
+        return m_hero_wins;
+    }
+
+private:
+    const unsigned char* m_data{nullptr};
+    std::size_t m_size{0};
+    std::vector<unsigned char> m_buffer; // used where mmap is not available
+    std::size_t m_fighter_count{0};
+    std::size_t m_timer_count{0};
+    const int* m_roles{nullptr};
+    const int* m_health{nullptr};
+    const SnapshotTimer* m_timers{nullptr};
+    std::int64_t m_clock{0};
+    std::uint64_t m_steps{0};
+    bool m_over{false};
+    bool m_hero_wins{false};
+};
+
+#endif // WORLD_SNAPSHOT_H
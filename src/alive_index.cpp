@@ -0,0 +1,275 @@
+#include "alive_index.h"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// Bits of a word of the bitsets
+constexpr std::size_t WORD_BITS = 64;
+
+
+/**
+ * @brief Read a word of a bitset written by another thread
+ *
+ * @param word the word of the bitset
+ * @return The value of the word
+ */
+static inline std::uint64_t load_word(const std::uint64_t& word) noexcept
+{
+    // atomic_ref of a const object comes with C++26: the word is only read
+    return std::atomic_ref<std::uint64_t>(
+        const_cast<std::uint64_t&>(word)).load(std::memory_order_acquire); // NOLINT
+}
+
+/**
+ * @brief Write a word of a bitset read by other threads
+ *
+ * @param word the word of the bitset
+ * @param value the value of the word
+ */
+static inline void store_word(std::uint64_t& word, const std::uint64_t value) noexcept
+{
+    std::atomic_ref<std::uint64_t>(word).store(value, std::memory_order_release);
+}
+
+
+//=============================================================================
+//
+//                    Implementations for the class AliveIndex
+//
+//=============================================================================
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::~AliveIndex()
+//
+AliveIndex::~AliveIndex()
+{
+    Clear();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::Add()
+//
+std::size_t AliveIndex::Add(Fighter& fighter)
+{
+    const std::size_t slot = m_fighters.size();
+    m_fighters.push_back(&fighter);
+    m_member.push_back(FACTION_NONE);
+    m_position.push_back(0);
+    for(Faction& faction : m_factions){
+        faction.alive.resize(slot / WORD_BITS + 1, 0);
+        // Insert() must not allocate: it runs in the noexcept Remove()
+        if(faction.dense.capacity() < m_fighters.size()){
+            faction.dense.reserve(2 * m_fighters.size());
+        }
+    }
+
+    fighter.m_index = this;
+    fighter.m_slot = slot;
+    Update(slot);
+    return slot;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::Remove(): called by Fighter::Reset()
+//
+void AliveIndex::Remove(const std::size_t slot) noexcept
+{
+    const auto lock = Lock();
+    Erase(slot);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::Unregister(): called by Fighter::~Fighter()
+//
+void AliveIndex::Unregister(const std::size_t slot) noexcept
+{
+    const auto lock = Lock();
+    Erase(slot);
+    m_fighters[slot] = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::Update()
+//
+void AliveIndex::Update(const std::size_t slot) noexcept
+{
+    const Fighter* fighter = m_fighters[slot];
+    const FACTION_t faction = fighter != nullptr && fighter->IsAlive()
+                            ? RoleFaction(fighter->GetRole()) : FACTION_NONE;
+
+    const auto lock = Lock();
+    if(faction != m_member[slot]){
+        Erase(slot);
+        Insert(slot, faction);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::Clear()
+//
+void AliveIndex::Clear() noexcept
+{
+    const auto lock = Lock();
+    for(Fighter* fighter : m_fighters){
+        if(fighter != nullptr){
+            fighter->m_index = nullptr;
+        }
+    }
+    m_fighters.clear();
+    m_member.clear();
+    m_position.clear();
+    for(Faction& faction : m_factions){
+        faction.alive.clear();
+        faction.dense.clear();
+        faction.count.store(0, std::memory_order_release);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::IsAlive()
+//
+bool AliveIndex::IsAlive(const std::size_t slot) const noexcept
+{
+    const std::uint64_t bit = std::uint64_t{1} << (slot % WORD_BITS);
+    for(const Faction& faction : m_factions){
+        if((load_word(faction.alive[slot / WORD_BITS]) & bit) != 0){
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::PopCount()
+//
+std::size_t AliveIndex::PopCount(const FACTION_t faction) const noexcept
+{
+    if(faction == FACTION_NONE){
+        return 0;
+    }
+    std::size_t count{0};
+    for(const std::uint64_t& word : m_factions[static_cast<std::size_t>(faction)].alive){
+        count += static_cast<std::size_t>(std::popcount(load_word(word)));
+    }
+    return count;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::Find()
+//
+std::size_t AliveIndex::Find(const FACTION_t faction, const std::size_t from) const noexcept
+{
+    if(faction == FACTION_NONE || from >= m_fighters.size()){
+        return NO_FIGHTER;
+    }
+    const std::vector<std::uint64_t>& alive = m_factions[static_cast<std::size_t>(faction)].alive;
+
+    // the bits below from are masked out of the first word
+    std::size_t word = from / WORD_BITS;
+    std::uint64_t bits = load_word(alive[word]) & (~std::uint64_t{0} << (from % WORD_BITS));
+    while(bits == 0){
+        if(++word == alive.size()){
+            return NO_FIGHTER;
+        }
+        bits = load_word(alive[word]);
+    }
+    return word * WORD_BITS + static_cast<std::size_t>(std::countr_zero(bits));
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::Target()
+//
+Fighter* AliveIndex::Target(const Fighter& attacker, const std::size_t choice) const noexcept
+{
+    const FACTION_t enemies = EnemyFaction(RoleFaction(attacker.GetRole()));
+    if(enemies == FACTION_NONE){
+        return nullptr;
+    }
+    const Faction& faction = m_factions[static_cast<std::size_t>(enemies)];
+
+    const auto lock = Lock();
+    if(faction.dense.empty()){
+        return nullptr;
+    }
+    return m_fighters[faction.dense[choice % faction.dense.size()]];
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::Lock(): none for a single writer
+//
+std::unique_lock<std::mutex> AliveIndex::Lock() const noexcept
+{
+    return m_single_writer ? std::unique_lock<std::mutex>{m_mutex, std::defer_lock}
+                           : std::unique_lock<std::mutex>{m_mutex};
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::Insert(): with the lock held
+//
+void AliveIndex::Insert(const std::size_t slot, const FACTION_t faction) noexcept
+{
+    m_member[slot] = faction;
+    if(faction == FACTION_NONE){
+        return;
+    }
+    Faction& members = m_factions[static_cast<std::size_t>(faction)];
+
+    // the capacity of the dense list was reserved by Add()
+    m_position[slot] = static_cast<std::uint32_t>(members.dense.size());
+    members.dense.push_back(static_cast<std::uint32_t>(slot));
+    std::uint64_t& word = members.alive[slot / WORD_BITS];
+    store_word(word, word | (std::uint64_t{1} << (slot % WORD_BITS)));
+    members.count.store(members.dense.size(), std::memory_order_release);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AliveIndex::Erase(): with the lock held
+//
+void AliveIndex::Erase(const std::size_t slot) noexcept
+{
+    const FACTION_t faction = m_member[slot];
+    if(faction == FACTION_NONE){
+        return;
+    }
+    m_member[slot] = FACTION_NONE;
+    Faction& members = m_factions[static_cast<std::size_t>(faction)];
+
+    // swap-remove: the last living slot takes the place of the removed one
+    const std::uint32_t position = m_position[slot];
+    const std::uint32_t last = members.dense.back();
+    members.dense[position] = last;
+    m_position[last] = position;
+    members.dense.pop_back();
+
+    std::uint64_t& word = members.alive[slot / WORD_BITS];
+    store_word(word, word & ~(std::uint64_t{1} << (slot % WORD_BITS)));
+    members.count.store(members.dense.size(), std::memory_order_release);
+}
@@ -0,0 +1,173 @@
+#include "balance_sweep.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Balance parameters of a sweep, from the slowest to the fastest varying,
+// and the members of BattleConfig they set
+static constexpr std::size_t PARAMETERS = 9;
+static constexpr SweepRange SweepRanges::* RANGES[PARAMETERS] = {
+    &SweepRanges::hero_health,   &SweepRanges::orc_health,
+    &SweepRanges::dragon_health, &SweepRanges::hero_damage,
+    &SweepRanges::orc_damage,    &SweepRanges::dragon_damage,
+    &SweepRanges::hero_interval, &SweepRanges::orc_interval,
+    &SweepRanges::dragon_interval,
+};
+static constexpr int BattleConfig::* VALUES[PARAMETERS] = {
+    &BattleConfig::hero_health,   &BattleConfig::orc_health,
+    &BattleConfig::dragon_health, &BattleConfig::hero_damage,
+    &BattleConfig::orc_damage,    &BattleConfig::dragon_damage,
+    &BattleConfig::hero_interval, &BattleConfig::orc_interval,
+    &BattleConfig::dragon_interval,
+};
+static constexpr const char* NAMES[PARAMETERS] = {
+    "hero_health", "orc_health", "dragon_health",
+    "hero_damage", "orc_damage", "dragon_damage",
+    "hero_interval", "orc_interval", "dragon_interval",
+};
+
+// Configurations simulated before their CSV lines are written
+static constexpr std::size_t BLOCK_SIZE = 4096;
+
+
+//-----------------------------------------------------------------------------
+//
+//  MergeStatistics(): the OpenMP reduction of the per-thread aggregates
+//
+static void MergeStatistics(BattleStatistics& into,
+                            const BattleStatistics& from) noexcept
+{
+    into.battles += from.battles;
+    into.wins += from.wins;
+    into.total_duration += from.total_duration;
+    into.hero_hits += from.hero_hits;
+    into.monster_hits += from.monster_hits;
+}
+
+#pragma omp declare reduction(merge : BattleStatistics : \
+                              MergeStatistics(omp_out, omp_in))
+
+
+//-----------------------------------------------------------------------------
+//
+//  SweepRange::Count()
+//
+std::size_t SweepRange::Count() const noexcept
+{
+    if(step <= 0 || last < first){
+        return 0;
+    }
+    return static_cast<std::size_t>((last - first) / step) + 1U;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  SweepSize()
+//
+std::size_t SweepSize(const SweepRanges& ranges) noexcept
+{
+    std::size_t size{1};
+    for(const auto range : RANGES){
+        size *= (ranges.*range).Count();
+    }
+    return size;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  SweepEnds()
+//
+bool SweepEnds(const SweepRanges& ranges) noexcept
+{
+    // the ranges only go up: their first values are the smallest
+    for(const auto range : {&SweepRanges::hero_damage, &SweepRanges::orc_damage,
+                            &SweepRanges::dragon_damage, &SweepRanges::hero_interval,
+                            &SweepRanges::orc_interval, &SweepRanges::dragon_interval})
+    {
+        if((ranges.*range).first <= 0){
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  SweepConfig()
+//
+BattleConfig SweepConfig(const BattleConfig& base, const SweepRanges& ranges,
+                         std::size_t index)
+{
+    BattleConfig config{base};
+    for(std::size_t i = PARAMETERS; i-- > 0; )
+    {
+        const SweepRange& range = ranges.*RANGES[i];
+        const std::size_t count = range.Count();
+        config.*VALUES[i] = range.first +
+                            range.step * static_cast<int>(index % count);
+        index /= count;
+    }
+    return config;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  RunSweep()
+//
+BattleStatistics RunSweep(const BattleConfig& base, const SweepRanges& ranges,
+                          const std::size_t battles, const std::uint32_t seed,
+                          std::ostream& csv)
+{
+    for(const auto* name : NAMES){
+        csv << name << ',';
+    }
+    csv << "battles,wins,win_rate,mean_duration,mean_hero_hits,"
+           "mean_monster_hits\n";
+
+    const std::size_t size = SweepSize(ranges);
+    std::vector<BattleStatistics> block(std::min(size, BLOCK_SIZE));
+    BattleStatistics total;
+
+    for(std::size_t start = 0; start < size; start += BLOCK_SIZE)
+    {
+        const std::size_t count = std::min(BLOCK_SIZE, size - start);
+
+        #pragma omp parallel for schedule(dynamic, 16) reduction(merge : total)
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            const BattleConfig config = SweepConfig(base, ranges, start + i);
+            BattleStatistics stats;
+            for(std::size_t battle = 0; battle < battles; ++battle){
+                AddResult(stats, SimulateBattle(
+                    config, seed + static_cast<std::uint32_t>(battle)
+                ));
+            }
+            block[i] = stats;
+            MergeStatistics(total, stats);
+        }
+
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            const BattleConfig config = SweepConfig(base, ranges, start + i);
+            for(const auto value : VALUES){
+                csv << config.*value << ',';
+            }
+            const BattleStatistics& stats = block[i];
+            const auto battle_count = static_cast<double>(
+                stats.battles > 0 ? stats.battles : 1U
+            );
+            csv << stats.battles << ',' << stats.wins << ','
+                << static_cast<double>(stats.wins) / battle_count << ','
+                << static_cast<double>(stats.total_duration) / battle_count << ','
+                << static_cast<double>(stats.hero_hits) / battle_count << ','
+                << static_cast<double>(stats.monster_hits) / battle_count << '\n';
+        }
+    }
+    return total;
+}
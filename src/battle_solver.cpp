@@ -0,0 +1,233 @@
+#include "battle_solver.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+//
+//  BattleSolver::State::operator==()
+//
+bool BattleSolver::State::operator==(const State& other) const noexcept
+{
+    return hero == other.hero && orc == other.orc && dragon == other.dragon &&
+           hero_cooldown == other.hero_cooldown &&
+           orc_cooldown == other.orc_cooldown &&
+           dragon_cooldown == other.dragon_cooldown &&
+           command == other.command;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BattleSolver::StateHash::operator()
+//
+std::size_t BattleSolver::StateHash::operator()(const State& state) const noexcept
+{
+    const int fields[] = {
+        state.hero, state.orc, state.dragon, state.hero_cooldown,
+        state.orc_cooldown, state.dragon_cooldown,
+        static_cast<int>(state.command),
+    };
+
+    // FNV-1a over the fields, then a final mix of the bits
+    std::uint64_t hash{14695981039346656037ULL};
+    for(const int field : fields){
+        hash ^= static_cast<std::uint32_t>(field);
+        hash *= 1099511628211ULL;
+    }
+    hash ^= hash >> 29U;
+    return hash;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Constructor
+//
+BattleSolver::BattleSolver(const BattleConfig& config)
+        : m_config( config )
+{
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BattleSolver::Solve()
+//
+BattleResult BattleSolver::Solve()
+{
+    return Solve(m_config.hero_health, m_config.orc_health,
+                 m_config.dragon_health);
+}
+
+BattleResult BattleSolver::Solve(const int hero_health,
+                                 const int orc_health,
+                                 const int dragon_health)
+{
+    State state{};
+    state.hero = hero_health;
+    state.orc = HitsToKill(orc_health);
+    state.dragon = HitsToKill(dragon_health);
+    state.hero_cooldown = (m_config.policy == POLICY_SCRIPTED &&
+                           m_config.script.empty())
+                        ? NO_ATTACK : m_config.hero_interval;
+    state.orc_cooldown = state.orc > 0 ? m_config.orc_interval : NO_ATTACK;
+    state.dragon_cooldown = state.dragon > 0 ? m_config.dragon_interval
+                                             : NO_ATTACK;
+    state.command = 0;
+
+    // Follow the battle until a known state or its end...
+    std::vector<std::pair<State, Transition>> path;
+    BattleResult result;
+    while(true)
+    {
+        const auto known = m_cache.find(state);
+        if(known != m_cache.end()){
+            result = known->second;
+            break;
+        }
+
+        const State before{state};
+        const Transition transition = Advance(state);
+        path.emplace_back(before, transition);
+        if(transition.over){
+            result.hero_wins = transition.hero_wins;
+            result.hero_health = state.hero;
+            break;
+        }
+    }
+
+    // ... then walk back, caching the outcome of each visited state
+    for(auto step = path.rbegin(); step != path.rend(); ++step)
+    {
+        const Transition& transition = step->second;
+        result.duration += transition.elapsed;
+        result.hero_hits += transition.hero_hit ? 1 : 0;
+        result.monster_hits += transition.monster_hit ? 1 : 0;
+        m_cache.emplace(step->first, result);
+    }
+    return result;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BattleSolver::ClearCache()
+//
+void BattleSolver::ClearCache() noexcept
+{
+    m_cache.clear();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BattleSolver::HitsToKill(): number of hero hits taken by a monster
+//
+int BattleSolver::HitsToKill(const int health) const noexcept
+{
+    if(health <= HEALTH_DEAD){
+        return 0;
+    }
+    return (health - 1) / m_config.hero_damage + 1;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BattleSolver::Advance(): process the next event of a state
+//
+BattleSolver::Transition BattleSolver::Advance(State& state) const noexcept
+{
+    Transition transition;
+
+    // dead monsters never attack again, so they have no events
+    int monster_cooldown{state.orc_cooldown};
+    if(state.dragon_cooldown != NO_ATTACK &&
+       (monster_cooldown == NO_ATTACK || state.dragon_cooldown < monster_cooldown))
+    {
+        monster_cooldown = state.dragon_cooldown;
+    }
+    const bool hero_acts = state.hero_cooldown != NO_ATTACK &&
+                           (monster_cooldown == NO_ATTACK ||
+                            state.hero_cooldown <= monster_cooldown);
+    if(!hero_acts && monster_cooldown == NO_ATTACK){
+        transition.over = true; // nothing can happen any more
+        return transition;
+    }
+
+    transition.elapsed = hero_acts ? state.hero_cooldown : monster_cooldown;
+    for(int* cooldown : {&state.hero_cooldown, &state.orc_cooldown,
+                         &state.dragon_cooldown})
+    {
+        if(*cooldown != NO_ATTACK){
+            *cooldown -= transition.elapsed;
+        }
+    }
+
+    if(hero_acts)
+    {
+        int* target{nullptr};
+        switch(m_config.policy)
+        {
+            case POLICY_ORC_FIRST:
+                target = state.orc > 0 ? &state.orc : &state.dragon;
+                break;
+            case POLICY_DRAGON_FIRST:
+                target = state.dragon > 0 ? &state.dragon : &state.orc;
+                break;
+            case POLICY_SCRIPTED:
+                if(state.command < m_config.script.size()){
+                    const ROLE_t role = m_config.script[state.command];
+                    target = role == ROLE_ORC    ? &state.orc
+                           : role == ROLE_DRAGON ? &state.dragon
+                           : nullptr;
+                }
+                ++state.command;
+                break;
+        }
+        if(target != nullptr && *target > 0 && state.hero > HEALTH_DEAD){
+            --*target;
+            transition.hero_hit = true;
+        }
+
+        state.hero_cooldown = (m_config.policy == POLICY_SCRIPTED &&
+                               state.command >= m_config.script.size())
+                            ? NO_ATTACK : m_config.hero_interval;
+        if(state.orc == 0){
+            state.orc_cooldown = NO_ATTACK;
+        }
+        if(state.dragon == 0){
+            state.dragon_cooldown = NO_ATTACK;
+        }
+        if(state.orc == 0 && state.dragon == 0){
+            transition.over = true;
+            transition.hero_wins = true;
+        }
+    }
+    else
+    {
+        // on a tie, the orc attacks first
+        const bool orc_acts = state.orc_cooldown == 0;
+        if(state.hero > HEALTH_DEAD){
+            state.hero -= orc_acts ? m_config.orc_damage : m_config.dragon_damage;
+            if(state.hero <= HEALTH_DEAD){
+                state.hero = HEALTH_UNDEFINED; // killed fighters are reset
+            }
+            transition.monster_hit = true;
+        }
+        if(orc_acts){
+            state.orc_cooldown = m_config.orc_interval;
+        }
+        else{
+            state.dragon_cooldown = m_config.dragon_interval;
+        }
+    }
+
+    if(state.hero <= HEALTH_DEAD){
+        transition.over = true;
+    }
+    return transition;
+}
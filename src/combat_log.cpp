@@ -0,0 +1,372 @@
+#include "combat_log.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "role_catalog.h"
+
+static_assert(sizeof(CombatRecord) == 16, "binary records must stay compact");
+
+// Time between two batches written by the flusher
+constexpr std::chrono::milliseconds FLUSH_INTERVAL{5};
+
+
+/**
+ * @brief Class CombatLog::Ring
+ *
+ * A lock free ring buffer with a single producer, the thread owning it, and
+ * a single consumer, the flusher.
+ */
+class CombatLog::Ring {
+public:
+    bool Push(const CombatRecord& record) noexcept
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if(tail - m_head.load(std::memory_order_acquire) == CAPACITY){
+            return false;
+        }
+        m_records[tail & (CAPACITY - 1)] = record;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t PopAll(std::vector<CombatRecord>& records)
+    {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        const std::size_t tail = m_tail.load(std::memory_order_acquire);
+        const std::size_t count = tail - head;
+        for(; head != tail; ++head){
+            records.push_back(m_records[head & (CAPACITY - 1)]);
+        }
+        m_head.store(head, std::memory_order_release);
+        return count;
+    }
+
+private:
+    static constexpr std::size_t CAPACITY = 4096; // a power of two
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_head{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_tail{0};
+    std::array<CombatRecord, CAPACITY> m_records{};
+};
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::Instance()
+//
+CombatLog& CombatLog::Instance()
+{
+    // never destroyed: the threads calling exit() while others are still
+    // fighting must not find a destroyed log
+    static auto* const log = new CombatLog(); // NOLINT
+    return *log;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::Start()
+//
+void CombatLog::Start(const LOG_MODE_t mode,
+                      const LOG_OVERFLOW_t overflow,
+                      std::ostream* output)
+{
+    Stop();
+    m_output.store(output, std::memory_order_release);
+    m_overflow.store(overflow, std::memory_order_relaxed);
+    if(mode == LOG_MODE_DIRECT){
+        return;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = true;
+    }
+    m_async_mode = mode;
+    m_flusher = std::thread{&CombatLog::RunFlusher, this};
+    m_mode.store(mode, std::memory_order_release);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::Stop()
+//
+void CombatLog::Stop()
+{
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        if( !m_running ){
+            m_output.store(nullptr, std::memory_order_release);
+            return;
+        }
+        m_running = false;
+    }
+    m_mode.store(LOG_MODE_DIRECT, std::memory_order_release);
+    m_wakeup.notify_all();
+    m_flushed.notify_all();
+    m_flusher.join();
+
+    // messages logged while the flusher was finishing
+    Drain();
+    m_output.store(nullptr, std::memory_order_release);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::Flush()
+//
+void CombatLog::Flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if( !m_running ){
+        lock.unlock();
+        std::ostream* output = m_output.load(std::memory_order_acquire);
+        (output != nullptr ? *output : std::cout).flush();
+        return;
+    }
+
+    const std::uint64_t request = ++m_flush_requests;
+    m_wakeup.notify_all();
+    const auto done = [this, request]() {
+        return m_flush_done >= request || !m_running;
+    };
+    while( !m_flushed.wait_for(lock, FLUSH_INTERVAL, done) ){
+        // the flusher writes at least once per interval
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::LogAttack()
+//
+void CombatLog::LogAttack(const ROLE_t attacker, const ROLE_t target) noexcept
+{
+    Log(LOG_EVENT_ATTACK, attacker, target, HEALTH_UNDEFINED);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::LogHit()
+//
+void CombatLog::LogHit(const ROLE_t attacker, const ROLE_t target,
+                       const int health) noexcept
+{
+    Log(LOG_EVENT_HIT, attacker, target, health);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::LogFighter()
+//
+void CombatLog::LogFighter(const ROLE_t role, const int health) noexcept
+{
+    Log(LOG_EVENT_FIGHTER, role, ROLE_UNDEFINED, health);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::Log()
+//
+void CombatLog::Log(const LOG_EVENT_t event,
+                    const ROLE_t attacker,
+                    const ROLE_t target,
+                    const int health) noexcept
+{
+    CombatRecord record{0, health, event, static_cast<std::int8_t>(attacker),
+                        static_cast<std::int8_t>(target), 0};
+
+    if(Mode() == LOG_MODE_DIRECT){
+        // a single write per message: messages of different threads
+        // are not interleaved
+        thread_local std::string text;
+        text.clear();
+        FormatRecord(record, text);
+        std::ostream* output = m_output.load(std::memory_order_acquire);
+        (output != nullptr ? *output : std::cout)
+            .write(text.data(), static_cast<std::streamsize>(text.size()));
+        return;
+    }
+
+    // a clock read instead of a counter shared by all the attacking threads
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    record.time = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+    Ring& ring = LocalRing();
+    while( !ring.Push(record) )
+    {
+        if(m_overflow.load(std::memory_order_relaxed) == LOG_OVERFLOW_DROP ||
+           Mode() == LOG_MODE_DIRECT){
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // backpressure: wait for the flusher
+        m_wakeup.notify_one();
+        std::this_thread::yield();
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::LocalRing()
+//
+CombatLog::Ring& CombatLog::LocalRing()
+{
+    thread_local std::shared_ptr<Ring> ring;
+    if( !ring ){
+        ring = std::make_shared<Ring>();
+        const std::lock_guard<std::mutex> lock(m_rings_mutex);
+        m_rings.push_back(ring);
+    }
+    return *ring;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::RunFlusher()
+//
+void CombatLog::RunFlusher()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    bool running{true};
+    while(running)
+    {
+        m_wakeup.wait_for(lock, FLUSH_INTERVAL, [this]() {
+            return !m_running || m_flush_requests != m_flush_done;
+        });
+        running = m_running;
+        const std::uint64_t requests = m_flush_requests;
+
+        lock.unlock();
+        Drain();
+        lock.lock();
+
+        m_flush_done = requests;
+        m_flushed.notify_all();
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::Drain(): write the content of all ring buffers as one batch
+//
+std::size_t CombatLog::Drain()
+{
+    m_batch.clear();
+    {
+        const std::lock_guard<std::mutex> lock(m_rings_mutex);
+        // the ring of a thread that has ended is forgotten once emptied: the
+        // check comes first, as the thread may push until it ends
+        m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(),
+                                     [this](const std::shared_ptr<Ring>& ring) {
+                                         const bool ended = ring.use_count() == 1;
+                                         ring->PopAll(m_batch);
+                                         return ended;
+                                     }),
+                      m_rings.end());
+    }
+    if(m_batch.empty()){
+        return 0;
+    }
+
+    // the messages of a thread are in order in its ring: stable on equal times
+    std::stable_sort(m_batch.begin(), m_batch.end(),
+                     [](const CombatRecord& first, const CombatRecord& second) {
+                         return first.time < second.time;
+                     });
+
+    std::ostream* output = m_output.load(std::memory_order_acquire);
+    std::ostream& stream = (output != nullptr) ? *output : std::cout;
+    if(m_async_mode == LOG_MODE_ASYNC_BINARY){
+        stream.write(reinterpret_cast<const char*>(m_batch.data()),
+                     static_cast<std::streamsize>(m_batch.size() *
+                                                  sizeof(CombatRecord)));
+    }
+    else{
+        m_text.clear();
+        for(const auto& record : m_batch){
+            FormatRecord(record, m_text);
+        }
+        stream.write(m_text.data(), static_cast<std::streamsize>(m_text.size()));
+    }
+    stream.flush();
+    return m_batch.size();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::FormatRecord()
+//
+void CombatLog::FormatRecord(const CombatRecord& record, std::string& text)
+{
+    const auto role = static_cast<ROLE_t>(record.attacker);
+    const char* name = RoleCatalog::Instance().Name(role);
+
+    if(record.event == LOG_EVENT_FIGHTER)
+    {
+        text += "Fighter information:\n\tRole: '";
+        text += name;
+        text += "'\n\tRemaining health: ";
+        text += std::to_string(record.health);
+        if(record.health == HEALTH_DEAD){
+            text += "\033[31m  -->  Fighter death!!!\033[0m";
+        }
+        if(role == ROLE_UNDEFINED || record.health < 0){
+            text += "\033[31m  -->  Fighter not initialized\033[0m";
+        }
+        text += '\n';
+        return;
+    }
+
+    const char* enemy_name = RoleCatalog::Instance().Name(static_cast<ROLE_t>(record.target));
+    text += (role == ROLE_HERO) ? "\033[32m" : "\033[31m";
+    text += name;
+    text += " hits ";
+    text += enemy_name;
+    text += ". ";
+    if(record.event == LOG_EVENT_HIT){
+        text += enemy_name;
+        text += " health is ";
+        text += std::to_string(record.health);
+    }
+    text += "\n\033[0m";
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CombatLog::DecodeRecords()
+//
+std::size_t CombatLog::DecodeRecords(std::istream& input, std::ostream& output)
+{
+    std::size_t count{0};
+    CombatRecord record{};
+    std::string text;
+    while(input.read(reinterpret_cast<char*>(&record), sizeof(record)))
+    {
+        text.clear();
+        FormatRecord(record, text);
+        output << text;
+        ++count;
+    }
+    return count;
+}
@@ -0,0 +1,125 @@
+#include "command_parser.h"
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @brief A word of the commands
+ */
+using COMMAND_WORD_t = enum COMMAND_WORD {
+    WORD_UNKNOWN,
+    WORD_ATTACK,
+    WORD_ORC,
+    WORD_DRAGON,
+};
+
+struct Keyword {
+    std::string_view text;  // lower case letters only
+    COMMAND_WORD_t word{WORD_UNKNOWN};
+};
+
+static constexpr Keyword KEYWORDS[] = {
+    {"attack", WORD_ATTACK},
+    {"orc", WORD_ORC},
+    {"dragon", WORD_DRAGON},
+};
+
+static constexpr std::size_t WORD_TABLE_SIZE = 8; // a power of 2
+
+
+//-----------------------------------------------------------------------------
+//
+//  WordHash(): the first and last letters and the length of a word, which
+//              tell the keywords apart
+//
+static constexpr std::size_t WordHash(const std::string_view word) noexcept
+{
+    // setting the bit 0x20 turns upper case letters into lower case ones
+    const auto first = static_cast<std::size_t>(word.front()) | 0x20U;
+    const auto last = static_cast<std::size_t>(word.back()) | 0x20U;
+    return (first + last + word.size()) & (WORD_TABLE_SIZE - 1);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  MakeWordTable(): the keywords at the index of their hash
+//
+static constexpr auto MakeWordTable() noexcept
+{
+    struct Table { Keyword slots[WORD_TABLE_SIZE]{}; bool perfect{true}; } table;
+    for(const auto& keyword : KEYWORDS){
+        auto& slot = table.slots[WordHash(keyword.text)];
+        table.perfect = table.perfect && slot.word == WORD_UNKNOWN;
+        slot = keyword;
+    }
+    return table;
+}
+
+static constexpr auto WORD_TABLE = MakeWordTable();
+static_assert(WORD_TABLE.perfect, "WordHash() must give each keyword its own slot");
+
+
+//-----------------------------------------------------------------------------
+//
+//  LookupWord()
+//
+static COMMAND_WORD_t LookupWord(const std::string_view word) noexcept
+{
+    const Keyword& candidate = WORD_TABLE.slots[WordHash(word)];
+    if(candidate.text.size() != word.size()){
+        return WORD_UNKNOWN;
+    }
+    // the keywords are letters: the bit 0x20 only makes the case differ
+    for(std::size_t i = 0; i < word.size(); ++i){
+        if((static_cast<unsigned char>(word[i]) | 0x20U) !=
+           static_cast<unsigned char>(candidate.text[i])){
+            return WORD_UNKNOWN;
+        }
+    }
+    return candidate.word;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  NextWord(): the next word of a command, removed from it
+//
+static std::string_view NextWord(std::string_view& command) noexcept
+{
+    const auto is_blank = [](const char c) { return c == ' ' || c == '\t'; };
+
+    std::size_t start{0};
+    while(start < command.size() && is_blank(command[start])){
+        ++start;
+    }
+    std::size_t end{start};
+    while(end < command.size() && !is_blank(command[end])){
+        ++end;
+    }
+    const auto word = command.substr(start, end - start);
+    command.remove_prefix(end);
+    return word;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ParseHeroCommand()
+//
+ROLE_t ParseHeroCommand(std::string_view command) noexcept
+{
+    const auto verb = NextWord(command);
+    const auto target = NextWord(command);
+    if(verb.empty() || target.empty() || !NextWord(command).empty() ||
+       LookupWord(verb) != WORD_ATTACK)
+    {
+        return ROLE_UNDEFINED;
+    }
+
+    switch(LookupWord(target))
+    {
+        case WORD_ORC:    return ROLE_ORC;
+        case WORD_DRAGON: return ROLE_DRAGON;
+        default:          return ROLE_UNDEFINED;
+    }
+}
@@ -0,0 +1,82 @@
+#include "command_queue.h"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+//=============================================================================
+//
+//                    Implementations for the class CommandQueue
+//
+//=============================================================================
+
+
+//-----------------------------------------------------------------------------
+//
+//  CommandQueue::CommandQueue()
+//
+CommandQueue::CommandQueue(const std::size_t capacity)
+: m_cells(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity))
+{
+    m_mask = m_cells.size() - 1;
+    // the cell of the position p is free for the producer of p
+    for(std::size_t i = 0; i < m_cells.size(); ++i){
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CommandQueue::TryPush()
+//
+bool CommandQueue::TryPush(const GameCommand& command, std::uint64_t& ticket) noexcept
+{
+    std::uint64_t position = m_tail.load(std::memory_order_relaxed);
+    for(;;)
+    {
+        Cell& cell = m_cells[position & m_mask];
+        const std::uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if(sequence == position){
+            // a failed exchange reloads the tail: another producer won
+            if(m_tail.compare_exchange_weak(position, position + 1,
+                                            std::memory_order_relaxed))
+            {
+                cell.command = command;
+                cell.sequence.store(position + 1, std::memory_order_release);
+                ticket = position;
+                return true;
+            }
+        }
+        else if(sequence < position){
+            // the cell still holds the command of the previous lap
+            return false;
+        }
+        else{
+            position = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  CommandQueue::Drain()
+//
+std::size_t CommandQueue::Drain(std::vector<GameCommand>& batch, const std::size_t max)
+{
+    std::size_t count{0};
+    for(; count < max; ++count, ++m_head)
+    {
+        Cell& cell = m_cells[m_head & m_mask];
+        if(cell.sequence.load(std::memory_order_acquire) != m_head + 1){
+            break; // empty, or still being written by its producer
+        }
+        batch.push_back(cell.command);
+        // free for the producer of the next lap
+        cell.sequence.store(m_head + m_cells.size(), std::memory_order_release);
+    }
+    return count;
+}
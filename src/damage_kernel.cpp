@@ -0,0 +1,355 @@
+#include "damage_kernel.h"
+#include <cstddef>
+#include <initializer_list>
+#include "role_catalog.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+    #define DAMAGE_KERNEL_X86
+    #include <immintrin.h>
+#endif
+
+// The vector kernels kill a fighter by setting all bits of its role and health
+static_assert(ROLE_UNDEFINED == -1 && HEALTH_UNDEFINED == -1,
+              "Reset() values must have all bits set");
+
+using DamageKernel = std::size_t (*)(const int*, const int*, int*, int*,
+                                     std::size_t) noexcept;
+
+
+//-----------------------------------------------------------------------------
+//
+//  DamageTickScalar(): reference implementation, also used for the tails
+//
+static std::size_t DamageTickScalar(const int* attacker_roles,
+                                    const int* attacker_health,
+                                    int* target_roles,
+                                    int* target_health,
+                                    const std::size_t count) noexcept
+{
+    const RoleCatalog& catalog = RoleCatalog::Instance();
+    std::size_t attacks{0};
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        const auto role = static_cast<ROLE_t>(attacker_roles[i]);
+        if(attacker_health[i] <= HEALTH_DEAD || target_health[i] <= HEALTH_DEAD ||
+           !catalog.AreEnemies(role, static_cast<ROLE_t>(target_roles[i])))
+        {
+            continue;
+        }
+
+        target_health[i] -= catalog.Damage(role);
+        if(target_health[i] <= HEALTH_DEAD){ // same as Fighter::Reset()
+            target_roles[i] = ROLE_UNDEFINED;
+            target_health[i] = HEALTH_UNDEFINED;
+        }
+        ++attacks;
+    }
+    return attacks;
+}
+
+
+#if defined(DAMAGE_KERNEL_X86)
+//-----------------------------------------------------------------------------
+//
+//  DamageTickSse42(): 4 fighters per iteration
+//
+//  Hero attacks monsters (role 1 or 2) and monsters attack the hero (role 0).
+//  The damage is 2 for the hero and 2 * role - 1 for the monsters.
+//
+__attribute__((target("sse4.2")))
+static std::size_t DamageTickSse42(const int* attacker_roles,
+                                   const int* attacker_health,
+                                   int* target_roles,
+                                   int* target_health,
+                                   const std::size_t count) noexcept
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+
+    std::size_t attacks{0};
+    std::size_t i{0};
+    for(; i + 4 <= count; i += 4)
+    {
+        const __m128i a_role = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(attacker_roles + i));
+        const __m128i a_health = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(attacker_health + i));
+        const __m128i t_role = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(target_roles + i));
+        const __m128i t_health = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(target_health + i));
+
+        const __m128i a_hero = _mm_cmpeq_epi32(a_role, zero);
+        const __m128i a_monster = _mm_or_si128(_mm_cmpeq_epi32(a_role, one),
+                                               _mm_cmpeq_epi32(a_role, two));
+        const __m128i t_hero = _mm_cmpeq_epi32(t_role, zero);
+        const __m128i t_monster = _mm_or_si128(_mm_cmpeq_epi32(t_role, one),
+                                               _mm_cmpeq_epi32(t_role, two));
+        const __m128i enemies = _mm_or_si128(_mm_and_si128(a_hero, t_monster),
+                                             _mm_and_si128(a_monster, t_hero));
+        const __m128i alive = _mm_and_si128(_mm_cmpgt_epi32(a_health, zero),
+                                            _mm_cmpgt_epi32(t_health, zero));
+        const __m128i hit = _mm_and_si128(enemies, alive);
+
+        const __m128i damage = _mm_blendv_epi8(
+            _mm_sub_epi32(_mm_add_epi32(a_role, a_role), one), two, a_hero);
+        const __m128i health = _mm_sub_epi32(t_health,
+                                             _mm_and_si128(damage, hit));
+        const __m128i killed = _mm_andnot_si128(_mm_cmpgt_epi32(health, zero),
+                                                hit);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target_roles + i),
+                         _mm_or_si128(t_role, killed));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target_health + i),
+                         _mm_or_si128(health, killed));
+
+        const auto mask = _mm_movemask_ps(_mm_castsi128_ps(hit));
+        attacks += static_cast<std::size_t>(
+            __builtin_popcount(static_cast<unsigned>(mask)));
+    }
+
+    return attacks + DamageTickScalar(attacker_roles + i, attacker_health + i,
+                                      target_roles + i, target_health + i,
+                                      count - i);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  DamageTickAvx2(): 8 fighters per iteration, same logic as SSE4.2
+//
+__attribute__((target("avx2")))
+static std::size_t DamageTickAvx2(const int* attacker_roles,
+                                  const int* attacker_health,
+                                  int* target_roles,
+                                  int* target_health,
+                                  const std::size_t count) noexcept
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i two = _mm256_set1_epi32(2);
+
+    std::size_t attacks{0};
+    std::size_t i{0};
+    for(; i + 8 <= count; i += 8)
+    {
+        const __m256i a_role = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(attacker_roles + i));
+        const __m256i a_health = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(attacker_health + i));
+        const __m256i t_role = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(target_roles + i));
+        const __m256i t_health = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(target_health + i));
+
+        const __m256i a_hero = _mm256_cmpeq_epi32(a_role, zero);
+        const __m256i a_monster = _mm256_or_si256(
+            _mm256_cmpeq_epi32(a_role, one), _mm256_cmpeq_epi32(a_role, two));
+        const __m256i t_hero = _mm256_cmpeq_epi32(t_role, zero);
+        const __m256i t_monster = _mm256_or_si256(
+            _mm256_cmpeq_epi32(t_role, one), _mm256_cmpeq_epi32(t_role, two));
+        const __m256i enemies = _mm256_or_si256(
+            _mm256_and_si256(a_hero, t_monster),
+            _mm256_and_si256(a_monster, t_hero));
+        const __m256i alive = _mm256_and_si256(
+            _mm256_cmpgt_epi32(a_health, zero),
+            _mm256_cmpgt_epi32(t_health, zero));
+        const __m256i hit = _mm256_and_si256(enemies, alive);
+
+        const __m256i damage = _mm256_blendv_epi8(
+            _mm256_sub_epi32(_mm256_add_epi32(a_role, a_role), one), two, a_hero);
+        const __m256i health = _mm256_sub_epi32(t_health,
+                                                _mm256_and_si256(damage, hit));
+        const __m256i killed = _mm256_andnot_si256(
+            _mm256_cmpgt_epi32(health, zero), hit);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target_roles + i),
+                            _mm256_or_si256(t_role, killed));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target_health + i),
+                            _mm256_or_si256(health, killed));
+
+        const auto mask = _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+        attacks += static_cast<std::size_t>(
+            __builtin_popcount(static_cast<unsigned>(mask)));
+    }
+
+    return attacks + DamageTickScalar(attacker_roles + i, attacker_health + i,
+                                      target_roles + i, target_health + i,
+                                      count - i);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  DamageTickAvx512(): 16 fighters per iteration using mask registers
+//
+__attribute__((target("avx512f")))
+static std::size_t DamageTickAvx512(const int* attacker_roles,
+                                    const int* attacker_health,
+                                    int* target_roles,
+                                    int* target_health,
+                                    const std::size_t count) noexcept
+{
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i two = _mm512_set1_epi32(2);
+    const __m512i undefined = _mm512_set1_epi32(-1);
+
+    std::size_t attacks{0};
+    std::size_t i{0};
+    for(; i + 16 <= count; i += 16)
+    {
+        const __m512i a_role = _mm512_loadu_si512(attacker_roles + i);
+        const __m512i a_health = _mm512_loadu_si512(attacker_health + i);
+        const __m512i t_role = _mm512_loadu_si512(target_roles + i);
+        const __m512i t_health = _mm512_loadu_si512(target_health + i);
+
+        const __mmask16 a_hero = _mm512_cmpeq_epi32_mask(a_role, zero);
+        const __mmask16 a_monster = _mm512_kor(
+            _mm512_cmpeq_epi32_mask(a_role, one),
+            _mm512_cmpeq_epi32_mask(a_role, two));
+        const __mmask16 t_hero = _mm512_cmpeq_epi32_mask(t_role, zero);
+        const __mmask16 t_monster = _mm512_kor(
+            _mm512_cmpeq_epi32_mask(t_role, one),
+            _mm512_cmpeq_epi32_mask(t_role, two));
+        const __mmask16 enemies = _mm512_kor(_mm512_kand(a_hero, t_monster),
+                                             _mm512_kand(a_monster, t_hero));
+        const __mmask16 alive = _mm512_mask_cmpgt_epi32_mask(
+            _mm512_cmpgt_epi32_mask(a_health, zero), t_health, zero);
+        const __mmask16 hit = _mm512_kand(enemies, alive);
+
+        const __m512i damage = _mm512_mask_mov_epi32(
+            _mm512_sub_epi32(_mm512_add_epi32(a_role, a_role), one),
+            a_hero, two);
+        const __m512i health = _mm512_mask_sub_epi32(t_health, hit,
+                                                     t_health, damage);
+        const __mmask16 killed = _mm512_mask_cmple_epi32_mask(hit, health, zero);
+
+        _mm512_storeu_si512(target_roles + i,
+                            _mm512_mask_mov_epi32(t_role, killed, undefined));
+        _mm512_storeu_si512(target_health + i,
+                            _mm512_mask_mov_epi32(health, killed, undefined));
+
+        attacks += static_cast<std::size_t>(
+            __builtin_popcount(static_cast<unsigned>(hit)));
+    }
+
+    return attacks + DamageTickScalar(attacker_roles + i, attacker_health + i,
+                                      target_roles + i, target_health + i,
+                                      count - i);
+}
+#endif // DAMAGE_KERNEL_X86
+
+
+//-----------------------------------------------------------------------------
+//
+//  SelectKernel()
+//
+static DamageKernel SelectKernel(const KERNEL_ISA_t isa) noexcept
+{
+    if( !KernelIsaSupported(isa) ){
+        return DamageTickScalar;
+    }
+
+    switch(isa)
+    {
+#if defined(DAMAGE_KERNEL_X86)
+        case ISA_SSE42:  return DamageTickSse42;
+        case ISA_AVX2:   return DamageTickAvx2;
+        case ISA_AVX512: return DamageTickAvx512;
+#endif
+        default:         return DamageTickScalar;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ApplyDamageTick()
+//
+std::size_t ApplyDamageTick(const int* attacker_roles,
+                            const int* attacker_health,
+                            int* target_roles,
+                            int* target_health,
+                            const std::size_t count) noexcept
+{
+    // the vector kernels hardcode the built-in roles: the scalar one
+    // follows any other catalog
+    static const DamageKernel kernel = SelectKernel( DetectKernelIsa() );
+    if( !RoleCatalog::Instance().IsBuiltin() ){
+        return DamageTickScalar(attacker_roles, attacker_health,
+                                target_roles, target_health, count);
+    }
+    return kernel(attacker_roles, attacker_health,
+                  target_roles, target_health, count);
+}
+
+std::size_t ApplyDamageTick(const KERNEL_ISA_t isa,
+                            const int* attacker_roles,
+                            const int* attacker_health,
+                            int* target_roles,
+                            int* target_health,
+                            const std::size_t count) noexcept
+{
+    if( !RoleCatalog::Instance().IsBuiltin() ){
+        return DamageTickScalar(attacker_roles, attacker_health,
+                                target_roles, target_health, count);
+    }
+    return SelectKernel(isa)(attacker_roles, attacker_health,
+                             target_roles, target_health, count);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  KernelIsaSupported()
+//
+bool KernelIsaSupported(const KERNEL_ISA_t isa) noexcept
+{
+#if defined(DAMAGE_KERNEL_X86)
+    __builtin_cpu_init();
+    switch(isa)
+    {
+        case ISA_SCALAR: return true;
+        case ISA_SSE42:  return __builtin_cpu_supports("sse4.2") != 0;
+        case ISA_AVX2:   return __builtin_cpu_supports("avx2") != 0;
+        case ISA_AVX512: return __builtin_cpu_supports("avx512f") != 0;
+    }
+    return false;
+#else
+    return isa == ISA_SCALAR;
+#endif
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  DetectKernelIsa()
+//
+KERNEL_ISA_t DetectKernelIsa() noexcept
+{
+    for(const auto isa : {ISA_AVX512, ISA_AVX2, ISA_SSE42}){
+        if( KernelIsaSupported(isa) ){
+            return isa;
+        }
+    }
+    return ISA_SCALAR;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  KernelIsaToString()
+//
+const char* KernelIsaToString(const KERNEL_ISA_t isa) noexcept
+{
+    switch(isa)
+    {
+        case ISA_SSE42:  return "SSE4.2";
+        case ISA_AVX2:   return "AVX2";
+        case ISA_AVX512: return "AVX-512";
+        default:         return "Scalar";
+    }
+}
@@ -0,0 +1,180 @@
+#include "deadline_timer.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+
+//-----------------------------------------------------------------------------
+//
+//  DeadlineTimer::DeadlineTimer()
+//
+DeadlineTimer::DeadlineTimer(const std::chrono::nanoseconds spin) noexcept
+: m_spin{std::max(spin, std::chrono::nanoseconds::zero())}
+{
+    // steady_clock is CLOCK_MONOTONIC: its time points arm the timer as is
+    m_timer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    m_wake = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if(m_timer < 0 || m_wake < 0){
+        if(m_timer >= 0){ close(m_timer); }
+        if(m_wake >= 0){ close(m_wake); }
+        m_timer = m_wake = -1;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  DeadlineTimer::~DeadlineTimer()
+//
+DeadlineTimer::~DeadlineTimer()
+{
+    if(m_timer >= 0){
+        close(m_timer);
+        close(m_wake);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  DeadlineTimer::SleepUntil()
+//
+bool DeadlineTimer::SleepUntil(const std::chrono::steady_clock::time_point deadline) noexcept
+{
+    if(Interrupted()){
+        return false;
+    }
+
+    // the kernel wakes the thread up a little late: it sleeps until the
+    // spin window, and the busy wait ends on the deadline itself
+    const auto wake_up = deadline - m_spin;
+    if(std::chrono::steady_clock::now() < wake_up && !Wait(wake_up)){
+        return false;
+    }
+    while(std::chrono::steady_clock::now() < deadline){
+        if(Interrupted()){
+            return false;
+        }
+        // no yield: the thread would give the core away for milliseconds
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+        __builtin_ia32_pause();
+#endif
+    }
+
+    Account(deadline);
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  DeadlineTimer::Interrupt()
+//
+void DeadlineTimer::Interrupt() noexcept
+{
+    m_interrupted.store(true, std::memory_order_release);
+    if(m_wake >= 0){
+        // the eventfd is never read: it stays readable, and so interrupted
+        const std::uint64_t one{1};
+        const auto written = write(m_wake, &one, sizeof(one));
+        static_cast<void>(written);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  DeadlineTimer::Stats()
+//
+TimingStats DeadlineTimer::Stats() const noexcept
+{
+    TimingStats stats;
+    stats.count = m_count;
+    if(m_count == 0){
+        return stats;
+    }
+    const auto count = static_cast<double>(m_count);
+    stats.mean_lateness = m_sum / count;
+    const double variance = m_sum_squares / count - stats.mean_lateness * stats.mean_lateness;
+    stats.jitter = variance > 0.0 ? std::sqrt(variance) : 0.0;
+    stats.max_lateness = m_max;
+    return stats;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  DeadlineTimer::Wait(): sleep until a time point, false if interrupted
+//
+bool DeadlineTimer::Wait(const std::chrono::steady_clock::time_point wake_up) noexcept
+{
+    if(m_timer < 0){
+        // no timerfd: short sleeps, checking for an interruption
+        constexpr std::chrono::milliseconds SLICE{1};
+        while(std::chrono::steady_clock::now() < wake_up){
+            if(Interrupted()){
+                return false;
+            }
+            std::this_thread::sleep_until(
+                std::min(wake_up, std::chrono::steady_clock::now() + SLICE));
+        }
+        return !Interrupted();
+    }
+
+    const auto since_epoch = wake_up.time_since_epoch();
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    itimerspec spec{};
+    spec.it_value.tv_sec = seconds.count();
+    spec.it_value.tv_nsec =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - seconds).count();
+    if(timerfd_settime(m_timer, TFD_TIMER_ABSTIME, &spec, nullptr) != 0){
+        return !Interrupted();
+    }
+
+    std::array<pollfd, 2> fds{
+        pollfd{m_timer, POLLIN, 0},
+        pollfd{m_wake, POLLIN, 0}
+    };
+    while(true)
+    {
+        const int ready = poll(fds.data(), fds.size(), -1);
+        if(ready < 0 && errno == EINTR){
+            continue;
+        }
+        if(ready < 0 || (fds[1].revents & POLLIN) != 0){
+            return false;
+        }
+        if((fds[0].revents & POLLIN) != 0){
+            std::uint64_t expirations{0};
+            const auto count = read(m_timer, &expirations, sizeof(expirations));
+            static_cast<void>(count);
+            return !Interrupted();
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  DeadlineTimer::Account(): add the lateness of a wake up
+//
+void DeadlineTimer::Account(const std::chrono::steady_clock::time_point deadline) noexcept
+{
+    const std::int64_t lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - deadline).count();
+    const auto value = static_cast<double>(lateness);
+    ++m_count;
+    m_sum += value;
+    m_sum_squares += value * value;
+    m_max = std::max(m_max, lateness);
+}
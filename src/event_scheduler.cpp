@@ -0,0 +1,146 @@
+#include "event_scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+#include "metrics.h"
+#include "role_catalog.h"
+
+
+//-----------------------------------------------------------------------------
+//
+//  EventScheduler::Schedule()
+//
+void EventScheduler::Schedule(const long long time, const std::size_t actor)
+{
+    m_queue.push_back( ScheduledEvent{time, actor, m_sequence++} );
+    std::push_heap(m_queue.begin(), m_queue.end(), Later{});
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  EventScheduler::Restore()
+//
+void EventScheduler::Restore(const long long now, const std::vector<ScheduledEvent>& events)
+{
+    m_queue = events;
+    std::make_heap(m_queue.begin(), m_queue.end(), Later{});
+    m_now = now;
+    m_started = false; // rebased on the restored time by the next Run()
+    m_sequence = 0;
+    for(const ScheduledEvent& event : m_queue){
+        m_sequence = std::max(m_sequence, event.sequence + 1);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  EventScheduler::Stop()
+//
+void EventScheduler::Stop() noexcept
+{
+    m_stopped.store(true, std::memory_order_release);
+    m_timer.Interrupt();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  EventScheduler::WaitUntil()
+//
+void EventScheduler::WaitUntil(const long long time)
+{
+    if(m_time_scale <= TIME_SCALE_UNTHROTTLED){
+        return;
+    }
+
+    // The deadline is absolute: the time spent processing an event does not
+    // delay the following ones. The timer wakes up within microseconds of it,
+    // well below a millisecond without a real time kernel.
+    m_timer.SleepUntil(m_start + WallTime(time));
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  EventScheduler::WallTime()
+//
+std::chrono::steady_clock::duration EventScheduler::WallTime(const long long time) const noexcept
+{
+    if(m_time_scale <= TIME_SCALE_UNTHROTTLED){
+        return std::chrono::steady_clock::duration::zero();
+    }
+    const std::chrono::duration<double, std::milli> offset{
+        static_cast<double>(time) / m_time_scale
+    };
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  RunMonsterActions()
+//
+std::size_t RunMonsterActions(EventScheduler& scheduler,
+                              Hero& hero,
+                              const std::vector<const Monster*>& monsters,
+                              const bool verbose)
+{
+    ScheduleMonsterActions(scheduler, monsters);
+    return ResumeMonsterActions(scheduler, hero, monsters, verbose);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ScheduleMonsterActions()
+//
+void ScheduleMonsterActions(EventScheduler& scheduler,
+                            const std::vector<const Monster*>& monsters)
+{
+    for(std::size_t i = 0; i < monsters.size(); ++i)
+    {
+        const int interval = RoleCatalog::Instance().AttackInterval(monsters[i]->GetRole());
+        if(interval > 0){
+            scheduler.Schedule(scheduler.Now() + interval, i);
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ResumeMonsterActions()
+//
+std::size_t ResumeMonsterActions(EventScheduler& scheduler,
+                                 Hero& hero,
+                                 const std::vector<const Monster*>& monsters,
+                                 const bool verbose,
+                                 const std::size_t max_events)
+{
+    std::size_t attacks{0};
+    AttackTally tally;
+    scheduler.Run([&](const ScheduledEvent& event) -> long long {
+        const Monster& monster = *monsters[event.actor];
+        bool hit{false};
+        if(verbose){
+            hit = monster.CanAttack(hero);
+            monster.Attack(hero);
+        }
+        else{
+            hit = monster.Hit(hero);
+        }
+        attacks += hit ? 1U : 0U;
+        tally.Add(monster.GetRole(), hit);
+
+        if( !hero.IsAlive() ){
+            scheduler.Stop();
+        }
+        // a killed monster is reset: its undefined role ends its activity
+        return RoleCatalog::Instance().AttackInterval(monster.GetRole());
+    }, max_events);
+
+    return attacks;
+}
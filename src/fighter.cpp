@@ -1,9 +1,10 @@
 #include "fighter.h"
-#include <cstdlib>
-#include <iostream>
-#include <mutex>
+#include "alive_index.h"
+#include "combat_log.h"
+#include "metrics.h"
+#include "replay_log.h"
+#include "role_catalog.h"
 
-std::mutex g_mutex; // NOLINT --> deactivate all clang-tidy checks on this line
 
 //-----------------------------------------------------------------------------
 //
@@ -21,15 +22,9 @@ std::mutex g_mutex; // NOLINT --> deactivate all clang-tidy checks on this line
 //  Constructor
 //
 Fighter::Fighter(const ROLE_t role) noexcept
-        : m_role( role )
+        : m_role( role ),
+          m_health( RoleCatalog::Instance().Health(role) )
 {
-    switch(m_role)
-    {
-        case ROLE_UNDEFINED: m_health = HEALTH_UNDEFINED; break;
-        case ROLE_HERO:      m_health = HEALTH_HERO;      break;
-        case ROLE_ORC:       m_health = HEALTH_ORC;       break;
-        case ROLE_DRAGON:    m_health = HEALTH_DRAGON;    break;
-    }
 }
 
 
@@ -58,6 +53,20 @@ Fighter::Fighter(Fighter&& other) noexcept
 }
 
 
+//-----------------------------------------------------------------------------
+//
+//  Destructor
+//
+Fighter::~Fighter()
+{
+    // the index must not keep a pointer to a destroyed fighter, e.g one
+    // despawned from a FighterPool whose slot is then reused
+    if(m_index != nullptr){
+        m_index->Unregister(m_slot);
+    }
+}
+
+
 //-----------------------------------------------------------------------------
 //
 //  Copy assignment operator=
@@ -68,8 +77,11 @@ Fighter& Fighter::operator=(const Fighter& other) noexcept
     if(&other == this){
         return *this;
     }
-    m_role = other.GetRole();
-    m_health = other.GetHealth();
+    m_role.store(other.GetRole(), std::memory_order_relaxed);
+    m_health.store(other.GetHealth(), std::memory_order_relaxed);
+    if(m_index != nullptr){
+        m_index->Update(m_slot);
+    }
     return *this;
 }
 
@@ -80,8 +92,11 @@ Fighter& Fighter::operator=(const Fighter& other) noexcept
 Fighter& Fighter::operator=(Fighter&& other) noexcept
 {
     //std::cout << "\nMove Assignment Operator!!!\n";
-    m_role = other.GetRole() ;
-    m_health = other.GetHealth();
+    m_role.store(other.GetRole(), std::memory_order_relaxed);
+    m_health.store(other.GetHealth(), std::memory_order_relaxed);
+    if(m_index != nullptr){
+        m_index->Update(m_slot);
+    }
     other.Reset();
     return *this;
 }
@@ -93,8 +108,11 @@ Fighter& Fighter::operator=(Fighter&& other) noexcept
 //
 void Fighter::Reset() noexcept
 {
-    m_role = ROLE_UNDEFINED;
-    m_health = static_cast<int>(HEALTH_UNDEFINED);
+    m_role.store(ROLE_UNDEFINED, std::memory_order_relaxed);
+    m_health.store(static_cast<int>(HEALTH_UNDEFINED), std::memory_order_relaxed);
+    if(m_index != nullptr){
+        m_index->Remove(m_slot);
+    }
 }
 
 
@@ -104,13 +122,7 @@ void Fighter::Reset() noexcept
 //
 const char* Fighter::RoleToString() const noexcept
 {
-    switch(m_role)
-    {
-        case ROLE_HERO:   return "Hero";
-        case ROLE_ORC:    return "Orc";
-        case ROLE_DRAGON: return "Dragon";
-        default:          return "Undefined";
-    }
+    return RoleCatalog::Instance().Name( GetRole() );
 }
 
 
@@ -120,26 +132,9 @@ const char* Fighter::RoleToString() const noexcept
 //
 ROLE_t Fighter::IntToRole(const int role) noexcept
 {
-    if(role <= -1){
-        return ROLE_UNDEFINED;
-    }
-
-    switch(role)
-    {
-        //case -1: return ROLE_UNDEFINED;
-        case 0:  return ROLE_HERO;
-        case 1:  return ROLE_ORC;
-        case 2:  return ROLE_DRAGON;
-        default: {
-            std::cout << "\033[31m\nError in file '" << __FILE__ << "' line "
-                      << __LINE__ << ": unknown fighter role!\n\033[0m";
-            //Avoid concurrent call to exit() by using 
-            //std::lock_guard<std::mutex>: it is an RAII aware mutex
-            //that is therefore automaticaly unlocked when going out of scope
-            std::lock_guard<std::mutex> lock(g_mutex); // NOLINT
-            exit( EXIT_FAILURE ); // NOLINT
-        }
-    }
+    // unknown ids are an error for the caller to handle, e.g SetRole()
+    // leaves the fighter undefined
+    return RoleCatalog::Instance().Role(role);
 }
 
 
@@ -149,17 +144,7 @@ ROLE_t Fighter::IntToRole(const int role) noexcept
 //
 void Fighter::Print() const noexcept
 {
-    std::cout << "Fighter information:\n\tRole: '" << this->RoleToString()
-              << "'\n\tRemaining health: " << this->GetHealth();
-
-    if( this->GetHealth() == HEALTH_DEAD ){
-        std::cout << "\033[31m  -->  Fighter death!!!\033[0m";
-    }
-    if(this->m_role == ROLE_UNDEFINED || this->m_health < 0){
-        std::cout << "\033[31m  -->  Fighter not initialized\033[0m";
-    }
-
-    std::cout << std::endl;
+    CombatLog::Instance().LogFighter( this->GetRole(), this->GetHealth() );
 }
 
 
@@ -169,7 +154,8 @@ void Fighter::Print() const noexcept
 //
 void Fighter::SetRole(const ROLE_t role) noexcept
 {
-    this->m_role = (role <= ROLE_UNDEFINED) ? ROLE_UNDEFINED : role;
+    this->m_role.store((role <= ROLE_UNDEFINED) ? ROLE_UNDEFINED : role,
+                       std::memory_order_relaxed);
 }
 
 void Fighter::SetRole(const int role_int) noexcept
@@ -185,15 +171,7 @@ void Fighter::SetRole(const int role_int) noexcept
 //
 bool Fighter::IsEnemy(const Fighter& other) const noexcept
 {
-    bool ret{false};
-    if(this->m_role == ROLE_HERO){
-        ret = other.GetRole() == ROLE_ORC || other.GetRole() == ROLE_DRAGON;
-    }
-    else if(this->m_role == ROLE_ORC || this->m_role == ROLE_DRAGON){
-        ret = other.GetRole() == ROLE_HERO;
-    }
-
-    return ret; //undefined fighter --> return false
+    return RoleCatalog::Instance().AreEnemies(this->GetRole(), other.GetRole());
 }
 
 
@@ -214,17 +192,64 @@ bool Fighter::CanAttack(const Fighter& other) const noexcept
 void Fighter::Attack(Fighter& other) const noexcept
 {
     if( this->CanAttack(other) ){
-        const char *myName( this->RoleToString() );
-        const char *enemy_name( other.RoleToString() );
-        if(this->GetRole() == ROLE_HERO){
-            std::cout  << "\033[32m" << myName << " hits " 
-                       << enemy_name << ". \n\033[0m";
-        }
-        else{
-            std::cout  << "\033[31m" << myName << " hits " 
-                       << enemy_name << ". \n\033[0m";
+        CombatLog::Instance().LogAttack( this->GetRole(), other.GetRole() );
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Fighter::Damage()
+//
+int Fighter::Damage() const noexcept
+{
+    return RoleCatalog::Instance().Damage( GetRole() );
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Fighter::Hit()
+//
+bool Fighter::Hit(Fighter& other) const noexcept
+{
+    return Hit(other, this->Damage());
+}
+
+bool Fighter::Hit(Fighter& other, const int damage) const noexcept
+{
+    int health_after{0};
+    const bool hit = this->CanAttack(other) && other.TakeDamage(damage, health_after);
+    Metrics::CountOutcome(this->GetRole(), hit, health_after);
+    if(hit){
+        ReplayRecorder::Instance().RecordHit( *this, other, damage, health_after );
+    }
+    return hit;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Fighter::TakeDamage()
+//
+bool Fighter::TakeDamage(const int damage, int& health_after) noexcept
+{
+    int health = m_health.load(std::memory_order_acquire);
+    do{
+        if(health <= HEALTH_DEAD){
+            return false; // already killed by someone else
         }
+        health_after = health - damage;
+    } while( !m_health.compare_exchange_weak(health, health_after,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire) );
+
+    // Only the thread that performed the killing hit gets here with a
+    // dead fighter: the others failed the compare-and-swap above.
+    if(health_after <= HEALTH_DEAD){
+        Reset();
     }
+    return true;
 }
 
 
@@ -246,17 +271,19 @@ void Fighter::Attack(Fighter& other) const noexcept
 void Hero::Attack(Fighter& other) const noexcept
 {
     if( this->CanAttack(other) ){
-        const char *myName( this->RoleToString() );
-        const char *enemy_name( other.RoleToString() );
-        constexpr int damage(2);
-        other.SetHealth( other.GetHealth() - damage );
-        std::cout  << "\033[32m" << myName << " hits " << enemy_name << ". "
-                   << enemy_name << " health is " << other.GetHealth() 
-                   << "\n\033[0m";
-
-        if( !other.IsAlive() ){
-            other.Reset();
+        const ROLE_t enemy_role = other.GetRole();
+        const int damage = this->Damage();
+        int health{0};
+        const bool hit = other.TakeDamage(damage, health);
+        Metrics::CountOutcome(this->GetRole(), hit, health);
+        if( !hit ){
+            return;
         }
+        CombatLog::Instance().LogHit( this->GetRole(), enemy_role, health );
+        ReplayRecorder::Instance().RecordHit( *this, other, damage, health );
+    }
+    else{
+        Metrics::CountOutcome(this->GetRole(), false, 0);
     }
 }
 
@@ -277,17 +304,19 @@ void Monster::Attack(Fighter& other) const noexcept
 {
     if( this->CanAttack(other) )
     {
-        const char *myName(this->RoleToString());
-        const char *enemy_name(other.RoleToString());
-        const int damage = (this->GetRole() == ROLE_ORC) ? 1 : 3;
-        other.SetHealth(other.GetHealth() - damage);
-        std::cout << "\033[31m" << myName << " hits " << enemy_name << ". "
-                  << enemy_name << " health is " << other.GetHealth() 
-                  << "\n\033[0m";
-
-        if (!other.IsAlive()){
-            other.Reset();
+        const ROLE_t enemy_role = other.GetRole();
+        const int damage = this->Damage();
+        int health{0};
+        const bool hit = other.TakeDamage(damage, health);
+        Metrics::CountOutcome(this->GetRole(), hit, health);
+        if( !hit ){
+            return;
         }
+        CombatLog::Instance().LogHit( this->GetRole(), enemy_role, health );
+        ReplayRecorder::Instance().RecordHit( *this, other, damage, health );
+    }
+    else{
+        Metrics::CountOutcome(this->GetRole(), false, 0);
     }
 }
 
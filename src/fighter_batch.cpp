@@ -0,0 +1,203 @@
+#include "fighter_batch.h"
+#include "damage_kernel.h"
+#include "role_catalog.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+//-----------------------------------------------------------------------------
+//
+//  Constructor
+//
+FighterBatch::FighterBatch(const std::size_t count, const ROLE_t role)
+        : m_roles( count, role ),
+          m_health( count, Fighter(role).GetHealth() )
+{
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterBatch::Add()
+//
+std::size_t FighterBatch::Add(const ROLE_t role)
+{
+    return Add( Fighter(role) );
+}
+
+std::size_t FighterBatch::Add(const Fighter& fighter)
+{
+    m_roles.push_back( fighter.GetRole() );
+    m_health.push_back( fighter.GetHealth() );
+    return m_roles.size() - 1;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterBatch::Reserve()
+//
+void FighterBatch::Reserve(const std::size_t count)
+{
+    m_roles.reserve(count);
+    m_health.reserve(count);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterBatch::Clear()
+//
+void FighterBatch::Clear() noexcept
+{
+    m_roles.clear();
+    m_health.clear();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterBatch::Assign()
+//
+void FighterBatch::Assign(const int* roles, const int* health,
+                          const std::size_t count)
+{
+    m_roles.assign(roles, roles + count);
+    m_health.assign(health, health + count);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterBatch::Get()
+//
+Fighter FighterBatch::Get(const std::size_t index) const noexcept
+{
+    Fighter fighter;
+    fighter.SetRole( GetRole(index) );
+    fighter.SetHealth( m_health[index] );
+    return fighter;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterBatch::IsAlive()
+//
+std::size_t FighterBatch::IsAlive(std::vector<std::uint8_t>& alive) const
+{
+    alive.resize( m_health.size() );
+
+    std::size_t count{0};
+    for(std::size_t i = 0; i < m_health.size(); ++i)
+    {
+        const bool is_alive = m_health[i] > HEALTH_DEAD;
+        alive[i] = is_alive ? 1U : 0U;
+        count += is_alive ? 1U : 0U;
+    }
+    return count;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterBatch::CountAlive()
+//
+std::size_t FighterBatch::CountAlive() const noexcept
+{
+    std::size_t count{0};
+    for(const int health : m_health){
+        count += health > HEALTH_DEAD ? 1U : 0U;
+    }
+    return count;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterBatch::CanAttack()
+//
+std::size_t FighterBatch::CanAttack(const FighterBatch& targets,
+                                    std::vector<std::uint8_t>& allowed) const
+{
+    const std::size_t count = std::min(Size(), targets.Size());
+    allowed.resize(count);
+
+    std::size_t attacks{0};
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        const bool can_attack =
+            m_health[i] > HEALTH_DEAD &&
+            targets.m_health[i] > HEALTH_DEAD &&
+            RoleCatalog::Instance().AreEnemies(GetRole(i), targets.GetRole(i));
+        allowed[i] = can_attack ? 1U : 0U;
+        attacks += can_attack ? 1U : 0U;
+    }
+    return attacks;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterBatch::AttackAll()
+//
+std::size_t FighterBatch::AttackAll(FighterBatch& targets) const noexcept
+{
+    return ApplyDamageTick(m_roles.data(), m_health.data(),
+                           targets.m_roles.data(), targets.m_health.data(),
+                           std::min(Size(), targets.Size()));
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterBatch::RunTicks()
+//
+std::size_t FighterBatch::RunTicks(FighterBatch& targets,
+                                   const std::size_t ticks) const noexcept
+{
+    std::size_t attacks{0};
+    for(std::size_t tick = 0; tick < ticks; ++tick){
+        const std::size_t tick_attacks = AttackAll(targets);
+        if(tick_attacks == 0){
+            break;
+        }
+        attacks += tick_attacks;
+    }
+    return attacks;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterBatch::AttackedBy()
+//
+std::size_t FighterBatch::AttackedBy(const Fighter& attacker) noexcept
+{
+    if( !attacker.IsAlive() ){
+        return 0;
+    }
+
+    const auto role = attacker.GetRole();
+    const int damage = attacker.Damage();
+
+    std::size_t attacks{0};
+    for(std::size_t i = 0; i < m_roles.size(); ++i)
+    {
+        if(m_health[i] <= HEALTH_DEAD ||
+           !RoleCatalog::Instance().AreEnemies(role, static_cast<ROLE_t>(m_roles[i])))
+        {
+            continue;
+        }
+
+        m_health[i] -= damage;
+        if(m_health[i] <= HEALTH_DEAD){
+            m_roles[i] = ROLE_UNDEFINED;
+            m_health[i] = HEALTH_UNDEFINED;
+        }
+        ++attacks;
+    }
+    return attacks;
+}
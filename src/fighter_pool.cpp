@@ -0,0 +1,134 @@
+#include "fighter_pool.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+
+
+//-----------------------------------------------------------------------------
+//
+//  Constructor
+//
+FighterPool::FighterPool(const std::size_t chunk_size)
+        : m_chunk_size( chunk_size > 0 ? chunk_size : 1 )
+{
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Destructor
+//
+FighterPool::~FighterPool()
+{
+    Release();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterPool::Spawn()
+//
+Fighter* FighterPool::Spawn(const ROLE_t role)
+{
+    void* slot = Allocate();
+    Fighter* fighter{nullptr};
+    switch(role)
+    {
+        case ROLE_HERO:   fighter = new(slot) Hero(role);    break;
+        case ROLE_ORC:    fighter = new(slot) Orc(role);     break;
+        case ROLE_DRAGON: fighter = new(slot) Dragon(role);  break;
+        default:          fighter = new(slot) Fighter(role); break;
+    }
+    ++m_live;
+    return fighter;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterPool::Despawn()
+//
+void FighterPool::Despawn(Fighter* fighter) noexcept
+{
+    if(fighter == nullptr){
+        return;
+    }
+    fighter->~Fighter();
+
+    auto* slot = new(static_cast<void*>(fighter)) Slot;
+    slot->next = m_free;
+    m_free = slot;
+    --m_live;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterPool::Release()
+//
+void FighterPool::Release() noexcept
+{
+    // the fighters still alive are destroyed: they may be registered to an
+    // AliveIndex. A handed out slot is alive unless it is in the free list.
+    if(m_live > 0){
+        m_free_slots.clear();
+        for(const Slot* slot = m_free; slot != nullptr; slot = slot->next){
+            m_free_slots.push_back(slot);
+        }
+        std::sort(m_free_slots.begin(), m_free_slots.end(), std::less<>());
+        for(std::size_t chunk = 0; chunk < m_chunks.size() && chunk <= m_chunk; ++chunk){
+            const std::size_t used = chunk == m_chunk ? m_used : m_chunk_size;
+            for(std::size_t i = 0; i < used; ++i){
+                Slot* slot = &m_chunks[chunk][i];
+                if( !std::binary_search(m_free_slots.begin(), m_free_slots.end(),
+                                        slot, std::less<>()) )
+                {
+                    std::launder(reinterpret_cast<Fighter*>(slot))->~Fighter(); // NOLINT
+                }
+            }
+        }
+    }
+
+    m_chunk = 0;
+    m_used = 0;
+    m_free = nullptr;
+    m_live = 0;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterPool::ThreadLocal()
+//
+FighterPool& FighterPool::ThreadLocal()
+{
+    static thread_local FighterPool pool; // NOLINT
+    return pool;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  FighterPool::Allocate(): take a recycled slot, or the next new one
+//
+void* FighterPool::Allocate()
+{
+    if(m_free != nullptr){
+        Slot* slot = m_free;
+        m_free = slot->next;
+        return slot;
+    }
+
+    if(m_chunk < m_chunks.size() && m_used == m_chunk_size){
+        ++m_chunk;
+        m_used = 0;
+    }
+    if(m_chunk == m_chunks.size()){
+        m_chunks.push_back(std::make_unique<Slot[]>(m_chunk_size));
+        // Release() lists the free slots without allocating
+        m_free_slots.reserve(Capacity());
+    }
+    return &m_chunks[m_chunk][m_used++];
+}
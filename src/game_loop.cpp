@@ -0,0 +1,168 @@
+#include "game_loop.h"
+#include "metrics.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+//=============================================================================
+//
+//                    Implementations for the class GameLoop
+//
+//=============================================================================
+
+
+//-----------------------------------------------------------------------------
+//
+//  GameLoop::GameLoop()
+//
+GameLoop::GameLoop(AliveIndex& alive, const bool verbose, const std::size_t capacity)
+: m_alive(alive), m_verbose(verbose), m_queue(capacity)
+{
+    // a tick drains at most a full queue: the batch never reallocates
+    m_batch.reserve(m_queue.Capacity());
+    // the kills of Apply() leave the index without a lock
+    m_alive.SetSingleWriter(true);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  GameLoop::~GameLoop()
+//
+GameLoop::~GameLoop()
+{
+    m_alive.SetSingleWriter(false);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  GameLoop::Submit()
+//
+std::uint64_t GameLoop::Submit(const GameCommand& command) noexcept
+{
+    std::uint64_t ticket{NO_TICKET};
+    while( !Stopped() ){
+        if(m_queue.TryPush(command, ticket)){
+            return ticket;
+        }
+        std::this_thread::yield(); // full until the next tick
+    }
+    return NO_TICKET;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  GameLoop::WaitFor()
+//
+void GameLoop::WaitFor(const std::uint64_t ticket) const noexcept
+{
+    if(ticket == NO_TICKET){
+        return;
+    }
+    std::uint64_t released = m_released.load(std::memory_order_acquire);
+    while(released <= ticket){
+        m_released.wait(released, std::memory_order_acquire);
+        released = m_released.load(std::memory_order_acquire);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  GameLoop::Tick()
+//
+std::size_t GameLoop::Tick()
+{
+    m_batch.clear();
+    const std::size_t count = m_queue.Drain(m_batch, m_batch.capacity());
+    AttackTally tally; // the attacks of the tick, counted once
+    for(const GameCommand& command : m_batch){
+        Apply(command, tally);
+    }
+
+    if(count > 0){
+        const std::uint64_t applied = m_applied.load(std::memory_order_relaxed) + count;
+        m_applied.store(applied, std::memory_order_release);
+        m_released.store(applied, std::memory_order_release);
+        m_released.notify_all();
+    }
+    return count;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  GameLoop::Run()
+//
+void GameLoop::Run(const std::chrono::nanoseconds tick)
+{
+    auto deadline = std::chrono::steady_clock::now();
+    while( !Stopped() ){
+        Tick();
+        if(m_alive.IsOver()){
+            break;
+        }
+        deadline += tick;
+        m_timer.SleepUntil(deadline);
+    }
+    Stop();
+
+    // the commands left in the queue are never applied
+    m_released.store(NO_TICKET, std::memory_order_release);
+    m_released.notify_all();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  GameLoop::Stop()
+//
+void GameLoop::Stop() noexcept
+{
+    m_stopped.store(true, std::memory_order_release);
+    m_timer.Interrupt();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  GameLoop::Apply(): on the simulation thread
+//
+void GameLoop::Apply(const GameCommand& command, AttackTally& tally)
+{
+    if(command.attacker >= m_alive.Size() || command.target >= m_alive.Size() ||
+       m_alive.At(command.attacker) == nullptr || m_alive.At(command.target) == nullptr)
+    {
+        return; // no such fighter, or destroyed
+    }
+    Fighter& attacker = *m_alive.At(command.attacker);
+    Fighter& target = *m_alive.At(command.target);
+
+    switch(command.type)
+    {
+        case COMMAND_ATTACK: {
+            bool hit{false};
+            if(m_verbose){
+                hit = attacker.CanAttack(target);
+                attacker.Attack(target);
+            }
+            else{
+                hit = attacker.Hit(target);
+            }
+            tally.Add(attacker.GetRole(), hit);
+            if(hit){
+                m_attacks.store(m_attacks.load(std::memory_order_relaxed) + 1,
+                                std::memory_order_relaxed);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
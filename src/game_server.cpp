@@ -0,0 +1,625 @@
+#include "game_server.h"
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "command_parser.h"
+#include "metrics.h"
+#include "role_catalog.h"
+#include "timing_wheel.h"
+
+// Longest command of a client, longer ones are dropped
+static constexpr std::size_t SESSION_LINE_MAX = 256;
+
+// Events handled per epoll_wait(), and connections accepted per wake up
+static constexpr int EVENTS_PER_WAIT = 256;
+static constexpr int ACCEPTS_PER_WAKEUP = 64;
+
+// epoll keys of the listening socket and of the wake up of Stop(), the
+// sessions being keyed by their slot
+static constexpr std::uint64_t LISTEN_KEY = UINT64_MAX;
+static constexpr std::uint64_t WAKE_KEY = UINT64_MAX - 1;
+
+// Monsters of a session, the payload of a timer being slot * 2 + monster
+static constexpr std::uint32_t SESSION_ORC = 0;
+static constexpr std::uint32_t SESSION_DRAGON = 1;
+
+
+/**
+ * @brief A connected player, with its own fighters
+ */
+struct Session {
+    int fd{-1};
+    Hero hero{ROLE_HERO};
+    Orc orc{ROLE_ORC};
+    Dragon dragon{ROLE_DRAGON};
+    TimerId timers[2]{INVALID_TIMER, INVALID_TIMER}; // next attack of each monster
+    char line[SESSION_LINE_MAX]{};  // pending command
+    std::size_t fill{0};
+    bool overflow{false};           // the pending command is too long
+    std::string output;             // lines not sent yet
+    std::size_t sent{0};
+    bool waiting_output{false};     // EPOLLOUT is watched
+    bool closing{false};            // game over: closed once output is sent
+
+    Fighter& Monster(const std::uint32_t monster) noexcept {
+        return monster == SESSION_ORC ? static_cast<Fighter&>(orc)
+                                      : static_cast<Fighter&>(dragon);
+    }
+};
+
+
+/**
+ * @brief Class ServerWorker
+ *
+ * The event loop of a worker thread and the sessions it accepted
+ */
+class ServerWorker {
+public:
+    explicit ServerWorker(GameServer& server) noexcept : m_server(server) {}
+    ~ServerWorker();
+    ServerWorker(const ServerWorker&) = delete;
+    ServerWorker& operator=(const ServerWorker&) = delete;
+
+    bool Open();
+    void Run();
+    void Stop() noexcept;
+
+private:
+    long long Tick() const noexcept;
+    std::chrono::steady_clock::time_point Deadline(long long tick) const noexcept;
+    int Timeout() const noexcept;
+    void Accept();
+    void Read(std::uint32_t slot);
+    void Execute(Session& session, std::string_view command);
+    void Attack(std::uint32_t payload, long long tick);
+    void EndGame(Session& session, const char* message);
+    void Flush(std::uint32_t slot);
+    void Close(std::uint32_t slot);
+    void Watch(Session& session, std::uint32_t slot, bool output) noexcept;
+
+    GameServer& m_server;
+    int m_epoll{-1};
+    int m_wake{-1};
+    std::atomic<bool> m_stopped{false};
+    std::chrono::steady_clock::time_point m_start{std::chrono::steady_clock::now()};
+    TimingWheel m_wheel;
+    std::vector<std::unique_ptr<Session>> m_sessions; // by slot
+    std::vector<std::uint32_t> m_free;     // slots to reuse
+    std::vector<std::uint32_t> m_closed;   // slots freed by the current events
+};
+
+
+//=============================================================================
+//
+//                    Implementations for the class ServerWorker
+//
+//=============================================================================
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::~ServerWorker()
+//
+ServerWorker::~ServerWorker()
+{
+    for(std::uint32_t slot = 0; slot < m_sessions.size(); ++slot){
+        if(m_sessions[slot]){
+            Close(slot);
+        }
+    }
+    if(m_epoll >= 0){
+        close(m_epoll);
+    }
+    if(m_wake >= 0){
+        close(m_wake);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Open()
+//
+bool ServerWorker::Open()
+{
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    m_wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(m_epoll < 0 || m_wake < 0){
+        return false;
+    }
+
+    // each connection wakes up a single worker
+    epoll_event listen_event{};
+    listen_event.events = EPOLLIN | EPOLLEXCLUSIVE;
+    listen_event.data.u64 = LISTEN_KEY;
+    epoll_event wake_event{};
+    wake_event.events = EPOLLIN;
+    wake_event.data.u64 = WAKE_KEY;
+    return epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_server.m_listen, &listen_event) == 0 &&
+           epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &wake_event) == 0;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Stop()
+//
+void ServerWorker::Stop() noexcept
+{
+    m_stopped.store(true, std::memory_order_release);
+    const std::uint64_t one{1};
+    const auto written = write(m_wake, &one, sizeof(one));
+    static_cast<void>(written);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Run()
+//
+void ServerWorker::Run()
+{
+    epoll_event events[EVENTS_PER_WAIT];
+    while( !m_stopped.load(std::memory_order_acquire) )
+    {
+        const int count = epoll_wait(m_epoll, events, EVENTS_PER_WAIT, Timeout());
+        for(int i = 0; i < count; ++i)
+        {
+            const std::uint64_t key = events[i].data.u64;
+            if(key == LISTEN_KEY){
+                Accept();
+                continue;
+            }
+            if(key == WAKE_KEY){
+                continue;
+            }
+            const auto slot = static_cast<std::uint32_t>(key);
+            if( !m_sessions[slot] ){
+                continue; // closed by a previous event
+            }
+            if((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0){
+                Read(slot);
+            }
+            if(m_sessions[slot] && (events[i].events & EPOLLOUT) != 0){
+                Flush(slot);
+            }
+        }
+
+        m_wheel.Advance(Tick(), [this](const long long tick,
+                                       const std::vector<std::uint32_t>& payloads) {
+            // the expired timers are released: no session may cancel them
+            const auto lateness = std::chrono::steady_clock::now() - Deadline(tick);
+            for(const std::uint32_t payload : payloads){
+                m_sessions[payload >> 1]->timers[payload & 1] = INVALID_TIMER;
+                Metrics::Record(HISTOGRAM_TICK_LATENESS, lateness);
+            }
+            for(const std::uint32_t payload : payloads){
+                Attack(payload, tick);
+            }
+        });
+
+        // the slots closed are reused once no pending event refers to them
+        m_free.insert(m_free.end(), m_closed.begin(), m_closed.end());
+        m_closed.clear();
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Tick(): the game time of the monster attacks
+//
+long long ServerWorker::Tick() const noexcept
+{
+    const std::chrono::duration<double, std::milli> elapsed{
+        std::chrono::steady_clock::now() - m_start
+    };
+    return static_cast<long long>(elapsed.count() * m_server.m_config.time_scale);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Deadline(): the time at which a tick is due
+//
+std::chrono::steady_clock::time_point ServerWorker::Deadline(const long long tick) const noexcept
+{
+    const std::chrono::duration<double, std::milli> offset{
+        static_cast<double>(tick) / m_server.m_config.time_scale
+    };
+    return m_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Timeout(): the wait of epoll_wait() until the next attack
+//
+int ServerWorker::Timeout() const noexcept
+{
+    if(m_wheel.Size() == 0){
+        return -1;
+    }
+    const auto ticks = static_cast<double>(m_wheel.NextTick() - Tick());
+    if(ticks <= 0.0){
+        return 0;
+    }
+    const double milliseconds = std::ceil(ticks / m_server.m_config.time_scale);
+    return milliseconds < INT_MAX ? static_cast<int>(milliseconds) : INT_MAX;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Accept()
+//
+void ServerWorker::Accept()
+{
+    for(int i = 0; i < ACCEPTS_PER_WAKEUP; ++i)
+    {
+        const int fd = accept4(m_server.m_listen, nullptr, nullptr,
+                               SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(fd < 0){
+            return; // no more pending connection, or out of descriptors
+        }
+
+        std::uint32_t slot{0};
+        if(m_free.empty()){
+            slot = static_cast<std::uint32_t>(m_sessions.size());
+            m_sessions.emplace_back();
+        }
+        else{
+            slot = m_free.back();
+            m_free.pop_back();
+        }
+        m_sessions[slot] = std::make_unique<Session>();
+        Session& session = *m_sessions[slot];
+        session.fd = fd;
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = slot;
+        if(epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) != 0){
+            close(fd);
+            m_sessions[slot].reset();
+            m_closed.push_back(slot);
+            continue;
+        }
+
+        const long long now = Tick();
+        for(const std::uint32_t monster : {SESSION_ORC, SESSION_DRAGON}){
+            const int interval = RoleCatalog::Instance().AttackInterval(session.Monster(monster).GetRole());
+            session.timers[monster] = m_wheel.Insert(now + interval, slot * 2 + monster);
+        }
+        m_server.m_sessions.fetch_add(1, std::memory_order_relaxed);
+        m_server.m_served.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Read(): frame the commands of a session and answer them
+//
+void ServerWorker::Read(const std::uint32_t slot)
+{
+    Session& session = *m_sessions[slot];
+    const auto count = read(session.fd, session.line + session.fill,
+                            SESSION_LINE_MAX - session.fill);
+    if(count == 0 || (count < 0 && errno != EAGAIN && errno != EINTR)){
+        Close(slot); // the player left
+        return;
+    }
+    if(count < 0){
+        return;
+    }
+
+    const auto received = std::chrono::steady_clock::now();
+    const std::size_t start = session.fill;
+    session.fill += static_cast<std::size_t>(count);
+    std::size_t line_start{0};
+    for(std::size_t i = start; i < session.fill && !session.closing; ++i)
+    {
+        if(session.line[i] != '\n'){
+            continue;
+        }
+        std::size_t end = i;
+        if(end > line_start && session.line[end - 1] == '\r'){
+            --end;
+        }
+        if(session.overflow){
+            session.overflow = false;
+        }
+        else{
+            Execute(session, std::string_view{session.line + line_start,
+                                              end - line_start});
+            Metrics::Record(HISTOGRAM_COMMAND_LATENCY,
+                            std::chrono::steady_clock::now() - received);
+        }
+        line_start = i + 1;
+    }
+
+    session.fill -= line_start;
+    std::memmove(session.line, session.line + line_start, session.fill);
+    if(session.fill == SESSION_LINE_MAX){
+        session.overflow = true;
+        session.fill = 0;
+    }
+    Flush(slot);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Execute(): a command of the hero
+//
+void ServerWorker::Execute(Session& session, const std::string_view command)
+{
+    m_server.m_commands.fetch_add(1, std::memory_order_relaxed);
+    const ROLE_t role = ParseHeroCommand(command);
+    if(role == ROLE_UNDEFINED){
+        session.output += "Hero does not understand the command\n";
+        return;
+    }
+
+    const std::uint32_t monster = role == ROLE_ORC ? SESSION_ORC : SESSION_DRAGON;
+    Fighter& target = session.Monster(monster);
+    if( !session.hero.Hit(target) ){
+        session.output += "Hero cannot attack ";
+        session.output += RoleCatalog::Instance().Name(role);
+        session.output += '\n';
+        return;
+    }
+    Metrics::Count(COUNTER_ATTACKS, session.hero.GetRole());
+
+    const int health = target.IsAlive() ? target.GetHealth() : HEALTH_DEAD;
+    session.output += "Hero hits ";
+    session.output += RoleCatalog::Instance().Name(role);
+    session.output += ". ";
+    session.output += RoleCatalog::Instance().Name(role);
+    session.output += " health is ";
+    session.output += std::to_string(health);
+    session.output += '\n';
+
+    if( !target.IsAlive() ){
+        m_wheel.Cancel(session.timers[monster]);
+        session.timers[monster] = INVALID_TIMER;
+    }
+    if( !session.orc.IsAlive() && !session.dragon.IsAlive() ){
+        EndGame(session, "Game over: you win\n");
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Attack(): a monster attack due on a tick
+//
+void ServerWorker::Attack(const std::uint32_t payload, const long long tick)
+{
+    const std::uint32_t slot = payload >> 1;
+    const std::uint32_t monster = payload & 1;
+    if( !m_sessions[slot] ){
+        return; // closed by another attack of the same tick
+    }
+    Session& session = *m_sessions[slot];
+    Fighter& attacker = session.Monster(monster);
+    const ROLE_t role = attacker.GetRole();
+    if(session.closing || !attacker.Hit(session.hero)){
+        return;
+    }
+    Metrics::Count(COUNTER_ATTACKS, role);
+
+    const int health = session.hero.IsAlive() ? session.hero.GetHealth()
+                                              : HEALTH_DEAD;
+    session.output += RoleCatalog::Instance().Name(role);
+    session.output += " hits Hero. Hero health is ";
+    session.output += std::to_string(health);
+    session.output += '\n';
+
+    if( !session.hero.IsAlive() ){
+        EndGame(session, "Game over: you loose\n");
+    }
+    else{
+        // the next attack is due one interval after this one, not after now
+        session.timers[monster] = m_wheel.Insert(
+            tick + RoleCatalog::Instance().AttackInterval(role), payload);
+    }
+    Flush(slot);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::EndGame()
+//
+void ServerWorker::EndGame(Session& session, const char* message)
+{
+    session.output += message;
+    session.closing = true;
+    for(TimerId& timer : session.timers){
+        m_wheel.Cancel(timer);
+        timer = INVALID_TIMER;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Flush(): send the pending output of a session
+//
+void ServerWorker::Flush(const std::uint32_t slot)
+{
+    Session& session = *m_sessions[slot];
+    while(session.sent < session.output.size())
+    {
+        const auto count = send(session.fd, session.output.data() + session.sent,
+                                session.output.size() - session.sent, MSG_NOSIGNAL);
+        if(count > 0){
+            session.sent += static_cast<std::size_t>(count);
+        }
+        else if(count < 0 && (errno == EAGAIN || errno == EINTR)){
+            if( !session.waiting_output ){
+                Watch(session, slot, true); // resumed on EPOLLOUT
+            }
+            return;
+        }
+        else{
+            Close(slot);
+            return;
+        }
+    }
+
+    session.output.clear();
+    session.sent = 0;
+    if(session.waiting_output){
+        Watch(session, slot, false);
+    }
+    if(session.closing){
+        Close(slot);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Watch(): watch the output of a session or not
+//
+void ServerWorker::Watch(Session& session, const std::uint32_t slot,
+                         const bool output) noexcept
+{
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP | (output ? EPOLLOUT : 0U);
+    event.data.u64 = slot;
+    epoll_ctl(m_epoll, EPOLL_CTL_MOD, session.fd, &event);
+    session.waiting_output = output;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ServerWorker::Close()
+//
+void ServerWorker::Close(const std::uint32_t slot)
+{
+    Session& session = *m_sessions[slot];
+    for(const TimerId timer : session.timers){
+        m_wheel.Cancel(timer);
+    }
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, session.fd, nullptr);
+    close(session.fd);
+    m_sessions[slot].reset();
+    m_closed.push_back(slot);
+    m_server.m_sessions.fetch_sub(1, std::memory_order_relaxed);
+}
+
+
+//=============================================================================
+//
+//                    Implementations for the class GameServer
+//
+//=============================================================================
+
+
+//-----------------------------------------------------------------------------
+//
+//  GameServer::GameServer()
+//
+GameServer::GameServer(const ServerConfig& config) : m_config(config)
+{
+    if(m_config.workers == 0){
+        m_config.workers = 1;
+    }
+    if(m_config.time_scale <= TIME_SCALE_UNTHROTTLED){
+        m_config.time_scale = TIME_SCALE_REAL_TIME;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  GameServer::~GameServer()
+//
+GameServer::~GameServer()
+{
+    Stop();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  GameServer::Start()
+//
+SERVER_STATUS_t GameServer::Start()
+{
+    if(m_listen >= 0){
+        return SERVER_RUNNING;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if(m_config.socket_path == nullptr ||
+       std::strlen(m_config.socket_path) >= sizeof(address.sun_path)){
+        return SERVER_SOCKET_ERROR;
+    }
+    std::strncpy(address.sun_path, m_config.socket_path, sizeof(address.sun_path) - 1);
+
+    m_listen = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    unlink(m_config.socket_path);
+    if(m_listen < 0 ||
+       bind(m_listen, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+       listen(m_listen, SOMAXCONN) != 0)
+    {
+        Stop();
+        return SERVER_SOCKET_ERROR;
+    }
+
+    for(std::size_t i = 0; i < m_config.workers; ++i){
+        m_workers.push_back(std::make_unique<ServerWorker>(*this));
+        if( !m_workers.back()->Open() ){
+            Stop();
+            return SERVER_SOCKET_ERROR;
+        }
+    }
+    for(auto& worker : m_workers){
+        m_threads.emplace_back([&worker]() { worker->Run(); });
+    }
+    return SERVER_OK;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  GameServer::Stop()
+//
+void GameServer::Stop()
+{
+    for(auto& worker : m_workers){
+        worker->Stop();
+    }
+    for(auto& thread : m_threads){
+        thread.join();
+    }
+    m_threads.clear();
+    m_workers.clear(); // closes the sessions
+
+    if(m_listen >= 0){
+        close(m_listen);
+        unlink(m_config.socket_path);
+        m_listen = -1;
+    }
+}
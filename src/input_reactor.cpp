@@ -0,0 +1,215 @@
+#include "input_reactor.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+
+//-----------------------------------------------------------------------------
+//
+//  InputReactor::InputReactor()
+//
+InputReactor::InputReactor()
+{
+    if(pipe(m_wake) != 0){
+        m_wake[0] = m_wake[1] = -1;
+        return;
+    }
+    for(const int fd : m_wake){
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); // NOLINT
+        fcntl(fd, F_SETFD, FD_CLOEXEC); // NOLINT
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  InputReactor::~InputReactor()
+//
+InputReactor::~InputReactor()
+{
+    for(const int fd : m_wake){
+        if(fd >= 0){
+            close(fd);
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  InputReactor::Add()
+//
+bool InputReactor::Add(const int fd, LineHandler on_line, CloseHandler on_close)
+{
+    if(m_wake[0] < 0 || fd < 0){
+        return false;
+    }
+    Input input;
+    input.fd = fd;
+    input.on_line = std::move(on_line);
+    input.on_close = std::move(on_close);
+    input.buffer.resize(INPUT_READ_SIZE);
+    m_inputs.push_back(std::move(input));
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  InputReactor::Stop()
+//
+void InputReactor::Stop() noexcept
+{
+    m_stopped.store(true, std::memory_order_release);
+    if(m_wake[1] >= 0){
+        // the pipe being full already wakes the reactor up
+        const char byte{0};
+        const auto written = write(m_wake[1], &byte, 1);
+        static_cast<void>(written);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  InputReactor::Run()
+//
+std::size_t InputReactor::Run()
+{
+    std::size_t lines{0};
+    while(!Stopped() && !m_inputs.empty())
+    {
+        lines += RunOnce(INPUT_WAIT_FOREVER);
+    }
+    return lines;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  InputReactor::RunOnce()
+//
+std::size_t InputReactor::RunOnce(const int timeout_ms)
+{
+    if(Stopped() || m_inputs.empty()){
+        return 0;
+    }
+
+    m_polled.resize(m_inputs.size() + 1);
+    m_polled[0] = pollfd{m_wake[0], POLLIN, 0};
+    for(std::size_t i = 0; i < m_inputs.size(); ++i){
+        m_polled[i + 1] = pollfd{m_inputs[i].fd, POLLIN, 0};
+    }
+    if(poll(m_polled.data(), m_polled.size(), timeout_ms) <= 0){
+        return 0; // timeout or signal
+    }
+    if(m_polled[0].revents != 0){
+        char bytes[64];
+        while(read(m_wake[0], bytes, sizeof(bytes)) > 0){}
+    }
+
+    std::size_t lines{0};
+    std::vector<std::size_t> closed_inputs;
+    for(std::size_t i = 0; i < m_inputs.size() && !Stopped(); ++i)
+    {
+        if(m_polled[i + 1].revents == 0){
+            continue;
+        }
+        bool closed{(m_polled[i + 1].revents & POLLNVAL) != 0};
+        if(!closed){
+            lines += Read(m_inputs[i], closed);
+        }
+        if(closed){
+            closed_inputs.push_back(i);
+        }
+    }
+
+    // the handlers may not add inputs: the indexes are still valid
+    for(auto index = closed_inputs.rbegin(); index != closed_inputs.rend(); ++index){
+        const CloseHandler on_close = std::move(m_inputs[*index].on_close);
+        m_inputs.erase(m_inputs.begin() + static_cast<std::ptrdiff_t>(*index));
+        if(on_close){
+            on_close();
+        }
+    }
+    return lines;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  InputReactor::Read()
+//
+std::size_t InputReactor::Read(Input& input, bool& closed)
+{
+    const auto count = read(input.fd, input.buffer.data() + input.fill,
+                            INPUT_READ_SIZE - input.fill);
+    if(count < 0){
+        closed = errno != EINTR && errno != EAGAIN && errno != EWOULDBLOCK;
+        return 0;
+    }
+    if(count > 0){
+        const std::size_t start = input.fill;
+        input.fill += static_cast<std::size_t>(count);
+        return Deliver(input, start);
+    }
+
+    // end of the input: its last line may lack the end of line
+    closed = true;
+    if(input.fill == 0 || input.overflow){
+        return 0;
+    }
+    input.buffer[input.fill] = '\n';
+    ++input.fill;
+    return Deliver(input, input.fill - 1);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  InputReactor::Deliver()
+//
+std::size_t InputReactor::Deliver(Input& input, const std::size_t start)
+{
+    const char* buffer = input.buffer.data();
+    std::size_t lines{0};
+    std::size_t line_start{0};
+
+    for(std::size_t i = start; i < input.fill && !Stopped(); ++i)
+    {
+        if(buffer[i] != '\n'){
+            continue;
+        }
+        std::size_t end = i;
+        if(end > line_start && buffer[end - 1] == '\r'){
+            --end;
+        }
+        if(input.overflow){
+            input.overflow = false; // end of the dropped line
+        }
+        else if(end - line_start <= INPUT_LINE_MAX){
+            input.on_line( std::string_view{buffer + line_start, end - line_start} );
+            ++lines;
+        }
+        line_start = i + 1;
+    }
+
+    if(Stopped()){
+        input.fill = 0;
+        return lines;
+    }
+    // the pending line moves to the front of the buffer, unless it is
+    // already too long: there is always room left to read
+    input.fill -= line_start;
+    if(input.fill > INPUT_LINE_MAX){
+        input.overflow = true;
+        input.fill = 0;
+    }
+    std::memmove(input.buffer.data(), buffer + line_start, input.fill);
+    return lines;
+}
@@ -1,179 +1,365 @@
+#include <atomic>
+#include <csignal>
 #include <bits/chrono.h>
-#include <cctype>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <functional>
 #include <iostream>
-#include <mutex>
-#include <string>
+#include <string_view>
 #include <thread>
-#include <type_traits>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include "alive_index.h"
+#include "combat_log.h"
+#include "command_parser.h"
+#include "event_scheduler.h"
+#include "game_loop.h"
+#include "game_server.h"
 #include "fighter.h"
-#include <iostream>
-#include <mutex>
-#include <string>
-#include <thread>
+#include "input_reactor.h"
+#include "metrics.h"
+#include "monster_behavior.h"
+#include "replay_log.h"
+#include "role_catalog.h"
+
+alignas(CACHE_LINE_SIZE) std::atomic<bool> g_game_running{false}; // NOLINT
 
-extern std::mutex g_mutex; // NOLINT --> deactivate all clang-tidy for this line
-bool g_game_running{false}; // NOLINT
-const int ORC_ATTACK_INTERVAL = 1500;
-const int DRAGON_ATTACK_INTERVAL = 2000;
+// SIGUSR1 writes a line into this pipe, read by the input reactor
+static int g_metrics_pipe[2]{-1, -1}; // NOLINT
 
 
 /**
- * @brief Execute monster actions
- * 
- * This function is called from the main to handle all hero actions, 
- * e.g hitting the monsters. The hero receive its command given by the player
- * of the game via the command line. 
- * 
- * @param hero the Hero of the game
- * @param orc a monster that fight against the Hero
- * @param dragon a monster that fight against the Hero
+ * @brief Ask for a dump of the metrics: the SIGUSR1 handler
  */
-void execute_hero_actions(const Hero &hero, 
-                          Orc &orc, 
-                          Dragon &dragon)
+static void request_metrics_dump(int /*signal*/)
 {
-    // static analyzers may complain about the fact that not all template
-    // arguments were given.
-    std::string command_in;
-    std::string command;
+    const char line = '\n';
+    [[maybe_unused]] const auto written = write(g_metrics_pipe[1], &line, 1);
+}
 
-    while (g_game_running)
-    {
-        std::cout << "Enter an attack command: ";
-        std::getline(std::cin, command_in);
-        command.clear();
 
-        for(auto item : command_in){
-            command += static_cast<char>( tolower(item) );
-        }
+/**
+ * @brief Print the prompt of the player
+ */
+static void print_prompt()
+{
+    // the prompt comes after the messages of the previous attacks
+    CombatLog::Instance().Flush();
+    std::cout << "Enter an attack command: " << std::flush;
+}
 
-        if (command == "attack orc") {
-            #pragma omp critical
-            hero.Attack(orc);
-        }
-        else if (command == "attack dragon") {
-            #pragma omp critical
-            hero.Attack(dragon);
-        }
 
-        if (!hero.IsAlive() || (!dragon.IsAlive() && !orc.IsAlive())) {
-            #pragma omp critical
-            g_game_running = false;
-        }
-    }
+/**
+ * @brief The slots of the fighters of the game in its AliveIndex: the
+ *        commands name the fighters by their slot
+ */
+struct GameSlots {
+    std::uint32_t hero{0};
+    std::uint32_t orc{0};
+    std::uint32_t dragon{0};
+};
 
-    std::cout << "\033[32m";
-    std::cout << "\n-----------------------------------------";
-    std::cout << "\n|        THREAD 0: GAME OVER            |";
-    std::cout << "\n|              YOU WIN                  |";
-    std::cout << "\n-----------------------------------------\n\n";
-    std::cout << "\033[0m";
 
-    std::lock_guard<std::mutex> lock1(g_mutex); // NOLINT
-    exit(EXIT_SUCCESS); // NOLINT : thread unsafe
+/**
+ * @brief Execute a hero action
+ * 
+ * This function is called by the input reactor of the main thread with each
+ * command given by the player of the game via the command line, e.g hitting
+ * the monsters.
+ * 
+ * @param game the simulation of the game
+ * @param slots the slots of the fighters of the game
+ * @param command the command line typed by the player
+ * @return The ticket of the attack, or NO_TICKET if there is none
+ */
+static std::uint64_t execute_hero_action(GameLoop &game,
+                                         const GameSlots &slots,
+                                         const std::string_view command)
+{
+    // the attack is applied by the simulation thread, the only one
+    // changing the fighters
+    switch( ParseHeroCommand(command) )
+    {
+        case ROLE_ORC:    return game.Submit({COMMAND_ATTACK, slots.hero, slots.orc});
+        case ROLE_DRAGON: return game.Submit({COMMAND_ATTACK, slots.hero, slots.dragon});
+        default:          return NO_TICKET;
+    }
 }
 
 
 /**
  * @brief Execute monster actions
  * 
- * This function is called from the main to handle all enemy actions, 
+ * This function runs on its own thread to handle all enemy actions, 
  * e.g enemy hitting the hero. 
- * It's implemented as template function that uses the c++11 
- * trailing return type notation (-> return_type) and c++11 
- * type traits (enable_if, is_base_of) to restrict the template to function
- * calls where the second parameter is a 'Monster', 'Orc' or 'Dragon' type.
+ * All monsters share a single thread: the behavior of each monster is a
+ * coroutine sleeping for the interval of its role, ORC_ATTACK_INTERVAL or
+ * DRAGON_ATTACK_INTERVAL, between the attacks it submits to the simulation.
  * 
- * @tparam T type of the template parameter, either 'Monster', 'Dragon' or 'Orc'
- * @param hero the Hero of the game
- * @param enemy a monster that fight against the Hero
- * @return std::enable_if_t<std::is_base_of_v<Monster, T>> 
+ * @param executor the real time executor of the monster behaviors
+ * @param game the simulation of the game
+ * @param orc a monster that fight against the Hero
+ * @param dragon a monster that fight against the Hero
+ * @param slots the slots of the fighters of the game
  */
-template<typename T>
-auto execute_monster_actions(Hero &hero, const T &enemy) 
--> std::enable_if_t<std::is_base_of_v<Monster, T>>
+static void execute_monster_actions(BehaviorExecutor &executor,
+                                    GameLoop &game,
+                                    const Orc &orc,
+                                    const Dragon &dragon,
+                                    const GameSlots &slots)
 {
-    int ATTACK_INTERVAL{0};
+    executor.Spawn( MonsterCommandBehavior(executor, orc, game,
+                                           {COMMAND_ATTACK, slots.orc, slots.hero}) );
+    executor.Spawn( MonsterCommandBehavior(executor, dragon, game,
+                                           {COMMAND_ATTACK, slots.dragon, slots.hero}) );
+    executor.Run();
+}
 
-    if(enemy.GetRole() == ROLE_ORC){
-        ATTACK_INTERVAL = ORC_ATTACK_INTERVAL;
+
+/**
+ * @brief Print the end of the game, and record it in the replay log
+ * 
+ * @param hero the Hero of the game
+ * @param orc a monster that fight against the Hero
+ * @param dragon a monster that fight against the Hero
+ */
+static void print_game_over(const Hero &hero, 
+                            const Orc &orc, 
+                            const Dragon &dragon)
+{
+    CombatLog::Instance().Flush();
+    if( hero.IsAlive() && !orc.IsAlive() && !dragon.IsAlive() ){
+        ReplayRecorder::Instance().RecordGameOver(true);
+        std::cout << "\033[32m";
+        std::cout << "\n-----------------------------------------";
+        std::cout << "\n|        THREAD 0: GAME OVER            |";
+        std::cout << "\n|              YOU WIN                  |";
+        std::cout << "\n-----------------------------------------\n\n";
+        std::cout << "\033[0m";
+    }
+    else if( !hero.IsAlive() ){
+        ReplayRecorder::Instance().RecordGameOver(false);
+        std::cout << "\033[31m";
+        std::cout << "\n-----------------------------------------";
+        std::cout << "\n|        THREAD 1: GAME OVER            |";
+        std::cout << "\n|             YOU LOOSE                 |";
+        std::cout << "\n-----------------------------------------\n\n";
+        std::cout << "\033[0m";
     }
-    else if(enemy.GetRole() == ROLE_DRAGON){
-        ATTACK_INTERVAL = DRAGON_ATTACK_INTERVAL;
+    else{
+        std::cout << "\nNo more commands: game aborted\n";
     }
+}
 
-    //const auto start = std::chrono::high_resolution_clock::now();
-    //std::chrono::_V2::system_clock::time_point end;
-    //long long elapsed{0}; 
 
-    while(g_game_running){
-        /*
-         * TODO(Godel): is it possible to trigger an event with a time 
-                        accuracy in milliseconds ? This might perhaps 
-                        require a real time kernel or some special hardware!! 
-                        Workaround: Ignore this for now
-         */
+/**
+ * @brief Print the accuracy of the monster attacks: the drift and the jitter
+ *        of their wake ups after the deadlines
+ * 
+ * @param timing the statistics of the executor of the monster behaviors
+ */
+static void print_attack_timing(const TimingStats &timing)
+{
+    if(timing.count == 0){
+        return;
+    }
+    constexpr double NS_PER_US = 1000.0;
+    std::cout << "Monster attacks: " << timing.count << " deadlines, drift "
+              << timing.mean_lateness / NS_PER_US << " us, jitter "
+              << timing.jitter / NS_PER_US << " us, max "
+              << static_cast<double>(timing.max_lateness) / NS_PER_US << " us\n";
+}
 
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(ATTACK_INTERVAL)
-        );
 
-        //end = std::chrono::high_resolution_clock::now();
-        //elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+/**
+ * @brief Serve many players over a Unix domain socket, until SIGINT or
+ *        SIGTERM
+ *
+ * @param config the socket and the number of workers
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if the server could not start
+ */
+static int serve(const ServerConfig& config)
+{
+    // the signals are waited for by this thread only: the workers inherit
+    // the mask
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    GameServer server{config};
+    if(server.Start() != SERVER_OK){
+        std::cerr << "Unable to listen on '" << config.socket_path << "'\n";
+        return EXIT_FAILURE;
+    }
+    std::cout << "Serving on " << config.socket_path << " with "
+              << config.workers << " workers, Ctrl-C to stop" << std::endl;
+
+    // SIGUSR1 dumps the metrics in JSON on the error output
+    int signal{0};
+    while(sigwait(&signals, &signal) == 0 && signal == SIGUSR1){
+        Metrics::Instance().Dump(std::cerr, METRICS_JSON);
+    }
+    server.Stop();
+    std::cout << "Sessions served:   " << server.SessionsServed() << "\n"
+              << "Commands answered: " << server.Commands() << "\n";
+    return EXIT_SUCCESS;
+}
 
-        #pragma omp critical
-        enemy.Attack(hero);
 
-        if( !hero.IsAlive() ) {
-            #pragma omp critical
-            g_game_running = false;
+int main(int argc, char** argv)
+{
+    const char* record_path{nullptr};
+    const char* roles_path{nullptr};
+    ServerConfig server_config;
+    for(int i = 1; i < argc; i += 2){
+        const char* option = argv[i];                            // NOLINT
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr; // NOLINT
+        if(value != nullptr && std::strcmp(option, "--record") == 0){
+            record_path = value;
+        }
+        else if(value != nullptr && std::strcmp(option, "--serve") == 0){
+            server_config.socket_path = value;
+        }
+        else if(value != nullptr && std::strcmp(option, "--workers") == 0){
+            server_config.workers = std::strtoull(value, nullptr, 10);
+        }
+        else if(value != nullptr && std::strcmp(option, "--roles") == 0){
+            roles_path = value;
+        }
+        else{
+            std::cerr << "Usage: " << argv[0] << " [--roles FILE] [--record FILE]\n"      // NOLINT
+                      << "       " << argv[0] << " [--roles FILE] --serve SOCKET [--workers N]\n"; // NOLINT
+            return EXIT_FAILURE;
         }
-        //std::cout << enemy.RoleToString() << " hits the Hero at " << elapsed << " ms\n";
     }
 
-    std::cout << "\033[31m";
-    std::cout << "\n-----------------------------------------";
-    std::cout << "\n|        THREAD 1: GAME OVER            |";
-    std::cout << "\n|             YOU LOOSE                 |";
-    std::cout << "\n-----------------------------------------\n\n";
-    std::cout << "\033[0m";
+    // --roles FILE: the roles of the game from a catalog, before any fighter
+    if(roles_path != nullptr){
+        RoleCatalog& catalog = RoleCatalog::Instance();
+        if(catalog.LoadFile(roles_path) != CATALOG_OK){
+            std::cerr << "Invalid role catalog '" << roles_path << "'";
+            if(catalog.ErrorLine() != 0){
+                std::cerr << " at line " << catalog.ErrorLine();
+            }
+            std::cerr << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+    if(server_config.socket_path != nullptr){
+        return serve(server_config);
+    }
 
-    std::lock_guard<std::mutex> lock2(g_mutex); // NOLINT
-    exit(EXIT_SUCCESS); // NOLINT
-}
+    // --record FILE: every hit of the game is written to a replay log
+    std::ofstream record_file;
+    if(record_path != nullptr){
+        record_file.open(record_path, std::ios::binary);
+        if(!record_file){
+            std::cerr << "Unable to write '" << record_path << "'\n";
+            return EXIT_FAILURE;
+        }
+    }
 
+    // each fighter on its own cache line: threads hitting different
+    // fighters do not invalidate each other's cache
+    alignas(CACHE_LINE_SIZE) auto hero = Hero(ROLE_HERO);
+    alignas(CACHE_LINE_SIZE) auto orc = Orc(ROLE_ORC);
+    alignas(CACHE_LINE_SIZE) auto dragon = Dragon(ROLE_DRAGON);
 
-int main(/*int argc, char** argv*/)
-{
-    auto hero = Hero(ROLE_HERO);
-    auto orc = Orc(ROLE_ORC);
-    auto dragon = Dragon(ROLE_DRAGON);
+    // the fighters killed by an attack leave the index: the end of the
+    // game is known without asking each fighter
+    AliveIndex alive;
+    GameSlots slots;
+    slots.hero = static_cast<std::uint32_t>(alive.Add(hero));
+    slots.orc = static_cast<std::uint32_t>(alive.Add(orc));
+    slots.dragon = static_cast<std::uint32_t>(alive.Add(dragon));
 
-    g_game_running = true;
+    // the attacks only append their messages to a ring buffer: the
+    // terminal output is done by a background thread
+    CombatLog::Instance().Start(LOG_MODE_ASYNC_TEXT, LOG_OVERFLOW_BLOCK);
+    if(record_file.is_open()){
+        ReplayRecorder::Instance().Start(record_file);
+        ReplayRecorder::Instance().Spawn(hero);
+        ReplayRecorder::Instance().Spawn(orc);
+        ReplayRecorder::Instance().Spawn(dragon);
+    }
+    g_game_running.store(true);
 
-    std::thread hero_thread{
-        execute_hero_actions, 
-        std::cref(hero), 
-        std::ref(orc), 
-        std::ref(dragon)
+    // the commands of the player are read by the main thread: an input
+    // reactor waits for them, and wakes up as soon as the game is over
+    BehaviorExecutor executor{TIME_SCALE_REAL_TIME};
+    InputReactor reactor;
+    GameLoop game{alive, true};
+    const auto end_game = [&]() {
+        g_game_running.store(false);
+        game.Stop();
+        executor.Stop();
+        reactor.Stop();
     };
-    std::thread orc_thread{
-        execute_monster_actions<Orc>, 
-        std::ref(hero), 
-        std::cref(orc)
-    };
-    std::thread dragon_thread{
-        execute_monster_actions<Dragon>, 
-        std::ref(hero), 
-        std::cref(dragon)
+    reactor.Add(STDIN_FILENO, 
+        [&](const std::string_view command) {
+            if( !g_game_running.load() ){
+                return;
+            }
+            if(command == "metrics" || command == "metrics json"){
+                CombatLog::Instance().Flush();
+                Metrics::Instance().Dump(std::cout, command == "metrics" ? METRICS_TEXT
+                                                                         : METRICS_JSON);
+                print_prompt();
+                return;
+            }
+            // the prompt waits for the attack: its message comes first
+            const auto received = std::chrono::steady_clock::now();
+            game.WaitFor( execute_hero_action(game, slots, command) );
+            Metrics::Record(HISTOGRAM_COMMAND_LATENCY,
+                            std::chrono::steady_clock::now() - received);
+            if( !game.Stopped() ){
+                print_prompt();
+            }
+        },
+        end_game
+    );
+
+    // kill -USR1 dumps the metrics in JSON on the error output
+    // a full pipe drops the line rather than block the signal handler
+    if(pipe2(g_metrics_pipe, O_NONBLOCK | O_CLOEXEC) == 0){
+        reactor.Add(g_metrics_pipe[0], [](std::string_view /*line*/) {
+            Metrics::Instance().Dump(std::cerr, METRICS_JSON);
+        });
+        std::signal(SIGUSR1, request_metrics_dump);
+    }
+
+    // the simulation thread owns the fighters: the game is over as soon as
+    // it kills the last fighter of a side
+    std::thread simulation_thread{[&]() {
+        game.Run();
+        end_game();
+    }};
+    std::thread monster_thread{
+        execute_monster_actions, 
+        std::ref(executor), 
+        std::ref(game), 
+        std::cref(orc),
+        std::cref(dragon),
+        std::cref(slots)
     };
 
-    hero_thread.join();
-    orc_thread.join();
-    dragon_thread.join();
+    print_prompt();
+    reactor.Run();
+    end_game();
+    monster_thread.join();
+    simulation_thread.join();
+
+    print_game_over(hero, orc, dragon);
+    print_attack_timing(executor.Timing());
+    ReplayRecorder::Instance().Stop();
+    CombatLog::Instance().Stop();
 
     return EXIT_SUCCESS;
 }
-
@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+// Commands of a game won by the hero: the orc first, then the dragon
+static constexpr int ORC_COMMANDS = 4;
+static constexpr std::size_t PLAYER_LINE_MAX = 256;
+
+
+/**
+ * @brief A simulated player, with its connection to the server
+ */
+struct Player {
+    int fd{-1};
+    char line[PLAYER_LINE_MAX]{};
+    std::size_t fill{0};
+    Clock::time_point sent;     // time of the command waiting for its answer
+    Clock::time_point next;     // time of the next command
+    bool waiting{false};
+    int moves{0};               // commands answered in the current game
+};
+
+// A command to send: the time, and the index of the player. Planning a new
+// command for a player cancels the previous one.
+using PlannedCommand = std::pair<Clock::time_point, std::size_t>;
+using PlannedQueue = std::priority_queue<PlannedCommand, std::vector<PlannedCommand>,
+                                         std::greater<PlannedCommand>>;
+
+static void plan(PlannedQueue& planned, Player& player, const std::size_t index,
+                 const Clock::time_point time)
+{
+    player.next = time;
+    planned.emplace(time, index);
+}
+
+
+/**
+ * @brief Print the command line usage of the load generator
+ *
+ * @param program the name of the executable
+ */
+static void print_usage(const char* program)
+{
+    std::cout << "Usage: " << program << " --socket PATH [options]\n"
+              << "  --socket PATH        socket of basic_game --serve\n"
+              << "  --sessions N         simultaneous players (default 10000)\n"
+              << "  --commands N         commands to send in total (default\n"
+              << "                       20 per player)\n"
+              << "  --interval MS        time between two commands of a player,\n"
+              << "                       once answered (default 100)\n";
+}
+
+
+/**
+ * @brief Connect a player to the server
+ *
+ * @param path the path to the socket of the server
+ * @param epoll the event loop receiving the answers
+ * @param index the index of the player
+ * @return The connected socket, or -1
+ */
+static int connect_player(const char* path, const int epoll, const std::size_t index)
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+    // a blocking connect waits for room in the backlog of the server
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(fd < 0){
+        return -1;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = index;
+    if(connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+       fcntl(fd, F_SETFL, O_NONBLOCK) != 0 ||
+       epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+
+/**
+ * @brief A percentile of sorted latencies
+ *
+ * @param sorted the latencies, in increasing order
+ * @param percent the percentile, e.g 99
+ * @return The latency below which the given percentage of the commands are
+ */
+static double percentile(const std::vector<double>& sorted, const double percent)
+{
+    if(sorted.empty()){
+        return 0.0;
+    }
+    const auto rank = static_cast<std::size_t>(
+        percent / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[rank];
+}
+
+
+int main(int argc, char** argv)
+{
+    const char* path{nullptr};
+    std::size_t sessions{10000};
+    std::size_t commands{0};
+    long long interval{100};
+
+    for(int i = 1; i + 1 < argc; i += 2){
+        const char* option = argv[i];    // NOLINT
+        const char* value = argv[i + 1]; // NOLINT
+        if(std::strcmp(option, "--socket") == 0){
+            path = value;
+        }
+        else if(std::strcmp(option, "--sessions") == 0){
+            sessions = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(option, "--commands") == 0){
+            commands = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(option, "--interval") == 0){
+            interval = std::atoll(value);
+        }
+        else{
+            print_usage(argv[0]); // NOLINT
+            return EXIT_FAILURE;
+        }
+    }
+    if(path == nullptr || argc % 2 == 0 || sessions == 0 || interval < 0){
+        print_usage(argv[0]); // NOLINT
+        return EXIT_FAILURE;
+    }
+    if(commands == 0){
+        commands = sessions * 20;
+    }
+
+    // one descriptor per player
+    rlimit files{};
+    if(getrlimit(RLIMIT_NOFILE, &files) == 0){
+        files.rlim_cur = files.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &files);
+    }
+
+    const int epoll = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<Player> players(sessions);
+    PlannedQueue planned;
+    std::mt19937 random{0};
+    std::uniform_int_distribution<long long> spread{0, std::max(interval, 1LL) - 1};
+    const std::chrono::milliseconds pause{interval};
+
+    const auto connect_start = Clock::now();
+    for(std::size_t i = 0; i < sessions; ++i){
+        players[i].fd = connect_player(path, epoll, i);
+        if(players[i].fd < 0){
+            std::cerr << "Unable to connect player " << i << " to '" << path << "'\n";
+            return EXIT_FAILURE;
+        }
+        // the first commands are spread over an interval
+        plan(planned, players[i], i, connect_start + std::chrono::milliseconds(spread(random)));
+    }
+
+    std::vector<double> latencies; // microseconds
+    latencies.reserve(commands);
+    std::size_t sent{0};
+    std::size_t games{0};
+    std::size_t lost{0};
+    std::vector<epoll_event> events(1024);
+    const auto start = Clock::now();
+
+    while(latencies.size() + lost < commands)
+    {
+        // send the commands due
+        auto now = Clock::now();
+        while(!planned.empty() && planned.top().first <= now && sent < commands)
+        {
+            const auto [time, index] = planned.top();
+            planned.pop();
+            Player& player = players[index];
+            if(time != player.next || player.fd < 0){
+                continue; // replaced by a later plan
+            }
+            const char* command = player.moves < ORC_COMMANDS ? "attack orc\n"
+                                                              : "attack dragon\n";
+            const auto length = static_cast<ssize_t>(std::strlen(command));
+            if(send(player.fd, command, static_cast<std::size_t>(length), MSG_NOSIGNAL) == length){
+                player.sent = Clock::now();
+                player.waiting = true;
+                ++sent;
+            }
+        }
+
+        int timeout{-1};
+        if(!planned.empty() && sent < commands){
+            const auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+                planned.top().first - Clock::now());
+            timeout = static_cast<int>(std::max<long long>(wait.count(), 0));
+        }
+        const int count = epoll_wait(epoll, events.data(),
+                                     static_cast<int>(events.size()), timeout);
+
+        now = Clock::now();
+        for(int e = 0; e < count; ++e)
+        {
+            const std::size_t index = events[static_cast<std::size_t>(e)].data.u64;
+            Player& player = players[index];
+            const auto received = read(player.fd, player.line + player.fill,
+                                       PLAYER_LINE_MAX - player.fill);
+            if(received <= 0){
+                // game over: the server closed the session, a new one starts
+                lost += player.waiting ? 1U : 0U;
+                close(player.fd);
+                player = Player{};
+                player.fd = connect_player(path, epoll, index);
+                ++games;
+                if(player.fd >= 0){
+                    plan(planned, player, index, now + pause);
+                }
+                continue;
+            }
+
+            player.fill += static_cast<std::size_t>(received);
+            std::size_t line_start{0};
+            for(std::size_t i = 0; i < player.fill; ++i)
+            {
+                if(player.line[i] != '\n'){
+                    continue;
+                }
+                const std::string_view line{player.line + line_start, i - line_start};
+                line_start = i + 1;
+                // the answers to the commands start with "Hero ", the attacks
+                // of the monsters are pushed without being asked for
+                if(player.waiting && line.substr(0, 5) == "Hero "){
+                    const std::chrono::duration<double, std::micro> latency{now - player.sent};
+                    latencies.push_back(latency.count());
+                    player.waiting = false;
+                    ++player.moves;
+                    plan(planned, player, index, now + pause);
+                }
+            }
+            player.fill -= line_start;
+            std::memmove(player.line, player.line + line_start, player.fill);
+            if(player.fill == PLAYER_LINE_MAX){
+                player.fill = 0; // not a line of the protocol
+            }
+        }
+    }
+
+    const std::chrono::duration<double> elapsed{Clock::now() - start};
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << "Sessions:          " << sessions << "\n"
+              << "Games finished:    " << games << "\n"
+              << "Commands answered: " << latencies.size() << "\n"
+              << "Commands lost:     " << lost << "\n"
+              << "Wall time:         " << elapsed.count() << " s\n"
+              << "Throughput:        "
+              << static_cast<double>(latencies.size()) / elapsed.count()
+              << " commands/s\n"
+              << "Latency p50:       " << percentile(latencies, 50.0) << " us\n"
+              << "Latency p99:       " << percentile(latencies, 99.0) << " us\n"
+              << "Latency max:       "
+              << (latencies.empty() ? 0.0 : latencies.back()) << " us\n";
+
+    for(const auto& player : players){
+        if(player.fd >= 0){
+            close(player.fd);
+        }
+    }
+    close(epoll);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "replay_log.h"
+#include "role_catalog.h"
+
+
+/**
+ * @brief Print the command line usage of the replay tool
+ *
+ * @param program the name of the executable
+ */
+static void print_usage(const char* program)
+{
+    std::cout << "Usage: " << program << " FILE [options]\n"
+              << "  FILE                 replay log written by basic_game --record\n"
+              << "  --repeat N           replay the log N times (default 1)\n"
+              << "  --roles FILE         role catalog the game was played with\n";
+}
+
+
+int main(int argc, char** argv)
+{
+    if(argc < 2 || argc % 2 != 0){
+        print_usage(argv[0]); // NOLINT
+        return EXIT_FAILURE;
+    }
+    const char* path = argv[1]; // NOLINT
+    std::size_t repeat{1};
+
+    for(int i = 2; i + 1 < argc; i += 2){
+        const char* option = argv[i];    // NOLINT
+        const char* value = argv[i + 1]; // NOLINT
+        if(std::strcmp(option, "--repeat") == 0){
+            repeat = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(option, "--roles") == 0){
+            if(RoleCatalog::Instance().LoadFile(value) != CATALOG_OK){
+                std::cerr << "Invalid role catalog '" << value << "'\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else{
+            print_usage(argv[0]); // NOLINT
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the whole log is read first: the replay is timed without the disk
+    std::ifstream file{path, std::ios::binary};
+    if(!file){
+        std::cerr << "Unable to read '" << path << "'\n";
+        return EXIT_FAILURE;
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    const std::string log = content.str();
+
+    ReplayResult result;
+    const auto start = std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < repeat; ++i){
+        std::istringstream input{log};
+        result = Replay(input);
+        if(!result.valid){
+            std::cerr << "'" << path << "' is not a valid replay log\n";
+            return EXIT_FAILURE;
+        }
+    }
+    const std::chrono::duration<double> elapsed{
+        std::chrono::steady_clock::now() - start
+    };
+
+    std::cout << "Events:            " << result.events << "\n"
+              << "Hits:              " << result.hits << "\n"
+              << "Deaths:            " << result.deaths << "\n"
+              << "Winner:            "
+              << (!result.game_over ? "none" : result.hero_wins ? "hero" : "monsters")
+              << "\n"
+              << "Mismatches:        " << result.mismatches << "\n";
+    if(result.mismatches != 0){
+        std::cout << "First mismatch:    event " << result.first_mismatch << "\n";
+    }
+    std::cout << "Wall time:         " << elapsed.count() << " s\n"
+              << "Throughput:        "
+              << static_cast<double>(result.events * repeat) / elapsed.count()
+              << " events/s\n";
+
+    return result.mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
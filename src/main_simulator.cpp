@@ -0,0 +1,358 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "battle_solver.h"
+#include "event_scheduler.h"
+#include "simulation.h"
+#include "work_stealing_pool.h"
+#include "world_snapshot.h"
+
+
+/**
+ * @brief Print the command line usage of the simulator
+ *
+ * @param program the name of the executable
+ */
+static void print_usage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --battles N          number of battles (default 1000000)\n"
+              << "  --policy P           orc | dragon | script (default orc)\n"
+              << "  --script FILE        commands of the hero, one per line\n"
+              << "  --hero-interval MS   time between two commands (default 1000)\n"
+              << "  --jitter MS          random extra delay per command (default 0)\n"
+              << "  --orc-interval MS    time between two orc attacks\n"
+              << "  --dragon-interval MS time between two dragon attacks\n"
+              << "  --hero-health N      start health of the hero, likewise\n"
+              << "  --orc-health N       for the orc and the dragon (default: the\n"
+              << "  --dragon-health N    game values)\n"
+              << "  --seed N             seed of the first battle (default 0)\n"
+              << "  --workers N          run the battles as concurrent sessions on\n"
+              << "                       a work-stealing pool, 0 for one worker per core\n"
+              << "  --events-per-task N  events of a session run by a task (default 1)\n"
+              << "  --exact              solve the battle exactly instead of simulating\n"
+              << "                       it, the jitter is ignored\n"
+              << "  --horde N            one hero, of --hero-health, against N orcs and\n"
+              << "                       dragons attacking on an event scheduler\n"
+              << "  --steps N            with --horde, stop after N monster actions\n"
+              << "                       (default: when the hero dies)\n"
+              << "  --checkpoint FILE    with --horde, save the world to FILE once stopped\n"
+              << "  --restore FILE       resume the horde battle saved in FILE\n";
+}
+
+
+/**
+ * @brief Run a horde battle: one hero against many monsters attacking on an
+ *        event scheduler
+ *
+ * A new battle starts with the monsters alternately orcs and dragons. The
+ * world is saved as a snapshot: the fighter 0 is the hero, the fighter
+ * i + 1 the monster i, and a timer is the next attack of a fighter.
+ *
+ * @param monster_count the number of monsters of a new battle
+ * @param hero_health the health points of the hero of a new battle
+ * @param restore_path the snapshot of the battle to resume, or nullptr
+ * @param checkpoint_path the snapshot written once stopped, or nullptr
+ * @param steps the largest number of monster actions to process
+ * @return EXIT_SUCCESS, or EXIT_FAILURE if a snapshot could not be used
+ */
+static int run_horde(const std::size_t monster_count, const int hero_health,
+                     const char* restore_path, const char* checkpoint_path,
+                     const std::size_t steps)
+{
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    WorldState world;
+    if(restore_path != nullptr){
+        const auto start = std::chrono::steady_clock::now();
+        const SNAPSHOT_STATUS_t status = ReadSnapshot(restore_path, world);
+        if(status != SNAPSHOT_OK || world.fighters.Size() == 0){
+            std::cerr << "Unable to restore the snapshot '" << restore_path
+                      << "' (status " << status << ")\n";
+            return EXIT_FAILURE;
+        }
+        std::cout << "Restored:          " << world.fighters.Size() << " fighters, "
+                  << world.timers.size() << " timers in "
+                  << Milliseconds(std::chrono::steady_clock::now() - start).count() << " ms\n";
+    }
+    else{
+        world.fighters.Reserve(monster_count + 1);
+        world.fighters.SetHealth(world.fighters.Add(ROLE_HERO), hero_health);
+        for(std::size_t i = 0; i < monster_count; ++i){
+            world.fighters.Add(i % 2 == 0 ? ROLE_ORC : ROLE_DRAGON);
+        }
+    }
+
+    Hero hero{world.fighters.GetRole(0)};
+    hero.SetHealth(world.fighters.GetHealth(0));
+    std::vector<Monster> monsters;
+    std::vector<const Monster*> attackers;
+    monsters.reserve(world.fighters.Size() - 1);
+    attackers.reserve(world.fighters.Size() - 1);
+    for(std::size_t i = 1; i < world.fighters.Size(); ++i){
+        monsters.emplace_back(world.fighters.GetRole(i));
+        monsters.back().SetHealth(world.fighters.GetHealth(i));
+        attackers.push_back(&monsters.back());
+    }
+
+    EventScheduler scheduler;
+    if(restore_path != nullptr){
+        std::vector<ScheduledEvent> events;
+        events.reserve(world.timers.size());
+        for(const SnapshotTimer& timer : world.timers){
+            if(timer.actor == 0 || timer.actor > monsters.size()){
+                std::cerr << "Invalid timer in the snapshot '" << restore_path << "'\n";
+                return EXIT_FAILURE;
+            }
+            events.push_back(ScheduledEvent{timer.time, timer.actor - 1,
+                                            timer.sequence});
+        }
+        scheduler.Restore(world.clock, events);
+    }
+    else{
+        ScheduleMonsterActions(scheduler, attackers);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::size_t attacks = world.over ? 0U
+        : ResumeMonsterActions(scheduler, hero, attackers, false, steps);
+    const std::chrono::duration<double> elapsed{
+        std::chrono::steady_clock::now() - start
+    };
+
+    world.clock = scheduler.Now();
+    world.steps += attacks;
+    world.over = world.over || !hero.IsAlive() || scheduler.Size() == 0;
+    world.hero_wins = world.over && hero.IsAlive();
+    std::cout << "Monsters:          " << monsters.size() << "\n"
+              << "Attacks:           " << attacks << " (" << world.steps << " in total)\n"
+              << "Hero health:       " << (hero.IsAlive() ? hero.GetHealth() : HEALTH_DEAD) << "\n"
+              << "Simulated time:    " << world.clock << " ms\n"
+              << "Game over:         " << (world.over ? "yes" : "no") << "\n"
+              << "Wall time:         " << elapsed.count() << " s\n";
+
+    if(checkpoint_path == nullptr){
+        return EXIT_SUCCESS;
+    }
+    const auto save_start = std::chrono::steady_clock::now();
+    world.fighters.Clear();
+    world.fighters.Add(hero);
+    for(const Monster& monster : monsters){
+        world.fighters.Add(monster);
+    }
+    world.timers.clear();
+    for(const ScheduledEvent& event : scheduler.Pending()){
+        world.timers.push_back(SnapshotTimer{event.time, event.actor + 1, event.sequence});
+    }
+    if(WriteSnapshot(world, checkpoint_path) != SNAPSHOT_OK){
+        std::cerr << "Unable to write the snapshot '" << checkpoint_path << "'\n";
+        return EXIT_FAILURE;
+    }
+    std::cout << "Checkpoint:        " << world.fighters.Size() << " fighters, "
+              << world.timers.size() << " timers in "
+              << Milliseconds(std::chrono::steady_clock::now() - save_start).count() << " ms\n";
+    return EXIT_SUCCESS;
+}
+
+
+/**
+ * @brief Read the commands of a script file
+ *
+ * Each line of the file is a command as typed by a player during a game,
+ * e.g "attack orc". Unknown commands are kept, the hero then does nothing.
+ *
+ * @param path the path to the script file
+ * @param config the battle configuration receiving the commands
+ * @return true if the file could be read, or false otherwise
+ */
+static bool load_script(const char* path, BattleConfig& config)
+{
+    std::ifstream file{path};
+    if(!file){
+        return false;
+    }
+
+    std::string line;
+    while(std::getline(file, line)){
+        config.script.push_back( ParseCommand(line.c_str()) );
+    }
+    return true;
+}
+
+
+int main(int argc, char** argv)
+{
+    BattleConfig config;
+    std::size_t battles{1000000};
+    std::uint32_t seed{0};
+    bool use_pool{false};
+    std::size_t workers{0};
+    std::size_t events_per_task{1};
+    bool exact{false};
+    std::size_t horde{0};
+    std::size_t steps{SIZE_MAX};
+    const char* checkpoint_path{nullptr};
+    const char* restore_path{nullptr};
+
+    for(int i = 1; i < argc; ++i)
+    {
+        const char* option = argv[i];    // NOLINT
+        if(std::strcmp(option, "--exact") == 0){
+            exact = true;
+            continue;
+        }
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr; // NOLINT
+        if(value == nullptr){
+            print_usage(argv[0]); // NOLINT
+            return EXIT_FAILURE;
+        }
+        ++i;
+
+        if(std::strcmp(option, "--battles") == 0){
+            battles = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(option, "--policy") == 0){
+            if(std::strcmp(value, "orc") == 0){
+                config.policy = POLICY_ORC_FIRST;
+            }
+            else if(std::strcmp(value, "dragon") == 0){
+                config.policy = POLICY_DRAGON_FIRST;
+            }
+            else if(std::strcmp(value, "script") == 0){
+                config.policy = POLICY_SCRIPTED;
+            }
+            else{
+                print_usage(argv[0]); // NOLINT
+                return EXIT_FAILURE;
+            }
+        }
+        else if(std::strcmp(option, "--script") == 0){
+            config.policy = POLICY_SCRIPTED;
+            if(!load_script(value, config)){
+                std::cerr << "Unable to read the script '" << value << "'\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else if(std::strcmp(option, "--hero-interval") == 0){
+            config.hero_interval = std::atoi(value);
+        }
+        else if(std::strcmp(option, "--jitter") == 0){
+            config.hero_jitter = std::atoi(value);
+        }
+        else if(std::strcmp(option, "--orc-interval") == 0){
+            config.orc_interval = std::atoi(value);
+        }
+        else if(std::strcmp(option, "--dragon-interval") == 0){
+            config.dragon_interval = std::atoi(value);
+        }
+        else if(std::strcmp(option, "--seed") == 0){
+            seed = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+        }
+        else if(std::strcmp(option, "--workers") == 0){
+            use_pool = true;
+            workers = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(option, "--events-per-task") == 0){
+            events_per_task = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(option, "--hero-health") == 0){
+            config.hero_health = std::atoi(value);
+        }
+        else if(std::strcmp(option, "--orc-health") == 0){
+            config.orc_health = std::atoi(value);
+        }
+        else if(std::strcmp(option, "--dragon-health") == 0){
+            config.dragon_health = std::atoi(value);
+        }
+        else if(std::strcmp(option, "--horde") == 0){
+            horde = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(option, "--steps") == 0){
+            steps = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(option, "--checkpoint") == 0){
+            checkpoint_path = value;
+        }
+        else if(std::strcmp(option, "--restore") == 0){
+            restore_path = value;
+        }
+        else{
+            print_usage(argv[0]); // NOLINT
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(config.hero_interval <= 0 || config.orc_interval <= 0 ||
+       config.dragon_interval <= 0 || config.hero_jitter < 0)
+    {
+        std::cerr << "Attack intervals must be positive\n";
+        return EXIT_FAILURE;
+    }
+
+    if(horde > 0 || restore_path != nullptr){
+        return run_horde(horde, config.hero_health, restore_path, checkpoint_path, steps);
+    }
+
+    if(exact){
+        const auto start = std::chrono::steady_clock::now();
+        BattleSolver solver{config};
+        const auto result = solver.Solve();
+        const std::chrono::duration<double> elapsed{
+            std::chrono::steady_clock::now() - start
+        };
+        std::cout << "Hero wins:         " << (result.hero_wins ? "yes" : "no") << "\n"
+                  << "Duration:          " << result.duration << " ms\n"
+                  << "Hero health:       " << result.hero_health << "\n"
+                  << "Hero hits:         " << result.hero_hits << "\n"
+                  << "Monster hits:      " << result.monster_hits << "\n"
+                  << "States:            " << solver.CacheSize() << "\n"
+                  << "Wall time:         " << elapsed.count() << " s\n";
+        return EXIT_SUCCESS;
+    }
+
+    std::unique_ptr<WorkStealingPool> pool;
+    if(use_pool){
+        pool = std::make_unique<WorkStealingPool>(workers);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto stats = pool
+        ? RunSessions(*pool, config, battles, seed, events_per_task)
+        : RunBattles(config, battles, seed);
+    const std::chrono::duration<double> elapsed{
+        std::chrono::steady_clock::now() - start
+    };
+
+    const auto count = static_cast<double>(stats.battles > 0 ? stats.battles : 1);
+    std::cout << "Battles:           " << stats.battles << "\n"
+              << "Hero wins:         " << stats.wins << " ("
+              << 100.0 * static_cast<double>(stats.wins) / count << " %)\n"
+              << "Mean duration:     "
+              << static_cast<double>(stats.total_duration) / count << " ms\n"
+              << "Mean hero hits:    "
+              << static_cast<double>(stats.hero_hits) / count << "\n"
+              << "Mean monster hits: "
+              << static_cast<double>(stats.monster_hits) / count << "\n"
+              << "Wall time:         " << elapsed.count() << " s\n"
+              << "Throughput:        "
+              << static_cast<double>(stats.battles) / elapsed.count()
+              << " battles/s\n";
+
+    if(pool){
+        const auto workers_stats = pool->Statistics();
+        for(std::size_t i = 0; i < workers_stats.size(); ++i){
+            std::cout << "Worker " << i << ":          "
+                      << workers_stats[i].tasks << " tasks, "
+                      << workers_stats[i].steals << " steals, "
+                      << 100.0 * workers_stats[i].utilization << " % busy\n";
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
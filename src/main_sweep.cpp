@@ -0,0 +1,163 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "balance_sweep.h"
+#include "simulation.h"
+
+
+/**
+ * @brief Print the command line usage of the sweep
+ *
+ * @param program the name of the executable
+ */
+static void print_usage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --hero-health R      range of a balance value, given as\n"
+              << "  --orc-health R       FIRST:LAST or FIRST:LAST:STEP, or a\n"
+              << "  --dragon-health R    single value (default: the game values)\n"
+              << "  --hero-damage R\n"
+              << "  --orc-damage R\n"
+              << "  --dragon-damage R\n"
+              << "  --hero-interval R\n"
+              << "  --orc-interval R\n"
+              << "  --dragon-interval R\n"
+              << "  --battles N          battles per configuration (default 1)\n"
+              << "  --policy P           orc | dragon (default orc)\n"
+              << "  --jitter MS          random extra delay per command (default 0)\n"
+              << "  --seed N             seed of the first battle (default 0)\n"
+              << "  --out FILE           CSV output file (default: stdout)\n";
+}
+
+
+/**
+ * @brief Parse a range given as FIRST, FIRST:LAST or FIRST:LAST:STEP
+ *
+ * @param text the range from the command line
+ * @param range the range receiving the values
+ * @return true if the range is valid and not empty, or false otherwise
+ */
+static bool parse_range(const char* text, SweepRange& range)
+{
+    char* end{nullptr};
+    range.first = static_cast<int>(std::strtol(text, &end, 10));
+    range.last = range.first;
+    range.step = 1;
+    if(*end == ':'){
+        range.last = static_cast<int>(std::strtol(end + 1, &end, 10));
+    }
+    if(*end == ':'){
+        range.step = static_cast<int>(std::strtol(end + 1, &end, 10));
+    }
+    return *end == '\0' && range.Count() > 0;
+}
+
+
+int main(int argc, char** argv)
+{
+    BattleConfig config;
+    SweepRanges ranges;
+    std::size_t battles{1};
+    std::uint32_t seed{0};
+    const char* out_path{nullptr};
+
+    const struct {
+        const char* option;
+        SweepRange* range;
+    } range_options[] = {
+        {"--hero-health", &ranges.hero_health},
+        {"--orc-health", &ranges.orc_health},
+        {"--dragon-health", &ranges.dragon_health},
+        {"--hero-damage", &ranges.hero_damage},
+        {"--orc-damage", &ranges.orc_damage},
+        {"--dragon-damage", &ranges.dragon_damage},
+        {"--hero-interval", &ranges.hero_interval},
+        {"--orc-interval", &ranges.orc_interval},
+        {"--dragon-interval", &ranges.dragon_interval},
+    };
+
+    for(int i = 1; i < argc; ++i)
+    {
+        const char* option = argv[i];    // NOLINT
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr; // NOLINT
+        if(value == nullptr){
+            print_usage(argv[0]); // NOLINT
+            return EXIT_FAILURE;
+        }
+        ++i;
+
+        bool is_range{false};
+        for(const auto& range_option : range_options){
+            if(std::strcmp(option, range_option.option) == 0){
+                is_range = true;
+                if(!parse_range(value, *range_option.range)){
+                    std::cerr << "Invalid range '" << value << "'\n";
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+        if(is_range){
+            continue;
+        }
+
+        if(std::strcmp(option, "--battles") == 0){
+            battles = std::strtoull(value, nullptr, 10);
+        }
+        else if(std::strcmp(option, "--policy") == 0){
+            if(std::strcmp(value, "dragon") == 0){
+                config.policy = POLICY_DRAGON_FIRST;
+            }
+        }
+        else if(std::strcmp(option, "--jitter") == 0){
+            config.hero_jitter = std::atoi(value);
+        }
+        else if(std::strcmp(option, "--seed") == 0){
+            seed = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+        }
+        else if(std::strcmp(option, "--out") == 0){
+            out_path = value;
+        }
+        else{
+            print_usage(argv[0]); // NOLINT
+            return EXIT_FAILURE;
+        }
+    }
+
+    if( !SweepEnds(ranges) || config.hero_jitter < 0 ){
+        std::cerr << "Attack intervals and damages must be positive\n";
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream out_file;
+    if(out_path != nullptr){
+        out_file.open(out_path);
+        if(!out_file){
+            std::cerr << "Unable to write '" << out_path << "'\n";
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& csv = out_path != nullptr ? out_file : std::cout;
+
+    const std::size_t size = SweepSize(ranges);
+    std::cerr << "Configurations:    " << size << " x " << battles
+              << " battles\n";
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto stats = RunSweep(config, ranges, battles, seed, csv);
+    csv.flush();
+    const std::chrono::duration<double> elapsed{
+        std::chrono::steady_clock::now() - start
+    };
+
+    std::cerr << "Battles:           " << stats.battles << "\n"
+              << "Hero wins:         " << stats.wins << "\n"
+              << "Wall time:         " << elapsed.count() << " s\n"
+              << "Throughput:        "
+              << static_cast<double>(size) / elapsed.count()
+              << " configurations/s\n";
+
+    return EXIT_SUCCESS;
+}
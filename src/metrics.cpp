@@ -0,0 +1,252 @@
+#include "metrics.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+
+/**
+ * @brief The shard of a thread, given back when the thread ends
+ */
+struct ShardLease {
+    Metrics::MetricsShard* shard{nullptr};
+
+    ShardLease() = default;
+    ShardLease(const ShardLease&) = delete;
+    ShardLease& operator=(const ShardLease&) = delete;
+    ~ShardLease() {
+        if(shard != nullptr){
+            Metrics::t_shard = nullptr;
+            Metrics::Instance().ReleaseShard(shard);
+        }
+    }
+};
+
+
+//=============================================================================
+//
+//                    Implementations for the class Metrics
+//
+//=============================================================================
+
+
+//-----------------------------------------------------------------------------
+//
+//  Metrics::Instance()
+//
+Metrics& Metrics::Instance()
+{
+    // never destroyed: the threads still running at exit() may record
+    static auto* const metrics = new Metrics(); // NOLINT
+    return *metrics;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Metrics::AcquireShard(): the first record of a thread
+//
+Metrics::MetricsShard& Metrics::AcquireShard() noexcept
+{
+    thread_local ShardLease lease;
+
+    Metrics& metrics = Instance();
+    {
+        const std::lock_guard<std::mutex> lock(metrics.m_mutex);
+        if(metrics.m_free.empty()){
+            metrics.m_shards.push_back(new MetricsShard()); // NOLINT
+            t_shard = metrics.m_shards.back();
+        }
+        else{
+            // the values of the ended thread are kept: the sums go on
+            t_shard = metrics.m_free.back();
+            metrics.m_free.pop_back();
+        }
+    }
+    lease.shard = t_shard;
+    return *t_shard;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Metrics::ReleaseShard()
+//
+void Metrics::ReleaseShard(MetricsShard* shard) noexcept
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.push_back(shard);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Metrics::CountRareOutcome()
+//
+void Metrics::CountRareOutcome(const ROLE_t role, const bool hit) noexcept
+{
+    Count(hit ? COUNTER_KILLS : COUNTER_REJECTED, role);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Metrics::Counter()
+//
+std::uint64_t Metrics::Counter(const METRIC_COUNTER_t counter,
+                               const ROLE_t role) const
+{
+    const std::size_t index = MetricCounterIndex(counter, role);
+    std::uint64_t sum{0};
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    for(const MetricsShard* shard : m_shards){
+        sum += shard->counters[index].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Metrics::Summary()
+//
+HistogramSummary Metrics::Summary(const METRIC_HISTOGRAM_t histogram) const
+{
+    std::array<std::uint64_t, HISTOGRAM_BUCKETS> buckets{};
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        for(const MetricsShard* shard : m_shards){
+            for(std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i){
+                buckets[i] += shard->histograms[histogram][i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    return Summarize(buckets);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Metrics::Summarize()
+//
+HistogramSummary Metrics::Summarize(
+    const std::array<std::uint64_t, HISTOGRAM_BUCKETS>& buckets) noexcept
+{
+    HistogramSummary summary;
+    for(const std::uint64_t count : buckets){
+        summary.count += count;
+    }
+
+    // a percentile is the highest value of the bucket holding its rank
+    const std::array<std::uint64_t*, 4> percentiles{
+        &summary.p50, &summary.p90, &summary.p99, &summary.p999
+    };
+    constexpr std::array<std::uint64_t, 4> PER_MILLE{500, 900, 990, 999};
+    std::size_t next{0};
+    std::uint64_t seen{0};
+    for(std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+    {
+        if(buckets[i] == 0){
+            continue;
+        }
+        seen += buckets[i];
+        while(next < percentiles.size() && seen * 1000 >= summary.count * PER_MILLE[next]){
+            *percentiles[next] = HistogramBucketMax(i);
+            ++next;
+        }
+        summary.max = HistogramBucketMax(i);
+    }
+    return summary;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Metrics::Dump()
+//
+void Metrics::Dump(std::ostream& output, const METRICS_FORMAT_t format) const
+{
+    // ROLE_UNDEFINED, then the roles of the catalog
+    std::vector<ROLE_t> roles{ROLE_UNDEFINED};
+    for(std::size_t id = 0; id < RoleCatalog::Instance().Size(); ++id){
+        roles.push_back(static_cast<ROLE_t>(id));
+    }
+    constexpr std::array<METRIC_COUNTER_t, METRIC_COUNTERS> COUNTERS{
+        COUNTER_ATTACKS, COUNTER_KILLS, COUNTER_REJECTED
+    };
+    constexpr std::array<METRIC_HISTOGRAM_t, METRIC_HISTOGRAMS> HISTOGRAMS{
+        HISTOGRAM_TICK_LATENESS, HISTOGRAM_COMMAND_LATENCY, HISTOGRAM_LOCK_WAIT
+    };
+
+    if(format == METRICS_TEXT)
+    {
+        for(const METRIC_COUNTER_t counter : COUNTERS){
+            for(const ROLE_t role : roles){
+                output << CounterName(counter) << ' ' << RoleCatalog::Instance().Name(role)
+                       << ":   " << Counter(counter, role) << '\n';
+            }
+        }
+        for(const METRIC_HISTOGRAM_t histogram : HISTOGRAMS){
+            const HistogramSummary summary = Summary(histogram);
+            output << HistogramName(histogram) << " (ns):   count " << summary.count
+                   << ", p50 " << summary.p50 << ", p90 " << summary.p90
+                   << ", p99 " << summary.p99 << ", p99.9 " << summary.p999
+                   << ", max " << summary.max << '\n';
+        }
+        return;
+    }
+
+    output << "{\"counters\":{";
+    for(std::size_t c = 0; c < COUNTERS.size(); ++c){
+        output << (c == 0 ? "" : ",") << '"' << CounterName(COUNTERS[c]) << "\":{";
+        for(std::size_t r = 0; r < roles.size(); ++r){
+            output << (r == 0 ? "" : ",") << '"' << RoleCatalog::Instance().Name(roles[r])
+                   << "\":" << Counter(COUNTERS[c], roles[r]);
+        }
+        output << '}';
+    }
+    output << "},\"histograms_ns\":{";
+    for(std::size_t h = 0; h < HISTOGRAMS.size(); ++h){
+        const HistogramSummary summary = Summary(HISTOGRAMS[h]);
+        output << (h == 0 ? "" : ",") << '"' << HistogramName(HISTOGRAMS[h]) << "\":{"
+               << "\"count\":" << summary.count << ",\"p50\":" << summary.p50
+               << ",\"p90\":" << summary.p90 << ",\"p99\":" << summary.p99
+               << ",\"p999\":" << summary.p999 << ",\"max\":" << summary.max << '}';
+    }
+    output << "}}\n";
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Metrics::CounterName()
+//
+const char* Metrics::CounterName(const METRIC_COUNTER_t counter) noexcept
+{
+    switch(counter)
+    {
+        case COUNTER_ATTACKS:  return "attacks";
+        case COUNTER_KILLS:    return "kills";
+        case COUNTER_REJECTED: return "rejected";
+        default:               return "unknown";
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Metrics::HistogramName()
+//
+const char* Metrics::HistogramName(const METRIC_HISTOGRAM_t histogram) noexcept
+{
+    switch(histogram)
+    {
+        case HISTOGRAM_TICK_LATENESS:   return "tick_lateness";
+        case HISTOGRAM_COMMAND_LATENCY: return "command_latency";
+        case HISTOGRAM_LOCK_WAIT:       return "lock_wait";
+        default:                        return "unknown";
+    }
+}
@@ -0,0 +1,246 @@
+#include "monster_behavior.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "metrics.h"
+#include "role_catalog.h"
+
+
+//=============================================================================
+//
+//                    Implementations for the class BehaviorExecutor
+//
+//=============================================================================
+
+
+//-----------------------------------------------------------------------------
+//
+//  BehaviorExecutor::~BehaviorExecutor()
+//
+BehaviorExecutor::~BehaviorExecutor()
+{
+    for(const Handle handle : m_behaviors){
+        if(handle){
+            handle.destroy();
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BehaviorExecutor::Spawn()
+//
+void BehaviorExecutor::Spawn(Behavior behavior)
+{
+    std::uint32_t slot{0};
+    if(m_free.empty()){
+        slot = static_cast<std::uint32_t>(m_behaviors.size());
+        m_behaviors.emplace_back();
+    }
+    else{
+        slot = m_free.back();
+        m_free.pop_back();
+    }
+
+    const Handle handle = std::exchange(behavior.m_handle, nullptr);
+    handle.promise().slot = slot;
+    m_behaviors[slot] = handle;
+    m_ready.push_back(slot);
+    ++m_live;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BehaviorExecutor::Stop()
+//
+void BehaviorExecutor::Stop() noexcept
+{
+    m_stopped.store(true, std::memory_order_release);
+    m_timer.Interrupt();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BehaviorExecutor::Run()
+//
+std::size_t BehaviorExecutor::Run()
+{
+    if(!m_started){
+        m_start = std::chrono::steady_clock::now();
+        m_started = true;
+    }
+
+    std::size_t resumed{0};
+    std::vector<std::uint32_t> starting;
+    while(!Stopped())
+    {
+        // the behaviors spawned so far start now, they may spawn others
+        while(!m_ready.empty() && !Stopped()){
+            starting.swap(m_ready);
+            for(const std::uint32_t slot : starting){
+                Resume(slot);
+                ++resumed;
+            }
+            starting.clear();
+        }
+        if(m_wheel.Size() == 0 || Stopped()){
+            break;
+        }
+
+        const long long next = m_wheel.NextTick();
+        WaitUntil(next);
+        m_wheel.Advance(next, [this, &resumed](const long long tick,
+                                               const std::vector<std::uint32_t>& slots) {
+            const bool real_time = m_time_scale > TIME_SCALE_UNTHROTTLED;
+            const auto lateness = real_time ? std::chrono::steady_clock::now() - Deadline(tick)
+                                            : std::chrono::steady_clock::duration::zero();
+            for(const std::uint32_t slot : slots){
+                if(Stopped()){
+                    return; // the others stay suspended until destroyed
+                }
+                if(real_time){
+                    Metrics::Record(HISTOGRAM_TICK_LATENESS, lateness);
+                }
+                Resume(slot);
+                ++resumed;
+            }
+        });
+    }
+    return resumed;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BehaviorExecutor::Wake(): called by a behavior going to sleep
+//
+void BehaviorExecutor::Wake(const std::uint32_t slot, const long long time)
+{
+    m_wheel.Insert(time, slot);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BehaviorExecutor::Resume()
+//
+void BehaviorExecutor::Resume(const std::uint32_t slot)
+{
+    const Handle handle = m_behaviors[slot];
+    handle.resume();
+    if(handle.done()){
+        handle.destroy();
+        m_behaviors[slot] = nullptr;
+        m_free.push_back(slot);
+        --m_live;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BehaviorExecutor::WaitUntil()
+//
+void BehaviorExecutor::WaitUntil(const long long time)
+{
+    if(m_time_scale <= TIME_SCALE_UNTHROTTLED){
+        return;
+    }
+    m_timer.SleepUntil(Deadline(time));
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BehaviorExecutor::Deadline(): the real time of a simulated time
+//
+std::chrono::steady_clock::time_point BehaviorExecutor::Deadline(const long long time) const noexcept
+{
+    const std::chrono::duration<double, std::milli> offset{
+        static_cast<double>(time) / m_time_scale
+    };
+    return m_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  MonsterBehavior()
+//
+Behavior MonsterBehavior(BehaviorExecutor& executor, const Monster& monster,
+                         Hero& hero, std::size_t& attacks, const bool verbose)
+{
+    // a killed monster is reset: its undefined role ends its behavior. The
+    // result of co_await is kept in a variable: GCC 12 miscompiles a co_await
+    // inside the condition of a loop or of an if statement.
+    for(int interval = RoleCatalog::Instance().AttackInterval(monster.GetRole());
+        interval > 0;
+        interval = RoleCatalog::Instance().AttackInterval(monster.GetRole()))
+    {
+        const bool awake = co_await executor.SleepFor(interval);
+        if( !awake ){
+            co_return;
+        }
+
+        bool hit{false};
+        if(verbose){
+            hit = monster.CanAttack(hero);
+            monster.Attack(hero);
+        }
+        else{
+            hit = monster.Hit(hero);
+        }
+        attacks += hit ? 1U : 0U;
+        if(hit){
+            Metrics::Count(COUNTER_ATTACKS, monster.GetRole());
+        }
+
+        if( !hero.IsAlive() ){
+            executor.Stop();
+            co_return;
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  RunMonsterBehaviors()
+//
+std::size_t RunMonsterBehaviors(BehaviorExecutor& executor,
+                                Hero& hero,
+                                const std::vector<const Monster*>& monsters,
+                                const bool verbose)
+{
+    std::size_t attacks{0};
+    for(const Monster* monster : monsters){
+        executor.Spawn( MonsterBehavior(executor, *monster, hero, attacks, verbose) );
+    }
+    executor.Run();
+    return attacks;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  MonsterCommandBehavior()
+//
+Behavior MonsterCommandBehavior(BehaviorExecutor& executor, const Monster& monster,
+                                GameLoop& game, const GameCommand attack)
+{
+    // the monster is only read here: the simulation thread kills it
+    for(int interval = RoleCatalog::Instance().AttackInterval(monster.GetRole());
+        interval > 0;
+        interval = RoleCatalog::Instance().AttackInterval(monster.GetRole()))
+    {
+        const bool awake = co_await executor.SleepFor(interval);
+        if( !awake || game.Submit(attack) == NO_TICKET ){
+            co_return;
+        }
+    }
+}
@@ -0,0 +1,387 @@
+#include "replay_log.h"
+#include "byte_order.h"
+#include "metrics.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+static constexpr char REPLAY_MAGIC[8] = {'S', 'C', 'G', 'R', 'E', 'P', 'L', 'Y'};
+
+// Records written to the output, or read from the input, at once
+static constexpr std::size_t REPLAY_BLOCK_RECORDS = 4096;
+
+// Largest number of fighters of a log, the indexes being 16 bits
+static constexpr std::size_t REPLAY_MAX_FIGHTERS = 65536;
+
+
+//-----------------------------------------------------------------------------
+//
+//  EncodeReplayRecord()
+//
+static void EncodeReplayRecord(const ReplayRecord& record,
+                               unsigned char* bytes) noexcept
+{
+    StoreLittle(bytes, record.event, 1);
+    StoreLittle(bytes + 1, static_cast<std::uint8_t>(record.role), 1);
+    StoreLittle(bytes + 2, record.actor, 2);
+    StoreLittle(bytes + 4, record.target, 2);
+    StoreLittle(bytes + 6, 0, 2);
+    StoreLittle(bytes + 8, static_cast<std::uint32_t>(record.value), 4);
+    StoreLittle(bytes + 12, static_cast<std::uint32_t>(record.health), 4);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  DecodeReplayRecord()
+//
+ReplayRecord DecodeReplayRecord(const unsigned char* bytes) noexcept
+{
+    ReplayRecord record;
+    record.event = static_cast<REPLAY_EVENT_t>(bytes[0]);
+    record.role = static_cast<std::int8_t>(bytes[1]);
+    record.actor = static_cast<std::uint16_t>(LoadLittle(bytes + 2, 2));
+    record.target = static_cast<std::uint16_t>(LoadLittle(bytes + 4, 2));
+    record.value = static_cast<std::int32_t>(LoadLittle(bytes + 8, 4));
+    record.health = static_cast<std::int32_t>(LoadLittle(bytes + 12, 4));
+    return record;
+}
+
+
+//=============================================================================
+//
+//                    Implementations for the class ReplayRecorder
+//
+//=============================================================================
+
+
+//-----------------------------------------------------------------------------
+//
+//  ReplayRecorder::Instance()
+//
+ReplayRecorder& ReplayRecorder::Instance()
+{
+    // never destroyed, so that it outlives the threads still fighting
+    static auto* recorder = new ReplayRecorder(); // NOLINT
+    return *recorder;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ReplayRecorder::Start()
+//
+void ReplayRecorder::Start(std::ostream& output)
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_output = &output;
+    m_ids.clear();
+    m_fighters.clear();
+    m_pending.clear();
+    m_recorded = 0;
+
+    unsigned char header[REPLAY_HEADER_SIZE] = {};
+    std::memcpy(header, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    StoreLittle(header + 8, REPLAY_VERSION, 2);
+    StoreLittle(header + 10, REPLAY_RECORD_SIZE, 2);
+    output.write(reinterpret_cast<const char*>(header), sizeof(header));
+    m_recording.store(true);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ReplayRecorder::Stop()
+//
+void ReplayRecorder::Stop()
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if( !m_recording.exchange(false) ){
+        return;
+    }
+
+    for(std::size_t i = 0; i < m_fighters.size(); ++i){
+        ReplayRecord record;
+        record.event = REPLAY_STATE;
+        record.role = static_cast<std::int8_t>(m_fighters[i]->GetRole());
+        record.actor = static_cast<std::uint16_t>(i);
+        record.value = m_fighters[i]->GetHealth();
+        Append(record);
+    }
+    WritePending();
+    m_output->flush();
+    m_output = nullptr;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ReplayRecorder::Spawn()
+//
+void ReplayRecorder::Spawn(const Fighter& fighter) noexcept
+{
+    if( !Recording() ){
+        return;
+    }
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_fighters.size() == REPLAY_MAX_FIGHTERS || m_ids.count(&fighter) != 0){
+        return;
+    }
+
+    ReplayRecord record;
+    record.event = REPLAY_SPAWN;
+    record.role = static_cast<std::int8_t>(fighter.GetRole());
+    record.actor = static_cast<std::uint16_t>(m_fighters.size());
+    record.value = fighter.GetHealth();
+    m_ids.emplace(&fighter, record.actor);
+    m_fighters.push_back(&fighter);
+    Append(record);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ReplayRecorder::RecordHit()
+//
+void ReplayRecorder::RecordHit(const Fighter& attacker, const Fighter& target,
+                               const int damage, const int health) noexcept
+{
+    if( !Recording() ){
+        return;
+    }
+    // the lock on the attack path: its contention is measured
+    const auto lock = LockTimed(m_mutex);
+    const auto attacker_id = m_ids.find(&attacker);
+    const auto target_id = m_ids.find(&target);
+    if(attacker_id == m_ids.end() || target_id == m_ids.end()){
+        return;
+    }
+
+    ReplayRecord record;
+    record.event = REPLAY_HIT;
+    record.role = static_cast<std::int8_t>(attacker.GetRole());
+    record.actor = attacker_id->second;
+    record.target = target_id->second;
+    record.value = damage;
+    record.health = health;
+    Append(record);
+
+    if(health <= HEALTH_DEAD){
+        record.event = REPLAY_DEATH;
+        record.value = 0;
+        record.health = 0;
+        Append(record);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ReplayRecorder::RecordGameOver()
+//
+void ReplayRecorder::RecordGameOver(const bool hero_wins) noexcept
+{
+    if( !Recording() ){
+        return;
+    }
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    ReplayRecord record;
+    record.event = REPLAY_GAME_OVER;
+    record.value = hero_wins ? 1 : 0;
+    Append(record);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ReplayRecorder::Recorded()
+//
+std::size_t ReplayRecorder::Recorded() const
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    return m_recorded;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ReplayRecorder::Append(): called with m_mutex held
+//
+void ReplayRecorder::Append(const ReplayRecord& record)
+{
+    const std::size_t fill = m_pending.size();
+    m_pending.resize(fill + REPLAY_RECORD_SIZE);
+    EncodeReplayRecord(record, m_pending.data() + fill);
+    ++m_recorded;
+    if(m_pending.size() >= REPLAY_BLOCK_RECORDS * REPLAY_RECORD_SIZE){
+        WritePending();
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ReplayRecorder::WritePending(): called with m_mutex held
+//
+void ReplayRecorder::WritePending()
+{
+    m_output->write(reinterpret_cast<const char*>(m_pending.data()),
+                    static_cast<std::streamsize>(m_pending.size()));
+    m_pending.clear();
+}
+
+
+//=============================================================================
+//
+//                    Replay
+//
+//=============================================================================
+
+
+/**
+ * @brief The fighters of a replay, and the checks of the records
+ */
+class ReplayWorld {
+public:
+    explicit ReplayWorld(ReplayResult& result) : m_result(result) {}
+
+    void Apply(const ReplayRecord& record)
+    {
+        switch(record.event)
+        {
+            case REPLAY_SPAWN:
+                Spawn(record);
+                break;
+            case REPLAY_HIT:
+                Hit(record);
+                break;
+            case REPLAY_DEATH:
+                ++m_result.deaths;
+                Check(Known(record.target) && !m_fighters[record.target]->IsAlive());
+                break;
+            case REPLAY_GAME_OVER:
+                m_result.game_over = true;
+                m_result.hero_wins = record.value != 0;
+                Check(GameOver(m_result.hero_wins));
+                break;
+            case REPLAY_STATE:
+                Check(Known(record.actor) &&
+                      m_fighters[record.actor]->GetHealth() == record.value);
+                break;
+            default:
+                Check(false);
+                break;
+        }
+        ++m_result.events;
+    }
+
+private:
+    void Check(const bool valid) noexcept
+    {
+        if(!valid){
+            if(m_result.mismatches == 0){
+                m_result.first_mismatch = m_result.events;
+            }
+            ++m_result.mismatches;
+        }
+    }
+
+    ATTRIBUTE_NO_DISCARD bool Known(const std::size_t index) const noexcept
+    {
+        return index < m_fighters.size();
+    }
+
+    void Spawn(const ReplayRecord& record)
+    {
+        if(record.actor != m_fighters.size()){
+            Check(false);
+            return;
+        }
+        const auto role = static_cast<ROLE_t>(record.role);
+        switch(role)
+        {
+            case ROLE_HERO:   m_fighters.push_back(std::make_unique<Hero>(role));    break;
+            case ROLE_ORC:    m_fighters.push_back(std::make_unique<Orc>(role));     break;
+            case ROLE_DRAGON: m_fighters.push_back(std::make_unique<Dragon>(role));  break;
+            default:          m_fighters.push_back(std::make_unique<Fighter>(role)); break;
+        }
+        m_fighters.back()->SetHealth(record.value);
+        m_roles.push_back(static_cast<ROLE_t>(record.role));
+    }
+
+    void Hit(const ReplayRecord& record)
+    {
+        ++m_result.hits;
+        if( !Known(record.actor) || !Known(record.target) ){
+            Check(false);
+            return;
+        }
+        Fighter& target = *m_fighters[record.target];
+        const bool hit = m_fighters[record.actor]->Hit(target, record.value);
+        if(hit){
+            Metrics::Count(COUNTER_ATTACKS, m_fighters[record.actor]->GetRole());
+        }
+        const int expected = record.health > HEALTH_DEAD ? record.health
+                                                         : HEALTH_UNDEFINED;
+        Check(hit && target.GetHealth() == expected);
+    }
+
+    ATTRIBUTE_NO_DISCARD bool GameOver(const bool hero_wins) const noexcept
+    {
+        bool heroes_alive{false};
+        bool monsters_alive{false};
+        for(std::size_t i = 0; i < m_fighters.size(); ++i){
+            if(m_roles[i] == ROLE_HERO){
+                heroes_alive = heroes_alive || m_fighters[i]->IsAlive();
+            }
+            else if(m_roles[i] != ROLE_UNDEFINED){
+                monsters_alive = monsters_alive || m_fighters[i]->IsAlive();
+            }
+        }
+        return hero_wins ? (heroes_alive && !monsters_alive) : !heroes_alive;
+    }
+
+    ReplayResult& m_result;
+    std::vector<std::unique_ptr<Fighter>> m_fighters;
+    std::vector<ROLE_t> m_roles; // spawn roles, kept after the deaths
+};
+
+
+//-----------------------------------------------------------------------------
+//
+//  Replay()
+//
+ReplayResult Replay(std::istream& input)
+{
+    ReplayResult result;
+    unsigned char header[REPLAY_HEADER_SIZE] = {};
+    if( !input.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        std::memcmp(header, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0 ||
+        LoadLittle(header + 8, 2) != REPLAY_VERSION ||
+        LoadLittle(header + 10, 2) != REPLAY_RECORD_SIZE )
+    {
+        return result;
+    }
+
+    ReplayWorld world{result};
+    std::vector<unsigned char> block(REPLAY_BLOCK_RECORDS * REPLAY_RECORD_SIZE);
+    while(input)
+    {
+        input.read(reinterpret_cast<char*>(block.data()),
+                   static_cast<std::streamsize>(block.size()));
+        const auto size = static_cast<std::size_t>(input.gcount());
+        if(size % REPLAY_RECORD_SIZE != 0){
+            return result; // truncated record
+        }
+        for(std::size_t offset = 0; offset < size; offset += REPLAY_RECORD_SIZE){
+            world.Apply( DecodeReplayRecord(block.data() + offset) );
+        }
+    }
+    result.valid = true;
+    return result;
+}
@@ -0,0 +1,210 @@
+#include "role_catalog.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+constinit RoleCatalog RoleCatalog::s_instance{};
+
+
+/**
+ * @brief A role read from a catalog, before its enemies are resolved
+ */
+struct CatalogEntry {
+    std::string name;
+    int health{0};
+    int damage{0};
+    int interval{0};
+    std::string enemies;
+    std::size_t line{0};
+};
+
+
+/**
+ * @brief Split the next word off a line
+ *
+ * @param line the rest of the line, without the word on return
+ * @return The word, empty at the end of the line
+ */
+static std::string_view next_word(std::string_view& line) noexcept
+{
+    constexpr std::string_view BLANKS{" \t\r"};
+    const std::size_t start = line.find_first_not_of(BLANKS);
+    if(start == std::string_view::npos){
+        line = {};
+        return {};
+    }
+    line.remove_prefix(start);
+    const std::size_t end = std::min(line.find_first_of(BLANKS), line.size());
+    const std::string_view word = line.substr(0, end);
+    line.remove_prefix(end);
+    return word;
+}
+
+/**
+ * @brief Parse a number of a catalog
+ *
+ * @param word the text of the number
+ * @param value receives the number
+ * @return true if the whole word is a non negative number, or false otherwise
+ */
+static bool parse_number(const std::string_view word, int& value) noexcept
+{
+    const char* const end = word.data() + word.size();
+    const auto result = std::from_chars(word.data(), end, value);
+    return result.ec == std::errc{} && result.ptr == end && value >= 0;
+}
+
+
+//=============================================================================
+//
+//                    Implementations for the class RoleCatalog
+//
+//=============================================================================
+
+
+//-----------------------------------------------------------------------------
+//
+//  RoleCatalog::Load()
+//
+CATALOG_STATUS_t RoleCatalog::Load(std::istream& input)
+{
+    // the whole catalog is checked before the tables are replaced
+    std::vector<CatalogEntry> entries;
+    std::string text;
+    std::size_t line_number{0};
+    while(std::getline(input, text))
+    {
+        ++line_number;
+        std::string_view line{text};
+        const std::string_view name = next_word(line);
+        if(name.empty() || name.front() == '#'){
+            continue;
+        }
+
+        m_error_line = line_number;
+        if(entries.size() == ROLE_CAPACITY){
+            return CATALOG_TOO_MANY_ROLES;
+        }
+        CatalogEntry entry;
+        entry.name = name;
+        entry.line = line_number;
+        if(name.size() >= ROLE_NAME_SIZE ||
+           !parse_number(next_word(line), entry.health) || entry.health == HEALTH_DEAD ||
+           !parse_number(next_word(line), entry.damage) ||
+           !parse_number(next_word(line), entry.interval))
+        {
+            return CATALOG_BAD_FORMAT;
+        }
+        entry.enemies = next_word(line);
+        if(entry.enemies.empty() || !next_word(line).empty()){
+            return CATALOG_BAD_FORMAT;
+        }
+        for(const CatalogEntry& other : entries){
+            if(other.name == entry.name){
+                return CATALOG_DUPLICATE_ROLE;
+            }
+        }
+        if(entries.size() < ROLE_BUILTIN &&
+           entry.name != Fighter::RoleName(static_cast<ROLE_t>(entries.size())))
+        {
+            return CATALOG_BAD_BUILTIN;
+        }
+        entries.push_back(std::move(entry));
+    }
+    m_error_line = 0;
+    if(input.bad()){
+        return CATALOG_IO_ERROR;
+    }
+    if(entries.size() < ROLE_BUILTIN){
+        return CATALOG_BAD_BUILTIN;
+    }
+
+    // the enemies are names of roles, possibly declared further down
+    std::array<std::uint64_t, ROWS> enemies{};
+    for(std::size_t id = 0; id < entries.size(); ++id)
+    {
+        std::string_view list{entries[id].enemies};
+        while(list != "-" && !list.empty())
+        {
+            const std::size_t comma = std::min(list.find(','), list.size());
+            const std::string_view enemy = list.substr(0, comma);
+            list.remove_prefix(std::min(comma + 1, list.size()));
+
+            std::size_t found{0};
+            while(found < entries.size() && entries[found].name != enemy){
+                ++found;
+            }
+            if(found == entries.size()){
+                m_error_line = entries[id].line;
+                return CATALOG_UNKNOWN_ENEMY;
+            }
+            enemies[id + 1] |= std::uint64_t{1} << (found + 1);
+        }
+    }
+
+    // the factions of RoleFaction(): the hero against all the other roles
+    const std::uint64_t hero = std::uint64_t{1} << Row(ROLE_HERO);
+    const std::uint64_t monsters = (((std::uint64_t{1} << entries.size()) - 1) << 1) & ~hero;
+    for(std::size_t id = 0; id < entries.size(); ++id)
+    {
+        const std::uint64_t expected = id == static_cast<std::size_t>(ROLE_HERO) ? monsters
+                                                                                  : hero;
+        if(enemies[id + 1] != expected){
+            m_error_line = entries[id].line;
+            return CATALOG_BAD_FACTIONS;
+        }
+    }
+
+    Erase();
+    for(std::size_t id = 0; id < entries.size(); ++id){
+        const CatalogEntry& entry = entries[id];
+        Set(static_cast<ROLE_t>(id), entry.name, entry.health, entry.damage, entry.interval);
+    }
+    m_enemies = enemies;
+    m_size = entries.size();
+
+    // the vector kernels of the damage hardcode the built-in rules
+    const RoleCatalog builtin;
+    m_builtin = m_size == builtin.m_size && m_health == builtin.m_health &&
+                m_damage == builtin.m_damage && m_interval == builtin.m_interval &&
+                m_enemies == builtin.m_enemies;
+    return CATALOG_OK;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  RoleCatalog::LoadFile()
+//
+CATALOG_STATUS_t RoleCatalog::LoadFile(const char* path)
+{
+    std::ifstream file(path);
+    if( !file ){
+        m_error_line = 0;
+        return CATALOG_IO_ERROR;
+    }
+    return Load(file);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  RoleCatalog::Find()
+//
+ROLE_t RoleCatalog::Find(const std::string_view name) const noexcept
+{
+    for(std::size_t id = 0; id < m_size; ++id){
+        if(name == m_names[id + 1].data()){
+            return static_cast<ROLE_t>(id);
+        }
+    }
+    return ROLE_UNDEFINED;
+}
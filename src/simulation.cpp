@@ -0,0 +1,186 @@
+#include "simulation.h"
+#include "command_parser.h"
+#include "metrics.h"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+
+//-----------------------------------------------------------------------------
+//
+//  HeroTarget(): choose the monster to attack according to the policy
+//
+static Fighter* HeroTarget(const BattleConfig& config,
+                           const std::size_t command_index,
+                           Fighter& orc,
+                           Fighter& dragon) noexcept
+{
+    switch(config.policy)
+    {
+        case POLICY_ORC_FIRST:
+            return orc.IsAlive() ? &orc : &dragon;
+        case POLICY_DRAGON_FIRST:
+            return dragon.IsAlive() ? &dragon : &orc;
+        case POLICY_SCRIPTED:
+            if(command_index >= config.script.size()){
+                return nullptr;
+            }
+            if(config.script[command_index] == ROLE_ORC){
+                return &orc;
+            }
+            if(config.script[command_index] == ROLE_DRAGON){
+                return &dragon;
+            }
+            return nullptr; // unknown command: the hero does nothing
+    }
+    return nullptr;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BattleSession::BattleSession()
+//
+BattleSession::BattleSession(const BattleConfig& config,
+                             const std::uint32_t seed) noexcept
+        : m_config( &config ),
+          m_generator( seed + 1U ), // a seed of 0 is not allowed
+          m_jitter( 0, config.hero_jitter ),
+          m_hero_idle( config.policy == POLICY_SCRIPTED && config.script.empty() ),
+          m_hero_time( HeroDelay() ),
+          m_orc_time( config.orc_interval ),
+          m_dragon_time( config.dragon_interval )
+{
+    m_hero.SetHealth(config.hero_health);
+    m_orc.SetHealth(config.orc_health);
+    m_dragon.SetHealth(config.dragon_health);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BattleSession::HeroDelay(): time until the next command of the hero
+//
+long long BattleSession::HeroDelay() noexcept
+{
+    return static_cast<long long>(m_config->hero_interval) +
+           (m_config->hero_jitter > 0 ? m_jitter(m_generator) : 0);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  BattleSession::Step()
+//
+bool BattleSession::Step() noexcept
+{
+    if(m_over){
+        return false;
+    }
+
+    const BattleConfig& config = *m_config;
+    const long long monster_time{
+        m_orc_time < m_dragon_time ? m_orc_time : m_dragon_time
+    };
+
+    if(!m_hero_idle && m_hero_time <= monster_time){
+        m_result.duration = m_hero_time;
+        Fighter* target = HeroTarget(config, m_command_index, m_orc, m_dragon);
+        if(target != nullptr && m_hero.Hit(*target, config.hero_damage)){
+            ++m_result.hero_hits;
+            Metrics::Count(COUNTER_ATTACKS, m_hero.GetRole());
+        }
+
+        ++m_command_index;
+        m_hero_idle = config.policy == POLICY_SCRIPTED &&
+                      m_command_index >= config.script.size();
+        m_hero_time += HeroDelay();
+
+        if(!m_orc.IsAlive() && !m_dragon.IsAlive()){
+            m_result.hero_wins = true;
+            m_over = true;
+        }
+    }
+    else if(m_orc_time == monster_time){
+        m_result.duration = m_orc_time;
+        if(m_orc.Hit(m_hero, config.orc_damage)){
+            ++m_result.monster_hits;
+            Metrics::Count(COUNTER_ATTACKS, m_orc.GetRole());
+        }
+        m_orc_time += config.orc_interval;
+    }
+    else{
+        m_result.duration = m_dragon_time;
+        if(m_dragon.Hit(m_hero, config.dragon_damage)){
+            ++m_result.monster_hits;
+            Metrics::Count(COUNTER_ATTACKS, m_dragon.GetRole());
+        }
+        m_dragon_time += config.dragon_interval;
+    }
+
+    if(!m_hero.IsAlive()){
+        m_over = true;
+    }
+    if(m_over){
+        m_result.hero_health = m_hero.GetHealth();
+    }
+    return !m_over;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  SimulateBattle()
+//
+BattleResult SimulateBattle(const BattleConfig& config,
+                            const std::uint32_t seed) noexcept
+{
+    BattleSession session{config, seed};
+    while( session.Step() ){
+    }
+    return session.Result();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  AddResult()
+//
+void AddResult(BattleStatistics& stats, const BattleResult& result) noexcept
+{
+    ++stats.battles;
+    stats.wins += result.hero_wins ? 1U : 0U;
+    stats.total_duration += result.duration;
+    stats.hero_hits += result.hero_hits;
+    stats.monster_hits += result.monster_hits;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  RunBattles()
+//
+BattleStatistics RunBattles(const BattleConfig& config,
+                            const std::size_t count,
+                            const std::uint32_t seed) noexcept
+{
+    BattleStatistics stats;
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        AddResult(stats, SimulateBattle(config, seed + static_cast<std::uint32_t>(i)));
+    }
+    return stats;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ParseCommand()
+//
+ROLE_t ParseCommand(const char* command) noexcept
+{
+    if(command == nullptr){
+        return ROLE_UNDEFINED;
+    }
+    return ParseHeroCommand(command);
+}
@@ -0,0 +1,28 @@
+#include "static_fighter.h"
+#include <variant>
+
+
+//-----------------------------------------------------------------------------
+//
+//  MakeFighter()
+//
+AnyFighter MakeFighter(const ROLE_t role) noexcept
+{
+    switch(role)
+    {
+        case ROLE_HERO:   return StaticHero{};
+        case ROLE_ORC:    return StaticOrc{};
+        case ROLE_DRAGON: return StaticDragon{};
+        default:          return StaticUndefined{};
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Print()
+//
+void Print(const AnyFighter& fighter) noexcept
+{
+    std::visit([](const auto& self) { self.Print(); }, fighter);
+}
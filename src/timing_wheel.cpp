@@ -0,0 +1,267 @@
+#include "timing_wheel.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "metrics.h"
+#include "role_catalog.h"
+
+
+//-----------------------------------------------------------------------------
+//
+//  Constructor
+//
+TimingWheel::TimingWheel(const long long now) noexcept
+        : m_now( now )
+{
+    m_heads.fill(NIL);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  TimingWheel::Reserve()
+//
+void TimingWheel::Reserve(const std::size_t count)
+{
+    m_nodes.reserve(count);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  TimingWheel::Insert()
+//
+TimerId TimingWheel::Insert(const long long expiry, const std::uint32_t payload)
+{
+    std::uint32_t index = m_free;
+    if(index != NIL){
+        m_free = m_nodes[index].next;
+    }
+    else{
+        index = static_cast<std::uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    Node& node = m_nodes[index];
+    node.expiry = expiry > m_now ? expiry : m_now + 1;
+    node.payload = payload;
+    Link(index);
+    ++m_size;
+    return index;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  TimingWheel::Cancel()
+//
+bool TimingWheel::Cancel(const TimerId id) noexcept
+{
+    if(id >= m_nodes.size() || m_nodes[id].list == FREE_NODE){
+        return false;
+    }
+    Unlink(id);
+    Release(id);
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  TimingWheel::Link(): put a node into the slot matching its expiry
+//
+//  The level is given by the highest byte in which the expiry differs from
+//  the current tick. The timer moves down one or more levels each time the
+//  current tick reaches the start of its slot, and expires when the current
+//  tick reaches its slot on the lowest level.
+//
+void TimingWheel::Link(const std::uint32_t index) noexcept
+{
+    Node& node = m_nodes[index];
+    const auto expiry = static_cast<std::uint64_t>(node.expiry);
+    const auto difference = expiry ^ static_cast<std::uint64_t>(m_now);
+
+    std::uint16_t list{OVERFLOW_LIST};
+    if((difference >> (SLOT_BITS * LEVELS)) == 0)
+    {
+        int level{0};
+        while((difference >> (SLOT_BITS * (level + 1))) != 0){
+            ++level;
+        }
+        const auto slot = (expiry >> (SLOT_BITS * level)) & SLOT_MASK;
+        list = static_cast<std::uint16_t>(static_cast<std::size_t>(level) * SLOTS + slot);
+    }
+
+    if(list < OVERFLOW_LIST){
+        m_occupied[list / 64] |= std::uint64_t{1} << (list % 64);
+    }
+    node.list = list;
+    node.prev = NIL;
+    node.next = m_heads[list];
+    if(node.next != NIL){
+        m_nodes[node.next].prev = index;
+    }
+    m_heads[list] = index;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  TimingWheel::Unlink()
+//
+void TimingWheel::Unlink(const std::uint32_t index) noexcept
+{
+    const Node& node = m_nodes[index];
+    if(node.prev == NIL){
+        m_heads[node.list] = node.next;
+        if(node.next == NIL && node.list < OVERFLOW_LIST){
+            m_occupied[node.list / 64] &= ~(std::uint64_t{1} << (node.list % 64));
+        }
+    }
+    else{
+        m_nodes[node.prev].next = node.next;
+    }
+    if(node.next != NIL){
+        m_nodes[node.next].prev = node.prev;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  TimingWheel::Detach(): empty a list and return its first node
+//
+std::uint32_t TimingWheel::Detach(const std::uint16_t list) noexcept
+{
+    const std::uint32_t head = m_heads[list];
+    m_heads[list] = NIL;
+    if(list < OVERFLOW_LIST){
+        m_occupied[list / 64] &= ~(std::uint64_t{1} << (list % 64));
+    }
+    return head;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  TimingWheel::NextTick(): find the next tick with timers to expire or
+//                           to cascade
+//
+//  Only the slots after the current one may hold timers on each level, and
+//  the slots of a lower level always come before the ones of an upper level.
+//  Hence the first occupied slot found, from the lowest level up, gives the
+//  next tick on which something happens.
+//
+long long TimingWheel::NextTick() const noexcept
+{
+    const auto now = static_cast<std::uint64_t>(m_now);
+    for(int level = 0; level < LEVELS; ++level)
+    {
+        const int shift = SLOT_BITS * level;
+        const std::size_t current = (now >> shift) & SLOT_MASK;
+        const std::size_t first = static_cast<std::size_t>(level) * SLOTS;
+        for(std::size_t slot = current + 1; slot < SLOTS; )
+        {
+            const std::size_t bit = first + slot;
+            const std::uint64_t word = m_occupied[bit / 64] >> (bit % 64);
+            if(word != 0){
+                slot += static_cast<std::size_t>(std::countr_zero(word));
+                const std::uint64_t upper = (now >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+                return static_cast<long long>(upper | (std::uint64_t{slot} << shift));
+            }
+            slot += 64 - bit % 64; // go on with the next word
+        }
+    }
+
+    // only the overflow list is left: it is cascaded on the next wrap around
+    // of the highest level
+    const int bits = SLOT_BITS * LEVELS;
+    return static_cast<long long>(((now >> bits) + 1) << bits);
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  TimingWheel::Cascade(): move the timers of the current slot of a level
+//                          down to the lower levels
+//
+void TimingWheel::Cascade(const int level) noexcept
+{
+    std::uint16_t list{OVERFLOW_LIST};
+    if(level < LEVELS){
+        const auto slot = (static_cast<std::uint64_t>(m_now) >> (SLOT_BITS * level))
+                        & SLOT_MASK;
+        list = static_cast<std::uint16_t>(static_cast<std::size_t>(level) * SLOTS + slot);
+    }
+
+    std::uint32_t index = Detach(list);
+    while(index != NIL){
+        const std::uint32_t next = m_nodes[index].next;
+        Link(index);
+        index = next;
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  TimingWheel::Release(): give a node back to the free list
+//
+void TimingWheel::Release(const std::uint32_t index) noexcept
+{
+    Node& node = m_nodes[index];
+    node.list = FREE_NODE;
+    node.next = m_free;
+    m_free = index;
+    --m_size;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  RunMonsterCooldowns()
+//
+std::size_t RunMonsterCooldowns(Hero& hero,
+                                const std::vector<const Monster*>& monsters,
+                                long long& end_time)
+{
+    TimingWheel wheel;
+    wheel.Reserve(monsters.size());
+    for(std::size_t i = 0; i < monsters.size(); ++i)
+    {
+        const int interval = RoleCatalog::Instance().AttackInterval(monsters[i]->GetRole());
+        if(interval > 0){
+            wheel.Insert(interval, static_cast<std::uint32_t>(i));
+        }
+    }
+
+    std::size_t attacks{0};
+    AttackTally tally;
+    end_time = wheel.Now();
+    while(hero.IsAlive() && wheel.Size() > 0)
+    {
+        // one tick with something to do at a time, so that the battle stops
+        // as soon as the hero is killed, without walking the idle ticks
+        wheel.Advance(wheel.NextTick(), [&](const long long tick,
+                                            const std::vector<std::uint32_t>& ready) {
+            for(const std::uint32_t index : ready)
+            {
+                if( !hero.IsAlive() ){
+                    break;
+                }
+                const Monster& monster = *monsters[index];
+                const bool hit = monster.Hit(hero);
+                attacks += hit ? 1U : 0U;
+                tally.Add(monster.GetRole(), hit);
+                end_time = tick;
+
+                const int interval = RoleCatalog::Instance().AttackInterval(monster.GetRole());
+                if(interval > 0){
+                    wheel.Insert(tick + interval, index);
+                }
+            }
+        });
+    }
+    return attacks;
+}
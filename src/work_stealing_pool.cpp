@@ -0,0 +1,314 @@
+#include "work_stealing_pool.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// The pool and the index of the worker running the current thread, if any
+static thread_local const WorkStealingPool* t_pool{nullptr}; // NOLINT
+static thread_local std::size_t t_worker{0};                 // NOLINT
+
+// Longest sleep of an idle worker, in case a wakeup is missed
+constexpr std::chrono::milliseconds IDLE_TIMEOUT{10};
+
+
+//-----------------------------------------------------------------------------
+//
+//  Constructor
+//
+WorkStealingPool::WorkStealingPool(std::size_t workers)
+{
+    if(workers == 0){
+        workers = std::thread::hardware_concurrency();
+    }
+    if(workers == 0){
+        workers = 1;
+    }
+
+    m_workers.reserve(workers);
+    for(std::size_t i = 0; i < workers; ++i){
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    ResetStatistics();
+    for(std::size_t i = 0; i < workers; ++i){
+        m_workers[i]->thread = std::thread{&WorkStealingPool::Run, this, i};
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Destructor
+//
+WorkStealingPool::~WorkStealingPool()
+{
+    Wait();
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop.store(true);
+    }
+    m_wakeup.notify_all();
+    for(auto& worker : m_workers){
+        worker->thread.join();
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  WorkStealingPool::Submit()
+//
+void WorkStealingPool::Submit(Task task)
+{
+    const std::size_t index = (t_pool == this)
+        ? t_worker
+        : m_next.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+
+    m_pending.fetch_add(1, std::memory_order_acq_rel);
+    {
+        Worker& worker = *m_workers[index];
+        const std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+        m_queued.fetch_add(1);
+    }
+
+    // Either the sleeping worker sees the new task when checking m_queued,
+    // or this thread sees the worker in m_sleeping and wakes it up
+    if(m_sleeping.load() > 0){
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakeup.notify_one();
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  WorkStealingPool::Wait()
+//
+void WorkStealingPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(m_pending.load(std::memory_order_acquire) != 0){
+        m_done.wait_for(lock, IDLE_TIMEOUT);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  WorkStealingPool::Statistics()
+//
+std::vector<WorkerStatistics> WorkStealingPool::Statistics() const
+{
+    using std::chrono::steady_clock;
+    const steady_clock::duration elapsed{
+        steady_clock::now().time_since_epoch().count() -
+        m_statistics_start.load(std::memory_order_relaxed)
+    };
+    const double elapsed_seconds = std::chrono::duration<double>(elapsed).count();
+
+    std::vector<WorkerStatistics> statistics;
+    for(const auto& worker : m_workers)
+    {
+        WorkerStatistics worker_statistics;
+        worker_statistics.tasks = worker->executed.load(std::memory_order_relaxed);
+        worker_statistics.steals = worker->steals.load(std::memory_order_relaxed);
+        worker_statistics.busy_seconds = std::chrono::duration<double>(
+            std::chrono::nanoseconds(worker->busy_ns.load(std::memory_order_relaxed))
+        ).count();
+        if(elapsed_seconds > 0.0){
+            worker_statistics.utilization = worker_statistics.busy_seconds /
+                                            elapsed_seconds;
+        }
+        statistics.push_back(worker_statistics);
+    }
+    return statistics;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  WorkStealingPool::ResetStatistics()
+//
+void WorkStealingPool::ResetStatistics()
+{
+    for(auto& worker : m_workers){
+        worker->executed.store(0, std::memory_order_relaxed);
+        worker->steals.store(0, std::memory_order_relaxed);
+        worker->busy_ns.store(0, std::memory_order_relaxed);
+    }
+    m_statistics_start.store(
+        std::chrono::steady_clock::now().time_since_epoch().count(),
+        std::memory_order_relaxed
+    );
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  WorkStealingPool::Run(): the loop of a worker thread
+//
+void WorkStealingPool::Run(const std::size_t index)
+{
+    t_pool = this;
+    t_worker = index;
+    Worker& worker = *m_workers[index];
+    auto random = static_cast<std::uint32_t>(index) * 2654435761U + 1U;
+
+    Task task;
+    while(true)
+    {
+        if(Pop(index, task) || Steal(index, random, task))
+        {
+            const auto start = std::chrono::steady_clock::now();
+            task();
+            task = nullptr;
+            const auto busy = std::chrono::steady_clock::now() - start;
+            worker.busy_ns.fetch_add(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count(),
+                std::memory_order_relaxed
+            );
+            worker.executed.fetch_add(1, std::memory_order_relaxed);
+            Finish();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_sleeping.fetch_add(1);
+        m_wakeup.wait_for(lock, IDLE_TIMEOUT, [this]() {
+            return m_stop.load() || m_queued.load() > 0;
+        });
+        m_sleeping.fetch_sub(1);
+        if(m_stop.load() && m_queued.load() == 0){
+            return;
+        }
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  WorkStealingPool::Pop(): take the newest task of a worker's own deque
+//
+bool WorkStealingPool::Pop(const std::size_t index, Task& task)
+{
+    Worker& worker = *m_workers[index];
+    const std::lock_guard<std::mutex> lock(worker.mutex);
+    if(worker.tasks.empty()){
+        return false;
+    }
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    m_queued.fetch_sub(1);
+    return true;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  WorkStealingPool::Steal(): take the oldest task of another worker,
+//                             starting with a random one
+//
+bool WorkStealingPool::Steal(const std::size_t index,
+                             std::uint32_t& random,
+                             Task& task)
+{
+    if(m_queued.load(std::memory_order_relaxed) == 0){
+        return false;
+    }
+
+    // xorshift32
+    random ^= random << 13U;
+    random ^= random >> 17U;
+    random ^= random << 5U;
+
+    const std::size_t count = m_workers.size();
+    const std::size_t first = random % count;
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        const std::size_t victim = (first + i) % count;
+        if(victim == index){
+            continue;
+        }
+        Worker& worker = *m_workers[victim];
+        const std::lock_guard<std::mutex> lock(worker.mutex);
+        if( !worker.tasks.empty() ){
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+            m_queued.fetch_sub(1);
+            m_workers[index]->steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  WorkStealingPool::Finish(): account for a completed task
+//
+void WorkStealingPool::Finish() noexcept
+{
+    if(m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1){
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_done.notify_all();
+    }
+}
+
+
+// Shared by all tasks of RunSessions(): with a session, this keeps the
+// captures of a task small enough for std::function not to allocate
+struct SessionRun {
+    WorkStealingPool* pool;
+    std::size_t events_per_task;
+};
+
+
+//-----------------------------------------------------------------------------
+//
+//  RunSlice(): process a few events of a session, then submit it again
+//
+static void RunSlice(const SessionRun& run, BattleSession& session)
+{
+    for(std::size_t i = 0; i < run.events_per_task; ++i){
+        if( !session.Step() ){
+            return;
+        }
+    }
+    run.pool->Submit([&run, &session]() { RunSlice(run, session); });
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  RunSessions()
+//
+BattleStatistics RunSessions(WorkStealingPool& pool,
+                             const BattleConfig& config,
+                             const std::size_t count,
+                             const std::uint32_t seed,
+                             const std::size_t events_per_task)
+{
+    const SessionRun run{&pool, events_per_task > 0 ? events_per_task : 1};
+    std::vector<BattleSession> sessions;
+    sessions.reserve(count); // sessions must not move while running
+    for(std::size_t i = 0; i < count; ++i){
+        sessions.emplace_back(config, seed + static_cast<std::uint32_t>(i));
+    }
+
+    for(auto& session : sessions){
+        pool.Submit([&run, &session]() { RunSlice(run, session); });
+    }
+    pool.Wait();
+
+    BattleStatistics stats;
+    for(const auto& session : sessions){
+        AddResult(stats, session.Result());
+    }
+    return stats;
+}
@@ -0,0 +1,418 @@
+#include "world_snapshot.h"
+#include "byte_order.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SNAPSHOT_USE_MMAP 1
+#endif
+
+static_assert(sizeof(int) == 4, "fighters are stored as int32");
+
+static constexpr char SNAPSHOT_MAGIC[8] = {'S', 'C', 'G', 'W', 'O', 'R', 'L', 'D'};
+static constexpr std::uint32_t FLAG_OVER = 1U;
+static constexpr std::uint32_t FLAG_HERO_WINS = 2U;
+
+static constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ULL;
+static constexpr std::uint64_t FNV_PRIME = 1099511628211ULL;
+
+// Bytes written to the file at once
+static constexpr std::size_t WRITE_BUFFER_SIZE = 1U << 16U;
+
+
+/**
+ * @brief Fields of a snapshot header, once checked
+ */
+struct SnapshotHeader {
+    std::size_t header_size{0};
+    std::uint32_t flags{0};
+    std::size_t fighter_count{0};
+    std::size_t timer_count{0};
+    std::int64_t clock{0};
+    std::uint64_t steps{0};
+    std::uint64_t checksum{0};
+    std::size_t sections_size{0};
+};
+
+
+//-----------------------------------------------------------------------------
+//
+//  PaddedSize(): size of a section, rounded up to a multiple of 8 bytes
+//
+static std::size_t PaddedSize(const std::size_t size) noexcept
+{
+    return (size + 7U) & ~std::size_t{7};
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  Checksum(): FNV-1a over 64 bit words
+//
+static std::uint64_t Checksum(std::uint64_t hash,
+                              const unsigned char* data,
+                              const std::size_t size) noexcept
+{
+    for(std::size_t offset = 0; offset + 8 <= size; offset += 8){
+        hash ^= LoadLittle(data + offset, 8);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ParseHeader(): check a snapshot and decode its header
+//
+static SNAPSHOT_STATUS_t ParseHeader(const unsigned char* data,
+                                     const std::size_t size,
+                                     const bool verify,
+                                     SnapshotHeader& header)
+{
+    if(size < SNAPSHOT_HEADER_SIZE ||
+       std::memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+    {
+        return SNAPSHOT_BAD_FORMAT;
+    }
+    if(LoadLittle(data + 8, 2) != SNAPSHOT_VERSION){
+        return SNAPSHOT_BAD_VERSION;
+    }
+
+    header.header_size = LoadLittle(data + 10, 2);
+    header.flags = static_cast<std::uint32_t>(LoadLittle(data + 12, 4));
+    const std::uint64_t fighter_count = LoadLittle(data + 16, 8);
+    const std::uint64_t timer_count = LoadLittle(data + 24, 8);
+    header.clock = static_cast<std::int64_t>(LoadLittle(data + 32, 8));
+    header.steps = LoadLittle(data + 40, 8);
+    header.checksum = LoadLittle(data + 48, 8);
+    const std::uint64_t sections_size = LoadLittle(data + 56, 8);
+
+    // the counts are bounded by the file size before computing any size
+    if(header.header_size < SNAPSHOT_HEADER_SIZE ||
+       header.header_size % 8 != 0 || header.header_size > size ||
+       fighter_count > size || timer_count > size ||
+       sections_size != 2 * PaddedSize(4 * fighter_count) +
+                        sizeof(SnapshotTimer) * timer_count ||
+       sections_size > size - header.header_size)
+    {
+        return SNAPSHOT_BAD_FORMAT;
+    }
+    header.fighter_count = fighter_count;
+    header.timer_count = timer_count;
+    header.sections_size = sections_size;
+
+    if(verify && Checksum(FNV_OFFSET, data + header.header_size,
+                          header.sections_size) != header.checksum)
+    {
+        return SNAPSHOT_BAD_CHECKSUM;
+    }
+    return SNAPSHOT_OK;
+}
+
+
+/**
+ * @brief Buffered writer of the sections of a snapshot, computing their
+ *        checksum on the way
+ */
+class SectionWriter {
+public:
+    explicit SectionWriter(std::ofstream& file) : m_file(file) {
+        m_buffer.reserve(WRITE_BUFFER_SIZE);
+    }
+
+    void PutInts(const int* values, std::size_t count)
+    {
+        const bool little_endian = LittleEndianHost();
+        while(count > 0)
+        {
+            const std::size_t fill = m_buffer.size();
+            const std::size_t chunk = std::min(count, (WRITE_BUFFER_SIZE - fill) / 4);
+            m_buffer.resize(fill + 4 * chunk);
+            unsigned char* out = m_buffer.data() + fill;
+            if(little_endian){
+                std::memcpy(out, values, 4 * chunk);
+            }
+            else{
+                for(std::size_t i = 0; i < chunk; ++i){
+                    StoreLittle(out + 4 * i, static_cast<std::uint32_t>(values[i]), 4);
+                }
+            }
+            values += chunk;
+            count -= chunk;
+            if(m_buffer.size() + 4 > WRITE_BUFFER_SIZE){
+                Flush();
+            }
+        }
+    }
+
+    void Put64(const std::uint64_t value)
+    {
+        if(m_buffer.size() + 8 > WRITE_BUFFER_SIZE){
+            Flush();
+        }
+        const std::size_t fill = m_buffer.size();
+        m_buffer.resize(fill + 8);
+        StoreLittle(m_buffer.data() + fill, value, 8);
+    }
+
+    void Pad()
+    {
+        m_buffer.resize(PaddedSize(m_buffer.size()), 0);
+    }
+
+    void Flush()
+    {
+        m_checksum = Checksum(m_checksum, m_buffer.data(), m_buffer.size());
+        m_file.write(reinterpret_cast<const char*>(m_buffer.data()),
+                     static_cast<std::streamsize>(m_buffer.size()));
+        m_written += m_buffer.size();
+        m_buffer.clear();
+    }
+
+    ATTRIBUTE_NO_DISCARD std::uint64_t Hash() const noexcept { return m_checksum; }
+    ATTRIBUTE_NO_DISCARD std::size_t Written() const noexcept { return m_written; }
+
+private:
+    std::ofstream& m_file;
+    std::vector<unsigned char> m_buffer; // always flushed at a multiple of 8
+    std::uint64_t m_checksum{FNV_OFFSET};
+    std::size_t m_written{0};
+};
+
+
+//-----------------------------------------------------------------------------
+//
+//  WriteSnapshot()
+//
+SNAPSHOT_STATUS_t WriteSnapshot(const WorldState& world, const char* path)
+{
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if(!file){
+        return SNAPSHOT_IO_ERROR;
+    }
+
+    // the header, known once the sections are written, goes in last
+    unsigned char header[SNAPSHOT_HEADER_SIZE] = {};
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    const std::size_t fighter_count = world.fighters.Size();
+    SectionWriter sections{file};
+    sections.PutInts(world.fighters.Roles(), fighter_count);
+    sections.Pad();
+    sections.PutInts(world.fighters.Health(), fighter_count);
+    sections.Pad();
+    for(const auto& timer : world.timers){
+        sections.Put64(static_cast<std::uint64_t>(timer.time));
+        sections.Put64(timer.actor);
+        sections.Put64(timer.sequence);
+    }
+    sections.Flush();
+
+    std::memcpy(header, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    StoreLittle(header + 8, SNAPSHOT_VERSION, 2);
+    StoreLittle(header + 10, SNAPSHOT_HEADER_SIZE, 2);
+    StoreLittle(header + 12, (world.over ? FLAG_OVER : 0U) |
+                       (world.hero_wins ? FLAG_HERO_WINS : 0U), 4);
+    StoreLittle(header + 16, fighter_count, 8);
+    StoreLittle(header + 24, world.timers.size(), 8);
+    StoreLittle(header + 32, static_cast<std::uint64_t>(world.clock), 8);
+    StoreLittle(header + 40, world.steps, 8);
+    StoreLittle(header + 48, sections.Hash(), 8);
+    StoreLittle(header + 56, sections.Written(), 8);
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    file.close();
+    return file ? SNAPSHOT_OK : SNAPSHOT_IO_ERROR;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  ReadSnapshot()
+//
+SNAPSHOT_STATUS_t ReadSnapshot(const char* path, WorldState& world)
+{
+    if(LittleEndianHost()){
+        MappedSnapshot snapshot;
+        const SNAPSHOT_STATUS_t status = snapshot.Open(path);
+        if(status == SNAPSHOT_OK){
+            snapshot.Restore(world);
+        }
+        return status;
+    }
+
+    // big endian host: the whole file is read, then decoded
+    std::ifstream file{path, std::ios::binary};
+    if(!file){
+        return SNAPSHOT_IO_ERROR;
+    }
+    const std::vector<unsigned char> data{std::istreambuf_iterator<char>(file),
+                                          std::istreambuf_iterator<char>()};
+    SnapshotHeader header;
+    const SNAPSHOT_STATUS_t status = ParseHeader(data.data(), data.size(),
+                                                 true, header);
+    if(status != SNAPSHOT_OK){
+        return status;
+    }
+
+    const std::size_t count = header.fighter_count;
+    const unsigned char* roles = data.data() + header.header_size;
+    const unsigned char* health = roles + PaddedSize(4 * count);
+    const unsigned char* timers = health + PaddedSize(4 * count);
+    std::vector<int> role_values(count);
+    std::vector<int> health_values(count);
+    for(std::size_t i = 0; i < count; ++i){
+        role_values[i] = static_cast<std::int32_t>(LoadLittle(roles + 4 * i, 4));
+        health_values[i] = static_cast<std::int32_t>(LoadLittle(health + 4 * i, 4));
+    }
+
+    world.clock = header.clock;
+    world.steps = header.steps;
+    world.over = (header.flags & FLAG_OVER) != 0;
+    world.hero_wins = (header.flags & FLAG_HERO_WINS) != 0;
+    world.fighters.Assign(role_values.data(), health_values.data(), count);
+    world.timers.resize(header.timer_count);
+    for(auto& timer : world.timers){
+        timer.time = static_cast<std::int64_t>(LoadLittle(timers, 8));
+        timer.actor = LoadLittle(timers + 8, 8);
+        timer.sequence = LoadLittle(timers + 16, 8);
+        timers += sizeof(SnapshotTimer);
+    }
+    return SNAPSHOT_OK;
+}
+
+
+//=============================================================================
+//
+//                    Implementations for the class MappedSnapshot
+//
+//=============================================================================
+
+
+//-----------------------------------------------------------------------------
+//
+//  Destructor
+//
+MappedSnapshot::~MappedSnapshot()
+{
+    Close();
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  MappedSnapshot::Open()
+//
+SNAPSHOT_STATUS_t MappedSnapshot::Open(const char* path, const bool verify)
+{
+    Close();
+
+#if defined(SNAPSHOT_USE_MMAP)
+    const int fd = ::open(path, O_RDONLY); // NOLINT
+    if(fd < 0){
+        return SNAPSHOT_IO_ERROR;
+    }
+    struct stat status{};
+    if(::fstat(fd, &status) != 0){
+        ::close(fd);
+        return SNAPSHOT_IO_ERROR;
+    }
+    const auto size = static_cast<std::size_t>(status.st_size);
+    if(size < SNAPSHOT_HEADER_SIZE){
+        ::close(fd);
+        return SNAPSHOT_BAD_FORMAT;
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping stays valid
+    if(mapping == MAP_FAILED){ // NOLINT
+        return SNAPSHOT_IO_ERROR;
+    }
+    m_data = static_cast<const unsigned char*>(mapping);
+    m_size = size;
+#else
+    std::ifstream file{path, std::ios::binary};
+    if(!file){
+        return SNAPSHOT_IO_ERROR;
+    }
+    m_buffer.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#endif
+
+    SnapshotHeader header;
+    SNAPSHOT_STATUS_t result = ParseHeader(m_data, m_size, verify, header);
+    if(result == SNAPSHOT_OK && !LittleEndianHost()){
+        result = SNAPSHOT_BAD_BYTE_ORDER;
+    }
+    if(result != SNAPSHOT_OK){
+        Close();
+        return result;
+    }
+
+    // the sections start at a multiple of 8 bytes from the page aligned
+    // mapping, so they can be used in place
+    const std::size_t section_size = PaddedSize(4 * header.fighter_count);
+    const unsigned char* sections = m_data + header.header_size;
+    m_fighter_count = header.fighter_count;
+    m_timer_count = header.timer_count;
+    m_roles = reinterpret_cast<const int*>(sections);
+    m_health = reinterpret_cast<const int*>(sections + section_size);
+    m_timers = reinterpret_cast<const SnapshotTimer*>(sections + 2 * section_size);
+    m_clock = header.clock;
+    m_steps = header.steps;
+    m_over = (header.flags & FLAG_OVER) != 0;
+    m_hero_wins = (header.flags & FLAG_HERO_WINS) != 0;
+    return SNAPSHOT_OK;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  MappedSnapshot::Close()
+//
+void MappedSnapshot::Close() noexcept
+{
+#if defined(SNAPSHOT_USE_MMAP)
+    if(m_data != nullptr){
+        ::munmap(const_cast<unsigned char*>(m_data), m_size); // NOLINT
+    }
+#endif
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_fighter_count = 0;
+    m_timer_count = 0;
+    m_roles = nullptr;
+    m_health = nullptr;
+    m_timers = nullptr;
+    m_clock = 0;
+    m_steps = 0;
+    m_over = false;
+    m_hero_wins = false;
+}
+
+
+//-----------------------------------------------------------------------------
+//
+//  MappedSnapshot::Restore()
+//
+void MappedSnapshot::Restore(WorldState& world) const
+{
+    world.clock = m_clock;
+    world.steps = m_steps;
+    world.over = m_over;
+    world.hero_wins = m_hero_wins;
+    world.fighters.Assign(m_roles, m_health, m_fighter_count);
+    world.timers.assign(m_timers, m_timers + m_timer_count);
+}
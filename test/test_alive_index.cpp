@@ -0,0 +1,194 @@
+#include <cstddef>
+#include <set>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "alive_index.h"
+#include "fighter.h"
+#include "fighter_pool.h"
+
+
+TEST(AliveIndex, Factions)
+{
+    EXPECT_EQ(RoleFaction(ROLE_HERO), FACTION_HEROES);
+    EXPECT_EQ(RoleFaction(ROLE_ORC), FACTION_MONSTERS);
+    EXPECT_EQ(RoleFaction(ROLE_DRAGON), FACTION_MONSTERS);
+    EXPECT_EQ(RoleFaction(ROLE_UNDEFINED), FACTION_NONE);
+    EXPECT_EQ(EnemyFaction(FACTION_HEROES), FACTION_MONSTERS);
+    EXPECT_EQ(EnemyFaction(FACTION_NONE), FACTION_NONE);
+}
+
+TEST(AliveIndex, KillLeavesTheIndex)
+{
+    auto hero = Hero(ROLE_HERO);
+    auto orc = Orc(ROLE_ORC);
+    auto dragon = Dragon(ROLE_DRAGON);
+    AliveIndex alive;
+    const std::size_t orc_slot = alive.Add(orc);
+    alive.Add(hero);
+    alive.Add(dragon);
+
+    EXPECT_EQ(alive.Size(), 3U);
+    EXPECT_EQ(alive.Count(FACTION_HEROES), 1U);
+    EXPECT_EQ(alive.Count(FACTION_MONSTERS), 2U);
+    EXPECT_FALSE(alive.IsOver());
+
+    // HEALTH_ORC = 7: the fourth hit kills the orc
+    for(int i = 0; i < 4; ++i){
+        EXPECT_TRUE(hero.Hit(orc));
+    }
+    EXPECT_FALSE(alive.IsAlive(orc_slot));
+    EXPECT_EQ(alive.Count(FACTION_MONSTERS), 1U);
+    EXPECT_EQ(alive.PopCount(FACTION_MONSTERS), 1U);
+    EXPECT_EQ(alive.Target(hero), &dragon);
+    EXPECT_EQ(alive.Target(dragon), &hero);
+
+    dragon.Reset();
+    EXPECT_FALSE(alive.AnyAlive(FACTION_MONSTERS));
+    EXPECT_TRUE(alive.IsOver());
+    EXPECT_EQ(alive.Target(hero), nullptr);
+
+    // a reset fighter is removed once
+    dragon.Reset();
+    EXPECT_EQ(alive.Count(FACTION_MONSTERS), 0U);
+}
+
+TEST(AliveIndex, UpdateAfterSetters)
+{
+    auto orc = Orc(ROLE_ORC);
+    AliveIndex alive;
+    const std::size_t slot = alive.Add(orc);
+
+    orc.SetHealth(HEALTH_DEAD);
+    EXPECT_TRUE(alive.IsAlive(slot)); // not tracked
+    alive.Update(slot);
+    EXPECT_FALSE(alive.IsAlive(slot));
+
+    orc.SetHealth(HEALTH_ORC);
+    orc.SetRole(ROLE_HERO);
+    alive.Update(slot);
+    EXPECT_EQ(alive.Count(FACTION_HEROES), 1U);
+    EXPECT_EQ(alive.Count(FACTION_MONSTERS), 0U);
+
+    // an assignment updates the index by itself
+    orc = Orc(ROLE_DRAGON);
+    EXPECT_EQ(alive.Count(FACTION_HEROES), 0U);
+    EXPECT_EQ(alive.Count(FACTION_MONSTERS), 1U);
+}
+
+TEST(AliveIndex, FindAndTarget)
+{
+    auto hero = Hero(ROLE_HERO);
+    std::vector<Monster> monsters(200, Monster(ROLE_ORC));
+    AliveIndex alive;
+    for(auto& monster : monsters){
+        alive.Add(monster);
+    }
+    for(std::size_t i = 0; i < 150; ++i){
+        monsters[i].Reset();
+    }
+
+    EXPECT_EQ(alive.Find(FACTION_MONSTERS), 150U);
+    EXPECT_EQ(alive.Find(FACTION_MONSTERS, 170), 170U);
+    monsters[199].Reset();
+    EXPECT_EQ(alive.Find(FACTION_MONSTERS, 199), NO_FIGHTER);
+    EXPECT_EQ(alive.Find(FACTION_HEROES), NO_FIGHTER);
+
+    // the targets are exactly the living monsters
+    std::set<const Fighter*> targets;
+    for(std::size_t choice = 0; choice < alive.Count(FACTION_MONSTERS); ++choice){
+        const Fighter* target = alive.Target(hero, choice);
+        ASSERT_NE(target, nullptr);
+        EXPECT_TRUE(target->IsAlive());
+        targets.insert(target);
+    }
+    EXPECT_EQ(targets.size(), 49U);
+}
+
+TEST(AliveIndex, ConcurrentKills)
+{
+    // two heroes kill disjoint halves of a horde at the same time
+    constexpr std::size_t MONSTERS = 10000;
+    std::vector<Monster> monsters(MONSTERS, Monster(ROLE_ORC));
+    AliveIndex alive;
+    for(auto& monster : monsters){
+        alive.Add(monster);
+    }
+
+    std::vector<std::thread> heroes;
+    for(std::size_t h = 0; h < 2; ++h){
+        heroes.emplace_back([&monsters, h]() {
+            const auto hero = Hero(ROLE_HERO);
+            for(std::size_t i = h; i < MONSTERS; i += 2){
+                while(hero.Hit(monsters[i])){}
+            }
+        });
+    }
+    for(auto& hero : heroes){
+        hero.join();
+    }
+
+    EXPECT_EQ(alive.Count(FACTION_MONSTERS), 0U);
+    EXPECT_EQ(alive.PopCount(FACTION_MONSTERS), 0U);
+}
+
+TEST(AliveIndex, ClearUnregisters)
+{
+    auto orc = Orc(ROLE_ORC);
+    {
+        AliveIndex alive;
+        alive.Add(orc);
+        alive.Clear();
+        EXPECT_EQ(alive.Size(), 0U);
+        EXPECT_FALSE(alive.AnyAlive(FACTION_MONSTERS));
+        orc.Reset(); // the orc no longer knows the index
+    }
+    AliveIndex alive;
+    alive.Add(orc);
+    EXPECT_EQ(alive.Count(FACTION_MONSTERS), 0U);
+}
+
+TEST(AliveIndex, DespawnUnregisters)
+{
+    FighterPool pool{4};
+    AliveIndex alive;
+    auto hero = Hero(ROLE_HERO);
+    alive.Add(hero);
+    Fighter* orc = pool.Spawn(ROLE_ORC);
+    const std::size_t orc_slot = alive.Add(*orc);
+
+    // the slot of the orc is reused by a fighter unknown to the index
+    pool.Despawn(orc);
+    EXPECT_EQ(alive.At(orc_slot), nullptr);
+    EXPECT_FALSE(alive.IsAlive(orc_slot));
+    EXPECT_EQ(alive.Count(FACTION_MONSTERS), 0U);
+    EXPECT_TRUE(alive.IsOver());
+    Fighter* dragon = pool.Spawn(ROLE_DRAGON);
+    EXPECT_EQ(static_cast<void*>(dragon), static_cast<void*>(orc));
+    EXPECT_EQ(alive.Target(hero), nullptr);
+
+    // a release destroys the living fighters, the despawned ones excepted
+    const std::size_t dragon_slot = alive.Add(*dragon);
+    Fighter* other = pool.Spawn(ROLE_ORC);
+    const std::size_t other_slot = alive.Add(*other);
+    pool.Despawn(other);
+    EXPECT_EQ(alive.Count(FACTION_MONSTERS), 1U);
+    pool.Release();
+    EXPECT_EQ(alive.At(dragon_slot), nullptr);
+    EXPECT_EQ(alive.At(other_slot), nullptr);
+    EXPECT_EQ(alive.Count(FACTION_MONSTERS), 0U);
+    EXPECT_EQ(alive.Count(FACTION_HEROES), 1U);
+}
+
+TEST(AliveIndex, DestroyedBeforeTheIndex)
+{
+    AliveIndex alive;
+    {
+        auto orc = Orc(ROLE_ORC);
+        alive.Add(orc);
+        EXPECT_EQ(alive.Count(FACTION_MONSTERS), 1U);
+    }
+    EXPECT_EQ(alive.Count(FACTION_MONSTERS), 0U);
+    EXPECT_EQ(alive.At(0), nullptr);
+    alive.Clear();
+}
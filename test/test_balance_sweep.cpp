@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include "gtest/gtest.h"
+#include "balance_sweep.h"
+#include "simulation.h"
+
+
+TEST(BalanceSweep, RangeCount)
+{
+    EXPECT_EQ((SweepRange{5, 5}).Count(), 1U);
+    EXPECT_EQ((SweepRange{1, 10}).Count(), 10U);
+    EXPECT_EQ((SweepRange{1, 10, 4}).Count(), 3U); // 1, 5, 9
+    EXPECT_EQ((SweepRange{10, 1}).Count(), 0U);
+    EXPECT_EQ((SweepRange{1, 10, 0}).Count(), 0U);
+
+    SweepRanges ranges;
+    EXPECT_EQ(SweepSize(ranges), 1U);
+    ranges.orc_health = {1, 10};
+    ranges.dragon_damage = {1, 3};
+    EXPECT_EQ(SweepSize(ranges), 30U);
+    ranges.hero_interval = {1000, 500};
+    EXPECT_EQ(SweepSize(ranges), 0U);
+}
+
+TEST(BalanceSweep, OnlyEndingBattles)
+{
+    SweepRanges ranges;
+    EXPECT_TRUE(SweepEnds(ranges));
+
+    ranges.hero_damage = {0, 3}; // the monsters would never die
+    EXPECT_FALSE(SweepEnds(ranges));
+    ranges.hero_damage = {1, 3};
+    ranges.orc_damage = {-2, 2}; // healing
+    EXPECT_FALSE(SweepEnds(ranges));
+    ranges.orc_damage = {1, 2};
+    ranges.dragon_interval = {0, 100};
+    EXPECT_FALSE(SweepEnds(ranges));
+    ranges.dragon_interval = {100, 100};
+    EXPECT_TRUE(SweepEnds(ranges));
+}
+
+TEST(BalanceSweep, Config)
+{
+    BattleConfig base;
+    base.hero_jitter = 7;
+    SweepRanges ranges;
+    ranges.hero_health = {10, 20, 10};
+    ranges.dragon_interval = {100, 300, 100};
+
+    // the dragon interval varies the fastest
+    auto config = SweepConfig(base, ranges, 0);
+    EXPECT_EQ(config.hero_health, 10);
+    EXPECT_EQ(config.dragon_interval, 100);
+    config = SweepConfig(base, ranges, 2);
+    EXPECT_EQ(config.hero_health, 10);
+    EXPECT_EQ(config.dragon_interval, 300);
+    config = SweepConfig(base, ranges, 4);
+    EXPECT_EQ(config.hero_health, 20);
+    EXPECT_EQ(config.dragon_interval, 200);
+
+    // fixed parameters keep their value, the rest comes from the base
+    EXPECT_EQ(config.orc_health, HEALTH_ORC);
+    EXPECT_EQ(config.hero_damage, Fighter::RoleDamage(ROLE_HERO));
+    EXPECT_EQ(config.hero_jitter, 7);
+}
+
+TEST(BalanceSweep, DefaultValues)
+{
+    std::ostringstream csv;
+    const auto stats = RunSweep(BattleConfig{}, SweepRanges{}, 1, 0, csv);
+
+    EXPECT_EQ(stats.battles, 1U);
+    EXPECT_EQ(stats.wins, 1U);
+    EXPECT_EQ(stats.total_duration, 14000);
+    EXPECT_EQ(stats.hero_hits, 14);
+    EXPECT_EQ(stats.monster_hits, 8);
+
+    std::string header;
+    std::string line;
+    std::istringstream lines{csv.str()};
+    std::getline(lines, header);
+    std::getline(lines, line);
+    EXPECT_EQ(header.rfind("hero_health,orc_health,", 0), 0U);
+    EXPECT_EQ(line, "40,7,20,2,1,3,1000,1500,2000,1,1,1,14000,14,8");
+}
+
+TEST(BalanceSweep, ReductionMatchesSequential)
+{
+    BattleConfig base;
+    base.hero_jitter = 500;
+    SweepRanges ranges;
+    ranges.hero_health = {10, 30, 5};
+    ranges.orc_damage = {1, 3};
+    ranges.hero_interval = {800, 1600, 200};
+
+    std::ostringstream csv;
+    const auto stats = RunSweep(base, ranges, 8, 3, csv);
+
+    BattleStatistics expected;
+    const std::size_t size = SweepSize(ranges);
+    for(std::size_t i = 0; i < size; ++i){
+        const auto config = SweepConfig(base, ranges, i);
+        for(std::uint32_t battle = 0; battle < 8; ++battle){
+            AddResult(expected, SimulateBattle(config, 3 + battle));
+        }
+    }
+    EXPECT_EQ(stats.battles, size * 8);
+    EXPECT_EQ(stats.wins, expected.wins);
+    EXPECT_EQ(stats.total_duration, expected.total_duration);
+    EXPECT_EQ(stats.hero_hits, expected.hero_hits);
+    EXPECT_EQ(stats.monster_hits, expected.monster_hits);
+
+    // a header, then one line per configuration
+    const std::string out = csv.str();
+    EXPECT_EQ(static_cast<std::size_t>(std::count(out.begin(), out.end(), '\n')),
+              size + 1);
+}
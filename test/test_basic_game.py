@@ -0,0 +1,114 @@
+"""Tests of the python interface of the game, built from include/fighter.i by
+the target basic_game_swig. Run by ctest as Python_tests, or by hand with:
+
+    PYTHONPATH=<build directory> python -m pytest test/test_basic_game.py
+"""
+import numpy
+import pytest
+
+import basic_game as game
+
+
+def orcs(health):
+    """A FighterBatch of orcs with the given health points"""
+    batch = game.FighterBatch()
+    for points in health:
+        batch.SetHealth(batch.Add(game.ROLE_ORC), points)
+    return batch
+
+
+def test_fighter_arrays_view_the_batch():
+    batch = game.FighterBatch(3, game.ROLE_ORC)
+    roles, health = game.fighter_arrays(batch)
+
+    assert roles.tolist() == [game.ROLE_ORC] * 3
+    assert health.tolist() == [game.HEALTH_ORC] * 3
+
+    # both ways: no copy
+    health[1] = 1
+    assert batch.GetHealth(1) == 1
+    batch.SetHealth(2, 5)
+    assert health[2] == 5
+
+    assert not roles.flags.writeable
+    with pytest.raises(ValueError):
+        roles[0] = game.ROLE_DRAGON
+
+
+def test_fighter_arrays_pin_the_batch():
+    batch = game.FighterBatch(3, game.ROLE_ORC)
+    roles, health = game.fighter_arrays(batch)
+
+    # the vectors viewed by the arrays would move or shrink
+    with pytest.raises(RuntimeError):
+        batch.Add(game.ROLE_ORC)
+    with pytest.raises(RuntimeError):
+        batch.Reserve(1000)
+    with pytest.raises(RuntimeError):
+        batch.Clear()
+    assert batch.Size() == 3
+
+    del roles
+    with pytest.raises(RuntimeError):
+        batch.Add(game.ROLE_ORC)
+    del health
+    assert batch.Add(game.ROLE_ORC) == 3
+
+
+def test_fighter_arrays_of_an_empty_batch():
+    roles, health = game.fighter_arrays(game.FighterBatch())
+    assert roles.size == 0
+    assert health.size == 0
+
+
+def test_count_alive():
+    health = numpy.array([game.HEALTH_DEAD, 3, game.HEALTH_UNDEFINED, game.HEALTH_HERO])
+    assert game.count_alive(health) == 2
+    assert game.count_alive([]) == 0
+
+
+def test_run_ticks_leaves_its_inputs_unchanged():
+    attacker_roles = numpy.full(2, game.ROLE_HERO, numpy.intc)
+    attacker_health = numpy.full(2, game.HEALTH_HERO, numpy.intc)
+    target_roles = numpy.array([game.ROLE_ORC, game.ROLE_DRAGON], numpy.intc)
+    target_health = numpy.array([game.HEALTH_ORC, game.HEALTH_DRAGON], numpy.intc)
+
+    roles, health, attacks = game.run_ticks(attacker_roles, attacker_health,
+                                            target_roles, target_health, 2)
+
+    assert attacks == 4
+    assert roles.tolist() == [game.ROLE_ORC, game.ROLE_DRAGON]
+    assert health.tolist() == [game.HEALTH_ORC - 4, game.HEALTH_DRAGON - 4]
+    assert target_health.tolist() == [game.HEALTH_ORC, game.HEALTH_DRAGON]
+
+
+def test_run_ticks_stops_once_nothing_attacks():
+    heroes = [game.ROLE_HERO] * 2
+    # 4 hits kill the first orc, 1 hit the second one
+    roles, health, attacks = game.run_ticks(heroes, [game.HEALTH_HERO] * 2,
+                                            [game.ROLE_ORC] * 2, [game.HEALTH_ORC, 1],
+                                            100)
+
+    assert attacks == 5
+    assert roles.tolist() == [game.ROLE_UNDEFINED] * 2
+    assert game.count_alive(health) == 0
+
+
+def test_run_ticks_in_place_updates_the_batches():
+    heroes = game.FighterBatch(2, game.ROLE_HERO)
+    targets = orcs([game.HEALTH_ORC, 1])
+    _, before = game.fighter_arrays(targets)
+
+    roles, health, attacks = game.apply_attacks_in_place(heroes, targets)
+
+    assert attacks == 2
+    assert roles.tolist() == [game.ROLE_ORC, game.ROLE_UNDEFINED]
+    assert health[0] == game.HEALTH_ORC - 2
+    # the arrays returned and the ones taken before view the same memory
+    assert before.tolist() == health.tolist()
+    health[0] = 1
+    assert targets.GetHealth(0) == 1
+
+    _, _, attacks = game.run_ticks_in_place(heroes, targets, 10)
+    assert attacks == 1
+    assert targets.CountAlive() == 0
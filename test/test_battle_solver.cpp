@@ -0,0 +1,115 @@
+#include <cstddef>
+#include "gtest/gtest.h"
+#include "battle_solver.h"
+#include "fighter.h"
+#include "simulation.h"
+
+
+static void ExpectSameResult(const BattleResult& solved,
+                             const BattleResult& simulated)
+{
+    EXPECT_EQ(solved.hero_wins, simulated.hero_wins);
+    EXPECT_EQ(solved.duration, simulated.duration);
+    EXPECT_EQ(solved.hero_health, simulated.hero_health);
+    EXPECT_EQ(solved.hero_hits, simulated.hero_hits);
+    EXPECT_EQ(solved.monster_hits, simulated.monster_hits);
+}
+
+
+TEST(BattleSolver, DefaultBattle)
+{
+    BattleSolver solver{BattleConfig{}};
+    const auto result = solver.Solve();
+
+    EXPECT_TRUE(result.hero_wins);
+    EXPECT_EQ(result.duration, 14000);
+    EXPECT_EQ(result.hero_hits, 14);
+    EXPECT_EQ(result.monster_hits, 8);
+    EXPECT_EQ(result.hero_health, HEALTH_HERO - 2 * 1 - 6 * 3);
+}
+
+TEST(BattleSolver, MatchesSimulation)
+{
+    const HERO_POLICY_t policies[] = {POLICY_ORC_FIRST, POLICY_DRAGON_FIRST};
+    const int intervals[][3] = {
+        {1000, 1500, 2000}, {700, 700, 700}, {1300, 900, 2500}, {2000, 1000, 3000},
+    };
+    const int damages[][3] = {{2, 1, 3}, {3, 2, 1}, {1, 1, 1}};
+
+    for(const auto policy : policies){
+        for(const auto& interval : intervals){
+            for(const auto& damage : damages)
+            {
+                BattleConfig config;
+                config.policy = policy;
+                config.hero_interval = interval[0];
+                config.orc_interval = interval[1];
+                config.dragon_interval = interval[2];
+                config.hero_damage = damage[0];
+                config.orc_damage = damage[1];
+                config.dragon_damage = damage[2];
+
+                BattleSolver solver{config};
+                for(int hero = 1; hero <= 60; hero += 7){
+                    for(int orc = 0; orc <= 12; orc += 3){
+                        for(int dragon = 1; dragon <= 30; dragon += 4)
+                        {
+                            config.hero_health = hero;
+                            config.orc_health = orc;
+                            config.dragon_health = dragon;
+                            ExpectSameResult(solver.Solve(hero, orc, dragon),
+                                             SimulateBattle(config));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(BattleSolver, ScriptedHero)
+{
+    BattleConfig config;
+    config.policy = POLICY_SCRIPTED;
+    config.script = {ROLE_ORC, ROLE_UNDEFINED, ROLE_DRAGON};
+    BattleSolver solver{config};
+    ExpectSameResult(solver.Solve(), SimulateBattle(config));
+
+    config.script.assign(4, ROLE_ORC);
+    config.script.insert(config.script.end(), 10, ROLE_DRAGON);
+    BattleSolver winner{config};
+    const auto result = winner.Solve();
+    EXPECT_TRUE(result.hero_wins);
+    ExpectSameResult(result, SimulateBattle(config));
+}
+
+TEST(BattleSolver, PersistentCache)
+{
+    BattleSolver solver{BattleConfig{}};
+    static_cast<void>(solver.Solve());
+    const std::size_t size = solver.CacheSize();
+    EXPECT_GT(size, 0U);
+
+    // a repeated query is a single lookup
+    static_cast<void>(solver.Solve());
+    EXPECT_EQ(solver.CacheSize(), size);
+
+    // an orc with 8 health points takes as many hits as one with 7
+    const auto result = solver.Solve(HEALTH_HERO, 8, HEALTH_DRAGON);
+    EXPECT_EQ(solver.CacheSize(), size);
+    EXPECT_EQ(result.duration, 14000);
+
+    solver.ClearCache();
+    EXPECT_EQ(solver.CacheSize(), 0U);
+}
+
+TEST(BattleSolver, LargeHealth)
+{
+    BattleConfig config;
+    config.hero_health = 200000;
+    config.orc_health = 30000;
+    config.dragon_health = 80000;
+
+    BattleSolver solver{config};
+    ExpectSameResult(solver.Solve(), SimulateBattle(config));
+}
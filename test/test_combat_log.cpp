@@ -0,0 +1,125 @@
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "combat_log.h"
+#include "fighter.h"
+
+
+static std::size_t count_lines(const std::string& text, const std::string& line)
+{
+    std::size_t count{0};
+    for(auto position = text.find(line); position != std::string::npos;
+        position = text.find(line, position + 1)){
+        ++count;
+    }
+    return count;
+}
+
+
+TEST(CombatLog, DirectMode)
+{
+    std::ostringstream output;
+    CombatLog::Instance().Start(LOG_MODE_DIRECT, LOG_OVERFLOW_DROP, &output);
+
+    auto hero = Hero(ROLE_HERO);
+    auto orc = Orc(ROLE_ORC);
+    hero.Attack(orc);
+    orc.Print();
+    CombatLog::Instance().Start(LOG_MODE_DIRECT);
+
+    EXPECT_EQ(output.str(), "\033[32mHero hits Orc. Orc health is 5\n\033[0m"
+                            "Fighter information:\n\tRole: 'Orc'\n\t"
+                            "Remaining health: 5\n");
+}
+
+TEST(CombatLog, AsyncTextFromSeveralThreads)
+{
+    constexpr int THREADS = 4;
+    constexpr int MESSAGES = 20000; // more than a ring buffer holds
+    std::ostringstream output;
+    CombatLog::Instance().Start(LOG_MODE_ASYNC_TEXT, LOG_OVERFLOW_BLOCK, &output);
+    EXPECT_EQ(CombatLog::Instance().Mode(), LOG_MODE_ASYNC_TEXT);
+
+    std::vector<std::thread> threads;
+    for(int t = 0; t < THREADS; ++t){
+        threads.emplace_back([]() {
+            for(int i = 0; i < MESSAGES; ++i){
+                CombatLog::Instance().LogHit(ROLE_ORC, ROLE_HERO, i);
+            }
+        });
+    }
+    for(auto& thread : threads){
+        thread.join();
+    }
+    CombatLog::Instance().Flush();
+    const auto text = output.str();
+    CombatLog::Instance().Stop();
+
+    // the backpressure policy never drops a message
+    EXPECT_EQ(CombatLog::Instance().Mode(), LOG_MODE_DIRECT);
+    EXPECT_EQ(count_lines(text, "Orc hits Hero."),
+              static_cast<std::size_t>(THREADS * MESSAGES));
+    EXPECT_EQ(count_lines(text, "Hero health is 19999\n"), static_cast<std::size_t>(THREADS));
+}
+
+TEST(CombatLog, MergedByTime)
+{
+    std::ostringstream output;
+    CombatLog::Instance().Start(LOG_MODE_ASYNC_TEXT, LOG_OVERFLOW_BLOCK, &output);
+    CombatLog::Instance().LogFighter(ROLE_HERO, HEALTH_HERO); // drained first
+    CombatLog::Instance().Flush();
+
+    std::thread orc{[]() { CombatLog::Instance().LogHit(ROLE_ORC, ROLE_HERO, 39); }};
+    orc.join();
+    CombatLog::Instance().LogHit(ROLE_DRAGON, ROLE_HERO, 36);
+    CombatLog::Instance().Flush();
+    const auto text = output.str();
+    CombatLog::Instance().Stop();
+
+    const auto orc_hit = text.find("Orc hits Hero.");
+    const auto dragon_hit = text.find("Dragon hits Hero.");
+    ASSERT_NE(orc_hit, std::string::npos);
+    ASSERT_NE(dragon_hit, std::string::npos);
+    EXPECT_LT(orc_hit, dragon_hit);
+}
+
+TEST(CombatLog, DropPolicy)
+{
+    constexpr int MESSAGES = 100000;
+    std::ostringstream output;
+    const auto dropped_before = CombatLog::Instance().Dropped();
+    CombatLog::Instance().Start(LOG_MODE_ASYNC_TEXT, LOG_OVERFLOW_DROP, &output);
+    for(int i = 0; i < MESSAGES; ++i){
+        CombatLog::Instance().LogAttack(ROLE_HERO, ROLE_DRAGON);
+    }
+    CombatLog::Instance().Stop();
+
+    // each message is either written or counted as dropped
+    const auto dropped = CombatLog::Instance().Dropped() - dropped_before;
+    EXPECT_EQ(count_lines(output.str(), "Hero hits Dragon.") + dropped,
+              static_cast<std::size_t>(MESSAGES));
+}
+
+TEST(CombatLog, BinaryMode)
+{
+    std::stringstream binary;
+    CombatLog::Instance().Start(LOG_MODE_ASYNC_BINARY, LOG_OVERFLOW_BLOCK, &binary);
+    auto hero = Hero(ROLE_HERO);
+    auto dragon = Dragon(ROLE_DRAGON);
+    dragon.Attack(hero);
+    hero.Attack(dragon);
+    dragon.Print();
+    CombatLog::Instance().Stop();
+
+    EXPECT_EQ(binary.str().size(), 3 * sizeof(CombatRecord));
+
+    std::ostringstream text;
+    EXPECT_EQ(CombatLog::DecodeRecords(binary, text), 3U);
+    EXPECT_EQ(text.str(), "\033[31mDragon hits Hero. Hero health is 37\n\033[0m"
+                          "\033[32mHero hits Dragon. Dragon health is 18\n\033[0m"
+                          "Fighter information:\n\tRole: 'Dragon'\n\t"
+                          "Remaining health: 18\n");
+}
@@ -0,0 +1,38 @@
+#include <string>
+#include <string_view>
+#include "gtest/gtest.h"
+#include "command_parser.h"
+
+
+TEST(CommandParser, Attacks)
+{
+    EXPECT_EQ(ParseHeroCommand("attack orc"), ROLE_ORC);
+    EXPECT_EQ(ParseHeroCommand("attack dragon"), ROLE_DRAGON);
+    EXPECT_EQ(ParseHeroCommand("ATTACK Orc"), ROLE_ORC);
+    EXPECT_EQ(ParseHeroCommand("aTtAcK dRaGoN"), ROLE_DRAGON);
+    EXPECT_EQ(ParseHeroCommand("  attack \t orc  "), ROLE_ORC);
+}
+
+TEST(CommandParser, UnknownCommands)
+{
+    EXPECT_EQ(ParseHeroCommand(""), ROLE_UNDEFINED);
+    EXPECT_EQ(ParseHeroCommand("   "), ROLE_UNDEFINED);
+    EXPECT_EQ(ParseHeroCommand("attack"), ROLE_UNDEFINED);
+    EXPECT_EQ(ParseHeroCommand("orc"), ROLE_UNDEFINED);
+    EXPECT_EQ(ParseHeroCommand("attack orcs"), ROLE_UNDEFINED);
+    EXPECT_EQ(ParseHeroCommand("attack orc now"), ROLE_UNDEFINED);
+    EXPECT_EQ(ParseHeroCommand("orc attack"), ROLE_UNDEFINED);
+    EXPECT_EQ(ParseHeroCommand("attack attack"), ROLE_UNDEFINED);
+    EXPECT_EQ(ParseHeroCommand("attack hero"), ROLE_UNDEFINED);
+    // same hash, length, first and last letters as the keywords
+    EXPECT_EQ(ParseHeroCommand("abbbck orc"), ROLE_UNDEFINED);
+    EXPECT_EQ(ParseHeroCommand("attack oRc\r"), ROLE_UNDEFINED);
+}
+
+TEST(CommandParser, ViewIntoABuffer)
+{
+    // the command is not terminated: only the view is read
+    const std::string script = "attack dragonattack orc";
+    EXPECT_EQ(ParseHeroCommand(std::string_view{script}.substr(0, 13)), ROLE_DRAGON);
+    EXPECT_EQ(ParseHeroCommand(std::string_view{script}.substr(13)), ROLE_ORC);
+}
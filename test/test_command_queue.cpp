@@ -0,0 +1,98 @@
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "command_queue.h"
+
+
+TEST(CommandQueue, Capacity)
+{
+    EXPECT_EQ(CommandQueue().Capacity(), COMMAND_QUEUE_CAPACITY);
+    EXPECT_EQ(CommandQueue(1000).Capacity(), 1024U);
+    EXPECT_EQ(CommandQueue(0).Capacity(), 2U);
+}
+
+TEST(CommandQueue, FirstInFirstOut)
+{
+    CommandQueue queue;
+    std::uint64_t ticket{NO_TICKET};
+    for(std::uint32_t i = 0; i < 3; ++i){
+        ASSERT_TRUE(queue.TryPush({COMMAND_ATTACK, i, i + 1}, ticket));
+        EXPECT_EQ(ticket, i);
+    }
+
+    std::vector<GameCommand> batch;
+    EXPECT_EQ(queue.Drain(batch, 10), 3U);
+    ASSERT_EQ(batch.size(), 3U);
+    for(std::uint32_t i = 0; i < 3; ++i){
+        EXPECT_EQ(batch[i].type, COMMAND_ATTACK);
+        EXPECT_EQ(batch[i].attacker, i);
+        EXPECT_EQ(batch[i].target, i + 1);
+    }
+    EXPECT_EQ(queue.Drain(batch, 10), 0U);
+}
+
+TEST(CommandQueue, FullAndWrapAround)
+{
+    CommandQueue queue(4);
+    std::uint64_t ticket{0};
+    std::vector<GameCommand> batch;
+    std::uint32_t sent{0};
+    std::uint32_t received{0};
+
+    // many laps of the ring, drained by halves
+    for(int lap = 0; lap < 10; ++lap){
+        while(queue.TryPush({COMMAND_ATTACK, sent, 0}, ticket)){
+            EXPECT_EQ(ticket, sent);
+            ++sent;
+        }
+        EXPECT_EQ(sent - received, 4U);
+
+        batch.clear();
+        EXPECT_EQ(queue.Drain(batch, 2), 2U);
+        for(const GameCommand& command : batch){
+            EXPECT_EQ(command.attacker, received++);
+        }
+    }
+}
+
+TEST(CommandQueue, ManyProducers)
+{
+    constexpr std::uint32_t PRODUCERS = 4;
+    constexpr std::uint32_t COMMANDS = 20000;
+    CommandQueue queue(64);
+
+    std::vector<std::thread> producers;
+    for(std::uint32_t p = 0; p < PRODUCERS; ++p){
+        producers.emplace_back([&queue, p]() {
+            std::uint64_t ticket{0};
+            for(std::uint32_t i = 0; i < COMMANDS; ++i){
+                while( !queue.TryPush({COMMAND_ATTACK, p, i}, ticket) ){
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // each command exactly once, in the order of its producer
+    std::vector<std::uint32_t> next(PRODUCERS, 0);
+    std::vector<GameCommand> batch;
+    for(std::size_t drained = 0; drained < PRODUCERS * COMMANDS; ){
+        batch.clear();
+        drained += queue.Drain(batch, 64);
+        for(const GameCommand& command : batch){
+            ASSERT_LT(command.attacker, PRODUCERS);
+            EXPECT_EQ(command.target, next[command.attacker]++);
+        }
+        if(batch.empty()){
+            std::this_thread::yield();
+        }
+    }
+    for(auto& producer : producers){
+        producer.join();
+    }
+    for(const std::uint32_t count : next){
+        EXPECT_EQ(count, COMMANDS);
+    }
+}
@@ -0,0 +1,117 @@
+#include <cstddef>
+#include <initializer_list>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "damage_kernel.h"
+#include "fighter.h"
+
+
+/**
+ * @brief Apply one attack with the classes of the game
+ *
+ * Heroes attack through Hero::Attack(), orcs and dragons through
+ * Monster::Attack() and undefined fighters through Fighter::Attack().
+ */
+static void reference_attack(const Fighter& attacker, Fighter& target)
+{
+    switch(attacker.GetRole())
+    {
+        case ROLE_HERO: {
+            Hero hero;
+            hero.SetRole(attacker.GetRole());
+            hero.SetHealth(attacker.GetHealth());
+            hero.Attack(target);
+            break;
+        }
+        case ROLE_ORC:
+        case ROLE_DRAGON: {
+            Monster monster;
+            monster.SetRole(attacker.GetRole());
+            monster.SetHealth(attacker.GetHealth());
+            monster.Attack(target);
+            break;
+        }
+        default:
+            attacker.Attack(target);
+    }
+}
+
+
+TEST(DamageKernel, Detection)
+{
+    EXPECT_TRUE(KernelIsaSupported(ISA_SCALAR));
+    EXPECT_TRUE(KernelIsaSupported(DetectKernelIsa()));
+    EXPECT_STREQ(KernelIsaToString(ISA_AVX2), "AVX2");
+}
+
+TEST(DamageKernel, MatchesMonsterAttack)
+{
+    std::minstd_rand generator{7};
+    std::uniform_int_distribution<int> role{-1, 2};
+    std::uniform_int_distribution<int> health{-1, 8};
+
+    // odd size so that every kernel also runs its scalar tail
+    constexpr std::size_t count{1037};
+    std::vector<int> attacker_roles(count);
+    std::vector<int> attacker_health(count);
+    std::vector<int> target_roles(count);
+    std::vector<int> target_health(count);
+    for(std::size_t i = 0; i < count; ++i){
+        attacker_roles[i] = role(generator);
+        attacker_health[i] = health(generator);
+        target_roles[i] = role(generator);
+        target_health[i] = health(generator);
+    }
+
+    testing::internal::CaptureStdout();
+    std::vector<Fighter> expected(count);
+    std::size_t expected_attacks{0};
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        Fighter attacker;
+        attacker.SetRole(attacker_roles[i]);
+        attacker.SetHealth(attacker_health[i]);
+        expected[i].SetRole(target_roles[i]);
+        expected[i].SetHealth(target_health[i]);
+
+        const int health_before = expected[i].GetHealth();
+        reference_attack(attacker, expected[i]);
+        expected_attacks += expected[i].GetHealth() != health_before ? 1U : 0U;
+    }
+    testing::internal::GetCapturedStdout();
+
+    for(const auto isa : {ISA_SCALAR, ISA_SSE42, ISA_AVX2, ISA_AVX512})
+    {
+        if( !KernelIsaSupported(isa) ){
+            continue;
+        }
+        SCOPED_TRACE(KernelIsaToString(isa));
+
+        auto roles = target_roles;
+        auto health_points = target_health;
+        const auto attacks = ApplyDamageTick(
+            isa, attacker_roles.data(), attacker_health.data(),
+            roles.data(), health_points.data(), count
+        );
+
+        EXPECT_EQ(attacks, expected_attacks);
+        for(std::size_t i = 0; i < count; ++i){
+            ASSERT_EQ(roles[i], expected[i].GetRole()) << "index " << i;
+            ASSERT_EQ(health_points[i], expected[i].GetHealth()) << "index " << i;
+        }
+    }
+}
+
+TEST(DamageKernel, SameArrays)
+{
+    // every fighter attacks itself: never an enemy, nothing changes
+    std::vector<int> roles{0, 1, 2, -1, 0, 1, 2, -1, 0, 1, 2, -1, 0, 1, 2, -1, 0};
+    std::vector<int> health(roles.size(), 5);
+
+    EXPECT_EQ(ApplyDamageTick(roles.data(), health.data(),
+                              roles.data(), health.data(), roles.size()), 0U);
+    for(const int points : health){
+        EXPECT_EQ(points, 5);
+    }
+}
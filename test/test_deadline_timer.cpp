@@ -0,0 +1,98 @@
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "gtest/gtest.h"
+#include "deadline_timer.h"
+#include "event_scheduler.h"
+
+
+// Busy wait, standing for the work done between two deadlines
+static void Work(const std::chrono::microseconds duration)
+{
+    const auto end = std::chrono::steady_clock::now() + duration;
+    while(std::chrono::steady_clock::now() < end){}
+}
+
+
+TEST(DeadlineTimer, SleepUntil)
+{
+    DeadlineTimer timer;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+
+    EXPECT_TRUE(timer.SleepUntil(deadline));
+    EXPECT_GE(std::chrono::steady_clock::now(), deadline);
+
+    const TimingStats stats = timer.Stats();
+    EXPECT_EQ(stats.count, 1U);
+    EXPECT_GE(stats.max_lateness, 0);
+    EXPECT_GE(stats.mean_lateness, 0.0);
+}
+
+TEST(DeadlineTimer, PastDeadline)
+{
+    DeadlineTimer timer{std::chrono::nanoseconds::zero()};
+    const auto deadline = std::chrono::steady_clock::now() - std::chrono::milliseconds(5);
+
+    EXPECT_TRUE(timer.SleepUntil(deadline));
+    EXPECT_EQ(timer.Stats().count, 1U);
+    EXPECT_GE(timer.Stats().max_lateness, 5000000);
+}
+
+TEST(DeadlineTimer, NoDrift)
+{
+    // 100 periods of 2 ms, each doing 500 us of work: relative sleeps of
+    // 2 ms would take 250 ms, absolute deadlines take 200 ms
+    constexpr int PERIODS = 100;
+    constexpr std::chrono::milliseconds PERIOD{2};
+    for(const auto spin : {std::chrono::nanoseconds::zero(),
+                           std::chrono::nanoseconds{DEADLINE_SPIN_DEFAULT}})
+    {
+        DeadlineTimer timer{spin};
+        const auto start = std::chrono::steady_clock::now();
+        for(int i = 1; i <= PERIODS; ++i){
+            Work(std::chrono::microseconds(500));
+            EXPECT_TRUE(timer.SleepUntil(start + i * PERIOD));
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        EXPECT_GE(elapsed, PERIODS * PERIOD);
+        EXPECT_LT(elapsed, PERIODS * PERIOD + std::chrono::milliseconds(40));
+        EXPECT_EQ(timer.Stats().count, static_cast<std::uint64_t>(PERIODS));
+        EXPECT_GE(timer.Stats().jitter, 0.0);
+    }
+}
+
+TEST(DeadlineTimer, InterruptWakesUp)
+{
+    DeadlineTimer timer;
+    std::thread interrupter{[&timer]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        timer.Interrupt();
+    }};
+    const auto start = std::chrono::steady_clock::now();
+    const bool on_time = timer.SleepUntil(start + std::chrono::minutes(1));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    interrupter.join();
+
+    EXPECT_FALSE(on_time);
+    EXPECT_TRUE(timer.Interrupted());
+    EXPECT_LT(elapsed, std::chrono::seconds(10));
+    EXPECT_EQ(timer.Stats().count, 0U);
+
+    // the timer stays interrupted
+    EXPECT_FALSE(timer.SleepUntil(std::chrono::steady_clock::now() + std::chrono::minutes(1)));
+}
+
+TEST(DeadlineTimer, SchedulerTiming)
+{
+    // a hundred times faster than real time: an event every 1 ms
+    EventScheduler scheduler{100.0};
+    scheduler.Schedule(100, 0);
+    const auto processed = scheduler.Run([](const ScheduledEvent& event) {
+        return event.time < 5000 ? 100LL : 0LL;
+    });
+
+    EXPECT_EQ(processed, 50U);
+    EXPECT_EQ(scheduler.Timing().count, 50U);
+    EXPECT_GE(scheduler.Timing().max_lateness, 0);
+}
@@ -0,0 +1,159 @@
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "event_scheduler.h"
+#include "fighter.h"
+
+
+TEST(EventScheduler, DeterministicOrder)
+{
+    EventScheduler scheduler;
+    scheduler.Schedule(20, 1);
+    scheduler.Schedule(10, 2);
+    scheduler.Schedule(10, 0);
+    scheduler.Schedule(20, 1);
+
+    std::vector<std::pair<long long, std::size_t>> order;
+    const auto processed = scheduler.Run([&](const ScheduledEvent& event) {
+        order.emplace_back(event.time, event.actor);
+        return 0LL;
+    });
+
+    const std::vector<std::pair<long long, std::size_t>> expected{
+        {10, 0}, {10, 2}, {20, 1}, {20, 1}
+    };
+    EXPECT_EQ(processed, 4U);
+    EXPECT_EQ(order, expected);
+    EXPECT_EQ(scheduler.Now(), 20);
+    EXPECT_EQ(scheduler.Size(), 0U);
+}
+
+TEST(EventScheduler, RescheduleAndStop)
+{
+    EventScheduler scheduler;
+    scheduler.Schedule(ORC_ATTACK_INTERVAL, 0);
+    scheduler.Schedule(DRAGON_ATTACK_INTERVAL, 1);
+
+    std::size_t processed = scheduler.Run([&](const ScheduledEvent& event) {
+        if(event.time >= 6000){
+            scheduler.Stop();
+        }
+        return static_cast<long long>(
+            event.actor == 0 ? ORC_ATTACK_INTERVAL : DRAGON_ATTACK_INTERVAL
+        );
+    });
+
+    // orc at 1.5, 3, 4.5, 6 s and dragon at 2, 4 s: the orc comes first at 6 s
+    EXPECT_EQ(processed, 6U);
+    EXPECT_TRUE(scheduler.Stopped());
+    EXPECT_EQ(scheduler.Now(), 6000);
+}
+
+TEST(EventScheduler, RestorePending)
+{
+    EventScheduler first;
+    first.Schedule(ORC_ATTACK_INTERVAL, 0);
+    first.Schedule(DRAGON_ATTACK_INTERVAL, 1);
+    const auto reschedule = [](const ScheduledEvent& event) {
+        return static_cast<long long>(
+            event.actor == 0 ? ORC_ATTACK_INTERVAL : DRAGON_ATTACK_INTERVAL
+        );
+    };
+
+    // orc at 1.5 and 3 s, dragon at 2 s: stopped with the dragon at 4 s and
+    // the orc at 4.5 s pending
+    EXPECT_EQ(first.Run(reschedule, 3), 3U);
+    EXPECT_EQ(first.Now(), 3000);
+    ASSERT_EQ(first.Pending().size(), 2U);
+
+    EventScheduler second;
+    second.Restore(first.Now(), first.Pending());
+    EXPECT_EQ(second.Now(), 3000);
+    second.Schedule(4000, 2); // after the restored events scheduled at 4 s
+
+    std::vector<std::pair<long long, std::size_t>> order;
+    second.Run([&](const ScheduledEvent& event) {
+        order.emplace_back(event.time, event.actor);
+        return 0LL;
+    });
+    const std::vector<std::pair<long long, std::size_t>> expected{
+        {4000, 1}, {4000, 2}, {4500, 0}
+    };
+    EXPECT_EQ(order, expected);
+}
+
+TEST(EventScheduler, RealTime)
+{
+    // ten times faster than real time: 200 simulated ms take 20 ms
+    EventScheduler scheduler{10.0};
+    scheduler.Schedule(200, 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    scheduler.Run([](const ScheduledEvent&) { return 0LL; });
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(elapsed, std::chrono::milliseconds(20));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(2000));
+}
+
+TEST(EventScheduler, RestoredClock)
+{
+    // restored at 20 s, ten times faster than real time: the event 200
+    // simulated ms later takes 20 ms, not the 2 s since the start
+    EventScheduler scheduler{10.0};
+    scheduler.Restore(20000, {ScheduledEvent{20200, 0, 0}});
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(scheduler.Run([](const ScheduledEvent&) { return 0LL; }), 1U);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(elapsed, std::chrono::milliseconds(20));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+}
+
+TEST(EventScheduler, StopWakesUp)
+{
+    EventScheduler scheduler{TIME_SCALE_REAL_TIME};
+    scheduler.Schedule(60000, 0); // one minute
+
+    std::thread stopper{[&scheduler]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        scheduler.Stop();
+    }};
+    const auto start = std::chrono::steady_clock::now();
+    const auto processed = scheduler.Run([](const ScheduledEvent&) {
+        return 0LL;
+    });
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    stopper.join();
+
+    EXPECT_EQ(processed, 0U);
+    EXPECT_LT(elapsed, std::chrono::seconds(10));
+}
+
+TEST(EventScheduler, ThousandsOfMonsters)
+{
+    std::vector<Monster> horde;
+    for(int i = 0; i < 5000; ++i){
+        horde.emplace_back(i % 2 == 0 ? ROLE_ORC : ROLE_DRAGON);
+    }
+    std::vector<const Monster*> monsters;
+    for(const auto& monster : horde){
+        monsters.push_back(&monster);
+    }
+
+    auto hero = Hero(ROLE_HERO);
+    hero.SetHealth(1000000);
+    EventScheduler scheduler;
+    const auto attacks = RunMonsterActions(scheduler, hero, monsters);
+
+    // within each 6 s cycle the 2500 orcs hit 4 times and the 2500 dragons
+    // 3 times: 10000 + 22500 damage per cycle, the hero dies in the 31st one
+    EXPECT_FALSE(hero.IsAlive());
+    EXPECT_GT(attacks, 30U * 32500U / 3U);
+    EXPECT_GT(scheduler.Now(), 30 * 6000);
+    EXPECT_LE(scheduler.Now(), 31 * 6000);
+}
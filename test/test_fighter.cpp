@@ -1,7 +1,11 @@
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 #include "gtest/gtest.h"
 #include "fighter.h"
 
@@ -176,11 +180,8 @@ TEST(Fighter, IntToRole)
     EXPECT_EQ(f_1.IntToRole(1),  ROLE_ORC);
     EXPECT_EQ(f_1.IntToRole(2),  ROLE_DRAGON);
 
-    EXPECT_EXIT(
-        f_1.IntToRole(3), 
-        testing::ExitedWithCode(EXIT_FAILURE),
-        "" // I don't care about the actual error message beeing generated
-    );
+    // an id unknown to the role catalog
+    EXPECT_EQ(f_1.IntToRole(3),  ROLE_UNDEFINED);
     testing::internal::GetCapturedStdout();
 }
 
@@ -289,6 +290,121 @@ TEST(Monster, Attack)
 }
 
 
+TEST(Fighter, Damage)
+{
+    EXPECT_EQ(Fighter(ROLE_UNDEFINED).Damage(), 0);
+    EXPECT_EQ(Fighter(ROLE_HERO).Damage(), 2);
+    EXPECT_EQ(Fighter(ROLE_ORC).Damage(), 1);
+    EXPECT_EQ(Fighter(ROLE_DRAGON).Damage(), 3);
+}
+
+TEST(Fighter, Hit)
+{
+    testing::internal::CaptureStdout();
+
+    const auto hero = Hero(ROLE_HERO);
+    const auto dragon = Monster(ROLE_DRAGON);
+    auto orc = Monster(ROLE_ORC);
+    auto hero_twin = Hero(ROLE_HERO);
+
+    EXPECT_TRUE(hero.Hit(orc));
+    EXPECT_EQ(orc.GetHealth(), HEALTH_ORC - 2);
+    EXPECT_FALSE(hero.Hit(hero_twin));
+    EXPECT_TRUE(dragon.Hit(hero_twin));
+    EXPECT_EQ(hero_twin.GetHealth(), HEALTH_HERO - 3);
+
+    orc.SetHealth(1);
+    EXPECT_TRUE(hero.Hit(orc)); // killed fighters are reset
+    EXPECT_EQ(orc.GetRole(), ROLE_UNDEFINED);
+    EXPECT_EQ(orc.GetHealth(), HEALTH_UNDEFINED);
+    EXPECT_FALSE(hero.Hit(orc));
+
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), ""); // silent
+}
+
+
+TEST(Fighter, TakeDamage)
+{
+    auto orc = Orc(ROLE_ORC);
+    int health{0};
+
+    EXPECT_TRUE(orc.TakeDamage(3, health));
+    EXPECT_EQ(health, HEALTH_ORC - 3);
+    EXPECT_TRUE(orc.TakeDamage(5, health));
+    EXPECT_EQ(health, -1);
+    EXPECT_EQ(orc.GetRole(), ROLE_UNDEFINED); // reset by the killing hit
+    EXPECT_FALSE(orc.TakeDamage(1, health));
+}
+
+TEST(Fighter, ConcurrentHit)
+{
+    // many heroes hit the same dragon: every single damage must be counted
+    // and the dragon must die exactly once
+    constexpr int health{100001};
+    constexpr int threads{8};
+    auto dragon = Dragon(ROLE_DRAGON);
+    dragon.SetHealth(health);
+
+    std::atomic<int> hits{0};
+    std::vector<std::thread> heroes;
+    for(int i = 0; i < threads; ++i){
+        heroes.emplace_back([&dragon, &hits]() {
+            const auto hero = Hero(ROLE_HERO);
+            while(hero.Hit(dragon)){
+                hits.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for(auto& hero : heroes){
+        hero.join();
+    }
+
+    EXPECT_EQ(hits.load(), (health + 1) / 2);
+    EXPECT_EQ(dragon.GetRole(), ROLE_UNDEFINED);
+    EXPECT_EQ(dragon.GetHealth(), HEALTH_UNDEFINED);
+}
+
+TEST(Fighter, ConcurrentHitThroughput)
+{
+    // each thread hits its own orc, kept on its own cache line. Without any
+    // global lock the attacks do not serialize: the throughput of each
+    // thread count is recorded in the test report (--gtest_output=xml)
+    struct alignas(CACHE_LINE_SIZE) Target { Orc orc{ROLE_ORC}; };
+    constexpr int hits_per_thread{200000};
+
+    for(const int threads : {1, 2, 4, 8})
+    {
+        std::vector<Target> targets(static_cast<std::size_t>(threads));
+        std::vector<std::thread> heroes;
+
+        const auto start = std::chrono::steady_clock::now();
+        for(auto& target : targets){
+            heroes.emplace_back([&target]() {
+                const auto hero = Hero(ROLE_HERO);
+                for(int i = 0; i < hits_per_thread; ++i){
+                    target.orc.SetHealth(HEALTH_ORC);
+                    EXPECT_TRUE(hero.Hit(target.orc));
+                }
+            });
+        }
+        for(auto& hero : heroes){
+            hero.join();
+        }
+        const std::chrono::duration<double> elapsed{
+            std::chrono::steady_clock::now() - start
+        };
+
+        const auto hits_per_second = static_cast<double>(threads) * 
+                                     hits_per_thread / elapsed.count();
+        testing::Test::RecordProperty(
+            "hits_per_second_" + std::to_string(threads) + "_threads",
+            std::to_string(static_cast<long long>(hits_per_second))
+        );
+        EXPECT_EQ(targets.front().orc.GetHealth(), HEALTH_ORC - 2);
+    }
+}
+
+
 
 int main(int argc, char **argv)
 {
@@ -0,0 +1,156 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+#include "fighter.h"
+#include "fighter_batch.h"
+
+
+/**
+ * @brief Create random fighters, including dead and undefined ones
+ */
+static std::vector<Fighter> random_fighters(std::size_t count, unsigned seed)
+{
+    std::minstd_rand generator{seed};
+    std::uniform_int_distribution<int> role{-1, 2};
+    std::uniform_int_distribution<int> health{-1, 45};
+
+    std::vector<Fighter> fighters;
+    fighters.reserve(count);
+    for(std::size_t i = 0; i < count; ++i){
+        fighters.emplace_back( Fighter::IntToRole(role(generator)) );
+        fighters.back().SetHealth( health(generator) );
+    }
+    return fighters;
+}
+
+static FighterBatch to_batch(const std::vector<Fighter>& fighters)
+{
+    FighterBatch batch;
+    batch.Reserve(fighters.size());
+    for(const auto& fighter : fighters){
+        batch.Add(fighter);
+    }
+    return batch;
+}
+
+
+TEST(FighterBatch, ConstructorFromRole)
+{
+    const FighterBatch batch(3, ROLE_DRAGON);
+
+    EXPECT_EQ(batch.Size(), 3U);
+    EXPECT_EQ(batch.GetRole(2), ROLE_DRAGON);
+    EXPECT_EQ(batch.GetHealth(2), HEALTH_DRAGON);
+    EXPECT_EQ(batch.CountAlive(), 3U);
+}
+
+TEST(FighterBatch, AddAndGet)
+{
+    FighterBatch batch;
+    EXPECT_EQ(batch.Add(ROLE_HERO), 0U);
+    EXPECT_EQ(batch.Add(Fighter(ROLE_ORC)), 1U);
+
+    const auto orc = batch.Get(1);
+    EXPECT_EQ(orc.GetRole(), ROLE_ORC);
+    EXPECT_EQ(orc.GetHealth(), HEALTH_ORC);
+
+    batch.Clear();
+    EXPECT_EQ(batch.Size(), 0U);
+}
+
+TEST(FighterBatch, IsAliveAndCanAttack)
+{
+    const auto attackers = random_fighters(1000, 1);
+    const auto targets = random_fighters(900, 2);
+    const auto batch = to_batch(attackers);
+    const auto target_batch = to_batch(targets);
+
+    std::vector<std::uint8_t> alive;
+    std::vector<std::uint8_t> allowed;
+    const auto alive_count = batch.IsAlive(alive);
+    const auto attack_count = batch.CanAttack(target_batch, allowed);
+
+    ASSERT_EQ(alive.size(), attackers.size());
+    ASSERT_EQ(allowed.size(), targets.size());
+    EXPECT_EQ(alive_count, batch.CountAlive());
+
+    std::size_t expected_attacks{0};
+    for(std::size_t i = 0; i < attackers.size(); ++i){
+        EXPECT_EQ(alive[i] != 0, attackers[i].IsAlive());
+    }
+    for(std::size_t i = 0; i < targets.size(); ++i){
+        EXPECT_EQ(allowed[i] != 0, attackers[i].CanAttack(targets[i]));
+        expected_attacks += attackers[i].CanAttack(targets[i]) ? 1U : 0U;
+    }
+    EXPECT_EQ(attack_count, expected_attacks);
+}
+
+TEST(FighterBatch, AttackAllMatchesFighter)
+{
+    const auto attackers = random_fighters(5000, 3);
+    auto targets = random_fighters(5000, 4);
+    const auto batch = to_batch(attackers);
+    auto target_batch = to_batch(targets);
+
+    // several ticks, so that fighters die and are reset
+    for(int tick = 0; tick < 10; ++tick)
+    {
+        std::size_t expected_attacks{0};
+        for(std::size_t i = 0; i < targets.size(); ++i){
+            expected_attacks += attackers[i].Hit(targets[i]) ? 1U : 0U;
+        }
+        EXPECT_EQ(batch.AttackAll(target_batch), expected_attacks);
+    }
+
+    for(std::size_t i = 0; i < targets.size(); ++i){
+        EXPECT_EQ(target_batch.GetRole(i), targets[i].GetRole());
+        EXPECT_EQ(target_batch.GetHealth(i), targets[i].GetHealth());
+    }
+}
+
+TEST(FighterBatch, RunTicks)
+{
+    const auto attackers = random_fighters(2000, 5);
+    const auto batch = to_batch(attackers);
+    auto ticked = to_batch(random_fighters(2000, 6));
+    auto target_batch = to_batch(random_fighters(2000, 6));
+
+    std::size_t expected_attacks{0};
+    for(int tick = 0; tick < 7; ++tick){
+        expected_attacks += batch.AttackAll(target_batch);
+    }
+    EXPECT_EQ(batch.RunTicks(ticked, 7), expected_attacks);
+    for(std::size_t i = 0; i < ticked.Size(); ++i){
+        EXPECT_EQ(ticked.GetHealth(i), target_batch.GetHealth(i));
+    }
+
+    // stops on the first tick without attack
+    const FighterBatch heroes(3, ROLE_HERO);
+    FighterBatch orcs(3, ROLE_ORC);
+    EXPECT_EQ(heroes.RunTicks(orcs, 100), 12U); // 4 hits kill an orc
+    EXPECT_EQ(orcs.CountAlive(), 0U);
+}
+
+TEST(FighterBatch, AttackedBy)
+{
+    FighterBatch batch(4, ROLE_ORC);
+    batch.Add(ROLE_HERO);
+    const auto hero = Hero(ROLE_HERO);
+
+    EXPECT_EQ(batch.AttackedBy(hero), 4U);
+    EXPECT_EQ(batch.GetHealth(0), HEALTH_ORC - 2);
+    EXPECT_EQ(batch.GetHealth(4), HEALTH_HERO);
+
+    for(int i = 0; i < 3; ++i){
+        batch.AttackedBy(hero);
+    }
+    EXPECT_EQ(batch.CountAlive(), 1U); // only the hero remains
+    EXPECT_EQ(batch.GetRole(0), ROLE_UNDEFINED);
+    EXPECT_EQ(batch.GetHealth(0), HEALTH_UNDEFINED);
+
+    auto dead_hero = Hero(ROLE_HERO);
+    dead_hero.SetHealth(HEALTH_DEAD);
+    EXPECT_EQ(FighterBatch(2, ROLE_DRAGON).AttackedBy(dead_hero), 0U);
+}
@@ -0,0 +1,476 @@
+#include <memory>
+#include <string>
+#include <utility>
+#include <variant>
+#include "gtest/gtest.h"
+#include "fighter.h"
+#include "metrics.h"
+#include "role_catalog.h"
+#include "static_fighter.h"
+
+/*
+ * The cases of test_fighter.cpp, run against both the virtual fighters
+ * (Fighter, Hero, Orc, Dragon) and the static ones (AnyFighter). The
+ * concurrent hits stay in test_fighter.cpp: a StaticFighter must not be
+ * attacked by several threads at once.
+ *
+ * A static fighter has no role of its own, the alternative of the variant
+ * is its role: SetRole() is a new fighter of the role keeping the health
+ * points, and IsEnemy() the rule of the built-in roles.
+ */
+
+struct VirtualFighters {
+    using Type = std::unique_ptr<Fighter>;
+
+    static Type Make(){ return std::make_unique<Fighter>(); }
+    static Type Make(const ROLE_t role){
+        switch(role)
+        {
+            case ROLE_HERO:   return std::make_unique<Hero>(role);
+            case ROLE_ORC:    return std::make_unique<Orc>(role);
+            case ROLE_DRAGON: return std::make_unique<Dragon>(role);
+            default:          return std::make_unique<Fighter>(role);
+        }
+    }
+    static Type Copy(const Type& fighter){ return std::make_unique<Fighter>(*fighter); }
+    static Type Move(Type& fighter){
+        return std::make_unique<Fighter>(std::move(*fighter));
+    }
+    static void CopyAssign(Type& fighter, const Type& other){ *fighter = *other; }
+    static void MoveAssign(Type& fighter, Type& other){ *fighter = std::move(*other); }
+
+    static ROLE_t Role(const Type& fighter){ return fighter->GetRole(); }
+    static int Health(const Type& fighter){ return fighter->GetHealth(); }
+    static void SetRole(Type& fighter, const int role){ fighter->SetRole(role); }
+    static void SetHealth(Type& fighter, const int health){
+        fighter->SetHealth(health);
+    }
+    static bool IsAlive(const Type& fighter){ return fighter->IsAlive(); }
+    static bool IsEnemy(const Type& fighter, const Type& other){
+        return fighter->IsEnemy(*other);
+    }
+    static bool CanAttack(const Type& fighter, const Type& other){
+        return fighter->CanAttack(*other);
+    }
+    static void Reset(Type& fighter){ fighter->Reset(); }
+    static const char* RoleToString(const Type& fighter){
+        return fighter->RoleToString();
+    }
+    static int Damage(const Type& fighter){ return fighter->Damage(); }
+    static bool TakeDamage(Type& fighter, const int damage, int& health_after){
+        return fighter->TakeDamage(damage, health_after);
+    }
+    static void Attack(const Type& attacker, Type& target){
+        attacker->Attack(*target);
+    }
+    static bool Hit(const Type& attacker, Type& target){
+        return attacker->Hit(*target);
+    }
+    static void Print(const Type& fighter){ fighter->Print(); }
+};
+
+struct StaticFighters {
+    using Type = AnyFighter;
+
+    static Type Make(){ return Type{}; }
+    static Type Make(const ROLE_t role){ return MakeFighter(role); }
+    static Type Copy(const Type& fighter){ return fighter; }
+    static Type Move(Type& fighter){ return std::move(fighter); }
+    static void CopyAssign(Type& fighter, const Type& other){ fighter = other; }
+    static void MoveAssign(Type& fighter, Type& other){ fighter = std::move(other); }
+
+    static ROLE_t Role(const Type& fighter){ return GetRole(fighter); }
+    static int Health(const Type& fighter){ return GetHealth(fighter); }
+    static void SetRole(Type& fighter, const int role){
+        const int health = GetHealth(fighter);
+        fighter = MakeFighter( Fighter::IntToRole(role) );
+        SetHealth(fighter, health);
+    }
+    static void SetHealth(Type& fighter, const int health){
+        std::visit([health](auto& self) { self.SetHealth(health); }, fighter);
+    }
+    static bool IsAlive(const Type& fighter){
+        return std::visit([](const auto& self) { return self.IsAlive(); }, fighter);
+    }
+    static bool IsEnemy(const Type& fighter, const Type& other){
+        return Fighter::RolesAreEnemies(GetRole(fighter), GetRole(other));
+    }
+    static bool CanAttack(const Type& fighter, const Type& other){
+        return std::visit([](const auto& self, const auto& target) {
+            return self.CanAttack(target);
+        }, fighter, other);
+    }
+    static void Reset(Type& fighter){ SetHealth(fighter, HEALTH_UNDEFINED); }
+    static const char* RoleToString(const Type& fighter){
+        return RoleCatalog::Instance().Name( GetRole(fighter) );
+    }
+    static int Damage(const Type& fighter){
+        return std::visit([](const auto& self) { return self.Damage(); }, fighter);
+    }
+    static bool TakeDamage(Type& fighter, const int damage, int& health_after){
+        return std::visit([damage, &health_after](auto& self) {
+            return self.TakeDamage(damage, health_after);
+        }, fighter);
+    }
+    static void Attack(const Type& attacker, Type& target){
+        ::Attack(attacker, target);
+    }
+    static bool Hit(const Type& attacker, Type& target){
+        return ::Hit(attacker, target);
+    }
+    static void Print(const Type& fighter){ ::Print(fighter); }
+};
+
+template<typename Implementation>
+class FighterDispatch : public testing::Test {};
+
+using Implementations = testing::Types<VirtualFighters, StaticFighters>;
+TYPED_TEST_SUITE(FighterDispatch, Implementations, );
+
+
+TYPED_TEST(FighterDispatch, DefaultConstructor)
+{
+    const auto f11 = TypeParam::Make();
+
+    EXPECT_EQ(TypeParam::Role(f11), ROLE_UNDEFINED);
+    EXPECT_EQ(TypeParam::Health(f11), HEALTH_UNDEFINED);
+}
+
+TYPED_TEST(FighterDispatch, ConstructorFromRole)
+{
+    const auto f_un = TypeParam::Make(ROLE_UNDEFINED);
+    const auto f_h = TypeParam::Make(ROLE_HERO);
+    const auto f_o = TypeParam::Make(ROLE_ORC);
+    const auto f_d = TypeParam::Make(ROLE_DRAGON);
+
+    EXPECT_EQ(TypeParam::Role(f_un), ROLE_UNDEFINED);
+    EXPECT_EQ(TypeParam::Health(f_un), HEALTH_UNDEFINED);
+    EXPECT_EQ(TypeParam::Role(f_h), ROLE_HERO);
+    EXPECT_EQ(TypeParam::Health(f_h), HEALTH_HERO);
+    EXPECT_EQ(TypeParam::Role(f_o), ROLE_ORC);
+    EXPECT_EQ(TypeParam::Health(f_o), HEALTH_ORC);
+    EXPECT_EQ(TypeParam::Role(f_d), ROLE_DRAGON);
+    EXPECT_EQ(TypeParam::Health(f_d), HEALTH_DRAGON);
+}
+
+TYPED_TEST(FighterDispatch, CopyConstructor)
+{
+    auto f11 = TypeParam::Make(ROLE_HERO);
+    TypeParam::SetHealth(f11, 7);
+    const auto f_copy = TypeParam::Copy(f11);
+
+    EXPECT_EQ(TypeParam::Role(f_copy), ROLE_HERO);
+    EXPECT_EQ(TypeParam::Health(f_copy), 7);
+
+    TypeParam::SetHealth(f11, 3); // not shared
+    EXPECT_EQ(TypeParam::Health(f_copy), 7);
+}
+
+TYPED_TEST(FighterDispatch, MoveConstructor)
+{
+    auto f00 = TypeParam::Make(ROLE_HERO);
+    const auto f_move = TypeParam::Move(f00);
+
+    EXPECT_EQ(TypeParam::Role(f_move), ROLE_HERO);
+    EXPECT_EQ(TypeParam::Health(f_move), HEALTH_HERO);
+}
+
+TYPED_TEST(FighterDispatch, CopyAssignmentOperator)
+{
+    const auto f11 = TypeParam::Make(ROLE_ORC);
+    auto f_copy = TypeParam::Make();
+    TypeParam::CopyAssign(f_copy, f11);
+
+    EXPECT_EQ(TypeParam::Role(f_copy), ROLE_ORC);
+    EXPECT_EQ(TypeParam::Health(f_copy), HEALTH_ORC);
+    EXPECT_EQ(TypeParam::Role(f11), ROLE_ORC);
+}
+
+TYPED_TEST(FighterDispatch, MoveAssignmentOperator)
+{
+    auto f00 = TypeParam::Make(ROLE_DRAGON);
+    auto f_move = TypeParam::Make();
+    TypeParam::MoveAssign(f_move, f00);
+
+    EXPECT_EQ(TypeParam::Role(f_move), ROLE_DRAGON);
+    EXPECT_EQ(TypeParam::Health(f_move), HEALTH_DRAGON);
+}
+
+TYPED_TEST(FighterDispatch, SetterMethods)
+{
+    auto f11 = TypeParam::Make(); //undefined role and health points
+
+    TypeParam::SetRole(f11, ROLE_DRAGON);
+    TypeParam::SetHealth(f11, HEALTH_DEAD);
+    EXPECT_EQ(TypeParam::Role(f11), ROLE_DRAGON);
+    EXPECT_EQ(TypeParam::Health(f11), HEALTH_DEAD);
+
+    TypeParam::SetRole(f11, ROLE_ORC);
+    TypeParam::SetHealth(f11, HEALTH_ORC);
+    EXPECT_EQ(TypeParam::Role(f11), ROLE_ORC);
+    EXPECT_EQ(TypeParam::Health(f11), HEALTH_ORC);
+
+    TypeParam::SetRole(f11, -2);
+    EXPECT_EQ(TypeParam::Role(f11), ROLE_UNDEFINED);
+    EXPECT_EQ(TypeParam::Health(f11), HEALTH_ORC);
+
+    TypeParam::SetRole(f11, 2);
+    EXPECT_EQ(TypeParam::Role(f11), ROLE_DRAGON);
+    EXPECT_EQ(TypeParam::Health(f11), HEALTH_ORC);
+}
+
+TYPED_TEST(FighterDispatch, IsAlive)
+{
+    auto f11 = TypeParam::Make(ROLE_HERO);
+    const auto f22 = TypeParam::Make(); //undefined
+
+    EXPECT_TRUE(TypeParam::IsAlive(f11));
+    EXPECT_FALSE(TypeParam::IsAlive(f22));
+
+    TypeParam::SetHealth(f11, HEALTH_DEAD);
+    EXPECT_FALSE(TypeParam::IsAlive(f11));
+}
+
+TYPED_TEST(FighterDispatch, IsEnemy)
+{
+    const auto f11 = TypeParam::Make(ROLE_HERO);
+    const auto ff1 = TypeParam::Make(ROLE_HERO);
+    const auto f12 = TypeParam::Make(ROLE_ORC);
+    const auto f22 = TypeParam::Make(ROLE_DRAGON);
+    const auto fu1 = TypeParam::Make(); //undefined
+
+    EXPECT_FALSE(TypeParam::IsEnemy(f11, ff1));
+    EXPECT_FALSE(TypeParam::IsEnemy(f11, fu1));
+    EXPECT_TRUE(TypeParam::IsEnemy(f11, f12));
+    EXPECT_TRUE(TypeParam::IsEnemy(f11, f22));
+    EXPECT_TRUE(TypeParam::IsEnemy(f12, f11));
+    EXPECT_FALSE(TypeParam::IsEnemy(f12, fu1));
+    EXPECT_FALSE(TypeParam::IsEnemy(f22, fu1));
+    EXPECT_FALSE(TypeParam::IsEnemy(f12, f22));
+}
+
+TYPED_TEST(FighterDispatch, CanAttack)
+{
+    const auto f_1 = TypeParam::Make(ROLE_HERO);
+    const auto ff_1 = TypeParam::Make(ROLE_HERO);
+    auto f1_1 = TypeParam::Make(ROLE_ORC);
+    const auto f2_1 = TypeParam::Make(ROLE_DRAGON);
+    const auto fu_1 = TypeParam::Make(); //undefined
+
+    EXPECT_FALSE(TypeParam::CanAttack(f_1, ff_1));
+    EXPECT_FALSE(TypeParam::CanAttack(f_1, fu_1));
+    EXPECT_TRUE(TypeParam::CanAttack(f_1, f1_1));
+    EXPECT_TRUE(TypeParam::CanAttack(f_1, f2_1));
+    EXPECT_FALSE(TypeParam::CanAttack(f1_1, fu_1));
+    EXPECT_FALSE(TypeParam::CanAttack(f2_1, fu_1));
+    EXPECT_FALSE(TypeParam::CanAttack(f1_1, f2_1));
+
+    TypeParam::SetHealth(f1_1, HEALTH_DEAD); // dead fighters neither
+    EXPECT_FALSE(TypeParam::CanAttack(f_1, f1_1));
+    EXPECT_FALSE(TypeParam::CanAttack(f1_1, f_1));
+}
+
+TYPED_TEST(FighterDispatch, Reset)
+{
+    auto f_1 = TypeParam::Make(ROLE_HERO);
+    TypeParam::Reset(f_1);
+
+    EXPECT_EQ(TypeParam::Health(f_1), HEALTH_UNDEFINED);
+    EXPECT_EQ(TypeParam::Role(f_1), ROLE_UNDEFINED);
+}
+
+TYPED_TEST(FighterDispatch, RoleToString)
+{
+    EXPECT_STREQ(TypeParam::RoleToString(TypeParam::Make(ROLE_UNDEFINED)), "Undefined");
+    EXPECT_STREQ(TypeParam::RoleToString(TypeParam::Make(ROLE_HERO)), "Hero");
+    EXPECT_STREQ(TypeParam::RoleToString(TypeParam::Make(ROLE_ORC)), "Orc");
+    EXPECT_STREQ(TypeParam::RoleToString(TypeParam::Make(ROLE_DRAGON)), "Dragon");
+}
+
+TYPED_TEST(FighterDispatch, IntToRole)
+{
+    testing::internal::CaptureStdout();
+    auto f_1 = TypeParam::Make();
+
+    const ROLE_t expected[] = {ROLE_UNDEFINED, ROLE_UNDEFINED, ROLE_HERO, ROLE_ORC,
+                               ROLE_DRAGON, ROLE_UNDEFINED};
+    // the last id is unknown to the role catalog
+    for(int id = -2; id <= 3; ++id){
+        TypeParam::SetRole(f_1, id);
+        TypeParam::SetHealth(f_1, 1);
+        EXPECT_EQ(TypeParam::Role(f_1), expected[id + 2]) << "id " << id; // NOLINT
+    }
+    testing::internal::GetCapturedStdout();
+}
+
+TYPED_TEST(FighterDispatch, Print)
+{
+    auto hero = TypeParam::Make(ROLE_HERO);
+    TypeParam::SetHealth(hero, HEALTH_DEAD);
+
+    testing::internal::CaptureStdout();
+    TypeParam::Print(hero);
+    auto out = testing::internal::GetCapturedStdout();
+    std::string expected{"Fighter information:\n\tRole: 'Hero'\n\t"};
+    expected += "Remaining health: 0\033[31m  -->  Fighter death!!!\033[0m\n";
+    EXPECT_EQ(out, expected);
+
+    testing::internal::CaptureStdout();
+    TypeParam::Print( TypeParam::Make(ROLE_UNDEFINED) );
+    out = testing::internal::GetCapturedStdout();
+    expected = "Fighter information:\n\tRole: 'Undefined'\n\t";
+    expected += "Remaining health: -1";
+    expected += "\033[31m  -->  Fighter not initialized\033[0m\n";
+    EXPECT_EQ(out, expected);
+}
+
+TYPED_TEST(FighterDispatch, Attack)
+{
+    testing::internal::CaptureStdout();
+
+    const auto fh_1 = TypeParam::Make(ROLE_HERO);
+    auto fo_1 = TypeParam::Make(ROLE_ORC);
+    auto fu_1 = TypeParam::Make();
+
+    TypeParam::Attack(fh_1, fo_1);
+    TypeParam::Attack(fh_1, fu_1); // can not occur: no output
+    TypeParam::Attack(fo_1, fu_1);
+
+    EXPECT_EQ(testing::internal::GetCapturedStdout(),
+              "\033[32mHero hits Orc. Orc health is 5\n\033[0m");
+}
+
+TYPED_TEST(FighterDispatch, HeroAttack)
+{
+    testing::internal::CaptureStdout();
+
+    auto h1_1 = TypeParam::Make(ROLE_HERO);
+    auto h2_1 = TypeParam::Make(ROLE_HERO);
+    auto orc = TypeParam::Make(ROLE_ORC);
+    auto dragon = TypeParam::Make(ROLE_DRAGON);
+
+    TypeParam::Attack(h1_1, orc);
+    TypeParam::Attack(h1_1, dragon);
+    TypeParam::Attack(h1_1, h2_1);
+
+    EXPECT_EQ(TypeParam::Health(orc), HEALTH_ORC - 2);
+    EXPECT_EQ(TypeParam::Health(dragon), HEALTH_DRAGON - 2);
+    EXPECT_EQ(TypeParam::Health(h2_1), HEALTH_HERO); // no attack
+
+    TypeParam::SetHealth(h1_1, HEALTH_DEAD);
+    TypeParam::Attack(h1_1, orc);
+    EXPECT_EQ(TypeParam::Health(orc), HEALTH_ORC - 2); // dead fighter can't attack
+
+    EXPECT_EQ(testing::internal::GetCapturedStdout(),
+              "\033[32mHero hits Orc. Orc health is 5\n\033[0m"
+              "\033[32mHero hits Dragon. Dragon health is 18\n\033[0m");
+}
+
+TYPED_TEST(FighterDispatch, MonsterAttack)
+{
+    testing::internal::CaptureStdout();
+
+    auto h_1 = TypeParam::Make(ROLE_HERO);
+    auto orc = TypeParam::Make(ROLE_ORC);
+    auto dragon = TypeParam::Make(ROLE_DRAGON);
+
+    TypeParam::Attack(orc, dragon);
+    TypeParam::Attack(dragon, orc);
+    EXPECT_EQ(TypeParam::Health(orc), static_cast<int>(HEALTH_ORC)); // no attack
+    EXPECT_EQ(TypeParam::Health(dragon), static_cast<int>(HEALTH_DRAGON));
+
+    TypeParam::Attack(orc, h_1);
+    EXPECT_EQ(TypeParam::Health(h_1), HEALTH_HERO - 1);
+    TypeParam::Attack(dragon, h_1);
+    EXPECT_EQ(TypeParam::Health(h_1), HEALTH_HERO - 4);
+
+    TypeParam::SetHealth(orc, HEALTH_DEAD);
+    TypeParam::SetHealth(dragon, HEALTH_DEAD);
+    TypeParam::Attack(orc, h_1);
+    TypeParam::Attack(dragon, h_1);
+    EXPECT_EQ(TypeParam::Health(h_1), HEALTH_HERO - 4); // dead fighter can't attack
+
+    testing::internal::GetCapturedStdout();
+}
+
+TYPED_TEST(FighterDispatch, Damage)
+{
+    EXPECT_EQ(TypeParam::Damage(TypeParam::Make(ROLE_UNDEFINED)), 0);
+    EXPECT_EQ(TypeParam::Damage(TypeParam::Make(ROLE_HERO)), 2);
+    EXPECT_EQ(TypeParam::Damage(TypeParam::Make(ROLE_ORC)), 1);
+    EXPECT_EQ(TypeParam::Damage(TypeParam::Make(ROLE_DRAGON)), 3);
+}
+
+TYPED_TEST(FighterDispatch, Hit)
+{
+    testing::internal::CaptureStdout();
+
+    const auto hero = TypeParam::Make(ROLE_HERO);
+    const auto dragon = TypeParam::Make(ROLE_DRAGON);
+    auto orc = TypeParam::Make(ROLE_ORC);
+    auto hero_twin = TypeParam::Make(ROLE_HERO);
+
+    EXPECT_TRUE(TypeParam::Hit(hero, orc));
+    EXPECT_EQ(TypeParam::Health(orc), HEALTH_ORC - 2);
+    EXPECT_FALSE(TypeParam::Hit(hero, hero_twin));
+    EXPECT_TRUE(TypeParam::Hit(dragon, hero_twin));
+    EXPECT_EQ(TypeParam::Health(hero_twin), HEALTH_HERO - 3);
+
+    TypeParam::SetHealth(orc, 1);
+    EXPECT_TRUE(TypeParam::Hit(hero, orc)); // killed fighters are reset
+    EXPECT_EQ(TypeParam::Role(orc), ROLE_UNDEFINED);
+    EXPECT_EQ(TypeParam::Health(orc), HEALTH_UNDEFINED);
+    EXPECT_FALSE(TypeParam::Hit(hero, orc));
+
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), ""); // silent
+}
+
+TYPED_TEST(FighterDispatch, CountsRareOutcomes)
+{
+    testing::internal::CaptureStdout();
+    const auto& metrics = Metrics::Instance();
+    const auto kills = metrics.Counter(COUNTER_KILLS, ROLE_HERO);
+    const auto rejected = metrics.Counter(COUNTER_REJECTED, ROLE_HERO);
+
+    const auto hero = TypeParam::Make(ROLE_HERO);
+    auto hero_twin = TypeParam::Make(ROLE_HERO);
+    auto orc = TypeParam::Make(ROLE_ORC);
+    TypeParam::SetHealth(orc, 2);
+
+    EXPECT_FALSE(TypeParam::Hit(hero, hero_twin));
+    TypeParam::Attack(hero, hero_twin);
+    EXPECT_TRUE(TypeParam::Hit(hero, orc));
+
+    EXPECT_EQ(metrics.Counter(COUNTER_REJECTED, ROLE_HERO), rejected + 2);
+    EXPECT_EQ(metrics.Counter(COUNTER_KILLS, ROLE_HERO), kills + 1);
+    testing::internal::GetCapturedStdout();
+}
+
+TYPED_TEST(FighterDispatch, TakeDamage)
+{
+    auto orc = TypeParam::Make(ROLE_ORC);
+    int health{0};
+
+    EXPECT_TRUE(TypeParam::TakeDamage(orc, 3, health));
+    EXPECT_EQ(health, HEALTH_ORC - 3);
+    EXPECT_TRUE(TypeParam::TakeDamage(orc, 5, health));
+    EXPECT_EQ(health, -1);
+    EXPECT_EQ(TypeParam::Role(orc), ROLE_UNDEFINED); // reset by the killing hit
+    EXPECT_FALSE(TypeParam::TakeDamage(orc, 1, health));
+}
+
+
+TEST(StaticFighter, CompileTimeRules)
+{
+    static_assert(sizeof(StaticOrc) == sizeof(int), "no vptr");
+    static_assert(StaticDragon::Damage() == 3);
+    static_assert( !StaticOrc{}.CanAttack(StaticDragon{}) );
+    static_assert( StaticHero{}.CanAttack(StaticDragon{}) );
+
+    constexpr auto health = []() {
+        StaticOrc orc;
+        StaticHero{}.Hit(orc);
+        return orc.GetHealth();
+    }();
+    EXPECT_EQ(health, HEALTH_ORC - 2);
+}
@@ -0,0 +1,79 @@
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "fighter.h"
+#include "fighter_pool.h"
+
+
+TEST(FighterPool, Spawn)
+{
+    FighterPool pool;
+    Fighter* hero = pool.Spawn(ROLE_HERO);
+    Fighter* orc = pool.Spawn(ROLE_ORC);
+    Fighter* dragon = pool.Spawn(ROLE_DRAGON);
+    Fighter* other = pool.Spawn(ROLE_UNDEFINED);
+
+    EXPECT_NE(dynamic_cast<Hero*>(hero), nullptr);
+    EXPECT_NE(dynamic_cast<Orc*>(orc), nullptr);
+    EXPECT_NE(dynamic_cast<Dragon*>(dragon), nullptr);
+    EXPECT_EQ(dynamic_cast<Monster*>(other), nullptr);
+    EXPECT_EQ(hero->GetHealth(), HEALTH_HERO);
+    EXPECT_EQ(orc->GetHealth(), HEALTH_ORC);
+    EXPECT_EQ(dragon->GetHealth(), HEALTH_DRAGON);
+    EXPECT_EQ(other->GetRole(), ROLE_UNDEFINED);
+    EXPECT_EQ(pool.Live(), 4U);
+
+    // the virtual dispatch works as for heap allocated fighters
+    EXPECT_TRUE(hero->Hit(*orc));
+    EXPECT_EQ(orc->GetHealth(), HEALTH_ORC - 2);
+}
+
+TEST(FighterPool, DespawnRecyclesSlots)
+{
+    FighterPool pool{4};
+    Fighter* orc = pool.Spawn(ROLE_ORC);
+    static_cast<void>(pool.Spawn(ROLE_HERO));
+    pool.Despawn(orc);
+    EXPECT_EQ(pool.Live(), 1U);
+
+    // the freed slot is reused, whatever the class of the new fighter
+    Fighter* dragon = pool.Spawn(ROLE_DRAGON);
+    EXPECT_EQ(static_cast<void*>(dragon), static_cast<void*>(orc));
+    EXPECT_EQ(dragon->GetRole(), ROLE_DRAGON);
+    EXPECT_EQ(pool.Capacity(), 4U);
+}
+
+TEST(FighterPool, ReleaseKeepsChunks)
+{
+    FighterPool pool{16};
+    std::vector<Fighter*> first_wave;
+    for(std::size_t i = 0; i < 40; ++i){
+        first_wave.push_back(pool.Spawn(i % 2 == 0 ? ROLE_ORC : ROLE_DRAGON));
+    }
+    EXPECT_EQ(pool.Capacity(), 48U);
+
+    pool.Release();
+    EXPECT_EQ(pool.Live(), 0U);
+
+    // the next wave takes the same slots, in the same order
+    for(std::size_t i = 0; i < 40; ++i){
+        EXPECT_EQ(pool.Spawn(ROLE_HERO), first_wave[i]);
+    }
+    EXPECT_EQ(pool.Capacity(), 48U);
+}
+
+TEST(FighterPool, ThreadLocal)
+{
+    FighterPool* main_pool = &FighterPool::ThreadLocal();
+    FighterPool* other_pool{nullptr};
+    std::thread thread{[&other_pool]() {
+        other_pool = &FighterPool::ThreadLocal();
+        Fighter* orc = other_pool->Spawn(ROLE_ORC);
+        other_pool->Despawn(orc);
+    }};
+    thread.join();
+
+    EXPECT_NE(main_pool, other_pool);
+    EXPECT_EQ(main_pool, &FighterPool::ThreadLocal());
+}
@@ -0,0 +1,115 @@
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "alive_index.h"
+#include "fighter.h"
+#include "game_loop.h"
+
+
+// The fighters of the game, in their slots 0, 1 and 2
+struct Battle {
+    Hero hero{ROLE_HERO};
+    Orc orc{ROLE_ORC};
+    Dragon dragon{ROLE_DRAGON};
+    AliveIndex alive;
+
+    Battle() {
+        alive.Add(hero);
+        alive.Add(orc);
+        alive.Add(dragon);
+    }
+};
+
+constexpr std::uint32_t HERO{0};
+constexpr std::uint32_t ORC{1};
+constexpr std::uint32_t DRAGON{2};
+
+
+TEST(GameLoop, TickAppliesCommands)
+{
+    Battle battle;
+    GameLoop game{battle.alive};
+
+    for(int i = 0; i < 4; ++i){
+        EXPECT_EQ(game.Submit({COMMAND_ATTACK, HERO, ORC}), static_cast<std::uint64_t>(i));
+    }
+    game.Submit({COMMAND_ATTACK, ORC, DRAGON}); // not enemies
+    game.Submit({COMMAND_ATTACK, HERO, 7});     // no such fighter
+    game.Submit({COMMAND_NONE, DRAGON, HERO});
+    EXPECT_EQ(battle.orc.GetHealth(), HEALTH_ORC);
+
+    EXPECT_EQ(game.Tick(), 7U);
+    EXPECT_EQ(game.Applied(), 7U);
+    EXPECT_EQ(game.Attacks(), 4U);
+    EXPECT_FALSE(battle.orc.IsAlive()); // HEALTH_ORC = 7
+    EXPECT_EQ(battle.dragon.GetHealth(), HEALTH_DRAGON);
+    EXPECT_EQ(battle.hero.GetHealth(), HEALTH_HERO);
+    EXPECT_EQ(game.Tick(), 0U);
+}
+
+TEST(GameLoop, SingleWriterOfTheIndex)
+{
+    Battle battle;
+    {
+        GameLoop game{battle.alive};
+        EXPECT_TRUE(battle.alive.SingleWriter());
+
+        for(int i = 0; i < 4; ++i){
+            game.Submit({COMMAND_ATTACK, HERO, ORC});
+        }
+        game.Tick();
+        EXPECT_FALSE(battle.alive.IsAlive(ORC)); // removed without a lock
+        EXPECT_EQ(battle.alive.Count(FACTION_MONSTERS), 1U);
+        EXPECT_EQ(battle.alive.Target(battle.hero), &battle.dragon);
+    }
+    EXPECT_FALSE(battle.alive.SingleWriter());
+}
+
+TEST(GameLoop, RunEndsWithTheGame)
+{
+    Battle battle;
+    GameLoop game{battle.alive};
+    std::thread simulation{[&game]() { game.Run(std::chrono::microseconds{100}); }};
+
+    // two players kill the monsters: 4 hits for the orc, 10 for the dragon
+    std::vector<std::thread> players;
+    for(const std::uint32_t target : {ORC, DRAGON}){
+        players.emplace_back([&game, target]() {
+            std::uint64_t ticket{NO_TICKET};
+            for(int i = 0; i < 10; ++i){
+                ticket = game.Submit({COMMAND_ATTACK, HERO, target});
+            }
+            game.WaitFor(ticket);
+        });
+    }
+    for(auto& player : players){
+        player.join();
+    }
+    simulation.join();
+
+    EXPECT_TRUE(game.Stopped());
+    EXPECT_TRUE(battle.alive.IsOver());
+    EXPECT_FALSE(battle.orc.IsAlive());
+    EXPECT_FALSE(battle.dragon.IsAlive());
+    EXPECT_EQ(game.Attacks(), 14U);
+    EXPECT_EQ(game.Submit({COMMAND_ATTACK, ORC, HERO}), NO_TICKET);
+}
+
+TEST(GameLoop, StopReleasesWaiters)
+{
+    Battle battle;
+    GameLoop game{battle.alive};
+    const std::uint64_t ticket = game.Submit({COMMAND_NONE, HERO, ORC});
+
+    std::thread simulation{[&game]() { game.Run(std::chrono::seconds{1}); }};
+    game.WaitFor(ticket);
+    game.Stop();
+    // a ticket never applied, e.g submitted just before the stop
+    game.WaitFor(ticket + 100);
+    simulation.join();
+
+    EXPECT_EQ(game.Applied(), 1U);
+    EXPECT_EQ(game.Submit({COMMAND_NONE, HERO, ORC}), NO_TICKET);
+}
@@ -0,0 +1,166 @@
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include "game_server.h"
+
+
+static std::string socket_path()
+{
+    return "/tmp/scg_test_server_" + std::to_string(getpid()) + ".sock";
+}
+
+
+// A blocking client of the server, reading with a timeout
+class Client {
+public:
+    explicit Client(const std::string& path) {
+        m_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+        timeval timeout{5, 0};
+        setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        m_connected = connect(m_fd, reinterpret_cast<const sockaddr*>(&address),
+                              sizeof(address)) == 0;
+    }
+    ~Client() { close(m_fd); }
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    bool Connected() const { return m_connected; }
+
+    void Send(const std::string& text) const {
+        EXPECT_EQ(send(m_fd, text.data(), text.size(), MSG_NOSIGNAL),
+                  static_cast<ssize_t>(text.size()));
+    }
+
+    // the next line, or "EOF" once the server closed the session
+    std::string ReadLine() {
+        while(true){
+            const auto end = m_pending.find('\n');
+            if(end != std::string::npos){
+                std::string line = m_pending.substr(0, end);
+                m_pending.erase(0, end + 1);
+                return line;
+            }
+            char bytes[256];
+            const auto count = read(m_fd, bytes, sizeof(bytes));
+            if(count <= 0){
+                return "EOF";
+            }
+            m_pending.append(bytes, static_cast<std::size_t>(count));
+        }
+    }
+
+    // the next answer to a command, skipping the attacks of the monsters
+    std::string ReadAnswer() {
+        std::string line = ReadLine();
+        while(line != "EOF" && line.compare(0, 5, "Hero ") != 0){
+            line = ReadLine();
+        }
+        return line;
+    }
+
+private:
+    int m_fd{-1};
+    bool m_connected{false};
+    std::string m_pending;
+};
+
+
+TEST(GameServer, AnswersCommands)
+{
+    const std::string path = socket_path();
+    GameServer server{ServerConfig{path.c_str(), 1, TIME_SCALE_REAL_TIME}};
+    ASSERT_EQ(server.Start(), SERVER_OK);
+    EXPECT_EQ(server.Start(), SERVER_RUNNING);
+
+    Client client{path};
+    ASSERT_TRUE(client.Connected());
+    client.Send("attack orc\nATTACK Dragon\r\n");
+    EXPECT_EQ(client.ReadAnswer(), "Hero hits Orc. Orc health is 5");
+    EXPECT_EQ(client.ReadAnswer(), "Hero hits Dragon. Dragon health is 18");
+    client.Send("dance\n");
+    EXPECT_EQ(client.ReadAnswer(), "Hero does not understand the command");
+    EXPECT_EQ(server.Commands(), 3U);
+    EXPECT_EQ(server.Sessions(), 1U);
+}
+
+TEST(GameServer, HeroWins)
+{
+    const std::string path = socket_path();
+    GameServer server{ServerConfig{path.c_str(), 2, TIME_SCALE_REAL_TIME}};
+    ASSERT_EQ(server.Start(), SERVER_OK);
+
+    Client client{path};
+    ASSERT_TRUE(client.Connected());
+    std::string commands;
+    for(int i = 0; i < 4; ++i){ commands += "attack orc\n"; }
+    for(int i = 0; i < 10; ++i){ commands += "attack dragon\n"; }
+    client.Send(commands);
+
+    std::vector<std::string> lines;
+    for(std::string line = client.ReadLine(); line != "EOF"; line = client.ReadLine()){
+        lines.push_back(line);
+    }
+    ASSERT_GE(lines.size(), 15U);
+    EXPECT_EQ(lines[3], "Hero hits Orc. Orc health is 0");
+    EXPECT_EQ(lines[lines.size() - 2], "Hero hits Dragon. Dragon health is 0");
+    EXPECT_EQ(lines.back(), "Game over: you win");
+}
+
+TEST(GameServer, MonstersPushTheirAttacks)
+{
+    const std::string path = socket_path();
+    // a thousand times faster: the hero dies within a second
+    GameServer server{ServerConfig{path.c_str(), 1, 1000.0}};
+    ASSERT_EQ(server.Start(), SERVER_OK);
+
+    Client client{path};
+    ASSERT_TRUE(client.Connected());
+    std::vector<std::string> lines;
+    for(std::string line = client.ReadLine(); line != "EOF"; line = client.ReadLine()){
+        lines.push_back(line);
+    }
+    ASSERT_GE(lines.size(), 2U);
+    EXPECT_EQ(lines.front().find(" hits Hero. Hero health is "), lines.front().find(' '));
+    EXPECT_EQ(lines[lines.size() - 2].substr(lines[lines.size() - 2].size() - 2), " 0");
+    EXPECT_EQ(lines.back(), "Game over: you loose");
+}
+
+TEST(GameServer, ManySessions)
+{
+    constexpr std::size_t CLIENTS = 64;
+    const std::string path = socket_path();
+    GameServer server{ServerConfig{path.c_str(), 2, TIME_SCALE_REAL_TIME}};
+    ASSERT_EQ(server.Start(), SERVER_OK);
+
+    std::vector<std::unique_ptr<Client>> clients;
+    for(std::size_t i = 0; i < CLIENTS; ++i){
+        clients.push_back(std::make_unique<Client>(path));
+        ASSERT_TRUE(clients.back()->Connected());
+        clients.back()->Send("attack dragon\n");
+    }
+    // each session has its own fighters
+    for(auto& client : clients){
+        EXPECT_EQ(client->ReadAnswer(), "Hero hits Dragon. Dragon health is 18");
+    }
+    EXPECT_EQ(server.Sessions(), CLIENTS);
+    EXPECT_EQ(server.SessionsServed(), CLIENTS);
+
+    clients.clear();
+    for(int i = 0; i < 500 && server.Sessions() != 0; ++i){
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    EXPECT_EQ(server.Sessions(), 0U);
+    server.Stop();
+    EXPECT_NE(access(path.c_str(), F_OK), 0); // the socket is removed
+}
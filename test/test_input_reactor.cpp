@@ -0,0 +1,134 @@
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "gtest/gtest.h"
+#include "input_reactor.h"
+
+
+// A pipe feeding a reactor, closed at the end of the test
+class Pipe {
+public:
+    Pipe() { EXPECT_EQ(pipe(m_fds), 0); }
+    ~Pipe() { CloseWriter(); close(m_fds[0]); }
+    Pipe(const Pipe&) = delete;
+    Pipe& operator=(const Pipe&) = delete;
+
+    int Reader() const { return m_fds[0]; }
+    void Write(const std::string& text) const {
+        EXPECT_EQ(write(m_fds[1], text.data(), text.size()),
+                  static_cast<ssize_t>(text.size()));
+    }
+    void CloseWriter() {
+        if(m_fds[1] >= 0){ close(m_fds[1]); m_fds[1] = -1; }
+    }
+
+private:
+    int m_fds[2]{-1, -1};
+};
+
+
+TEST(InputReactor, FramesLines)
+{
+    Pipe input;
+    InputReactor reactor;
+    std::vector<std::string> lines;
+    ASSERT_TRUE(reactor.Add(input.Reader(),
+                            [&](std::string_view line) { lines.emplace_back(line); }));
+
+    input.Write("attack orc\nattack dra");
+    EXPECT_EQ(reactor.RunOnce(1000), 1U);
+    input.Write("gon\r\n\nattack orc\n");
+    EXPECT_EQ(reactor.RunOnce(1000), 3U);
+
+    const std::vector<std::string> expected{"attack orc", "attack dragon", "",
+                                            "attack orc"};
+    EXPECT_EQ(lines, expected);
+    EXPECT_EQ(reactor.RunOnce(0), 0U); // nothing to read
+}
+
+TEST(InputReactor, LastLineAndClose)
+{
+    Pipe input;
+    InputReactor reactor;
+    std::vector<std::string> lines;
+    int closed{0};
+    ASSERT_TRUE(reactor.Add(input.Reader(),
+                            [&](std::string_view line) { lines.emplace_back(line); },
+                            [&]() { ++closed; }));
+
+    input.Write("attack orc\nattack dragon");
+    input.CloseWriter();
+    EXPECT_EQ(reactor.Run(), 2U); // returns once every input is closed
+    EXPECT_EQ(lines.back(), "attack dragon");
+    EXPECT_EQ(closed, 1);
+    EXPECT_EQ(reactor.Inputs(), 0U);
+}
+
+TEST(InputReactor, DropsLongLines)
+{
+    Pipe input;
+    InputReactor reactor;
+    std::vector<std::string> lines;
+    ASSERT_TRUE(reactor.Add(input.Reader(),
+                            [&](std::string_view line) { lines.emplace_back(line); }));
+
+    input.Write(std::string(3 * INPUT_LINE_MAX, 'x') + "\nattack orc\n");
+    input.CloseWriter();
+    reactor.Run();
+    ASSERT_EQ(lines.size(), 1U);
+    EXPECT_EQ(lines[0], "attack orc");
+}
+
+TEST(InputReactor, SeveralInputs)
+{
+    Pipe first;
+    Pipe second;
+    InputReactor reactor;
+    std::string received;
+    ASSERT_TRUE(reactor.Add(first.Reader(),
+                            [&](std::string_view line) { received += line; }));
+    ASSERT_TRUE(reactor.Add(second.Reader(),
+                            [&](std::string_view line) { received += line; }));
+
+    second.Write("b\n");
+    first.Write("a\n");
+    first.CloseWriter();
+    second.CloseWriter();
+    EXPECT_EQ(reactor.Run(), 2U);
+    EXPECT_EQ(received, "ab"); // inputs in the order they were added
+}
+
+TEST(InputReactor, StopFromHandler)
+{
+    Pipe input;
+    InputReactor reactor;
+    std::vector<std::string> lines;
+    ASSERT_TRUE(reactor.Add(input.Reader(), [&](std::string_view line) {
+        lines.emplace_back(line);
+        reactor.Stop();
+    }));
+
+    input.Write("attack orc\nattack dragon\n");
+    EXPECT_EQ(reactor.Run(), 1U); // the following lines are not delivered
+    EXPECT_TRUE(reactor.Stopped());
+    EXPECT_EQ(reactor.RunOnce(), 0U);
+}
+
+TEST(InputReactor, StopWakesUpImmediately)
+{
+    Pipe input; // never written: the player does not type anything
+    InputReactor reactor;
+    ASSERT_TRUE(reactor.Add(input.Reader(), [](std::string_view) {}));
+
+    const auto start = std::chrono::steady_clock::now();
+    std::thread stopper{[&reactor]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        reactor.Stop();
+    }};
+    EXPECT_EQ(reactor.Run(), 0U);
+    stopper.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
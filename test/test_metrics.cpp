@@ -0,0 +1,172 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "fighter.h"
+#include "metrics.h"
+
+
+TEST(Metrics, HistogramBuckets)
+{
+    for(std::uint64_t value = 0; value < 16; ++value){
+        EXPECT_EQ(HistogramBucket(value), value);
+        EXPECT_EQ(HistogramBucketMax(HistogramBucket(value)), value);
+    }
+    for(const std::uint64_t value : {17ULL, 1000ULL, 123456789ULL, 1ULL << 40}){
+        const auto highest = HistogramBucketMax(HistogramBucket(value));
+        EXPECT_GE(highest, value);
+        EXPECT_LT(highest - value, value / 16 + 1);
+    }
+}
+
+TEST(Metrics, Summarize)
+{
+    std::array<std::uint64_t, HISTOGRAM_BUCKETS> buckets{};
+    for(std::uint64_t value = 1; value <= 1000; ++value){
+        ++buckets[HistogramBucket(value * 1000)];
+    }
+    const HistogramSummary summary = Metrics::Summarize(buckets);
+
+    EXPECT_EQ(summary.count, 1000U);
+    EXPECT_NEAR(static_cast<double>(summary.p50), 500000.0, 500000.0 / 16);
+    EXPECT_NEAR(static_cast<double>(summary.p99), 990000.0, 990000.0 / 16);
+    EXPECT_GE(summary.max, 1000000U);
+    EXPECT_LE(summary.p999, summary.max);
+
+    const HistogramSummary empty = Metrics::Summarize({});
+    EXPECT_EQ(empty.count, 0U);
+    EXPECT_EQ(empty.max, 0U);
+}
+
+TEST(Metrics, CountsAttacksPerRole)
+{
+    const auto& metrics = Metrics::Instance();
+    const auto attacks = metrics.Counter(COUNTER_ATTACKS, ROLE_HERO);
+    const auto kills = metrics.Counter(COUNTER_KILLS, ROLE_HERO);
+    const auto rejected = metrics.Counter(COUNTER_REJECTED, ROLE_HERO);
+
+    const auto hero = Hero(ROLE_HERO);
+    auto orc = Orc(ROLE_ORC);
+    {
+        // 4 hits kill the orc, then the hit is rejected
+        AttackTally tally;
+        for(bool hit = true; hit; ){
+            hit = hero.Hit(orc);
+            tally.Add(hero.GetRole(), hit);
+        }
+        EXPECT_EQ(metrics.Counter(COUNTER_ATTACKS, ROLE_HERO) - attacks, 0U);
+    }
+    EXPECT_EQ(metrics.Counter(COUNTER_ATTACKS, ROLE_HERO) - attacks, 4U);
+
+    auto other = Hero(ROLE_HERO);
+    hero.Attack(other);
+    auto dragon = Dragon(ROLE_DRAGON);
+    hero.Attack(dragon); // the hit is left to the caller
+
+    EXPECT_EQ(metrics.Counter(COUNTER_ATTACKS, ROLE_HERO) - attacks, 4U);
+    EXPECT_EQ(metrics.Counter(COUNTER_KILLS, ROLE_HERO) - kills, 1U);
+    EXPECT_EQ(metrics.Counter(COUNTER_REJECTED, ROLE_HERO) - rejected, 2U);
+}
+
+TEST(Metrics, RolesOutsideTheCatalog)
+{
+    auto& metrics = Metrics::Instance();
+    // SetRole(ROLE_t) does not check the upper bound
+    auto rogue = Fighter(ROLE_HERO);
+    rogue.SetRole(static_cast<ROLE_t>(ROLE_CAPACITY + 1000));
+    auto orc = Orc(ROLE_ORC);
+    const auto rejected = metrics.Counter(COUNTER_REJECTED, rogue.GetRole());
+
+    EXPECT_FALSE(rogue.Hit(orc));
+    EXPECT_EQ(metrics.Counter(COUNTER_REJECTED, rogue.GetRole()), rejected + 1);
+    EXPECT_LT(MetricCounterIndex(COUNTER_REJECTED, static_cast<ROLE_t>(1 << 30)),
+              METRIC_COUNTERS * METRIC_ROLES);
+}
+
+TEST(Metrics, TallyFlushesOnRoleChange)
+{
+    const auto& metrics = Metrics::Instance();
+    const auto orc = metrics.Counter(COUNTER_ATTACKS, ROLE_ORC);
+    const auto dragon = metrics.Counter(COUNTER_ATTACKS, ROLE_DRAGON);
+
+    AttackTally tally;
+    tally.Add(ROLE_ORC, true);
+    tally.Add(ROLE_ORC, false);
+    tally.Add(ROLE_ORC, true);
+    tally.Add(ROLE_DRAGON, true);
+    EXPECT_EQ(metrics.Counter(COUNTER_ATTACKS, ROLE_ORC) - orc, 2U);
+    EXPECT_EQ(metrics.Counter(COUNTER_ATTACKS, ROLE_DRAGON) - dragon, 0U);
+
+    tally.Flush();
+    EXPECT_EQ(metrics.Counter(COUNTER_ATTACKS, ROLE_DRAGON) - dragon, 1U);
+}
+
+TEST(Metrics, ShardsOutliveTheirThreads)
+{
+    const auto& metrics = Metrics::Instance();
+    const auto before = metrics.Counter(COUNTER_ATTACKS, ROLE_DRAGON);
+
+    // more threads over time than shards: the shards are reused
+    for(int round = 0; round < 3; ++round){
+        std::vector<std::thread> threads;
+        for(int i = 0; i < 4; ++i){
+            threads.emplace_back([]() {
+                for(int hit = 0; hit < 1000; ++hit){
+                    Metrics::Count(COUNTER_ATTACKS, ROLE_DRAGON);
+                }
+            });
+        }
+        for(auto& thread : threads){
+            thread.join();
+        }
+    }
+    EXPECT_EQ(metrics.Counter(COUNTER_ATTACKS, ROLE_DRAGON) - before, 12000U);
+}
+
+TEST(Metrics, LockTimed)
+{
+    const auto& metrics = Metrics::Instance();
+    const auto before = metrics.Summary(HISTOGRAM_LOCK_WAIT).count;
+
+    std::mutex mutex;
+    {
+        const auto lock = LockTimed(mutex);
+        EXPECT_TRUE(lock.owns_lock());
+    }
+    std::unique_lock<std::mutex> held(mutex);
+    std::thread waiter{[&mutex]() {
+        const auto lock = LockTimed(mutex);
+    }};
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    held.unlock();
+    waiter.join();
+
+    const HistogramSummary summary = metrics.Summary(HISTOGRAM_LOCK_WAIT);
+    EXPECT_EQ(summary.count - before, 2U);
+    EXPECT_GE(summary.max, 1000000U); // the waiter waited for milliseconds
+}
+
+TEST(Metrics, Dump)
+{
+    const auto hero = Hero(ROLE_HERO);
+    auto orc = Orc(ROLE_ORC);
+    hero.Hit(orc);
+
+    std::ostringstream text;
+    Metrics::Instance().Dump(text, METRICS_TEXT);
+    EXPECT_NE(text.str().find("attacks Hero:   "), std::string::npos);
+    EXPECT_NE(text.str().find("tick_lateness (ns):   count "), std::string::npos);
+
+    std::ostringstream json;
+    Metrics::Instance().Dump(json, METRICS_JSON);
+    const std::string dump = json.str();
+    EXPECT_EQ(dump.rfind("{\"counters\":{\"attacks\":{\"Undefined\":", 0), 0U);
+    EXPECT_NE(dump.find("\"histograms_ns\":{\"tick_lateness\":{\"count\":"), std::string::npos);
+    EXPECT_EQ(dump.substr(dump.size() - 3), "}}\n");
+}
@@ -0,0 +1,180 @@
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "event_scheduler.h"
+#include "alive_index.h"
+#include "fighter.h"
+#include "game_loop.h"
+#include "monster_behavior.h"
+
+
+// Counts the live coroutine frames of the tests
+static int g_frames{0}; // NOLINT
+
+struct FrameCounter {
+    FrameCounter() { ++g_frames; }
+    ~FrameCounter() { --g_frames; }
+    FrameCounter(const FrameCounter&) = delete;
+    FrameCounter& operator=(const FrameCounter&) = delete;
+};
+
+static Behavior Ticker(BehaviorExecutor& executor, const long long period,
+                       std::vector<long long>& ticks)
+{
+    const FrameCounter counter;
+    for(;;){
+        const bool awake = co_await executor.SleepFor(period);
+        if(!awake){
+            co_return;
+        }
+        ticks.push_back(executor.Now());
+    }
+}
+
+static Behavior Countdown(BehaviorExecutor& executor, int count,
+                          std::vector<long long>& ticks)
+{
+    const FrameCounter counter;
+    for(; count > 0; --count){
+        const bool awake = co_await executor.SleepFor(100);
+        if(!awake){
+            co_return;
+        }
+        ticks.push_back(executor.Now());
+    }
+}
+
+
+TEST(MonsterBehavior, SleepAndFinish)
+{
+    std::vector<long long> ticks;
+    {
+        BehaviorExecutor executor;
+        executor.Spawn( Countdown(executor, 3, ticks) );
+        EXPECT_EQ(executor.Size(), 1U);
+        EXPECT_EQ(g_frames, 0); // not started before Run()
+
+        EXPECT_EQ(executor.Run(), 4U); // the start and 3 wake ups
+        EXPECT_EQ(executor.Size(), 0U);
+        EXPECT_EQ(g_frames, 0);       // destroyed once done
+        EXPECT_EQ(executor.Now(), 300);
+    }
+    const std::vector<long long> expected{100, 200, 300};
+    EXPECT_EQ(ticks, expected);
+}
+
+TEST(MonsterBehavior, StopDestroysSuspendedBehaviors)
+{
+    std::vector<long long> ticks;
+    {
+        BehaviorExecutor executor;
+        executor.Spawn( Ticker(executor, 250, ticks) );
+        executor.Spawn( Countdown(executor, 100, ticks) );
+        executor.Spawn( [](BehaviorExecutor& self) -> Behavior {
+            co_await self.SleepFor(1050);
+            self.Stop();
+        }(executor) );
+        executor.Run();
+
+        EXPECT_TRUE(executor.Stopped());
+        EXPECT_EQ(executor.Now(), 1050);
+        EXPECT_EQ(g_frames, 2); // suspended until the executor is destroyed
+    }
+    EXPECT_EQ(g_frames, 0);
+    EXPECT_EQ(ticks.size(), 14U); // 4 ticks and 10 countdowns, then the stop
+}
+
+TEST(MonsterBehavior, SameBattleAsTheScheduler)
+{
+    auto orc = Orc(ROLE_ORC);
+    auto dragon = Dragon(ROLE_DRAGON);
+    const std::vector<const Monster*> monsters{&orc, &dragon};
+
+    auto hero = Hero(ROLE_HERO);
+    EventScheduler scheduler;
+    const auto scheduled_attacks = RunMonsterActions(scheduler, hero, monsters);
+    EXPECT_FALSE(hero.IsAlive());
+
+    auto other_orc = Orc(ROLE_ORC);
+    auto other_dragon = Dragon(ROLE_DRAGON);
+    const std::vector<const Monster*> other_monsters{&other_orc, &other_dragon};
+    auto other_hero = Hero(ROLE_HERO);
+    BehaviorExecutor executor;
+    const auto attacks = RunMonsterBehaviors(executor, other_hero, other_monsters);
+
+    EXPECT_FALSE(other_hero.IsAlive());
+    EXPECT_EQ(attacks, scheduled_attacks);
+    EXPECT_EQ(executor.Now(), scheduler.Now());
+}
+
+TEST(MonsterBehavior, ThousandsOfMonsters)
+{
+    std::vector<Monster> horde;
+    for(int i = 0; i < 5000; ++i){
+        horde.emplace_back(i % 2 == 0 ? ROLE_ORC : ROLE_DRAGON);
+    }
+    std::vector<const Monster*> monsters;
+    for(const auto& monster : horde){
+        monsters.push_back(&monster);
+    }
+
+    auto hero = Hero(ROLE_HERO);
+    hero.SetHealth(1000000);
+    BehaviorExecutor executor;
+    const auto attacks = RunMonsterBehaviors(executor, hero, monsters);
+
+    // as with the scheduler, the hero dies in the 31st cycle of 6 s
+    EXPECT_FALSE(hero.IsAlive());
+    EXPECT_GT(attacks, 30U * 32500U / 3U);
+    EXPECT_GT(executor.Now(), 30 * 6000);
+    EXPECT_LE(executor.Now(), 31 * 6000);
+}
+
+TEST(MonsterBehavior, StopWakesUp)
+{
+    BehaviorExecutor executor{TIME_SCALE_REAL_TIME};
+    std::vector<long long> ticks;
+    executor.Spawn( Ticker(executor, 60000, ticks) ); // one minute
+
+    std::thread stopper{[&executor]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        executor.Stop();
+    }};
+    const auto start = std::chrono::steady_clock::now();
+    executor.Run();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    stopper.join();
+
+    EXPECT_TRUE(ticks.empty());
+    EXPECT_LT(elapsed, std::chrono::seconds(10));
+}
+
+TEST(MonsterBehavior, CommandsToTheSimulation)
+{
+    auto hero = Hero(ROLE_HERO);
+    auto orc = Orc(ROLE_ORC);
+    auto dragon = Dragon(ROLE_DRAGON);
+    AliveIndex alive;
+    alive.Add(hero);
+    alive.Add(orc);
+    alive.Add(dragon);
+
+    // the monsters only submit their attacks: the hero is hit by the
+    // simulation thread, which stops the executor when the hero is dead
+    BehaviorExecutor executor;
+    GameLoop game{alive};
+    std::thread simulation{[&]() {
+        game.Run(std::chrono::microseconds{100});
+        executor.Stop();
+    }};
+    executor.Spawn(MonsterCommandBehavior(executor, orc, game, {COMMAND_ATTACK, 1, 0}));
+    executor.Spawn(MonsterCommandBehavior(executor, dragon, game, {COMMAND_ATTACK, 2, 0}));
+    executor.Run();
+    simulation.join();
+
+    EXPECT_FALSE(hero.IsAlive());
+    EXPECT_TRUE(orc.IsAlive());
+    EXPECT_TRUE(dragon.IsAlive());
+}
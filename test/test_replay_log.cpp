@@ -0,0 +1,154 @@
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include "gtest/gtest.h"
+#include "combat_log.h"
+#include "fighter.h"
+#include "replay_log.h"
+
+
+// Record a battle won by the hero with the attacks of the game
+static std::string record_battle()
+{
+    std::ostringstream messages;
+    CombatLog::Instance().Start(LOG_MODE_DIRECT, LOG_OVERFLOW_DROP, &messages);
+
+    std::ostringstream log;
+    auto hero = Hero(ROLE_HERO);
+    auto orc = Orc(ROLE_ORC);
+    auto dragon = Dragon(ROLE_DRAGON);
+    ReplayRecorder::Instance().Start(log);
+    ReplayRecorder::Instance().Spawn(hero);
+    ReplayRecorder::Instance().Spawn(orc);
+    ReplayRecorder::Instance().Spawn(dragon);
+
+    orc.Attack(hero);
+    dragon.Attack(hero);
+    while(orc.IsAlive()){
+        hero.Attack(orc);
+    }
+    while(dragon.IsAlive()){
+        hero.Attack(dragon);
+    }
+    ReplayRecorder::Instance().RecordGameOver(true);
+    ReplayRecorder::Instance().Stop();
+
+    CombatLog::Instance().Start(LOG_MODE_DIRECT);
+    return log.str();
+}
+
+
+TEST(ReplayLog, RecordedBattleReplays)
+{
+    const std::string log = record_battle();
+    // header, 3 spawns, 2 + 4 + 10 hits, 2 deaths, game over, 3 states
+    ASSERT_EQ(log.size(), REPLAY_HEADER_SIZE + 25 * REPLAY_RECORD_SIZE);
+    EXPECT_EQ(ReplayRecorder::Instance().Recorded(), 25U);
+
+    std::istringstream input{log};
+    const auto result = Replay(input);
+    EXPECT_TRUE(result.valid);
+    EXPECT_EQ(result.events, 25U);
+    EXPECT_EQ(result.hits, 16U);
+    EXPECT_EQ(result.deaths, 2U);
+    EXPECT_TRUE(result.game_over);
+    EXPECT_TRUE(result.hero_wins);
+    EXPECT_EQ(result.mismatches, 0U);
+}
+
+TEST(ReplayLog, RecordLayout)
+{
+    const std::string log = record_battle();
+    const auto* bytes = reinterpret_cast<const unsigned char*>(log.data());
+    EXPECT_EQ(log.compare(0, 8, "SCGREPLY"), 0);
+
+    const auto spawn = DecodeReplayRecord(bytes + REPLAY_HEADER_SIZE);
+    EXPECT_EQ(spawn.event, REPLAY_SPAWN);
+    EXPECT_EQ(spawn.role, ROLE_HERO);
+    EXPECT_EQ(spawn.actor, 0U);
+    EXPECT_EQ(spawn.value, HEALTH_HERO);
+
+    // the orc hits the hero
+    const auto hit = DecodeReplayRecord(bytes + REPLAY_HEADER_SIZE +
+                                        3 * REPLAY_RECORD_SIZE);
+    EXPECT_EQ(hit.event, REPLAY_HIT);
+    EXPECT_EQ(hit.role, ROLE_ORC);
+    EXPECT_EQ(hit.actor, 1U);
+    EXPECT_EQ(hit.target, 0U);
+    EXPECT_EQ(hit.health, HEALTH_HERO - hit.value);
+}
+
+TEST(ReplayLog, TamperedHitIsReported)
+{
+    std::string log = record_battle();
+    // health of the target after the first hit
+    log[REPLAY_HEADER_SIZE + 3 * REPLAY_RECORD_SIZE + 12] += 1;
+
+    std::istringstream input{log};
+    const auto result = Replay(input);
+    EXPECT_TRUE(result.valid);
+    EXPECT_GE(result.mismatches, 1U);
+    EXPECT_EQ(result.first_mismatch, 3U);
+}
+
+TEST(ReplayLog, InvalidLogs)
+{
+    std::string log = record_battle();
+
+    std::string bad_magic = log;
+    bad_magic[0] = 'X';
+    std::istringstream bad_magic_input{bad_magic};
+    EXPECT_FALSE(Replay(bad_magic_input).valid);
+
+    std::string bad_version = log;
+    bad_version[8] = 2;
+    std::istringstream bad_version_input{bad_version};
+    EXPECT_FALSE(Replay(bad_version_input).valid);
+
+    std::istringstream truncated{log.substr(0, log.size() - 1)};
+    EXPECT_FALSE(Replay(truncated).valid);
+
+    std::istringstream empty{std::string{}};
+    EXPECT_FALSE(Replay(empty).valid);
+}
+
+TEST(ReplayLog, HooksIdleWithoutRecording)
+{
+    ReplayRecorder::Instance().Stop(); // no recording: nothing to do
+    EXPECT_FALSE(ReplayRecorder::Instance().Recording());
+
+    std::ostringstream messages;
+    CombatLog::Instance().Start(LOG_MODE_DIRECT, LOG_OVERFLOW_DROP, &messages);
+    auto hero = Hero(ROLE_HERO);
+    auto orc = Orc(ROLE_ORC);
+    const auto recorded = ReplayRecorder::Instance().Recorded();
+    hero.Attack(orc);
+    CombatLog::Instance().Start(LOG_MODE_DIRECT);
+    EXPECT_EQ(ReplayRecorder::Instance().Recorded(), recorded);
+}
+
+TEST(ReplayLog, RecordsSilentHits)
+{
+    std::ostringstream log;
+    auto hero = Hero(ROLE_HERO);
+    auto orc = Orc(ROLE_ORC);
+    auto stranger = Orc(ROLE_ORC);
+    ReplayRecorder::Instance().Start(log);
+    ReplayRecorder::Instance().Spawn(hero);
+    ReplayRecorder::Instance().Spawn(orc);
+
+    std::size_t hits = 0;
+    while(orc.IsAlive()){
+        ASSERT_TRUE(hero.Hit(orc));
+        ++hits;
+    }
+    EXPECT_TRUE(hero.Hit(stranger)); // not spawned: not recorded
+    ReplayRecorder::Instance().Stop();
+
+    std::istringstream input{log.str()};
+    const auto result = Replay(input);
+    EXPECT_TRUE(result.valid);
+    EXPECT_EQ(result.hits, hits);
+    EXPECT_EQ(result.deaths, 1U);
+    EXPECT_EQ(result.mismatches, 0U);
+}
@@ -0,0 +1,184 @@
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "alive_index.h"
+#include "damage_kernel.h"
+#include "fighter.h"
+#include "role_catalog.h"
+
+// The built-in roles and a troll, enemy of the hero only
+static const std::string TROLL_CATALOG =
+    "# name   health  damage  interval  enemies\n"
+    "Hero     40      2       0         Orc,Dragon,Troll\n"
+    "Orc      7       1       1500      Hero\n"
+    "\n"
+    "Dragon   20      3       2000      Hero\n"
+    "Troll    30      4       2500      Hero\n";
+
+constexpr auto ROLE_TROLL = static_cast<ROLE_t>(3);
+
+
+/**
+ * @brief Load a catalog from a text
+ *
+ * @param catalog the catalog to be loaded
+ * @param text the text of the catalog
+ * @return The status of the load
+ */
+static CATALOG_STATUS_t load(RoleCatalog& catalog, const std::string& text)
+{
+    std::istringstream input(text);
+    return catalog.Load(input);
+}
+
+
+TEST(RoleCatalog, Builtin)
+{
+    const RoleCatalog catalog;
+
+    EXPECT_TRUE(catalog.IsBuiltin());
+    EXPECT_EQ(catalog.Size(), ROLE_BUILTIN);
+    EXPECT_EQ(catalog.Role(2), ROLE_DRAGON);
+    EXPECT_EQ(catalog.Role(3), ROLE_UNDEFINED);
+    EXPECT_EQ(catalog.Find("Orc"), ROLE_ORC);
+    EXPECT_EQ(catalog.Find("Troll"), ROLE_UNDEFINED);
+    for(const ROLE_t role : {ROLE_UNDEFINED, ROLE_HERO, ROLE_ORC, ROLE_DRAGON}){
+        EXPECT_EQ(catalog.Health(role), Fighter::RoleHealth(role));
+        EXPECT_EQ(catalog.Damage(role), Fighter::RoleDamage(role));
+        EXPECT_EQ(catalog.AttackInterval(role), Fighter::RoleAttackInterval(role));
+        EXPECT_STREQ(catalog.Name(role), Fighter::RoleName(role));
+        for(const ROLE_t other : {ROLE_UNDEFINED, ROLE_HERO, ROLE_ORC, ROLE_DRAGON}){
+            EXPECT_EQ(catalog.AreEnemies(role, other), Fighter::RolesAreEnemies(role, other));
+        }
+    }
+}
+
+TEST(RoleCatalog, LoadTroll)
+{
+    RoleCatalog catalog;
+    ASSERT_EQ(load(catalog, TROLL_CATALOG), CATALOG_OK);
+
+    EXPECT_FALSE(catalog.IsBuiltin());
+    EXPECT_EQ(catalog.Size(), 4U);
+    EXPECT_EQ(catalog.Find("Troll"), ROLE_TROLL);
+    EXPECT_EQ(catalog.Role(3), ROLE_TROLL);
+    EXPECT_EQ(catalog.Health(ROLE_TROLL), 30);
+    EXPECT_EQ(catalog.Damage(ROLE_TROLL), 4);
+    EXPECT_EQ(catalog.AttackInterval(ROLE_TROLL), 2500);
+    EXPECT_STREQ(catalog.Name(ROLE_TROLL), "Troll");
+    EXPECT_TRUE(catalog.AreEnemies(ROLE_TROLL, ROLE_HERO));
+    EXPECT_TRUE(catalog.AreEnemies(ROLE_HERO, ROLE_TROLL));
+    EXPECT_FALSE(catalog.AreEnemies(ROLE_TROLL, ROLE_ORC));
+
+    // the built-in rules again, written as a catalog
+    ASSERT_EQ(load(catalog,
+                   "Hero 40 2 0 Orc,Dragon\nOrc 7 1 1500 Hero\nDragon 20 3 2000 Hero\n"),
+              CATALOG_OK);
+    EXPECT_TRUE(catalog.IsBuiltin());
+    EXPECT_EQ(catalog.Role(3), ROLE_UNDEFINED);
+}
+
+TEST(RoleCatalog, Errors)
+{
+    RoleCatalog catalog;
+    const std::string builtin = "Hero 40 2 0 Orc\nOrc 7 1 1500 Hero\nDragon 20 3 2000 -\n";
+
+    EXPECT_EQ(load(catalog, builtin + "Troll 30 x 2500 Hero\n"), CATALOG_BAD_FORMAT);
+    EXPECT_EQ(catalog.ErrorLine(), 4U);
+    EXPECT_EQ(load(catalog, builtin + "Troll 30 4 2500\n"), CATALOG_BAD_FORMAT);
+    EXPECT_EQ(load(catalog, builtin + "Troll 0 4 2500 Hero\n"), CATALOG_BAD_FORMAT);
+    EXPECT_EQ(load(catalog, builtin + "Troll -3 4 2500 Hero\n"), CATALOG_BAD_FORMAT);
+    EXPECT_EQ(load(catalog, builtin + "Troll 30 4 2500 Hero extra\n"), CATALOG_BAD_FORMAT);
+    EXPECT_EQ(load(catalog, "# comment\nOrc 7 1 1500 Hero\n"), CATALOG_BAD_BUILTIN);
+    EXPECT_EQ(catalog.ErrorLine(), 2U);
+    EXPECT_EQ(load(catalog, "Hero 40 2 0 -\nOrc 7 1 1500 Hero\n"), CATALOG_BAD_BUILTIN);
+    EXPECT_EQ(catalog.ErrorLine(), 0U);
+    EXPECT_EQ(load(catalog, builtin + "Troll 30 4 2500 Hero\nTroll 1 1 1 -\n"),
+              CATALOG_DUPLICATE_ROLE);
+    EXPECT_EQ(catalog.ErrorLine(), 5U);
+    EXPECT_EQ(load(catalog, builtin + "Troll 30 4 2500 Hero,Goblin\n"), CATALOG_UNKNOWN_ENEMY);
+    EXPECT_EQ(catalog.ErrorLine(), 4U);
+    EXPECT_EQ(catalog.LoadFile("/nonexistent/roles.txt"), CATALOG_IO_ERROR);
+
+    std::string crowded = builtin;
+    for(std::size_t i = ROLE_BUILTIN; i <= ROLE_CAPACITY; ++i){
+        crowded += "Troll" + std::to_string(i) + " 30 4 2500 Hero\n";
+    }
+    EXPECT_EQ(load(catalog, crowded), CATALOG_TOO_MANY_ROLES);
+    EXPECT_EQ(catalog.ErrorLine(), ROLE_CAPACITY + 1);
+
+    // a failed load leaves the roles unchanged
+    EXPECT_TRUE(catalog.IsBuiltin());
+    EXPECT_EQ(catalog.Size(), ROLE_BUILTIN);
+}
+
+TEST(RoleCatalog, TwoFactions)
+{
+    RoleCatalog catalog;
+    const std::string hero = "Hero 40 2 0 Orc,Dragon,Troll\n";
+    const std::string monsters = "Orc 7 1 1500 Hero\nDragon 20 3 2000 Hero\n";
+
+    // the enemies of the monsters follow RoleFaction(): only the hero
+    EXPECT_EQ(load(catalog, hero + monsters + "Troll 30 4 2500 Orc\n"), CATALOG_BAD_FACTIONS);
+    EXPECT_EQ(catalog.ErrorLine(), 4U);
+    EXPECT_EQ(load(catalog, hero + monsters + "Troll 30 4 2500 Hero,Orc\n"),
+              CATALOG_BAD_FACTIONS);
+    EXPECT_EQ(load(catalog, hero + monsters + "Troll 30 4 2500 -\n"), CATALOG_BAD_FACTIONS);
+    EXPECT_EQ(load(catalog, hero + "Orc 7 1 1500 Hero,Orc\nDragon 20 3 2000 Hero\n"
+                                   "Troll 30 4 2500 Hero\n"), CATALOG_BAD_FACTIONS);
+    EXPECT_EQ(catalog.ErrorLine(), 2U);
+    // and the hero fights all of them
+    EXPECT_EQ(load(catalog, "Hero 40 2 0 Orc,Dragon\n" + monsters + "Troll 30 4 2500 Hero\n"),
+              CATALOG_BAD_FACTIONS);
+    EXPECT_EQ(catalog.ErrorLine(), 1U);
+    EXPECT_TRUE(catalog.IsBuiltin());
+
+    ASSERT_EQ(load(catalog, TROLL_CATALOG), CATALOG_OK);
+    const auto size = static_cast<int>(catalog.Size());
+    for(int a = 0; a < size; ++a){
+        for(int b = 0; b < size; ++b){
+            const ROLE_t role = catalog.Role(a);
+            const ROLE_t other = catalog.Role(b);
+            EXPECT_EQ(catalog.AreEnemies(role, other),
+                      EnemyFaction(RoleFaction(role)) == RoleFaction(other));
+        }
+    }
+}
+
+TEST(RoleCatalog, FightersFollowTheCatalog)
+{
+    RoleCatalog& catalog = RoleCatalog::Instance();
+    ASSERT_EQ(load(catalog, TROLL_CATALOG), CATALOG_OK);
+
+    EXPECT_EQ(Fighter::IntToRole(3), ROLE_TROLL);
+    EXPECT_EQ(Fighter::IntToRole(4), ROLE_UNDEFINED);
+    auto hero = Hero(ROLE_HERO);
+    auto troll = Monster(ROLE_TROLL);
+    EXPECT_EQ(troll.GetHealth(), 30);
+    EXPECT_STREQ(troll.RoleToString(), "Troll");
+    EXPECT_EQ(troll.Damage(), 4);
+    EXPECT_TRUE(troll.IsEnemy(hero));
+
+    troll.Attack(hero);
+    EXPECT_EQ(hero.GetHealth(), HEALTH_HERO - 4);
+    hero.Attack(troll);
+    EXPECT_EQ(troll.GetHealth(), 30 - 2);
+
+    // the damage kernels fall back to the rules of the catalog
+    const std::vector<int> attacker_roles{ROLE_TROLL, ROLE_TROLL};
+    const std::vector<int> attacker_health{30, 30};
+    std::vector<int> target_roles{ROLE_HERO, ROLE_ORC};
+    std::vector<int> target_health{HEALTH_HERO, HEALTH_ORC};
+    for(const KERNEL_ISA_t isa : {ISA_SCALAR, ISA_SSE42, ISA_AVX2, ISA_AVX512}){
+        std::vector<int> health = target_health;
+        EXPECT_EQ(ApplyDamageTick(isa, attacker_roles.data(), attacker_health.data(),
+                                  target_roles.data(), health.data(), 2), 1U);
+        EXPECT_EQ(health[0], HEALTH_HERO - 4);
+        EXPECT_EQ(health[1], HEALTH_ORC);
+    }
+
+    catalog.LoadBuiltin();
+    EXPECT_EQ(Fighter::IntToRole(3), ROLE_UNDEFINED);
+}
@@ -0,0 +1,84 @@
+#include <cstdint>
+#include "gtest/gtest.h"
+#include "fighter.h"
+#include "simulation.h"
+
+
+TEST(Simulation, DefaultBattle)
+{
+    // Hero acts every second: orc dies at 4s, dragon at 14s. Meanwhile the orc
+    // hits at 1.5s and 3s, the dragon every 2s until 12s.
+    const BattleConfig config;
+    const auto result = SimulateBattle(config);
+
+    EXPECT_TRUE(result.hero_wins);
+    EXPECT_EQ(result.duration, 14000);
+    EXPECT_EQ(result.hero_hits, 14);
+    EXPECT_EQ(result.monster_hits, 8);
+    EXPECT_EQ(result.hero_health, HEALTH_HERO - 2 * 1 - 6 * 3);
+}
+
+TEST(Simulation, SlowHeroLooses)
+{
+    BattleConfig config;
+    config.hero_interval = 5000;
+    const auto result = SimulateBattle(config);
+
+    EXPECT_FALSE(result.hero_wins);
+    EXPECT_EQ(result.hero_health, HEALTH_UNDEFINED); // reset on death
+}
+
+TEST(Simulation, BalanceValues)
+{
+    // a hero hitting twice as hard kills the orc at 2s and the dragon at 7s
+    BattleConfig config;
+    config.hero_damage = 2 * Fighter::RoleDamage(ROLE_HERO);
+    auto result = SimulateBattle(config);
+    EXPECT_TRUE(result.hero_wins);
+    EXPECT_EQ(result.duration, 7000);
+    EXPECT_EQ(result.hero_hits, 7);
+
+    // ... but not a hero with a single health point
+    config.hero_health = 1;
+    result = SimulateBattle(config);
+    EXPECT_FALSE(result.hero_wins);
+    EXPECT_EQ(result.duration, 1500);
+    EXPECT_EQ(result.monster_hits, 1);
+}
+
+TEST(Simulation, ScriptedHero)
+{
+    BattleConfig config;
+    config.policy = POLICY_SCRIPTED;
+    config.script = {ROLE_ORC, ROLE_UNDEFINED, ROLE_DRAGON};
+    const auto result = SimulateBattle(config);
+
+    // the hero stays idle after its last command and finally dies
+    EXPECT_FALSE(result.hero_wins);
+    EXPECT_EQ(result.hero_hits, 2);
+}
+
+TEST(Simulation, Deterministic)
+{
+    BattleConfig config;
+    config.hero_interval = 1200;
+    config.hero_jitter = 1000;
+
+    const auto first = RunBattles(config, 100, 42);
+    const auto second = RunBattles(config, 100, 42);
+
+    EXPECT_EQ(first.battles, 100U);
+    EXPECT_EQ(first.wins, second.wins);
+    EXPECT_EQ(first.total_duration, second.total_duration);
+    EXPECT_GT(first.wins, 0U);
+    EXPECT_LT(first.wins, 100U);
+}
+
+TEST(Simulation, ParseCommand)
+{
+    EXPECT_EQ(ParseCommand("attack orc"), ROLE_ORC);
+    EXPECT_EQ(ParseCommand("Attack DRAGON"), ROLE_DRAGON);
+    EXPECT_EQ(ParseCommand("attack orcs"), ROLE_UNDEFINED);
+    EXPECT_EQ(ParseCommand("attack"), ROLE_UNDEFINED);
+    EXPECT_EQ(ParseCommand(nullptr), ROLE_UNDEFINED);
+}
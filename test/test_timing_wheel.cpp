@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include "gtest/gtest.h"
+#include "event_scheduler.h"
+#include "fighter.h"
+#include "timing_wheel.h"
+
+
+TEST(TimingWheel, ExpireInOrder)
+{
+    TimingWheel wheel;
+    wheel.Insert(30, 3);
+    wheel.Insert(10, 1);
+    wheel.Insert(20, 2);
+    wheel.Insert(10, 4);
+    EXPECT_EQ(wheel.Size(), 4U);
+
+    std::vector<std::pair<long long, std::size_t>> batches;
+    const auto expired = wheel.Advance(25, [&](const long long tick,
+                                               const std::vector<std::uint32_t>& ready) {
+        batches.emplace_back(tick, ready.size());
+    });
+
+    // the two timers due at tick 10 are handed over together
+    const std::vector<std::pair<long long, std::size_t>> expected{{10, 2}, {20, 1}};
+    EXPECT_EQ(expired, 3U);
+    EXPECT_EQ(batches, expected);
+    EXPECT_EQ(wheel.Now(), 25);
+    EXPECT_EQ(wheel.Size(), 1U);
+}
+
+TEST(TimingWheel, Cancel)
+{
+    TimingWheel wheel;
+    const auto first = wheel.Insert(100, 1);
+    const auto second = wheel.Insert(100, 2);
+    EXPECT_TRUE(wheel.Cancel(first));
+    EXPECT_FALSE(wheel.Cancel(first));
+    EXPECT_FALSE(wheel.Cancel(INVALID_TIMER));
+
+    std::vector<std::uint32_t> payloads;
+    wheel.Advance(1000, [&](long long, const std::vector<std::uint32_t>& ready) {
+        payloads.insert(payloads.end(), ready.begin(), ready.end());
+    });
+    EXPECT_EQ(payloads, std::vector<std::uint32_t>{2});
+    EXPECT_FALSE(wheel.Cancel(second));
+    EXPECT_EQ(wheel.Size(), 0U);
+}
+
+TEST(TimingWheel, PastTimerExpiresOnNextTick)
+{
+    TimingWheel wheel{50};
+    wheel.Insert(10, 7);
+
+    long long expired_at{0};
+    wheel.Advance(100, [&](const long long tick, const std::vector<std::uint32_t>&) {
+        expired_at = tick;
+    });
+    EXPECT_EQ(expired_at, 51);
+}
+
+TEST(TimingWheel, FarTimers)
+{
+    // one timer on each level and one in the overflow list
+    const std::vector<long long> expiries{
+        200, 70000, 20000000, 3000000000LL, 5000000000LL
+    };
+    TimingWheel wheel;
+    for(std::size_t i = 0; i < expiries.size(); ++i){
+        wheel.Insert(expiries[i], static_cast<std::uint32_t>(i));
+    }
+
+    std::vector<long long> ticks;
+    wheel.Advance(6000000000LL, [&](const long long tick,
+                                    const std::vector<std::uint32_t>& ready) {
+        for(std::size_t i = 0; i < ready.size(); ++i){
+            ticks.push_back(tick);
+        }
+    });
+    EXPECT_EQ(ticks, expiries);
+}
+
+TEST(TimingWheel, SameOrderAsBinaryHeap)
+{
+    using Timer = std::pair<long long, std::uint32_t>;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> heap;
+    TimingWheel wheel;
+    std::minstd_rand random{42};
+    std::uniform_int_distribution<long long> delay{1, 100000};
+
+    for(std::uint32_t i = 0; i < 20000; ++i){
+        const long long expiry = delay(random);
+        heap.emplace(expiry, i);
+        wheel.Insert(expiry, i);
+    }
+
+    // periodic timers: each expired one comes back with a new delay
+    std::size_t checked{0};
+    while(checked < 100000)
+    {
+        wheel.Advance(wheel.Now() + 1, [&](const long long tick,
+                                           std::vector<std::uint32_t> ready) {
+            std::vector<std::uint32_t> expected;
+            while( !heap.empty() && heap.top().first == tick ){
+                expected.push_back(heap.top().second);
+                heap.pop();
+            }
+            std::sort(ready.begin(), ready.end());
+            std::sort(expected.begin(), expected.end());
+            ASSERT_EQ(ready, expected);
+
+            for(const std::uint32_t payload : ready){
+                const long long expiry = tick + delay(random);
+                heap.emplace(expiry, payload);
+                wheel.Insert(expiry, payload);
+            }
+            checked += ready.size();
+        });
+        ASSERT_FALSE(heap.empty());
+        ASSERT_GT(heap.top().first, wheel.Now());
+    }
+    EXPECT_EQ(wheel.Size(), heap.size());
+}
+
+TEST(TimingWheel, SameBattleAsEventScheduler)
+{
+    std::vector<Monster> horde;
+    for(int i = 0; i < 5000; ++i){
+        horde.emplace_back(i % 2 == 0 ? ROLE_ORC : ROLE_DRAGON);
+    }
+    std::vector<const Monster*> monsters;
+    for(const auto& monster : horde){
+        monsters.push_back(&monster);
+    }
+
+    auto hero = Hero(ROLE_HERO);
+    hero.SetHealth(1000000);
+    long long end_time{0};
+    const auto attacks = RunMonsterCooldowns(hero, monsters, end_time);
+    EXPECT_FALSE(hero.IsAlive());
+
+    auto other_hero = Hero(ROLE_HERO);
+    other_hero.SetHealth(1000000);
+    EventScheduler scheduler;
+    RunMonsterActions(scheduler, other_hero, monsters);
+
+    // the order of the monsters within the last tick may differ, not the tick
+    EXPECT_GT(attacks, 30U * 32500U / 3U);
+    EXPECT_EQ(end_time, scheduler.Now());
+}
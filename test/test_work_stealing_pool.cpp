@@ -0,0 +1,96 @@
+#include <atomic>
+#include <cstddef>
+#include "gtest/gtest.h"
+#include "simulation.h"
+#include "work_stealing_pool.h"
+
+
+static void count_down(WorkStealingPool& pool, std::atomic<std::size_t>& done,
+                       const int depth)
+{
+    done.fetch_add(1);
+    if(depth > 0){
+        pool.Submit([&pool, &done, depth]() { count_down(pool, done, depth - 1); });
+        pool.Submit([&pool, &done, depth]() { count_down(pool, done, depth - 1); });
+    }
+}
+
+
+TEST(WorkStealingPool, RunsAllTasks)
+{
+    WorkStealingPool pool{4};
+    EXPECT_EQ(pool.Workers(), 4U);
+
+    std::atomic<std::size_t> done{0};
+    for(int i = 0; i < 10000; ++i){
+        pool.Submit([&done]() { done.fetch_add(1); });
+    }
+    pool.Wait();
+    EXPECT_EQ(done.load(), 10000U);
+
+    std::size_t tasks{0};
+    for(const auto& worker : pool.Statistics()){
+        tasks += worker.tasks;
+        EXPECT_GE(worker.utilization, 0.0);
+        EXPECT_LE(worker.utilization, 1.5);
+    }
+    EXPECT_EQ(tasks, 10000U);
+}
+
+TEST(WorkStealingPool, NestedTasks)
+{
+    WorkStealingPool pool{3};
+    std::atomic<std::size_t> done{0};
+
+    // a single task spawning a binary tree of 2^15 - 1 tasks: all but the
+    // first are submitted to the deque of a worker, the others have to steal
+    pool.Submit([&pool, &done]() { count_down(pool, done, 14); });
+    pool.Wait();
+    EXPECT_EQ(done.load(), (1U << 15U) - 1U);
+
+    pool.ResetStatistics();
+    for(const auto& worker : pool.Statistics()){
+        EXPECT_EQ(worker.tasks, 0U);
+        EXPECT_EQ(worker.steals, 0U);
+    }
+}
+
+TEST(WorkStealingPool, SessionsMatchSequentialBattles)
+{
+    BattleConfig config;
+    config.hero_interval = 1200;
+    config.hero_jitter = 1000;
+
+    WorkStealingPool pool{4};
+    const auto expected = RunBattles(config, 2000, 3);
+    for(const std::size_t events_per_task : {1U, 16U}){
+        const auto stats = RunSessions(pool, config, 2000, 3, events_per_task);
+        EXPECT_EQ(stats.battles, expected.battles);
+        EXPECT_EQ(stats.wins, expected.wins);
+        EXPECT_EQ(stats.total_duration, expected.total_duration);
+        EXPECT_EQ(stats.hero_hits, expected.hero_hits);
+        EXPECT_EQ(stats.monster_hits, expected.monster_hits);
+    }
+}
+
+TEST(BattleSession, SameAsSimulateBattle)
+{
+    BattleConfig config;
+    BattleSession session{config, 0};
+    EXPECT_FALSE(session.Over());
+
+    std::size_t steps{0};
+    while( session.Step() ){
+        ++steps;
+    }
+    EXPECT_TRUE(session.Over());
+    EXPECT_FALSE(session.Step());
+
+    const auto expected = SimulateBattle(config, 0);
+    EXPECT_EQ(session.Result().duration, expected.duration);
+    EXPECT_EQ(session.Result().hero_health, expected.hero_health);
+    EXPECT_EQ(session.Result().hero_hits, expected.hero_hits);
+    // at least one event per hit
+    EXPECT_GE(steps + 1, static_cast<std::size_t>(expected.hero_hits +
+                                                  expected.monster_hits));
+}
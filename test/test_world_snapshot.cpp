@@ -0,0 +1,177 @@
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "fighter.h"
+#include "world_snapshot.h"
+
+
+static std::string SnapshotPath(const char* name)
+{
+    return testing::TempDir() + name;
+}
+
+static std::vector<unsigned char> ReadBytes(const std::string& path)
+{
+    std::ifstream file{path, std::ios::binary};
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+static void WriteBytes(const std::string& path,
+                       const std::vector<unsigned char>& bytes)
+{
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<const char*>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+}
+
+// The world of the format compatibility test: a hero and a wounded orc,
+// the next orc attack due at 1.5s
+static WorldState SmallWorld()
+{
+    WorldState world;
+    world.clock = 1000;
+    world.steps = 2;
+    world.hero_wins = true;
+    world.fighters.Add(ROLE_HERO);
+    world.fighters.Add(ROLE_ORC);
+    world.fighters.SetHealth(1, 5);
+    world.timers.push_back({1500, 1, 3});
+    return world;
+}
+
+// SmallWorld() as written by version 1 of the format
+static const std::vector<unsigned char> SMALL_WORLD_V1 = {
+    'S', 'C', 'G', 'W', 'O', 'R', 'L', 'D',  1, 0, 64, 0,  2, 0, 0, 0,
+    2, 0, 0, 0, 0, 0, 0, 0,   1, 0, 0, 0, 0, 0, 0, 0,
+    0xE8, 0x03, 0, 0, 0, 0, 0, 0,   2, 0, 0, 0, 0, 0, 0, 0,
+    0x47, 0x6E, 0x4C, 0x4D, 0x46, 0x41, 0x92, 0x6F,   40, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0,  1, 0, 0, 0,          // roles
+    40, 0, 0, 0,  5, 0, 0, 0,         // health
+    0xDC, 0x05, 0, 0, 0, 0, 0, 0,  1, 0, 0, 0, 0, 0, 0, 0,
+    3, 0, 0, 0, 0, 0, 0, 0,           // timer
+};
+
+static void ExpectSameWorld(const WorldState& world, const WorldState& expected)
+{
+    EXPECT_EQ(world.clock, expected.clock);
+    EXPECT_EQ(world.steps, expected.steps);
+    EXPECT_EQ(world.over, expected.over);
+    EXPECT_EQ(world.hero_wins, expected.hero_wins);
+    ASSERT_EQ(world.fighters.Size(), expected.fighters.Size());
+    for(std::size_t i = 0; i < world.fighters.Size(); ++i){
+        EXPECT_EQ(world.fighters.GetRole(i), expected.fighters.GetRole(i));
+        EXPECT_EQ(world.fighters.GetHealth(i), expected.fighters.GetHealth(i));
+    }
+    ASSERT_EQ(world.timers.size(), expected.timers.size());
+    for(std::size_t i = 0; i < world.timers.size(); ++i){
+        EXPECT_EQ(world.timers[i].time, expected.timers[i].time);
+        EXPECT_EQ(world.timers[i].actor, expected.timers[i].actor);
+        EXPECT_EQ(world.timers[i].sequence, expected.timers[i].sequence);
+    }
+}
+
+
+TEST(WorldSnapshot, FormatVersion1)
+{
+    // snapshots of version 1 must stay readable: update SMALL_WORLD_V1
+    // only together with SNAPSHOT_VERSION
+    const auto path = SnapshotPath("world_v1.snapshot");
+    ASSERT_EQ(WriteSnapshot(SmallWorld(), path.c_str()), SNAPSHOT_OK);
+    EXPECT_EQ(ReadBytes(path), SMALL_WORLD_V1);
+
+    WriteBytes(path, SMALL_WORLD_V1);
+    WorldState world;
+    ASSERT_EQ(ReadSnapshot(path.c_str(), world), SNAPSHOT_OK);
+    ExpectSameWorld(world, SmallWorld());
+}
+
+TEST(WorldSnapshot, RoundTrip)
+{
+    WorldState world;
+    world.clock = 123456789012LL;
+    world.steps = 987654321;
+    world.over = true;
+    for(std::size_t i = 0; i < 100001; ++i){
+        world.fighters.Add(static_cast<ROLE_t>(static_cast<int>(i % 4) - 1));
+        world.fighters.SetHealth(i, static_cast<int>(i % 50) - 1);
+    }
+    for(std::size_t i = 0; i < 5000; ++i){
+        world.timers.push_back({static_cast<std::int64_t>(i * 7), i, i + 1});
+    }
+
+    const auto path = SnapshotPath("world_round_trip.snapshot");
+    ASSERT_EQ(WriteSnapshot(world, path.c_str()), SNAPSHOT_OK);
+
+    WorldState restored;
+    restored.fighters.Add(ROLE_DRAGON); // replaced
+    ASSERT_EQ(ReadSnapshot(path.c_str(), restored), SNAPSHOT_OK);
+    ExpectSameWorld(restored, world);
+}
+
+TEST(WorldSnapshot, MappedView)
+{
+    const auto path = SnapshotPath("world_view.snapshot");
+    ASSERT_EQ(WriteSnapshot(SmallWorld(), path.c_str()), SNAPSHOT_OK);
+
+    MappedSnapshot snapshot;
+    ASSERT_EQ(snapshot.Open(path.c_str()), SNAPSHOT_OK);
+    EXPECT_TRUE(snapshot.IsOpen());
+    EXPECT_EQ(snapshot.Clock(), 1000);
+    EXPECT_EQ(snapshot.Steps(), 2U);
+    EXPECT_FALSE(snapshot.Over());
+    EXPECT_TRUE(snapshot.HeroWins());
+    ASSERT_EQ(snapshot.FighterCount(), 2U);
+    EXPECT_EQ(snapshot.Roles()[0], ROLE_HERO);
+    EXPECT_EQ(snapshot.Roles()[1], ROLE_ORC);
+    EXPECT_EQ(snapshot.Health()[0], HEALTH_HERO);
+    EXPECT_EQ(snapshot.Health()[1], 5);
+    ASSERT_EQ(snapshot.TimerCount(), 1U);
+    EXPECT_EQ(snapshot.Timers()[0].time, 1500);
+    EXPECT_EQ(snapshot.Timers()[0].actor, 1U);
+
+    snapshot.Close();
+    EXPECT_FALSE(snapshot.IsOpen());
+    EXPECT_EQ(snapshot.FighterCount(), 0U);
+}
+
+TEST(WorldSnapshot, InvalidFiles)
+{
+    const auto path = SnapshotPath("world_invalid.snapshot");
+    WorldState world = SmallWorld();
+    MappedSnapshot snapshot;
+
+    EXPECT_EQ(snapshot.Open(SnapshotPath("no_such.snapshot").c_str()),
+              SNAPSHOT_IO_ERROR);
+
+    auto bytes = SMALL_WORLD_V1;
+    bytes[72] ^= 1U; // a role
+    WriteBytes(path, bytes);
+    EXPECT_EQ(ReadSnapshot(path.c_str(), world), SNAPSHOT_BAD_CHECKSUM);
+    EXPECT_EQ(snapshot.Open(path.c_str(), false), SNAPSHOT_OK);
+    ExpectSameWorld(world, SmallWorld()); // left unchanged
+
+    bytes = SMALL_WORLD_V1;
+    bytes[8] = 2; // version
+    WriteBytes(path, bytes);
+    EXPECT_EQ(snapshot.Open(path.c_str()), SNAPSHOT_BAD_VERSION);
+    EXPECT_FALSE(snapshot.IsOpen());
+
+    bytes = SMALL_WORLD_V1;
+    bytes[0] = 'X';
+    WriteBytes(path, bytes);
+    EXPECT_EQ(snapshot.Open(path.c_str()), SNAPSHOT_BAD_FORMAT);
+
+    bytes = SMALL_WORLD_V1;
+    bytes.resize(bytes.size() - 8); // truncated
+    WriteBytes(path, bytes);
+    EXPECT_EQ(snapshot.Open(path.c_str()), SNAPSHOT_BAD_FORMAT);
+
+    bytes = SMALL_WORLD_V1;
+    bytes[16] = 0xFF; // fighter count
+    WriteBytes(path, bytes);
+    EXPECT_EQ(snapshot.Open(path.c_str()), SNAPSHOT_BAD_FORMAT);
+}